@@ -203,6 +203,7 @@ public:
 	void ResolveLiteralReferences();
 
 	void Adc(REGISTER, REGISTER, REGISTER);
+	void Adcs(REGISTER, REGISTER, REGISTER);
 	void Add(REGISTER, REGISTER, REGISTER);
 	void Add(REGISTER, REGISTER, const ImmediateAluOperand&);
 	void Adds(REGISTER, REGISTER, REGISTER);
@@ -236,6 +237,8 @@ public:
 	void Or(REGISTER, REGISTER, REGISTER);
 	void Or(REGISTER, REGISTER, const ImmediateAluOperand&);
 	void Or(CONDITION, REGISTER, REGISTER, const ImmediateAluOperand&);
+	void Rev(REGISTER, REGISTER);
+	void Rev16(REGISTER, REGISTER);
 	void Rsb(REGISTER, REGISTER, const ImmediateAluOperand&);
 	void Sbc(REGISTER, REGISTER, REGISTER);
 	void Sdiv(REGISTER, REGISTER, REGISTER);
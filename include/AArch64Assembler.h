@@ -4,6 +4,7 @@
 #include <vector>
 #include "Stream.h"
 #include "Literal128.h"
+#include "CodeRegionRelocation.h"
 
 class CAArch64Assembler
 {
@@ -85,13 +86,18 @@ public:
 	virtual ~CAArch64Assembler() = default;
 
 	void SetStream(Framework::CStream*);
+	void SetColdStream(Framework::CStream*);
+	void SetColdRegion(bool);
+	const CodeRegionRelocationArray& GetRegionRelocations() const;
 
 	LABEL CreateLabel();
 	void ClearLabels();
 	void MarkLabel(LABEL);
 	void ResolveLabelReferences();
 	void ResolveLiteralReferences();
+	void EmitIslandIfNeeded();
 
+	void Adcs(REGISTER32, REGISTER32, REGISTER32);
 	void Add(REGISTER32, REGISTER32, REGISTER32);
 	void Add(REGISTER64, REGISTER64, REGISTER64);
 	void Add(REGISTER32, REGISTER32, uint16, ADDSUB_IMM_SHIFT_TYPE);
@@ -99,6 +105,7 @@ public:
 	void Add_4s(REGISTERMD, REGISTERMD, REGISTERMD);
 	void Add_8h(REGISTERMD, REGISTERMD, REGISTERMD);
 	void Add_16b(REGISTERMD, REGISTERMD, REGISTERMD);
+	void Adds(REGISTER32, REGISTER32, REGISTER32);
 	void And(REGISTER32, REGISTER32, REGISTER32);
 	void And(REGISTER64, REGISTER64, REGISTER64);
 	void And(REGISTER32, REGISTER32, uint8, uint8, uint8);
@@ -176,6 +183,7 @@ public:
 	void Ldrh(REGISTER32, REGISTER64, uint32);
 	void Ldrh(REGISTER32, REGISTER64, REGISTER64, bool);
 	void Ldr_Pc(REGISTER64, uint32);
+	void Ldr_Pc(REGISTER64, uint64);
 	void Ldr_Pc(REGISTERMD, const LITERAL128&);
 	void Ldr_1s(REGISTERMD, REGISTER64, uint32);
 	void Ldr_1q(REGISTERMD, REGISTER64, uint32);
@@ -194,6 +202,7 @@ public:
 	void Mov_Sp(REGISTER64, REGISTER64);
 	void Movi_4s(REGISTERMD, uint8, MOVI_4S_IMM_SHIFT_TYPE);
 	void Movn(REGISTER32, uint16, uint8);
+	void Movn(REGISTER64, uint16, uint8);
 	void Movk(REGISTER32, uint16, uint8);
 	void Movk(REGISTER64, uint16, uint8);
 	void Movz(REGISTER32, uint16, uint8);
@@ -204,8 +213,12 @@ public:
 	void Orn_16b(REGISTERMD, REGISTERMD, REGISTERMD);
 	void Orr(REGISTER32, REGISTER32, REGISTER32);
 	void Orr(REGISTER32, REGISTER32, uint8, uint8, uint8);
+	void Orr(REGISTER64, REGISTER64, uint8, uint8, uint8);
 	void Orr_16b(REGISTERMD, REGISTERMD, REGISTERMD);
 	void Ret(REGISTER64 = x30);
+	void Rev(REGISTER32, REGISTER32);
+	void Rev(REGISTER64, REGISTER64);
+	void Rev16(REGISTER32, REGISTER32);
 	void Scvtf_1s(REGISTERMD, REGISTERMD);
 	void Scvtf_4s(REGISTERMD, REGISTERMD);
 	void Sdiv(REGISTER32, REGISTER32, REGISTER32);
@@ -244,6 +257,7 @@ public:
 	void Sub_4s(REGISTERMD, REGISTERMD, REGISTERMD);
 	void Sub_8h(REGISTERMD, REGISTERMD, REGISTERMD);
 	void Sub_16b(REGISTERMD, REGISTERMD, REGISTERMD);
+	void Subs(REGISTER32, REGISTER32, REGISTER32);
 	void Tbl(REGISTERMD, REGISTERMD, REGISTERMD);
 	void Tst(REGISTER32, REGISTER32);
 	void Tst(REGISTER64, REGISTER64);
@@ -272,9 +286,16 @@ public:
 	void Zip2_16b(REGISTERMD, REGISTERMD, REGISTERMD);
 
 private:
+	struct LABELINFO
+	{
+		size_t offset = 0;
+		bool isCold = false;
+	};
+
 	struct LABELREF
 	{
 		size_t offset = 0;
+		bool isCold = false;
 		bool cbz = false;
 		bool cbz64 = false;
 		REGISTER32 cbRegister = w0;
@@ -284,18 +305,51 @@ private:
 	struct LITERAL128REF
 	{
 		size_t offset = 0;
+		bool isCold = false;
 		uint32 rt = 0;
 		LITERAL128 value = LITERAL128(0, 0);
 	};
 
-	typedef std::map<LABEL, size_t> LabelMapType;
+	struct LITERAL64REF
+	{
+		size_t offset = 0;
+		bool isCold = false;
+		uint32 rt = 0;
+		uint64 value = 0;
+	};
+
+	typedef std::map<LABEL, LABELINFO> LabelMapType;
 	typedef std::multimap<LABEL, LABELREF> LabelReferenceMapType;
 
 	typedef std::vector<LITERAL128REF> Literal128ArrayType;
+	typedef std::vector<LITERAL64REF> Literal64ArrayType;
+
+	//Conditional branches and literal loads reach +/-1MB. Code is checked for
+	//forward references getting close to that limit, islands containing
+	//branch veneers and literals are then emitted in the middle of the code.
+	enum : size_t
+	{
+		ISLAND_SOFT_DISTANCE = 0x80000,
+		ISLAND_HARD_DISTANCE = 0xC0000,
+		NO_PENDING_REFERENCE = ~static_cast<size_t>(0),
+	};
+
+	struct ISLANDSTATE
+	{
+		size_t pendingStart = NO_PENDING_REFERENCE;
+		size_t unconditionalBranchEnd = NO_PENDING_REFERENCE;
+	};
 
 	void CreateBranchLabelReference(LABEL, CONDITION);
 	void CreateCompareBranchLabelReference(LABEL, CONDITION, REGISTER32);
 	void CreateCompareBranchLabelReference(LABEL, CONDITION, REGISTER64);
+	bool IsConditionalBranchOutOfRange(LABEL) const;
+	void NotePendingReference();
+	void NoteUnconditionalBranch();
+	ISLANDSTATE& GetIslandState();
+	void EmitIsland(bool);
+	bool HasLiterals(bool) const;
+	void WriteLiteralPool(Framework::CStream*, bool);
 
 	void WriteAddSubOpImm(uint32, uint32 shift, uint32 imm, uint32 rn, uint32 rd);
 	void WriteDataProcOpReg2(uint32, uint32 rm, uint32 rn, uint32 rd);
@@ -308,6 +362,13 @@ private:
 	LabelMapType m_labels;
 	LabelReferenceMapType m_labelReferences;
 	Literal128ArrayType m_literal128Refs;
+	Literal64ArrayType m_literal64Refs;
+	CodeRegionRelocationArray m_regionRelocations;
 
+	//Stream currently receiving code, either the hot or the cold one
 	Framework::CStream* m_stream = nullptr;
+	Framework::CStream* m_hotStream = nullptr;
+	Framework::CStream* m_coldStream = nullptr;
+	bool m_coldRegion = false;
+	ISLANDSTATE m_islandStates[2];
 };
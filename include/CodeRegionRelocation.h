@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+#include "Types.h"
+
+enum class CODE_REGION_RELOCATION_TYPE
+{
+	REL32,    //32-bit displacement relative to the end of the field
+	BRANCH26, //AArch64 B instruction
+};
+
+//Branch between the hot and cold code regions that needs to be patched
+//once both regions have their final location
+struct CODE_REGION_RELOCATION
+{
+	CODE_REGION_RELOCATION_TYPE type = CODE_REGION_RELOCATION_TYPE::REL32;
+	bool inColdRegion = false;
+	uint32 offset = 0;
+	uint32 targetOffset = 0;
+};
+typedef std::vector<CODE_REGION_RELOCATION> CodeRegionRelocationArray;
@@ -5,6 +5,7 @@
 #include <list>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <stack>
 #include "ArrayStack.h"
@@ -40,6 +41,14 @@ namespace Jitter
 			RETURN_VALUE_128,
 		};
 
+		//Tells how likely a path is to be taken, unlikely paths are moved away from the main flow
+		enum BRANCH_HINT
+		{
+			BRANCH_HINT_NONE,
+			BRANCH_HINT_LIKELY,
+			BRANCH_HINT_UNLIKELY,
+		};
+
 		typedef unsigned int LABEL;
 
 		CJitter(CCodeGen*);
@@ -50,13 +59,13 @@ namespace Jitter
 
 		bool IsStackEmpty() const;
 
-		void BeginIf(CONDITION);
+		void BeginIf(CONDITION, BRANCH_HINT = BRANCH_HINT_NONE);
 		void Else();
 		void EndIf();
 
 		LABEL CreateLabel();
 		void MarkLabel(LABEL);
-		void Goto(LABEL);
+		void Goto(LABEL, BRANCH_HINT = BRANCH_HINT_NONE);
 
 		void PushCtx();
 		void PushCst(uint32);
@@ -72,9 +81,12 @@ namespace Jitter
 		void Swap();
 
 		void Add();
+		void AddOvf();
+		void AddCarry();
+		void Adc();
 		void And();
 		void Break();
-		void Call(void*, unsigned int, RETURN_VALUE_TYPE);
+		void Call(void*, unsigned int, RETURN_VALUE_TYPE, uint32 = CALL_ATTRIBUTE_NONE);
 		void Cmp(CONDITION);
 		void Div();
 		void DivS();
@@ -96,6 +108,8 @@ namespace Jitter
 		void Srl();
 		void Srl(uint8);
 		void Sub();
+		void SubOvf();
+		void SubBorrow();
 		void Xor();
 
 		//Memory operations
@@ -125,6 +139,30 @@ namespace Jitter
 		void Store64AtRef();
 		void Store64AtRefIdx(size_t = sizeof(uint64));
 
+		//Byte swapping memory operations
+		void LoadFromRefBSwap();
+		void LoadFromRefIdxBSwap(size_t = sizeof(uint32));
+		void Load16FromRefBSwap();
+		void Load16FromRefIdxBSwap(size_t = sizeof(uint16));
+		void Load64FromRefBSwap();
+		void Load64FromRefIdxBSwap(size_t = sizeof(uint64));
+		void StoreAtRefBSwap();
+		void StoreAtRefIdxBSwap(size_t = sizeof(uint32));
+		void Store16AtRefBSwap();
+		void Store16AtRefIdxBSwap(size_t = sizeof(uint16));
+		void Store64AtRefBSwap();
+		void Store64AtRefIdxBSwap(size_t = sizeof(uint64));
+
+		//Memory base operations
+		//Address is computed as memory base + index + displacement, where memory base is
+		//a pointer stored in context at the offset specified with SetMemoryBase
+		void LoadFromMemBase(uint32 = 0);
+		void Load8FromMemBase(uint32 = 0);
+		void Load16FromMemBase(uint32 = 0);
+		void StoreAtMemBase(uint32 = 0);
+		void Store8AtMemBase(uint32 = 0);
+		void Store16AtMemBase(uint32 = 0);
+
 		//64-bits
 		virtual void PushRel64(size_t);
 		void PushCst64(uint64);
@@ -245,6 +283,13 @@ namespace Jitter
 		CCodeGen* GetCodeGen();
 
 		void SetStream(Framework::CStream*);
+		void SetMemoryBase(size_t);
+
+		//Pinned relatives are kept in registers for the whole function, they are only
+		//written back to the context around calls, external jumps and at function exit.
+		//They must only be accessed through PushRel/PullRel.
+		void PinRelative(size_t);
+		void ClearPinnedRelatives();
 
 	private:
 		struct SYMBOL_REGALLOCINFO
@@ -286,9 +331,36 @@ namespace Jitter
 			CSymbolTable symbolTable;
 			bool optimized = false;
 			bool hasJumpRef = false;
+			bool isCold = false;
+			//Ids of the blocks that can run after this one, kept up to date when flow control changes
+			std::vector<uint32> successors;
 		};
 		typedef std::list<BASIC_BLOCK> BasicBlockList;
 
+		//Control flow graph over m_basicBlocks, nodes are in the same order as the blocks
+		struct CONTROL_FLOW_GRAPH
+		{
+			enum
+			{
+				INVALID_NODE = ~0U,
+			};
+
+			struct NODE
+			{
+				BasicBlockList::iterator block;
+				std::vector<uint32> successors;
+				std::vector<uint32> predecessors;
+				uint32 immediateDominator = INVALID_NODE;
+				uint32 reversePostOrderIndex = INVALID_NODE;
+			};
+
+			bool IsReachable(uint32) const;
+			bool Dominates(uint32, uint32) const;
+
+			std::vector<NODE> nodes;
+			std::vector<uint32> reversePostOrder;
+		};
+
 		struct VERSIONED_STATEMENT_LIST
 		{
 			StatementList statements;
@@ -297,9 +369,13 @@ namespace Jitter
 
 		void InsertUnaryStatement(Jitter::OPERATION);
 		void InsertBinaryStatement(Jitter::OPERATION);
+		void InsertBinaryFlagStatement(Jitter::OPERATION);
 		void InsertShiftCstStatement(Jitter::OPERATION, uint8);
 		void InsertLoadFromRefIdxStatement(Jitter::OPERATION, size_t);
 		void InsertStoreAtRefIdxStatement(Jitter::OPERATION, size_t);
+		void PushMemoryBaseRef(uint32);
+		void InsertLoadFromMemBaseStatement(Jitter::OPERATION, uint32);
+		void InsertStoreAtMemBaseStatement(Jitter::OPERATION, uint32);
 		void InsertBinary64Statement(Jitter::OPERATION);
 		void InsertUnaryFp32Statement(Jitter::OPERATION);
 		void InsertBinaryFp32Statement(Jitter::OPERATION);
@@ -307,13 +383,19 @@ namespace Jitter
 		void InsertBinaryMdStatement(Jitter::OPERATION);
 
 		void Compile();
+		bool CompileUnoptimized();
 
 		bool ConstantFolding(StatementList&);
 		bool ConstantPropagation(StatementList&);
 		bool CopyPropagation(StatementList&);
+		bool ReduceConstantDivisions(StatementList&);
+		bool SimplifyKnownBits(StatementList&);
 		bool ReorderAdd(StatementList&);
+		bool FoldAddRefAddressing(StatementList&);
+		bool FuseFlagBranches(StatementList&);
 		bool CommonExpressionElimination(VERSIONED_STATEMENT_LIST&);
 		bool DeadcodeElimination(VERSIONED_STATEMENT_LIST&);
+		bool EliminatePureCalls(VERSIONED_STATEMENT_LIST&);
 
 		void FixFlowControl(StatementList&);
 
@@ -321,11 +403,23 @@ namespace Jitter
 		bool FoldConstant64Operation(STATEMENT&);
 		bool FoldConstant6432Operation(STATEMENT&);
 		bool FoldConstant12832Operation(STATEMENT&);
-
-		BASIC_BLOCK ConcatBlocks(const BasicBlockList&);
+		bool FoldConstantByteSwapOperation(STATEMENT&);
+
+		BASIC_BLOCK ConcatBlocks(const BasicBlockList&, bool);
+		CONTROL_FLOW_GRAPH BuildControlFlowGraph();
+		static void AddBlockSuccessor(BASIC_BLOCK&, uint32);
+		static void ReplaceBlockSuccessor(BASIC_BLOCK&, uint32, uint32);
+		std::vector<uint32> ComputeBlockSuccessors(BasicBlockList::const_iterator) const;
+		bool CheckBlockSuccessors() const;
 		bool MergeBlocks();
 		bool PruneBlocks();
 		void HarmonizeBlocks();
+		void PlaceBlocks(bool);
+		bool ForwardRelativeConstants();
+		bool EliminateDeadRelativeStores();
+		bool HoistLoopInvariants();
+		bool HoistLoopInvariants(const CONTROL_FLOW_GRAPH&, uint32, const std::vector<bool>&);
+		bool IsHoistedTemporary(const CSymbol*) const;
 		void MergeBasicBlocks(BASIC_BLOCK&, const BASIC_BLOCK&);
 
 		void StartBlock(uint32);
@@ -349,28 +443,44 @@ namespace Jitter
 		void PruneSymbols(BASIC_BLOCK&) const;
 
 		void AllocateRegisters(BASIC_BLOCK&);
+		void AssignPinnedRelativeRegisters();
+		void AllocatePinnedRelatives(BASIC_BLOCK&, bool, bool);
 		static AllocationRangeArray ComputeAllocationRanges(const BASIC_BLOCK&);
 		void ComputeLivenessForRange(const BASIC_BLOCK&, const AllocationRange&, SymbolRegAllocInfo&) const;
 		void MarkAliasedSymbols(const BASIC_BLOCK&, const AllocationRange&, SymbolRegAllocInfo&) const;
-		void AssociateSymbolsToRegisters(SymbolRegAllocInfo&) const;
+		void AssociateSymbolsToRegisters(SymbolRegAllocInfo&, bool) const;
 
 		void NormalizeStatements(BASIC_BLOCK&);
 		unsigned int AllocateStack(BASIC_BLOCK&);
+		unsigned int AllocateHoistedTemporaries(unsigned int);
 
 		bool m_blockStarted = false;
 
 		CArrayStack<SymbolPtr> m_shadow;
 		IntStack m_ifStack;
+		std::stack<BRANCH_HINT> m_ifHintStack;
+		unsigned int m_coldRegionDepth = 0;
 
 		unsigned int m_nextTemporary = 1;
 		unsigned int m_nextBlockId = 1;
 
+		//Temporaries moved out of loops, these live across blocks and get their own stack slot
+		std::unordered_set<uint32> m_hoistedTemporaries;
+
 		BASIC_BLOCK* m_currentBlock = nullptr;
 		BasicBlockList m_basicBlocks;
 		CCodeGen* m_codeGen = nullptr;
 
+		size_t m_memoryBaseOffset = SIZE_MAX;
+		bool m_usesMemoryBase = false;
+
+		std::vector<uint32> m_pinnedRelatives;
+		std::map<uint32, unsigned int> m_pinnedRelativeRegisters;
+
 		unsigned int m_nextLabelId = 1;
 		LabelMapType m_labels;
+		//Blocks ending with a GOTO to a label that isn't marked yet
+		std::map<LABEL, std::vector<BASIC_BLOCK*>> m_pendingLabelReferences;
 	};
 
 }
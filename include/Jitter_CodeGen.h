@@ -2,7 +2,9 @@
 
 #include "Stream.h"
 #include "Jitter_Statement.h"
+#include "CodeRegionRelocation.h"
 #include <map>
+#include <vector>
 #include <functional>
 
 namespace Jitter
@@ -21,17 +23,40 @@ namespace Jitter
 
 		typedef std::function<void(uintptr_t, uint32, SYMBOL_REF_TYPE)> ExternalSymbolReferencedHandler;
 
+		enum
+		{
+			MEMORY_BASE_NONE = ~0U,
+		};
+
 		virtual ~CCodeGen(){};
 
 		virtual void SetStream(Framework::CStream*) = 0;
+		virtual void SetColdStream(Framework::CStream*);
+		bool HasColdStream() const;
+		const CodeRegionRelocationArray& GetCodeRegionRelocations() const;
+		static void ApplyCodeRegionRelocations(const CodeRegionRelocationArray&, void*, void*);
+		//Same as above, but writes through writable aliases of the hot and cold code
+		static void ApplyCodeRegionRelocations(const CodeRegionRelocationArray&, void*, void*, void*, void*);
 		void SetExternalSymbolReferencedHandler(const ExternalSymbolReferencedHandler&);
+		void SetMemoryBaseOffset(uint32);
 
 		virtual void GenerateCode(const StatementList&, unsigned int) = 0;
+		//Tells if statements can be generated as they come out of the front end, without going through
+		//the optimizer and register allocator. Statements are checked as emitted (gotos aren't resolved and
+		//operands aren't normalized), GenerateCode then gets them with resolved jumps and stack locations.
+		virtual bool CanGenerateUnoptimized(const StatementList&) const;
 		virtual unsigned int GetAvailableRegisterCount() const = 0;
 		virtual unsigned int GetAvailableMdRegisterCount() const = 0;
 		virtual bool Has128BitsCallOperands() const = 0;
 		virtual bool CanHold128BitsReturnValueInRegisters() const = 0;
 		virtual bool SupportsExternalJumps() const = 0;
+		virtual bool SupportsBlockPlacement() const = 0;
+		virtual bool SupportsColdRegion() const = 0;
+		virtual bool SupportsMemoryBase() const = 0;
+		virtual bool SupportsRefIndexDisplacement() const = 0;
+		//Tells if CONDJMP can test the flag of an ALU flag operation result directly (see OP_CONDJMP)
+		virtual bool SupportsAluFlagBranches() const = 0;
+		virtual bool SupportsNestedLoops() const = 0;
 		virtual void RegisterExternalSymbols(CObjectFile*) const = 0;
 		virtual uint32 GetPointerSize() const = 0;
 
@@ -94,8 +119,22 @@ namespace Jitter
 
 		bool SymbolMatches(MATCHTYPE, const SymbolRefPtr&);
 		static uint32 GetRegisterUsage(const StatementList&);
+		bool HasMemoryBase() const;
+		OPERATION GetLiveFlagOperation(const STATEMENT&) const;
+		void UpdateLiveFlags(const STATEMENT&);
 
 		MatcherMapType m_matchers;
 		ExternalSymbolReferencedHandler m_externalSymbolReferencedHandler;
+
+		//Stream receiving the code of cold blocks, code is emitted in a single region when not set
+		Framework::CStream* m_coldStream = nullptr;
+		CodeRegionRelocationArray m_codeRegionRelocations;
+
+		//Offset in context where the memory base pointer is found, loaded in
+		//a reserved register for the whole function when needed
+		uint32 m_memoryBaseOffset = MEMORY_BASE_NONE;
+
+		//ALU flag operation whose flag is still held in the processor flags, set by its emitter
+		const STATEMENT* m_liveFlagStatement = nullptr;
 	};
 }
@@ -4,5 +4,13 @@
 
 namespace Jitter
 {
-	CCodeGen* CreateCodeGen();
+	enum class CODEGEN_TIER
+	{
+		OPTIMIZED,
+		//Favors compilation speed over code quality, for code that doesn't run often.
+		//Only available on x86-64, other platforms use the optimized code generator.
+		BASELINE,
+	};
+
+	CCodeGen* CreateCodeGen(CODEGEN_TIER = CODEGEN_TIER::OPTIMIZED);
 };
@@ -30,6 +30,12 @@ namespace Jitter
 		bool CanHold128BitsReturnValueInRegisters() const override;
 		bool Has128BitsCallOperands() const override;
 		bool SupportsExternalJumps() const override;
+		bool SupportsBlockPlacement() const override;
+		bool SupportsColdRegion() const override;
+		bool SupportsMemoryBase() const override;
+		bool SupportsRefIndexDisplacement() const override;
+		bool SupportsAluFlagBranches() const override;
+		bool SupportsNestedLoops() const override;
 		uint32 GetPointerSize() const override;
 
 	private:
@@ -546,6 +552,9 @@ namespace Jitter
 		template <bool>
 		void Emit_MulTmp64AnyAny(const STATEMENT&);
 
+		//ADDOVF/ADDCARRY/ADC/SUBOVF/SUBBORROW
+		void Emit_AluFlag_Tmp64AnyAny(const STATEMENT&);
+
 		//DIV/DIVS
 		template <bool>
 		void Div_GenericTmp64AnyAny(const STATEMENT&);
@@ -639,6 +648,26 @@ namespace Jitter
 		void Emit_StoreAtRef_64_VarAny(const STATEMENT&);
 		void Emit_StoreAtRef_64_VarAnyAny(const STATEMENT&);
 
+		//LOADFROMREFBSWAP
+		void Emit_LoadFromRefBSwap_VarVar(const STATEMENT&);
+		void Emit_LoadFromRefBSwap_VarVarAny(const STATEMENT&);
+		void Emit_LoadFromRefBSwap_64_MemVar(const STATEMENT&);
+		void Emit_LoadFromRefBSwap_64_MemVarAny(const STATEMENT&);
+
+		//LOAD16FROMREFBSWAP
+		void Emit_Load16FromRefBSwap_VarVar(const STATEMENT&);
+		void Emit_Load16FromRefBSwap_VarVarAny(const STATEMENT&);
+
+		//STOREATREFBSWAP
+		void Emit_StoreAtRefBSwap_VarAny(const STATEMENT&);
+		void Emit_StoreAtRefBSwap_VarAnyAny(const STATEMENT&);
+		void Emit_StoreAtRefBSwap_64_VarAny(const STATEMENT&);
+		void Emit_StoreAtRefBSwap_64_VarAnyAny(const STATEMENT&);
+
+		//STORE16ATREFBSWAP
+		void Emit_Store16AtRefBSwap_VarAny(const STATEMENT&);
+		void Emit_Store16AtRefBSwap_VarAnyAny(const STATEMENT&);
+
 		//MOV64
 		void Emit_Mov_Mem64Mem64(const STATEMENT&);
 		void Emit_Mov_Mem64Cst64(const STATEMENT&);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <deque>
+#include <set>
 #include "Jitter_CodeGen.h"
 #include "AArch64Assembler.h"
 
@@ -16,12 +17,19 @@ namespace Jitter
 
 		void GenerateCode(const StatementList&, unsigned int) override;
 		void SetStream(Framework::CStream*) override;
+		void SetColdStream(Framework::CStream*) override;
 		void RegisterExternalSymbols(CObjectFile*) const override;
 		unsigned int GetAvailableRegisterCount() const override;
 		unsigned int GetAvailableMdRegisterCount() const override;
 		bool Has128BitsCallOperands() const override;
 		bool CanHold128BitsReturnValueInRegisters() const override;
 		bool SupportsExternalJumps() const override;
+		bool SupportsBlockPlacement() const override;
+		bool SupportsColdRegion() const override;
+		bool SupportsMemoryBase() const override;
+		bool SupportsRefIndexDisplacement() const override;
+		bool SupportsAluFlagBranches() const override;
+		bool SupportsNestedLoops() const override;
 		uint32 GetPointerSize() const override;
 
 	private:
@@ -41,6 +49,12 @@ namespace Jitter
 			uint8 imms;
 		};
 
+		struct CACHED_CONSTANT
+		{
+			bool valid = false;
+			uint32 value = 0;
+		};
+
 		struct PARAM_STATE
 		{
 			bool prepared = false;
@@ -103,6 +117,10 @@ namespace Jitter
 		void LoadConstantInRegister(CAArch64Assembler::REGISTER32, uint32);
 		void LoadConstant64InRegister(CAArch64Assembler::REGISTER64, uint64);
 
+		bool TryLoadCachedConstantInRegister(CAArch64Assembler::REGISTER32, uint32);
+		void CacheConstantInTempRegister(CAArch64Assembler::REGISTER32, uint32);
+		void ClearConstantCache();
+
 		void LoadMemory64LowInRegister(CAArch64Assembler::REGISTER32, CSymbol*);
 		void LoadMemory64HighInRegister(CAArch64Assembler::REGISTER32, CSymbol*);
 
@@ -131,6 +149,7 @@ namespace Jitter
 
 		CAArch64Assembler::REGISTER64 PrepareSymbolRegisterDefRef(CSymbol*, CAArch64Assembler::REGISTER64);
 		CAArch64Assembler::REGISTER64 PrepareSymbolRegisterUseRef(CSymbol*, CAArch64Assembler::REGISTER64);
+		CAArch64Assembler::REGISTER64 PrepareRefBaseRegisterUse(CSymbol*, uint32);
 		void CommitSymbolRegisterRef(CSymbol*, CAArch64Assembler::REGISTER64);
 
 		CAArch64Assembler::REGISTERMD PrepareSymbolRegisterDefFp(CSymbol*, CAArch64Assembler::REGISTERMD);
@@ -149,6 +168,7 @@ namespace Jitter
 		bool TryGetAddSubImmParams(uint32, ADDSUB_IMM_PARAMS&);
 		bool TryGetAddSub64ImmParams(uint64, ADDSUB_IMM_PARAMS&);
 		bool TryGetLogicalImmParams(uint32, LOGICAL_IMM_PARAMS&);
+		bool TryGetLogicalImm64Params(uint64, LOGICAL_IMM_PARAMS&);
 
 		// clang-format off
 		//SHIFTOP ----------------------------------------------------------
@@ -600,7 +620,9 @@ namespace Jitter
 		void Emit_Epilog();
 
 		CAArch64Assembler::LABEL GetLabel(uint32);
+		bool IsInOtherCodeRegion(uint32) const;
 		void MarkLabel(const STATEMENT&);
+		void MarkColdLabel(const STATEMENT&);
 
 		void Emit_Nop(const STATEMENT&);
 
@@ -649,6 +671,27 @@ namespace Jitter
 		void Emit_StoreAtRef_64_VarAny(const STATEMENT&);
 		void Emit_StoreAtRef_64_VarAnyAny(const STATEMENT&);
 
+		void Emit_LoadFromRefBSwap_VarVar(const STATEMENT&);
+		void Emit_LoadFromRefBSwap_VarVarAny(const STATEMENT&);
+		void Emit_Load16FromRefBSwap_VarVar(const STATEMENT&);
+		void Emit_Load16FromRefBSwap_VarVarAny(const STATEMENT&);
+		void Emit_StoreAtRefBSwap_VarAny(const STATEMENT&);
+		void Emit_StoreAtRefBSwap_VarAnyAny(const STATEMENT&);
+		void Emit_Store16AtRefBSwap_VarAny(const STATEMENT&);
+		void Emit_Store16AtRefBSwap_VarAnyAny(const STATEMENT&);
+		void Emit_LoadFromRefBSwap_64_MemVar(const STATEMENT&);
+		void Emit_LoadFromRefBSwap_64_MemVarAny(const STATEMENT&);
+		void Emit_StoreAtRefBSwap_64_VarAny(const STATEMENT&);
+		void Emit_StoreAtRefBSwap_64_VarAnyAny(const STATEMENT&);
+
+		CAArch64Assembler::REGISTER64 PrepareMemBaseIndex(CSymbol*, CSymbol*);
+		void Emit_LoadFromMemBase_VarAnyCst(const STATEMENT&);
+		void Emit_Load8FromMemBase_VarAnyCst(const STATEMENT&);
+		void Emit_Load16FromMemBase_VarAnyCst(const STATEMENT&);
+		void Emit_StoreAtMemBase_AnyCstAny(const STATEMENT&);
+		void Emit_Store8AtMemBase_AnyCstAny(const STATEMENT&);
+		void Emit_Store16AtMemBase_AnyCstAny(const STATEMENT&);
+
 		void Emit_Param_Ctx(const STATEMENT&);
 		void Emit_Param_Reg(const STATEMENT&);
 		void Emit_Param_Mem(const STATEMENT&);
@@ -671,10 +714,12 @@ namespace Jitter
 		void Emit_Jmp(const STATEMENT&);
 
 		void Emit_CondJmp(const STATEMENT&);
+		void CondJmp_JumpTo(uint32, CAArch64Assembler::CONDITION);
 		void Emit_CondJmp_AnyVar(const STATEMENT&);
 		void Emit_CondJmp_VarCst(const STATEMENT&);
 
 		void Emit_CondJmp_Ref_VarCst(const STATEMENT&);
+		void Emit_CondJmp_Tmp64Cst(const STATEMENT&);
 
 		void Cmp_GetFlag(CAArch64Assembler::REGISTER32, Jitter::CONDITION);
 		void Emit_Cmp_VarAnyVar(const STATEMENT&);
@@ -717,6 +762,9 @@ namespace Jitter
 		template <bool>
 		void Emit_Div_Tmp64AnyAny(const STATEMENT&);
 
+		//ADDOVF/ADDCARRY/ADC/SUBOVF/SUBBORROW
+		void Emit_AluFlag_Tmp64AnyAny(const STATEMENT&);
+
 		//SHIFT64
 		template <typename>
 		void Emit_Shift64_MemMemVar(const STATEMENT&);
@@ -789,6 +837,7 @@ namespace Jitter
 		static CAArch64Assembler::REGISTER32 g_paramRegisters[MAX_PARAM_REGS];
 		static CAArch64Assembler::REGISTER64 g_paramRegisters64[MAX_PARAM_REGS];
 		static CAArch64Assembler::REGISTER64 g_baseRegister;
+		static CAArch64Assembler::REGISTER64 g_memoryBaseRegister;
 
 		static const LITERAL128 g_fpClampMask1;
 		static const LITERAL128 g_fpClampMask2;
@@ -796,9 +845,12 @@ namespace Jitter
 		Framework::CStream* m_stream = nullptr;
 		CAArch64Assembler m_assembler;
 		LabelMapType m_labels;
+		std::set<uint32> m_coldBlockIds;
+		bool m_inColdRegion = false;
 		ParamStack m_params;
 		uint32 m_nextTempRegister = 0;
 		uint32 m_nextTempRegisterMd = 0;
+		CACHED_CONSTANT m_constantCache[MAX_TEMP_REGS];
 		uint16 m_registerSave = 0;
 		uint32 m_paramSpillBase = 0;
 
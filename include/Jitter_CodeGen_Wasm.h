@@ -3,8 +3,7 @@
 #include <stack>
 #include "Jitter_CodeGen.h"
 #include "MemStream.h"
-
-class CWasmModuleBuilder;
+#include "WasmModuleBuilder.h"
 
 namespace Jitter
 {
@@ -29,6 +28,8 @@ namespace Jitter
 	public:
 		CCodeGen_Wasm();
 
+		void SetGenerateTailCalls(bool);
+
 		void GenerateCode(const StatementList&, unsigned int) override;
 		void SetStream(Framework::CStream*) override;
 		void RegisterExternalSymbols(CObjectFile*) const override;
@@ -38,9 +39,31 @@ namespace Jitter
 		bool Has128BitsCallOperands() const override;
 		bool CanHold128BitsReturnValueInRegisters() const override;
 		bool SupportsExternalJumps() const override;
+		bool SupportsBlockPlacement() const override;
+		bool SupportsColdRegion() const override;
+		bool SupportsMemoryBase() const override;
+		bool SupportsRefIndexDisplacement() const override;
+		bool SupportsAluFlagBranches() const override;
+		bool SupportsNestedLoops() const override;
 		uint32 GetPointerSize() const override;
 
+		//Functions generated between BeginBatch and EndBatch are gathered in a single module
+		//that is written by EndBatch. Function N of the batch is exported as "codeGenFuncN",
+		//unless the batch holds a single function, which is exported as "codeGenFunc".
+		void BeginBatch();
+		void EndBatch(Framework::CStream&);
+
 	private:
+		enum MAX_REGISTERS
+		{
+			MAX_REGISTERS = 16,
+		};
+
+		enum MAX_MDREGISTERS
+		{
+			MAX_MDREGISTERS = 16,
+		};
+
 		enum LABEL_FLOW
 		{
 			LABEL_FLOW_BLOCK,
@@ -76,9 +99,13 @@ namespace Jitter
 		void PrepareLocalVars(const StatementList&);
 
 		uint32 GetTemporaryLocation(CSymbol*) const;
+		uint32 GetRegisterLocation(CSymbol*) const;
 
 		void PushContext();
 
+		void PushRegister(CSymbol*);
+		void PullRegister(CSymbol*);
+
 		void PushRelativeAddress(CSymbol*);
 		void PushRelative(CSymbol*);
 
@@ -88,6 +115,9 @@ namespace Jitter
 		void PushRelativeRefAddress(CSymbol*);
 		void PushRelativeRef(CSymbol*);
 
+		uint32 PushRefIndexAddress(CSymbol*, CSymbol*, uint8);
+		void WriteMemArg(uint8, uint32);
+
 		void PushTemporaryRef(CSymbol*);
 		void PullTemporaryRef(CSymbol*);
 
@@ -134,6 +164,20 @@ namespace Jitter
 		template <uint8, uint8>
 		void Emit_Generic_StoreAtRef_VarAnyAny(const STATEMENT&);
 
+		template <uint8, uint8, uint8>
+		void Emit_Generic_LoadFromRefBSwap_MemVar(const STATEMENT&);
+
+		template <uint8, uint8, uint8>
+		void Emit_Generic_LoadFromRefBSwap_MemVarAny(const STATEMENT&);
+
+		template <uint8, uint8, uint8>
+		void Emit_Generic_StoreAtRefBSwap_VarAny(const STATEMENT&);
+
+		template <uint8, uint8, uint8>
+		void Emit_Generic_StoreAtRefBSwap_VarAnyAny(const STATEMENT&);
+
+		void SwapBytes(uint8);
+
 		void Emit_LoadFromRef_VarVar(const STATEMENT&);
 		void Emit_LoadFromRef_VarVarAny(const STATEMENT&);
 
@@ -144,6 +188,7 @@ namespace Jitter
 		void Emit_Param_Any(const STATEMENT&);
 
 		void Emit_Call(const STATEMENT&);
+		void Emit_RetVal_Reg(const STATEMENT&);
 		void Emit_RetVal_Tmp(const STATEMENT&);
 
 		void Emit_ExternJmp(const STATEMENT&);
@@ -185,6 +230,9 @@ namespace Jitter
 		template <bool>
 		void Emit_Div_Tmp64AnyAny(const STATEMENT&);
 
+		//ADDOVF/ADDCARRY/ADC/SUBOVF/SUBBORROW
+		void Emit_AluFlag_Tmp64AnyAny(const STATEMENT&);
+
 		void Emit_ExtLow64VarMem64(const STATEMENT&);
 		void Emit_ExtHigh64VarMem64(const STATEMENT&);
 		void Emit_MergeTo64_Mem64AnyAny(const STATEMENT&);
@@ -192,6 +240,7 @@ namespace Jitter
 		//FPU
 		template <uint32>
 		void Emit_Fpu_MemMem(const STATEMENT&);
+		void Emit_Fp_Mov_VarVar(const STATEMENT&);
 		template <uint32>
 		void Emit_Fpu_MemMemMem(const STATEMENT&);
 		void Emit_Fp_Cmp_AnyMemMem(const STATEMENT&);
@@ -232,6 +281,9 @@ namespace Jitter
 
 		Framework::CStream* m_stream = nullptr;
 		Framework::CMemStream m_functionStream;
+		CWasmModuleBuilder m_batchModuleBuilder;
+		bool m_isBatching = false;
+		bool m_generateTailCalls = false;
 		std::map<uint32, LABEL_FLOW> m_labelFlows;
 		std::map<std::string, uint32> m_signatures;
 		std::map<TemporaryInstance, uint32> m_temporaryLocations;
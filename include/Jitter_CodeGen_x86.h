@@ -15,9 +15,16 @@ namespace Jitter
 
 		void GenerateCode(const StatementList&, unsigned int) override;
 		void SetStream(Framework::CStream*) override;
+		void SetColdStream(Framework::CStream*) override;
 		void RegisterExternalSymbols(CObjectFile*) const override;
 		bool Has128BitsCallOperands() const override;
 		bool SupportsExternalJumps() const override;
+		bool SupportsBlockPlacement() const override;
+		bool SupportsColdRegion() const override;
+		bool SupportsMemoryBase() const override;
+		bool SupportsRefIndexDisplacement() const override;
+		bool SupportsAluFlagBranches() const override;
+		bool SupportsNestedLoops() const override;
 
 	protected:
 		typedef std::map<uint32, CX86Assembler::LABEL> LabelMapType;
@@ -482,7 +489,7 @@ namespace Jitter
 		CX86Assembler::CAddress MakeMemoryReferenceSymbolAddress(CSymbol*);
 		CX86Assembler::CAddress MakeVariableReferenceSymbolAddress(CSymbol*);
 
-		CX86Assembler::CAddress MakeRefBaseScaleSymbolAddress(CSymbol*, CX86Assembler::REGISTER, CSymbol*, CX86Assembler::REGISTER, uint8);
+		CX86Assembler::CAddress MakeRefBaseScaleSymbolAddress(CSymbol*, CX86Assembler::REGISTER, CSymbol*, CX86Assembler::REGISTER, uint8, uint32);
 
 		CX86Assembler::CAddress MakeRelative64SymbolAddress(CSymbol*);
 		CX86Assembler::CAddress MakeRelative64SymbolLoAddress(CSymbol*);
@@ -511,6 +518,7 @@ namespace Jitter
 
 		//LABEL
 		void MarkLabel(const STATEMENT&);
+		void MarkColdLabel(const STATEMENT&);
 
 		//NOP
 		void Emit_Nop(const STATEMENT&);
@@ -608,6 +616,9 @@ namespace Jitter
 		template <bool>
 		void Emit_MulMem64VarCst(const STATEMENT&);
 
+		//ADDOVF/ADDCARRY/ADC/SUBOVF/SUBBORROW
+		void Emit_AluFlag_Mem64AnyAny(const STATEMENT&);
+
 		//DIV/DIVS
 		template <bool>
 		void Emit_DivMem64VarVar(const STATEMENT&);
@@ -634,6 +645,7 @@ namespace Jitter
 		void Emit_CondJmp_RegCst(const STATEMENT&);
 		void Emit_CondJmp_MemMem(const STATEMENT&);
 		void Emit_CondJmp_MemCst(const STATEMENT&);
+		void Emit_CondJmp_Mem64Cst(const STATEMENT&);
 
 		//MERGETO64
 		void Emit_MergeTo64_Mem64RegReg(const STATEMENT&);
@@ -641,6 +653,7 @@ namespace Jitter
 		void Emit_MergeTo64_Mem64RegCst(const STATEMENT&);
 		void Emit_MergeTo64_Mem64MemReg(const STATEMENT&);
 		void Emit_MergeTo64_Mem64MemMem(const STATEMENT&);
+		void Emit_MergeTo64_Mem64MemCst(const STATEMENT&);
 		void Emit_MergeTo64_Mem64CstReg(const STATEMENT&);
 		void Emit_MergeTo64_Mem64CstMem(const STATEMENT&);
 
@@ -678,6 +691,25 @@ namespace Jitter
 		void Emit_Store16AtRef_VarAnyVar(const STATEMENT&);
 		void Emit_Store16AtRef_VarAnyCst(const STATEMENT&);
 
+		//LOADFROMREFBSWAP
+		void LoadBSwap32(CX86Assembler::REGISTER, const CX86Assembler::CAddress&);
+		void StoreBSwap16(const CX86Assembler::CAddress&, CX86Assembler::REGISTER);
+		void StoreBSwap32(const CX86Assembler::CAddress&, CX86Assembler::REGISTER);
+		void Emit_LoadFromRefBSwap_VarVar(const STATEMENT&);
+		void Emit_LoadFromRefBSwap_VarVarAny(const STATEMENT&);
+
+		//LOAD16FROMREFBSWAP
+		void Emit_Load16FromRefBSwap_VarVar(const STATEMENT&);
+		void Emit_Load16FromRefBSwap_VarVarAny(const STATEMENT&);
+
+		//STOREATREFBSWAP
+		void Emit_StoreAtRefBSwap_VarAny(const STATEMENT&);
+		void Emit_StoreAtRefBSwap_VarAnyAny(const STATEMENT&);
+
+		//STORE16ATREFBSWAP
+		void Emit_Store16AtRefBSwap_VarAny(const STATEMENT&);
+		void Emit_Store16AtRefBSwap_VarAnyAny(const STATEMENT&);
+
 		//FPUOP Generic
 		CX86Assembler::SSE_CMP_TYPE GetSseConditionCode(Jitter::CONDITION);
 
@@ -129,6 +129,14 @@ namespace Jitter
 		void Emit_StoreAtRef_64_VarAnyMem(const STATEMENT&);
 		void Emit_StoreAtRef_64_VarAnyCst(const STATEMENT&);
 
+		//LOADFROMREFBSWAP
+		void Emit_LoadFromRefBSwap_64_MemVar(const STATEMENT&);
+		void Emit_LoadFromRefBSwap_64_MemVarAny(const STATEMENT&);
+
+		//STOREATREFBSWAP
+		void Emit_StoreAtRefBSwap_64_VarMem(const STATEMENT&);
+		void Emit_StoreAtRefBSwap_64_VarAnyMem(const STATEMENT&);
+
 		//STORE8ATREF
 		void Emit_Store8AtRef_VarVar(const STATEMENT&);
 		void Emit_Store8AtRef_VarAnyVar(const STATEMENT&);
@@ -170,7 +178,7 @@ namespace Jitter
 		CX86Assembler::REGISTER PrepareRefSymbolRegisterUse(CSymbol*, CX86Assembler::REGISTER) override;
 		void CommitRefSymbolRegister(CSymbol*, CX86Assembler::REGISTER);
 
-		AddressPair MakeRefBaseScaleSymbolAddress64(CSymbol*, CX86Assembler::REGISTER, CSymbol*, CX86Assembler::REGISTER, uint8);
+		AddressPair MakeRefBaseScaleSymbolAddress64(CSymbol*, CX86Assembler::REGISTER, CSymbol*, CX86Assembler::REGISTER, uint8, uint32);
 
 		static CONSTMATCHER g_constMatchers[];
 		static CX86Assembler::REGISTER g_registers[MAX_REGISTERS];
@@ -22,6 +22,7 @@ namespace Jitter
 		unsigned int GetAvailableRegisterCount() const override;
 		unsigned int GetAvailableMdRegisterCount() const override;
 		bool CanHold128BitsReturnValueInRegisters() const override;
+		bool SupportsMemoryBase() const override;
 		uint32 GetPointerSize() const override;
 
 	protected:
@@ -157,6 +158,14 @@ namespace Jitter
 		void Emit_StoreAtRef_64_VarAnyMem(const STATEMENT&);
 		void Emit_StoreAtRef_64_VarAnyCst(const STATEMENT&);
 
+		//LOADFROMREFBSWAP
+		void Emit_LoadFromRefBSwap_64_MemVar(const STATEMENT&);
+		void Emit_LoadFromRefBSwap_64_MemVarAny(const STATEMENT&);
+
+		//STOREATREFBSWAP
+		void Emit_StoreAtRefBSwap_64_VarMem(const STATEMENT&);
+		void Emit_StoreAtRefBSwap_64_VarAnyMem(const STATEMENT&);
+
 		//STORE8ATREF
 		void Emit_Store8AtRef_VarVar(const STATEMENT&);
 		void Emit_Store8AtRef_VarAnyVar(const STATEMENT&);
@@ -164,6 +173,16 @@ namespace Jitter
 		//CONDJMP
 		void Emit_CondJmp_Ref_VarCst(const STATEMENT&);
 
+		//MEMBASE
+		void Emit_LoadFromMemBase_VarAnyCst(const STATEMENT&);
+		void Emit_Load8FromMemBase_VarAnyCst(const STATEMENT&);
+		void Emit_Load16FromMemBase_VarAnyCst(const STATEMENT&);
+		void Emit_StoreAtMemBase_AnyCstAny(const STATEMENT&);
+		void Emit_Store8AtMemBase_AnyCstAny(const STATEMENT&);
+		void Emit_Store16AtMemBase_AnyCstAny(const STATEMENT&);
+
+		PLATFORM_ABI GetPlatformAbi() const;
+
 	private:
 		typedef void (CCodeGen_x86_64::*ConstCodeEmitterType)(const STATEMENT&);
 
@@ -210,6 +229,8 @@ namespace Jitter
 		void CommitRefSymbolRegister(CSymbol*, CX86Assembler::REGISTER);
 
 		void WriteConstant64ToAddress(const CX86Assembler::CAddress&, CX86Assembler::REGISTER, uint64);
+		CX86Assembler::REGISTER GetMemoryBaseRegister() const;
+		CX86Assembler::CAddress MakeMemBaseAddress(CSymbol*, CSymbol*);
 
 		static CONSTMATCHER g_constMatchers[];
 		static CX86Assembler::REGISTER g_systemVRegisters[SYSTEMV_MAX_REGISTERS];
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Jitter_CodeGen_x86_64.h"
+
+namespace Jitter
+{
+	//Baseline code generator that lowers each statement by copying a precompiled machine code
+	//stencil and patching its operands and jump offsets. Stencils only cover integer operations
+	//on relatives, temporaries and constants, no registers are allocated. Statement lists that
+	//contain anything else are handed to the matcher based x86-64 code generator. Functions fully
+	//covered by stencils skip the optimizer and register allocator.
+	class CCodeGen_x86_64_Stencil : public CCodeGen_x86_64
+	{
+	public:
+		CCodeGen_x86_64_Stencil(CX86CpuFeatures = CX86CpuFeatures::AutoDetect());
+		virtual ~CCodeGen_x86_64_Stencil() = default;
+
+		void GenerateCode(const StatementList&, unsigned int) override;
+		bool CanGenerateUnoptimized(const StatementList&) const override;
+		void SetStream(Framework::CStream*) override;
+
+		unsigned int GetAvailableRegisterCount() const override;
+		unsigned int GetAvailableMdRegisterCount() const override;
+		bool SupportsBlockPlacement() const override;
+		bool SupportsColdRegion() const override;
+
+		bool CanGenerateFromStencils(const StatementList&) const;
+
+	private:
+		void GenerateFromStencils(const StatementList&, unsigned int);
+
+		Framework::CStream* m_stream = nullptr;
+	};
+}
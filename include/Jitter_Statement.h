@@ -29,6 +29,13 @@ namespace Jitter
 		OP_DIV,
 		OP_DIVS,
 
+		//Arithmetic operations producing a flag (dst is 64-bit: low = result, high = flag)
+		OP_ADDOVF,
+		OP_ADDCARRY,
+		OP_ADC,
+		OP_SUBOVF,
+		OP_SUBBORROW,
+
 		OP_LZC,
 
 		OP_RELTOREF,
@@ -41,6 +48,20 @@ namespace Jitter
 		OP_STORE8ATREF,
 		OP_STORE16ATREF,
 
+		//Byte swapping variants of memory operations (ie.: big endian data)
+		OP_LOADFROMREFBSWAP,
+		OP_LOAD16FROMREFBSWAP,
+		OP_STOREATREFBSWAP,
+		OP_STORE16ATREFBSWAP,
+
+		//Memory operations relative to the memory base register (dst, index, displacement, value)
+		OP_LOADFROMMEMBASE,
+		OP_LOAD8FROMMEMBASE,
+		OP_LOAD16FROMMEMBASE,
+		OP_STOREATMEMBASE,
+		OP_STORE8ATMEMBASE,
+		OP_STORE16ATMEMBASE,
+
 		OP_ADD64,
 		OP_SUB64,
 		OP_AND64,
@@ -160,6 +181,7 @@ namespace Jitter
 		OP_CALL,
 		OP_RETVAL,
 		OP_JMP,
+		//Can also test the flag of an ALU flag operation result (src1 is 64-bit, src2 is 0, NE when set, EQ when clear)
 		OP_CONDJMP,
 		OP_EXTERNJMP,     //Pass control to another function with same signature (void (*)(void*)) and same input parameter
 		OP_EXTERNJMP_DYN, //Same as above, but destination can be changed at run time, cannot be used in AOT mode
@@ -167,6 +189,7 @@ namespace Jitter
 		OP_BREAK,
 
 		OP_LABEL,
+		OP_LABEL_COLD,
 	};
 
 	enum CONDITION
@@ -184,6 +207,15 @@ namespace Jitter
 		CONDITION_GE,
 	};
 
+	//Hints describing what a called function might do with the context
+	enum CALL_ATTRIBUTE
+	{
+		CALL_ATTRIBUTE_NONE = 0,
+		CALL_ATTRIBUTE_NO_CONTEXT_ACCESS = 0x01,  //Never reads or writes the context
+		CALL_ATTRIBUTE_READS_CONTEXT_ONLY = 0x02, //Might read the context, but never writes to it
+		CALL_ATTRIBUTE_PURE = 0x04,               //No side effects, result only depends on parameters (implies no context access)
+	};
+
 	struct STATEMENT
 	{
 	public:
@@ -191,6 +223,8 @@ namespace Jitter
 		    : op(OP_NOP)
 		    , jmpBlock(-1)
 		    , jmpCondition(CONDITION_NEVER)
+		    , callAttributes(CALL_ATTRIBUTE_NONE)
+		    , displacement(0)
 		{
 		}
 
@@ -201,6 +235,8 @@ namespace Jitter
 		SymbolRefPtr dst;
 		uint32 jmpBlock;
 		CONDITION jmpCondition;
+		uint32 callAttributes;
+		uint32 displacement; //Added to the address of indexed reference accesses
 
 		template <typename F>
 		void VisitOperands(const F& visitor)
@@ -245,6 +281,11 @@ namespace Jitter
 
 	typedef std::list<STATEMENT> StatementList;
 
+	//Calls that are known to leave the context alone
+	bool IsContextIsolatedCall(const STATEMENT&);
+	//Calls that might write to the context
+	bool CallMightWriteContext(const STATEMENT&);
+
 	std::string ConditionToString(CONDITION);
 	void DumpStatementList(const StatementList&);
 	void DumpStatementList(std::ostream&, const StatementList&);
@@ -11,8 +11,10 @@ public:
 
 	void AlignPool();
 	uint64 GetLiteralPosition(const LITERAL128&);
+	uint64 GetLiteralPosition(uint64);
 
 private:
 	Framework::CStream* m_stream;
 	std::map<LITERAL128, uint64> m_literalPositions;
+	std::map<uint64, uint64> m_literal64Positions;
 };
@@ -1,16 +1,24 @@
 #pragma once
 
 #include "Types.h"
+#include <map>
+#include <mutex>
+#include <vector>
 
 #if defined(__EMSCRIPTEN__)
 #include <emscripten/bind.h>
 #endif
 
+class CMemoryFunctionRegion;
+
 class CMemoryFunction
 {
 public:
 	CMemoryFunction();
 	CMemoryFunction(const void*, size_t);
+#if !defined(__EMSCRIPTEN__)
+	CMemoryFunction(CMemoryFunctionRegion&, const void*, size_t);
+#endif
 	CMemoryFunction(const CMemoryFunction&) = delete;
 	CMemoryFunction(CMemoryFunction&&);
 
@@ -26,18 +34,108 @@ public:
 	void* GetCode() const;
 	size_t GetSize() const;
 
+	//Address through which the code can be written, only valid between BeginModify and EndModify
+	void* GetWritableCode() const;
+
 	void BeginModify();
 	void EndModify();
 
 	CMemoryFunction CreateInstance();
 
+#if !defined(__EMSCRIPTEN__)
+	//Reserves executable memory that code can be generated into directly (see CMemoryFunctionStream)
+	static CMemoryFunction Reserve(size_t);
+	static CMemoryFunction Reserve(CMemoryFunctionRegion&, size_t);
+#endif
+
+#if defined(__EMSCRIPTEN__)
+	//Compiles and instantiates a module containing multiple functions (see CCodeGen_Wasm::BeginBatch)
+	static std::vector<CMemoryFunction> CreateBatch(const void*, size_t, uint32);
+#endif
+
 private:
+	void Allocate(size_t);
 	void ClearCache();
 	void Reset();
 
 	void* m_code;
+	void* m_writableCode = nullptr;
 	size_t m_size;
+	CMemoryFunctionRegion* m_region = nullptr;
 #if defined(__EMSCRIPTEN__)
 	emscripten::val m_wasmModule;
+	uint32 m_wasmFunctionIndex = 0;
 #endif
 };
+
+#if !defined(__EMSCRIPTEN__)
+
+//Large contiguous block of code memory that functions can be allocated from. Keeps code
+//packed together instead of spreading it over separate pages and tries to back it with
+//huge pages to reduce iTLB misses. Must outlive the functions allocated from it.
+class CMemoryFunctionRegion
+{
+public:
+	enum HUGE_PAGE_MODE
+	{
+		HUGE_PAGE_MODE_NONE,
+		HUGE_PAGE_MODE_TRANSPARENT,
+		HUGE_PAGE_MODE_EXPLICIT,
+	};
+
+	//Transparent huge pages are only provided to shared memory if the system allows it, but
+	//private memory can't have separate writable and executable views of the same pages.
+	enum HUGE_PAGE_POLICY
+	{
+		HUGE_PAGE_POLICY_KEEP_SEPARATE_VIEWS,
+		HUGE_PAGE_POLICY_ALLOW_WRITABLE_EXECUTABLE,
+	};
+
+	enum MAPPING_MODE
+	{
+		MAPPING_MODE_SINGLE, //Code is written and executed through the same pages
+		MAPPING_MODE_DUAL,   //Code is written through a separate view that isn't executable
+	};
+
+	struct STATS
+	{
+		size_t capacity = 0;
+		size_t usedSize = 0;
+		size_t largestFreeBlockSize = 0;
+		uint32 functionCount = 0;
+		MAPPING_MODE mappingMode = MAPPING_MODE_SINGLE;
+		HUGE_PAGE_MODE hugePageMode = HUGE_PAGE_MODE_NONE;
+		size_t hugePageBackedSize = 0;
+	};
+
+	CMemoryFunctionRegion(size_t, HUGE_PAGE_POLICY = HUGE_PAGE_POLICY_KEEP_SEPARATE_VIEWS);
+	CMemoryFunctionRegion(const CMemoryFunctionRegion&) = delete;
+	virtual ~CMemoryFunctionRegion();
+
+	CMemoryFunctionRegion& operator=(const CMemoryFunctionRegion&) = delete;
+
+	STATS GetStats() const;
+
+private:
+	friend class CMemoryFunction;
+
+	typedef std::map<size_t, size_t> FreeBlockMap;
+
+	size_t Allocate(size_t);
+	bool TryAllocate(size_t, size_t&);
+	void Free(size_t, size_t);
+
+	uint8* m_code = nullptr;
+	uint8* m_writableCode = nullptr;
+	size_t m_size = 0;
+	//For transparent huge pages, this only means that they were requested
+	HUGE_PAGE_MODE m_hugePageMode = HUGE_PAGE_MODE_NONE;
+	CMemoryFunction m_memory;
+
+	mutable std::mutex m_mutex;
+	FreeBlockMap m_freeBlocks;
+	size_t m_usedSize = 0;
+	uint32 m_functionCount = 0;
+};
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Stream.h"
+#include "MemoryFunction.h"
+
+//Writes directly into the code memory reserved by a CMemoryFunction, which lets code
+//generators emit and patch code in place instead of going through an intermediate buffer.
+//The AArch32 and AArch64 assemblers write their output once. The x86 assembler still
+//assembles in its own buffer since jump sizes are only known once all code is there,
+//the final copy out of that buffer is the only one made.
+//Writes must happen between the function's BeginModify and EndModify calls.
+class CMemoryFunctionStream : public Framework::CStream
+{
+public:
+	CMemoryFunctionStream(CMemoryFunction&);
+
+	void Seek(int64, Framework::STREAM_SEEK_DIRECTION) override;
+	uint64 Tell() override;
+	uint64 Read(void*, uint64) override;
+	uint64 Write(const void*, uint64) override;
+	bool IsEOF() override;
+
+	//Amount of code written so far
+	uint64 GetSize() const;
+
+private:
+	uint8* m_code = nullptr;
+	uint64 m_capacity = 0;
+	uint64 m_size = 0;
+	uint64 m_position = 0;
+};
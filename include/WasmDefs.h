@@ -54,6 +54,7 @@ namespace Wasm
 		INST_BR_IF = 0x0D,
 		INST_END = 0x0B,
 		INST_CALL_INDIRECT = 0x11,
+		INST_RETURN_CALL_INDIRECT = 0x13,
 		INST_LOCAL_GET = 0x20,
 		INST_LOCAL_SET = 0x21,
 		INST_I32_LOAD = 0x28,
@@ -129,6 +130,8 @@ namespace Wasm
 		INST_I64_EXTEND_I32_S = 0xAC,
 		INST_I64_EXTEND_I32_U = 0xAD,
 		INST_F32_CONVERT_I32_S = 0xB2,
+		INST_I32_REINTERPRET_F32 = 0xBC,
+		INST_F32_REINTERPRET_I32 = 0xBE,
 		INST_I32x4_TRUNC_SAT_F32x4_S = 0xF8,
 		INST_F32x4_CONVERT_I32x4_S = 0xFA
 	};
@@ -146,8 +149,11 @@ namespace Wasm
 		INST_I8x16_SHUFFLE = 0x0D,
 		INST_I8x16_SWIZZLE = 0x0E,
 		INST_I32x4_SPLAT = 0x11,
+		INST_I64x2_SPLAT = 0x12,
 		INST_F32x4_SPLAT = 0x13,
 		INST_I8x16_REPLACE_LANE = 0x17,
+		INST_I32x4_EXTRACT_LANE = 0x1B,
+		INST_I64x2_EXTRACT_LANE = 0x1D,
 		INST_F32x4_EXTRACT_LANE = 0x1F,
 		INST_I8x16_EQ = 0x23,
 		INST_I8x16_GT_S = 0x27,
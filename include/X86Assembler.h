@@ -4,6 +4,7 @@
 #include "Stream.h"
 #include "MemStream.h"
 #include "Literal128.h"
+#include "CodeRegionRelocation.h"
 #include <map>
 #include <vector>
 
@@ -116,6 +117,9 @@ public:
 	void End();
 
 	void SetStream(Framework::CStream*);
+	void SetColdStream(Framework::CStream*);
+	void SetColdRegion(bool);
+	const CodeRegionRelocationArray& GetRegionRelocations() const;
 
 	static CAddress MakeRegisterAddress(REGISTER);
 	static CAddress MakeXmmRegisterAddress(XMMREGISTER);
@@ -150,6 +154,8 @@ public:
 	void AndId(const CAddress&, uint32);
 	void AndIq(const CAddress&, uint64);
 	void BsrEd(REGISTER, const CAddress&);
+	void BswapEd(REGISTER);
+	void BswapEq(REGISTER);
 	void CallEd(const CAddress&);
 	void CmovsEd(REGISTER, const CAddress&);
 	void CmovnsEd(REGISTER, const CAddress&);
@@ -178,6 +184,7 @@ public:
 	void JnbeJx(LABEL);
 	void JnoJx(LABEL);
 	void JnsJx(LABEL);
+	void JoJx(LABEL);
 	void LeaGd(REGISTER, const CAddress&);
 	void LeaGq(REGISTER, const CAddress&);
 	void MovEw(REGISTER, const CAddress&);
@@ -194,6 +201,12 @@ public:
 	void MovIw(const CAddress&, uint16);
 	void MovId(const CAddress&, uint32);
 	void MovIq(const CAddress&, uint32);
+	void MovbeEw(REGISTER, const CAddress&);
+	void MovbeEd(REGISTER, const CAddress&);
+	void MovbeEq(REGISTER, const CAddress&);
+	void MovbeGw(const CAddress&, REGISTER);
+	void MovbeGd(const CAddress&, REGISTER);
+	void MovbeGq(const CAddress&, REGISTER);
 	void MovsxEb(REGISTER, const CAddress&);
 	void MovsxEw(REGISTER, const CAddress&);
 	void MovzxEb(REGISTER, const CAddress&);
@@ -210,6 +223,7 @@ public:
 	void PushId(uint32);
 	void RclEd(const CAddress&, uint8);
 	void RepMovsb();
+	void RolEw(const CAddress&, uint8);
 	void Ret();
 	void SarEd(const CAddress&);
 	void SarEd(const CAddress&, uint8);
@@ -226,6 +240,8 @@ public:
 	void SetlEb(const CAddress&);
 	void SetleEb(const CAddress&);
 	void SetgEb(const CAddress&);
+	void SetgeEb(const CAddress&);
+	void SetoEb(const CAddress&);
 	void ShrEd(const CAddress&);
 	void ShrEd(const CAddress&, uint8);
 	void ShrEq(const CAddress&);
@@ -546,19 +562,20 @@ private:
 		    : start(0)
 		    , size(0)
 		    , projectedStart(0)
+		    , isCold(false)
 		{
 		}
 
 		uint32 start;
 		uint32 size;
 		uint32 projectedStart;
+		bool isCold;
 		LabelRefArray labelRefs;
 		Literal128Refs literal128Refs;
 	};
 
 	typedef std::map<LABEL, LABELINFO> LabelMap;
 	typedef std::vector<LABEL> LabelArray;
-	typedef std::vector<uint8> ByteArray;
 
 	void WriteRexByte(bool, const CAddress&);
 	void WriteRexByte(bool, const CAddress&, REGISTER&, bool = false);
@@ -570,6 +587,7 @@ private:
 	void WriteEvOp(uint8, uint8, bool, const CAddress&);
 	void WriteEvGvOp(uint8, bool, const CAddress&, REGISTER);
 	void WriteEvGvOp0F(uint8, bool, const CAddress&, REGISTER);
+	void WriteEvGvOp0F38(uint8, bool, const CAddress&, REGISTER);
 	void WriteEvIb(uint8, const CAddress&, uint8);
 	void WriteEvId(uint8, const CAddress&, uint32);
 	void WriteEvIq(uint8, const CAddress&, uint64);
@@ -587,8 +605,7 @@ private:
 
 	void CreateLabelReference(LABEL, JMP_TYPE);
 
-	void IncrementJumpOffsetsLocal(LABELINFO&, LabelRefArray::iterator, unsigned int);
-	void IncrementJumpOffsets(LabelArray::const_iterator, unsigned int);
+	void ResolveRegionLiteralReferences(Framework::CStream*, bool);
 
 	static unsigned int GetJumpSize(JMP_TYPE, JMP_LENGTH);
 	static void WriteJump(Framework::CStream*, JMP_TYPE, JMP_LENGTH, uint32);
@@ -603,6 +620,9 @@ private:
 	LITERAL128ID m_nextLiteral128Id = 1;
 	LABELINFO* m_currentLabel = nullptr;
 	Framework::CStream* m_outputStream = nullptr;
+	Framework::CStream* m_coldStream = nullptr;
+	bool m_coldRegion = false;
+	CodeRegionRelocationArray m_regionRelocations;
+	//Code is assembled here and copied to the output streams once jumps are relaxed in End
 	Framework::CMemStream m_tmpStream;
-	ByteArray m_copyBuffer;
 };
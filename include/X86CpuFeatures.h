@@ -7,6 +7,7 @@ public:
 	bool hasSse41 = false;
 	bool hasAvx = false;
 	bool hasAvx2 = false;
+	bool hasMovbe = false;
 
 	static CX86CpuFeatures AutoDetect();
 };
@@ -179,6 +179,11 @@ void CAArch32Assembler::Adc(REGISTER rd, REGISTER rn, REGISTER rm)
 	GenericAlu(ALU_OPCODE_ADC, false, rd, rn, rm);
 }
 
+void CAArch32Assembler::Adcs(REGISTER rd, REGISTER rn, REGISTER rm)
+{
+	GenericAlu(ALU_OPCODE_ADC, true, rd, rn, rm);
+}
+
 void CAArch32Assembler::Add(REGISTER rd, REGISTER rn, REGISTER rm)
 {
 	GenericAlu(ALU_OPCODE_ADD, false, rd, rn, rm);
@@ -498,6 +503,24 @@ void CAArch32Assembler::Or(CONDITION cc, REGISTER rd, REGISTER rn, const Immedia
 	GenericAlu(ALU_OPCODE_ORR, false, rd, rn, operand, cc);
 }
 
+void CAArch32Assembler::Rev(REGISTER rd, REGISTER rm)
+{
+	uint32 opcode = 0x06BF0F30;
+	opcode |= CONDITION_AL << 28;
+	opcode |= rm;
+	opcode |= (rd << 12);
+	WriteWord(opcode);
+}
+
+void CAArch32Assembler::Rev16(REGISTER rd, REGISTER rm)
+{
+	uint32 opcode = 0x06BF0FB0;
+	opcode |= CONDITION_AL << 28;
+	opcode |= rm;
+	opcode |= (rd << 12);
+	WriteWord(opcode);
+}
+
 void CAArch32Assembler::Rsb(REGISTER rd, REGISTER rn, const ImmediateAluOperand& operand)
 {
 	GenericAlu(ALU_OPCODE_RSB, false, rd, rn, operand);
@@ -1,4 +1,5 @@
 #include <assert.h>
+#include <algorithm>
 #include <stdexcept>
 #include "AArch64Assembler.h"
 #include "LiteralPool.h"
@@ -6,6 +7,25 @@
 void CAArch64Assembler::SetStream(Framework::CStream* stream)
 {
 	m_stream = stream;
+	m_hotStream = stream;
+	m_coldRegion = false;
+}
+
+void CAArch64Assembler::SetColdStream(Framework::CStream* stream)
+{
+	m_coldStream = stream;
+}
+
+void CAArch64Assembler::SetColdRegion(bool coldRegion)
+{
+	assert(!coldRegion || (m_coldStream != nullptr));
+	m_coldRegion = coldRegion;
+	m_stream = coldRegion ? m_coldStream : m_hotStream;
+}
+
+const CodeRegionRelocationArray& CAArch64Assembler::GetRegionRelocations() const
+{
+	return m_regionRelocations;
 }
 
 CAArch64Assembler::LABEL CAArch64Assembler::CreateLabel()
@@ -16,43 +36,66 @@ CAArch64Assembler::LABEL CAArch64Assembler::CreateLabel()
 void CAArch64Assembler::ClearLabels()
 {
 	m_labels.clear();
+	m_islandStates[0] = ISLANDSTATE();
+	m_islandStates[1] = ISLANDSTATE();
 }
 
 void CAArch64Assembler::MarkLabel(LABEL label)
 {
-	m_labels[label] = static_cast<size_t>(m_stream->Tell());
+	auto& labelInfo = m_labels[label];
+	labelInfo.offset = static_cast<size_t>(m_stream->Tell());
+	labelInfo.isCold = m_coldRegion;
+	//Code following the label is reachable, can't put an island there anymore
+	GetIslandState().unconditionalBranchEnd = NO_PENDING_REFERENCE;
 }
 
 void CAArch64Assembler::CreateBranchLabelReference(LABEL label, CONDITION condition)
 {
 	LABELREF reference;
 	reference.offset = static_cast<size_t>(m_stream->Tell());
+	reference.isCold = m_coldRegion;
 	reference.condition = condition;
 	m_labelReferences.insert(std::make_pair(label, reference));
+	if((condition != CONDITION_AL) && (m_labels.find(label) == std::end(m_labels)))
+	{
+		NotePendingReference();
+	}
 }
 
 void CAArch64Assembler::CreateCompareBranchLabelReference(LABEL label, CONDITION condition, REGISTER32 cbRegister)
 {
 	LABELREF reference;
 	reference.offset = static_cast<size_t>(m_stream->Tell());
+	reference.isCold = m_coldRegion;
 	reference.condition = condition;
 	reference.cbz = true;
 	reference.cbRegister = cbRegister;
 	m_labelReferences.insert(std::make_pair(label, reference));
+	if(m_labels.find(label) == std::end(m_labels))
+	{
+		NotePendingReference();
+	}
 }
 
 void CAArch64Assembler::CreateCompareBranchLabelReference(LABEL label, CONDITION condition, REGISTER64 cbRegister)
 {
 	LABELREF reference;
 	reference.offset = static_cast<size_t>(m_stream->Tell());
+	reference.isCold = m_coldRegion;
 	reference.condition = condition;
 	reference.cbz64 = true;
 	reference.cbRegister = static_cast<REGISTER32>(cbRegister);
 	m_labelReferences.insert(std::make_pair(label, reference));
+	if(m_labels.find(label) == std::end(m_labels))
+	{
+		NotePendingReference();
+	}
 }
 
 void CAArch64Assembler::ResolveLabelReferences()
 {
+	auto currentStream = m_stream;
+	m_regionRelocations.clear();
 	for(const auto& labelReferencePair : m_labelReferences)
 	{
 		auto label(m_labels.find(labelReferencePair.first));
@@ -61,18 +104,43 @@ void CAArch64Assembler::ResolveLabelReferences()
 			throw std::runtime_error("Invalid label.");
 		}
 		const auto& labelReference = labelReferencePair.second;
-		size_t labelPos = label->second;
+		const auto& labelInfo = label->second;
+		size_t labelPos = labelInfo.offset;
 		int offset = static_cast<int>(labelPos - labelReference.offset) / 4;
 
+		m_stream = labelReference.isCold ? m_coldStream : m_hotStream;
 		m_stream->Seek(labelReference.offset, Framework::STREAM_SEEK_SET);
-		if(labelReference.condition == CONDITION_AL)
+		if(labelInfo.isCold != labelReference.isCold)
 		{
+			//Only unconditional branches have enough range to reach the other region
+			if(labelReference.condition != CONDITION_AL)
+			{
+				throw std::runtime_error("Conditional branch to other code region.");
+			}
+			CODE_REGION_RELOCATION relocation;
+			relocation.type = CODE_REGION_RELOCATION_TYPE::BRANCH26;
+			relocation.inColdRegion = labelReference.isCold;
+			relocation.offset = static_cast<uint32>(labelReference.offset);
+			relocation.targetOffset = static_cast<uint32>(labelPos);
+			m_regionRelocations.push_back(relocation);
+			WriteWord(0x14000000);
+		}
+		else if(labelReference.condition == CONDITION_AL)
+		{
+			if((offset < -0x2000000) || (offset >= 0x2000000))
+			{
+				throw std::runtime_error("Branch target out of range.");
+			}
 			uint32 opcode = 0x14000000;
 			opcode |= (offset & 0x3FFFFFF);
 			WriteWord(opcode);
 		}
 		else
 		{
+			if((offset < -0x40000) || (offset >= 0x40000))
+			{
+				throw std::runtime_error("Conditional branch target out of range.");
+			}
 			if(labelReference.cbz || labelReference.cbz64)
 			{
 				assert((labelReference.condition == CONDITION_EQ) || (labelReference.condition == CONDITION_NE));
@@ -104,29 +172,192 @@ void CAArch64Assembler::ResolveLabelReferences()
 			}
 		}
 	}
-	m_stream->Seek(0, Framework::STREAM_SEEK_END);
+	m_hotStream->Seek(0, Framework::STREAM_SEEK_END);
+	if(m_coldStream)
+	{
+		m_coldStream->Seek(0, Framework::STREAM_SEEK_END);
+	}
+	m_stream = currentStream;
 	m_labelReferences.clear();
 }
 
 void CAArch64Assembler::ResolveLiteralReferences()
 {
-	if(m_literal128Refs.empty()) return;
+	//Each region gets its own pool to keep literals in range of the loads
+	if(m_hotStream)
+	{
+		WriteLiteralPool(m_hotStream, false);
+	}
+	if(m_coldStream)
+	{
+		WriteLiteralPool(m_coldStream, true);
+	}
+	assert(m_literal128Refs.empty());
+	assert(m_literal64Refs.empty());
+	m_literal128Refs.clear();
+	m_literal64Refs.clear();
+}
+
+void CAArch64Assembler::EmitIslandIfNeeded()
+{
+	auto& islandState = GetIslandState();
+	if(islandState.pendingStart == NO_PENDING_REFERENCE) return;
 
-	CLiteralPool literalPool(m_stream);
+	size_t currentPos = static_cast<size_t>(m_stream->Tell());
+	size_t distance = currentPos - islandState.pendingStart;
+
+	//Execution can't fall through after an unconditional branch, an island costs nothing there
+	if((islandState.unconditionalBranchEnd == currentPos) && (distance >= ISLAND_SOFT_DISTANCE))
+	{
+		EmitIsland(false);
+	}
+	else if(distance >= ISLAND_HARD_DISTANCE)
+	{
+		EmitIsland(true);
+	}
+}
+
+bool CAArch64Assembler::IsConditionalBranchOutOfRange(LABEL label) const
+{
+	//Only known for backward branches, forward ones are taken care of by islands
+	auto labelIterator = m_labels.find(label);
+	if(labelIterator == std::end(m_labels)) return false;
+	const auto& labelInfo = labelIterator->second;
+	if(labelInfo.isCold != m_coldRegion) return false;
+	size_t distance = static_cast<size_t>(m_stream->Tell()) - labelInfo.offset;
+	return distance > 0x100000;
+}
+
+void CAArch64Assembler::NotePendingReference()
+{
+	auto& islandState = GetIslandState();
+	if(islandState.pendingStart != NO_PENDING_REFERENCE) return;
+	islandState.pendingStart = static_cast<size_t>(m_stream->Tell());
+}
+
+void CAArch64Assembler::NoteUnconditionalBranch()
+{
+	GetIslandState().unconditionalBranchEnd = static_cast<size_t>(m_stream->Tell());
+}
+
+CAArch64Assembler::ISLANDSTATE& CAArch64Assembler::GetIslandState()
+{
+	return m_islandStates[m_coldRegion ? 1 : 0];
+}
+
+void CAArch64Assembler::EmitIsland(bool needsSkipBranch)
+{
+	//Conditional branches to labels that are not bound yet are redirected to a veneer
+	//branching to the actual target, unconditional branches reach +/-128MB
+	std::vector<std::pair<LABEL, LABELREF>> veneers;
+	for(auto labelReferenceIterator = m_labelReferences.begin(); labelReferenceIterator != m_labelReferences.end();)
+	{
+		const auto& labelReference = labelReferenceIterator->second;
+		bool needsVeneer = (labelReference.condition != CONDITION_AL) &&
+		                   (labelReference.isCold == m_coldRegion) &&
+		                   (m_labels.find(labelReferenceIterator->first) == std::end(m_labels));
+		if(!needsVeneer)
+		{
+			++labelReferenceIterator;
+			continue;
+		}
+		veneers.push_back(*labelReferenceIterator);
+		labelReferenceIterator = m_labelReferences.erase(labelReferenceIterator);
+	}
+
+	GetIslandState().pendingStart = NO_PENDING_REFERENCE;
+	if(veneers.empty() && !HasLiterals(m_coldRegion)) return;
+
+	LABEL skipLabel = 0;
+	if(needsSkipBranch)
+	{
+		skipLabel = CreateLabel();
+		B(skipLabel);
+	}
+
+	for(const auto& veneer : veneers)
+	{
+		auto veneerLabel = CreateLabel();
+		MarkLabel(veneerLabel);
+		m_labelReferences.insert(std::make_pair(veneerLabel, veneer.second));
+		B(veneer.first);
+	}
+
+	WriteLiteralPool(m_stream, m_coldRegion);
+
+	if(needsSkipBranch)
+	{
+		MarkLabel(skipLabel);
+	}
+}
+
+bool CAArch64Assembler::HasLiterals(bool isCold) const
+{
+	return std::any_of(m_literal128Refs.begin(), m_literal128Refs.end(),
+	                   [isCold](const LITERAL128REF& literalRef) { return literalRef.isCold == isCold; }) ||
+	       std::any_of(m_literal64Refs.begin(), m_literal64Refs.end(),
+	                   [isCold](const LITERAL64REF& literalRef) { return literalRef.isCold == isCold; });
+}
+
+void CAArch64Assembler::WriteLiteralPool(Framework::CStream* stream, bool isCold)
+{
+	if(!HasLiterals(isCold)) return;
+
+	CLiteralPool literalPool(stream);
 	literalPool.AlignPool();
 
-	for(const auto& literalRef : m_literal128Refs)
+	//128-bit literals go first to keep them aligned, 64-bit ones follow
+	for(auto literalRefIterator = m_literal128Refs.begin(); literalRefIterator != m_literal128Refs.end();)
+	{
+		const auto& literalRef = *literalRefIterator;
+		if(literalRef.isCold != isCold)
+		{
+			++literalRefIterator;
+			continue;
+		}
+		auto literalPos = static_cast<uint32>(literalPool.GetLiteralPosition(literalRef.value));
+		auto offset = literalPos - static_cast<uint32>(literalRef.offset);
+		assert((offset & 0x03) == 0);
+		if(offset >= 0x100000)
+		{
+			throw std::runtime_error("Literal out of range.");
+		}
+		offset /= 4;
+		stream->Seek(literalRef.offset, Framework::STREAM_SEEK_SET);
+		stream->Write32(0x9C000000 | static_cast<uint32>(offset << 5) | literalRef.rt);
+		literalRefIterator = m_literal128Refs.erase(literalRefIterator);
+	}
+
+	for(auto literalRefIterator = m_literal64Refs.begin(); literalRefIterator != m_literal64Refs.end();)
 	{
+		const auto& literalRef = *literalRefIterator;
+		if(literalRef.isCold != isCold)
+		{
+			++literalRefIterator;
+			continue;
+		}
 		auto literalPos = static_cast<uint32>(literalPool.GetLiteralPosition(literalRef.value));
-		m_stream->Seek(literalRef.offset, Framework::STREAM_SEEK_SET);
-		auto offset = literalPos - literalRef.offset;
+		auto offset = literalPos - static_cast<uint32>(literalRef.offset);
 		assert((offset & 0x03) == 0);
-		assert(offset < 0x100000);
+		if(offset >= 0x100000)
+		{
+			throw std::runtime_error("Literal out of range.");
+		}
 		offset /= 4;
-		m_stream->Write32(0x9C000000 | static_cast<uint32>(offset << 5) | literalRef.rt);
+		stream->Seek(literalRef.offset, Framework::STREAM_SEEK_SET);
+		stream->Write32(0x58000000 | static_cast<uint32>(offset << 5) | literalRef.rt);
+		literalRefIterator = m_literal64Refs.erase(literalRefIterator);
 	}
-	m_literal128Refs.clear();
-	m_stream->Seek(0, Framework::STREAM_SEEK_END);
+	stream->Seek(0, Framework::STREAM_SEEK_END);
+}
+
+void CAArch64Assembler::Adcs(REGISTER32 rd, REGISTER32 rn, REGISTER32 rm)
+{
+	uint32 opcode = 0x3A000000;
+	opcode |= (rd << 0);
+	opcode |= (rn << 5);
+	opcode |= (rm << 16);
+	WriteWord(opcode);
 }
 
 void CAArch64Assembler::Add(REGISTER32 rd, REGISTER32 rn, REGISTER32 rm)
@@ -184,6 +415,15 @@ void CAArch64Assembler::Add_16b(REGISTERMD rd, REGISTERMD rn, REGISTERMD rm)
 	WriteWord(opcode);
 }
 
+void CAArch64Assembler::Adds(REGISTER32 rd, REGISTER32 rn, REGISTER32 rm)
+{
+	uint32 opcode = 0x2B000000;
+	opcode |= (rd << 0);
+	opcode |= (rn << 5);
+	opcode |= (rm << 16);
+	WriteWord(opcode);
+}
+
 void CAArch64Assembler::And(REGISTER32 rd, REGISTER32 rn, REGISTER32 rm)
 {
 	uint32 opcode = 0x0A000000;
@@ -244,6 +484,7 @@ void CAArch64Assembler::B(LABEL label)
 {
 	CreateBranchLabelReference(label, CONDITION_AL);
 	WriteWord(0);
+	NoteUnconditionalBranch();
 }
 
 void CAArch64Assembler::B_offset(uint32 offset)
@@ -254,6 +495,7 @@ void CAArch64Assembler::B_offset(uint32 offset)
 	uint32 opcode = 0x14000000;
 	opcode |= offset;
 	WriteWord(opcode);
+	NoteUnconditionalBranch();
 }
 
 void CAArch64Assembler::Bl(uint32 offset)
@@ -271,10 +513,20 @@ void CAArch64Assembler::Br(REGISTER64 rn)
 	uint32 opcode = 0xD61F0000;
 	opcode |= (rn << 5);
 	WriteWord(opcode);
+	NoteUnconditionalBranch();
 }
 
 void CAArch64Assembler::BCc(CONDITION condition, LABEL label)
 {
+	if((condition != CONDITION_AL) && IsConditionalBranchOutOfRange(label))
+	{
+		//Conditions are encoded in pairs, flipping the lowest bit gives the opposite one
+		auto skipLabel = CreateLabel();
+		BCc(static_cast<CONDITION>(condition ^ 1), skipLabel);
+		B(label);
+		MarkLabel(skipLabel);
+		return;
+	}
 	CreateBranchLabelReference(label, condition);
 	WriteWord(0);
 }
@@ -288,24 +540,56 @@ void CAArch64Assembler::Blr(REGISTER64 rn)
 
 void CAArch64Assembler::Cbnz(REGISTER32 rt, LABEL label)
 {
+	if(IsConditionalBranchOutOfRange(label))
+	{
+		auto skipLabel = CreateLabel();
+		Cbz(rt, skipLabel);
+		B(label);
+		MarkLabel(skipLabel);
+		return;
+	}
 	CreateCompareBranchLabelReference(label, CONDITION_NE, rt);
 	WriteWord(0);
 }
 
 void CAArch64Assembler::Cbnz(REGISTER64 rt, LABEL label)
 {
+	if(IsConditionalBranchOutOfRange(label))
+	{
+		auto skipLabel = CreateLabel();
+		Cbz(rt, skipLabel);
+		B(label);
+		MarkLabel(skipLabel);
+		return;
+	}
 	CreateCompareBranchLabelReference(label, CONDITION_NE, rt);
 	WriteWord(0);
 }
 
 void CAArch64Assembler::Cbz(REGISTER32 rt, LABEL label)
 {
+	if(IsConditionalBranchOutOfRange(label))
+	{
+		auto skipLabel = CreateLabel();
+		Cbnz(rt, skipLabel);
+		B(label);
+		MarkLabel(skipLabel);
+		return;
+	}
 	CreateCompareBranchLabelReference(label, CONDITION_EQ, rt);
 	WriteWord(0);
 }
 
 void CAArch64Assembler::Cbz(REGISTER64 rt, LABEL label)
 {
+	if(IsConditionalBranchOutOfRange(label))
+	{
+		auto skipLabel = CreateLabel();
+		Cbnz(rt, skipLabel);
+		B(label);
+		MarkLabel(skipLabel);
+		return;
+	}
 	CreateCompareBranchLabelReference(label, CONDITION_EQ, rt);
 	WriteWord(0);
 }
@@ -829,13 +1113,27 @@ void CAArch64Assembler::Ldr_Pc(REGISTER64 rt, uint32 offset)
 	WriteWord(opcode);
 }
 
+void CAArch64Assembler::Ldr_Pc(REGISTER64 rt, uint64 literal)
+{
+	LITERAL64REF literalRef;
+	literalRef.offset = static_cast<size_t>(m_stream->Tell());
+	literalRef.isCold = m_coldRegion;
+	literalRef.value = literal;
+	literalRef.rt = rt;
+	m_literal64Refs.push_back(literalRef);
+	NotePendingReference();
+	WriteWord(0);
+}
+
 void CAArch64Assembler::Ldr_Pc(REGISTERMD rt, const LITERAL128& literal)
 {
 	LITERAL128REF literalRef;
 	literalRef.offset = static_cast<size_t>(m_stream->Tell());
+	literalRef.isCold = m_coldRegion;
 	literalRef.value = literal;
 	literalRef.rt = rt;
 	m_literal128Refs.push_back(literalRef);
+	NotePendingReference();
 	WriteWord(0);
 }
 
@@ -973,6 +1271,12 @@ void CAArch64Assembler::Movn(REGISTER32 rd, uint16 imm, uint8 pos)
 	WriteMoveWideOpImm(0x12800000, pos, imm, rd);
 }
 
+void CAArch64Assembler::Movn(REGISTER64 rd, uint16 imm, uint8 pos)
+{
+	assert(pos < 4);
+	WriteMoveWideOpImm(0x92800000, pos, imm, rd);
+}
+
 void CAArch64Assembler::Movk(REGISTER32 rd, uint16 imm, uint8 pos)
 {
 	assert(pos < 2);
@@ -1047,6 +1351,11 @@ void CAArch64Assembler::Orr(REGISTER32 rd, REGISTER32 rn, uint8 n, uint8 immr, u
 	WriteLogicalOpImm(0x32000000, n, immr, imms, rn, rd);
 }
 
+void CAArch64Assembler::Orr(REGISTER64 rd, REGISTER64 rn, uint8 n, uint8 immr, uint8 imms)
+{
+	WriteLogicalOpImm(0xB2000000, n, immr, imms, rn, rd);
+}
+
 void CAArch64Assembler::Orr_16b(REGISTERMD rd, REGISTERMD rn, REGISTERMD rm)
 {
 	uint32 opcode = 0x4EA01C00;
@@ -1061,6 +1370,31 @@ void CAArch64Assembler::Ret(REGISTER64 rn)
 	uint32 opcode = 0xD65F0000;
 	opcode |= (rn << 5);
 	WriteWord(opcode);
+	NoteUnconditionalBranch();
+}
+
+void CAArch64Assembler::Rev(REGISTER32 rd, REGISTER32 rn)
+{
+	uint32 opcode = 0x5AC00800;
+	opcode |= (rd << 0);
+	opcode |= (rn << 5);
+	WriteWord(opcode);
+}
+
+void CAArch64Assembler::Rev(REGISTER64 rd, REGISTER64 rn)
+{
+	uint32 opcode = 0xDAC00C00;
+	opcode |= (rd << 0);
+	opcode |= (rn << 5);
+	WriteWord(opcode);
+}
+
+void CAArch64Assembler::Rev16(REGISTER32 rd, REGISTER32 rn)
+{
+	uint32 opcode = 0x5AC00400;
+	opcode |= (rd << 0);
+	opcode |= (rn << 5);
+	WriteWord(opcode);
 }
 
 void CAArch64Assembler::Scvtf_1s(REGISTERMD rd, REGISTERMD rn)
@@ -1405,6 +1739,15 @@ void CAArch64Assembler::Sub_16b(REGISTERMD rd, REGISTERMD rn, REGISTERMD rm)
 	WriteWord(opcode);
 }
 
+void CAArch64Assembler::Subs(REGISTER32 rd, REGISTER32 rn, REGISTER32 rm)
+{
+	uint32 opcode = 0x6B000000;
+	opcode |= (rd << 0);
+	opcode |= (rn << 5);
+	opcode |= (rm << 16);
+	WriteWord(opcode);
+}
+
 void CAArch64Assembler::Tbl(REGISTERMD rd, REGISTERMD rn, REGISTERMD rm)
 {
 	uint32 opcode = 0x4E002000;
@@ -1,4 +1,5 @@
 #include <assert.h>
+#include <algorithm>
 #include "Jitter.h"
 #include "placeholder_def.h"
 
@@ -25,13 +26,35 @@ void CJitter::SetStream(Framework::CStream* stream)
 	m_codeGen->SetStream(stream);
 }
 
+void CJitter::SetMemoryBase(size_t offset)
+{
+	m_memoryBaseOffset = offset;
+}
+
+void CJitter::PinRelative(size_t offset)
+{
+	assert((offset & 3) == 0);
+	uint32 relativeOffset = static_cast<uint32>(offset);
+	if(std::find(std::begin(m_pinnedRelatives), std::end(m_pinnedRelatives), relativeOffset) != std::end(m_pinnedRelatives)) return;
+	m_pinnedRelatives.push_back(relativeOffset);
+}
+
+void CJitter::ClearPinnedRelatives()
+{
+	m_pinnedRelatives.clear();
+}
+
 void CJitter::Begin()
 {
 	assert(m_blockStarted == false);
 	m_blockStarted = true;
 	m_nextTemporary = 1;
 	m_nextBlockId = 1;
+	m_usesMemoryBase = false;
+	m_coldRegionDepth = 0;
 	m_basicBlocks.clear();
+	m_pendingLabelReferences.clear();
+	m_currentBlock = nullptr;
 
 	StartBlock(m_nextBlockId++);
 }
@@ -52,9 +75,21 @@ bool CJitter::IsStackEmpty() const
 
 void CJitter::StartBlock(uint32 blockId)
 {
+	//Previous block falls through to the new one unless it ends with an unconditional jump
+	if(m_currentBlock)
+	{
+		const auto& statements = m_currentBlock->statements;
+		bool endsWithJump = !statements.empty() && ((statements.back().op == OP_JMP) || (statements.back().op == OP_GOTO));
+		if(!endsWithJump)
+		{
+			AddBlockSuccessor(*m_currentBlock, blockId);
+		}
+	}
+
 	auto blockIterator = m_basicBlocks.emplace(m_basicBlocks.end(), BASIC_BLOCK());
 	m_currentBlock = &(*blockIterator);
 	m_currentBlock->id = blockId;
+	m_currentBlock->isCold = (m_coldRegionDepth != 0);
 }
 
 CJitter::LABEL CJitter::CreateLabel()
@@ -67,12 +102,37 @@ void CJitter::MarkLabel(LABEL label)
 	uint32 newBlockId = m_nextBlockId++;
 	StartBlock(newBlockId);
 	m_labels[label] = newBlockId;
+
+	auto pendingIterator = m_pendingLabelReferences.find(label);
+	if(pendingIterator != std::end(m_pendingLabelReferences))
+	{
+		for(auto referencingBlock : pendingIterator->second)
+		{
+			AddBlockSuccessor(*referencingBlock, newBlockId);
+		}
+		m_pendingLabelReferences.erase(pendingIterator);
+	}
 }
 
-void CJitter::Goto(LABEL label)
+void CJitter::Goto(LABEL label, BRANCH_HINT hint)
 {
 	assert(m_shadow.GetCount() == 0);
 
+	if(hint != BRANCH_HINT_NONE)
+	{
+		m_currentBlock->isCold = (hint == BRANCH_HINT_UNLIKELY);
+	}
+
+	auto labelIterator = m_labels.find(label);
+	if(labelIterator != std::end(m_labels))
+	{
+		AddBlockSuccessor(*m_currentBlock, labelIterator->second);
+	}
+	else
+	{
+		m_pendingLabelReferences[label].push_back(m_currentBlock);
+	}
+
 	STATEMENT statement;
 	statement.op = OP_GOTO;
 	statement.jmpBlock = label;
@@ -120,10 +180,12 @@ CONDITION CJitter::GetReverseCondition(CONDITION condition)
 	throw std::exception();
 }
 
-void CJitter::BeginIf(CONDITION condition)
+void CJitter::BeginIf(CONDITION condition, BRANCH_HINT hint)
 {
 	uint32 jumpBlockId = m_nextBlockId++;
 	m_ifStack.push(jumpBlockId);
+	m_ifHintStack.push(hint);
+	if(hint == BRANCH_HINT_UNLIKELY) m_coldRegionDepth++;
 
 	STATEMENT statement;
 	statement.op = OP_CONDJMP;
@@ -132,6 +194,7 @@ void CJitter::BeginIf(CONDITION condition)
 	statement.jmpCondition = GetReverseCondition(condition);
 	statement.jmpBlock = jumpBlockId;
 	InsertStatement(statement);
+	AddBlockSuccessor(*m_currentBlock, jumpBlockId);
 
 	assert(m_shadow.GetCount() == 0);
 
@@ -150,10 +213,20 @@ void CJitter::Else()
 	uint32 jumpBlockId = m_nextBlockId++;
 	m_ifStack.push(jumpBlockId);
 
+	//Else path has the opposite likelihood of the If path
+	auto& hint = m_ifHintStack.top();
+	if(hint == BRANCH_HINT_UNLIKELY) m_coldRegionDepth--;
+	if(hint != BRANCH_HINT_NONE)
+	{
+		hint = (hint == BRANCH_HINT_LIKELY) ? BRANCH_HINT_UNLIKELY : BRANCH_HINT_LIKELY;
+	}
+	if(hint == BRANCH_HINT_UNLIKELY) m_coldRegionDepth++;
+
 	STATEMENT statement;
 	statement.op = OP_JMP;
 	statement.jmpBlock = jumpBlockId;
 	InsertStatement(statement);
+	AddBlockSuccessor(*m_currentBlock, jumpBlockId);
 
 	StartBlock(nextBlockId);
 }
@@ -165,6 +238,8 @@ void CJitter::EndIf()
 
 	uint32 nextBlockId = m_ifStack.top();
 	m_ifStack.pop();
+	if(m_ifHintStack.top() == BRANCH_HINT_UNLIKELY) m_coldRegionDepth--;
+	m_ifHintStack.pop();
 	StartBlock(nextBlockId);
 }
 
@@ -239,6 +314,31 @@ void CJitter::Add()
 	InsertBinaryStatement(OP_ADD);
 }
 
+void CJitter::AddOvf()
+{
+	InsertBinaryFlagStatement(OP_ADDOVF);
+}
+
+void CJitter::AddCarry()
+{
+	InsertBinaryFlagStatement(OP_ADDCARRY);
+}
+
+void CJitter::Adc()
+{
+	SymbolPtr tempSym = MakeSymbol(SYM_TEMPORARY64, m_nextTemporary++);
+
+	STATEMENT statement;
+	statement.op = OP_ADC;
+	statement.src3 = MakeSymbolRef(m_shadow.Pull());
+	statement.src2 = MakeSymbolRef(m_shadow.Pull());
+	statement.src1 = MakeSymbolRef(m_shadow.Pull());
+	statement.dst = MakeSymbolRef(tempSym);
+	InsertStatement(statement);
+
+	m_shadow.Push(tempSym);
+}
+
 void CJitter::And()
 {
 	InsertBinaryStatement(OP_AND);
@@ -251,7 +351,7 @@ void CJitter::Break()
 	InsertStatement(statement);
 }
 
-void CJitter::Call(void* func, unsigned int paramCount, RETURN_VALUE_TYPE returnValue)
+void CJitter::Call(void* func, unsigned int paramCount, RETURN_VALUE_TYPE returnValue, uint32 attributes)
 {
 	for(unsigned int i = 0; i < paramCount; i++)
 	{
@@ -294,6 +394,7 @@ void CJitter::Call(void* func, unsigned int paramCount, RETURN_VALUE_TYPE return
 	callStatement.src1 = MakeSymbolRef(MakeConstantPtr(reinterpret_cast<uintptr_t>(func)));
 	callStatement.src2 = MakeSymbolRef(MakeSymbol(SYM_CONSTANT, paramCount));
 	callStatement.op = OP_CALL;
+	callStatement.callAttributes = attributes;
 	InsertStatement(callStatement);
 
 	if(returnValue != RETURN_VALUE_NONE)
@@ -469,6 +570,16 @@ void CJitter::Sub()
 	InsertBinaryStatement(OP_SUB);
 }
 
+void CJitter::SubOvf()
+{
+	InsertBinaryFlagStatement(OP_SUBOVF);
+}
+
+void CJitter::SubBorrow()
+{
+	InsertBinaryFlagStatement(OP_SUBBORROW);
+}
+
 void CJitter::Xor()
 {
 	InsertBinaryStatement(OP_XOR);
@@ -662,6 +773,183 @@ void CJitter::Store64AtRefIdx(size_t scale)
 	StoreAtRefIdx(scale);
 }
 
+void CJitter::LoadFromRefBSwap()
+{
+	InsertUnaryStatement(OP_LOADFROMREFBSWAP);
+}
+
+void CJitter::LoadFromRefIdxBSwap(size_t scale)
+{
+	assert(scale == 1 || scale == 4);
+	InsertLoadFromRefIdxStatement(OP_LOADFROMREFBSWAP, scale);
+}
+
+void CJitter::Load16FromRefBSwap()
+{
+	InsertUnaryStatement(OP_LOAD16FROMREFBSWAP);
+}
+
+void CJitter::Load16FromRefIdxBSwap(size_t scale)
+{
+	assert(scale == 1);
+	InsertLoadFromRefIdxStatement(OP_LOAD16FROMREFBSWAP, scale);
+}
+
+void CJitter::Load64FromRefBSwap()
+{
+	auto tempSym = MakeSymbol(SYM_TEMPORARY64, m_nextTemporary++);
+
+	STATEMENT statement;
+	statement.op = OP_LOADFROMREFBSWAP;
+	statement.src1 = MakeSymbolRef(m_shadow.Pull());
+	statement.dst = MakeSymbolRef(tempSym);
+	InsertStatement(statement);
+
+	m_shadow.Push(tempSym);
+}
+
+void CJitter::Load64FromRefIdxBSwap(size_t scale)
+{
+	assert(scale == 1);
+
+	auto tempSym = MakeSymbol(SYM_TEMPORARY64, m_nextTemporary++);
+
+	STATEMENT statement;
+	statement.op = OP_LOADFROMREFBSWAP;
+	statement.jmpCondition = static_cast<CONDITION>(scale);
+	statement.src2 = MakeSymbolRef(m_shadow.Pull());
+	statement.src1 = MakeSymbolRef(m_shadow.Pull());
+	statement.dst = MakeSymbolRef(tempSym);
+	InsertStatement(statement);
+
+	m_shadow.Push(tempSym);
+}
+
+void CJitter::StoreAtRefBSwap()
+{
+	STATEMENT statement;
+	statement.op = OP_STOREATREFBSWAP;
+	statement.src2 = MakeSymbolRef(m_shadow.Pull());
+	statement.src1 = MakeSymbolRef(m_shadow.Pull());
+	InsertStatement(statement);
+}
+
+void CJitter::StoreAtRefIdxBSwap(size_t scale)
+{
+	assert(scale == 1 || scale == 4);
+	InsertStoreAtRefIdxStatement(OP_STOREATREFBSWAP, scale);
+}
+
+void CJitter::Store16AtRefBSwap()
+{
+	STATEMENT statement;
+	statement.op = OP_STORE16ATREFBSWAP;
+	statement.src2 = MakeSymbolRef(m_shadow.Pull());
+	statement.src1 = MakeSymbolRef(m_shadow.Pull());
+	InsertStatement(statement);
+}
+
+void CJitter::Store16AtRefIdxBSwap(size_t scale)
+{
+	assert(scale == 1);
+	InsertStoreAtRefIdxStatement(OP_STORE16ATREFBSWAP, scale);
+}
+
+void CJitter::Store64AtRefBSwap()
+{
+	StoreAtRefBSwap();
+}
+
+void CJitter::Store64AtRefIdxBSwap(size_t scale)
+{
+	assert(scale == 1);
+	InsertStoreAtRefIdxStatement(OP_STOREATREFBSWAP, scale);
+}
+
+void CJitter::LoadFromMemBase(uint32 displacement)
+{
+	if(!m_codeGen->SupportsMemoryBase())
+	{
+		auto index = m_shadow.Pull();
+		PushMemoryBaseRef(displacement);
+		m_shadow.Push(index);
+		LoadFromRefIdx(1);
+		return;
+	}
+	InsertLoadFromMemBaseStatement(OP_LOADFROMMEMBASE, displacement);
+}
+
+void CJitter::Load8FromMemBase(uint32 displacement)
+{
+	if(!m_codeGen->SupportsMemoryBase())
+	{
+		auto index = m_shadow.Pull();
+		PushMemoryBaseRef(displacement);
+		m_shadow.Push(index);
+		Load8FromRefIdx(1);
+		return;
+	}
+	InsertLoadFromMemBaseStatement(OP_LOAD8FROMMEMBASE, displacement);
+}
+
+void CJitter::Load16FromMemBase(uint32 displacement)
+{
+	if(!m_codeGen->SupportsMemoryBase())
+	{
+		auto index = m_shadow.Pull();
+		PushMemoryBaseRef(displacement);
+		m_shadow.Push(index);
+		Load16FromRefIdx(1);
+		return;
+	}
+	InsertLoadFromMemBaseStatement(OP_LOAD16FROMMEMBASE, displacement);
+}
+
+void CJitter::StoreAtMemBase(uint32 displacement)
+{
+	if(!m_codeGen->SupportsMemoryBase())
+	{
+		auto value = m_shadow.Pull();
+		auto index = m_shadow.Pull();
+		PushMemoryBaseRef(displacement);
+		m_shadow.Push(index);
+		m_shadow.Push(value);
+		StoreAtRefIdx(1);
+		return;
+	}
+	InsertStoreAtMemBaseStatement(OP_STOREATMEMBASE, displacement);
+}
+
+void CJitter::Store8AtMemBase(uint32 displacement)
+{
+	if(!m_codeGen->SupportsMemoryBase())
+	{
+		auto value = m_shadow.Pull();
+		auto index = m_shadow.Pull();
+		PushMemoryBaseRef(displacement);
+		m_shadow.Push(index);
+		m_shadow.Push(value);
+		Store8AtRefIdx(1);
+		return;
+	}
+	InsertStoreAtMemBaseStatement(OP_STORE8ATMEMBASE, displacement);
+}
+
+void CJitter::Store16AtMemBase(uint32 displacement)
+{
+	if(!m_codeGen->SupportsMemoryBase())
+	{
+		auto value = m_shadow.Pull();
+		auto index = m_shadow.Pull();
+		PushMemoryBaseRef(displacement);
+		m_shadow.Push(index);
+		m_shadow.Push(value);
+		Store16AtRefIdx(1);
+		return;
+	}
+	InsertStoreAtMemBaseStatement(OP_STORE16ATMEMBASE, displacement);
+}
+
 //64-bits
 //------------------------------------------------
 void CJitter::PushRel64(size_t offset)
@@ -1503,6 +1791,22 @@ void CJitter::InsertBinaryStatement(Jitter::OPERATION operation)
 	m_shadow.Push(tempSym);
 }
 
+//Result is a 64-bit temporary holding the operation's result in its low part
+//and the produced flag (0 or 1) in its high part
+void CJitter::InsertBinaryFlagStatement(Jitter::OPERATION operation)
+{
+	auto tempSym = MakeSymbol(SYM_TEMPORARY64, m_nextTemporary++);
+
+	STATEMENT statement;
+	statement.op = operation;
+	statement.src2 = MakeSymbolRef(m_shadow.Pull());
+	statement.src1 = MakeSymbolRef(m_shadow.Pull());
+	statement.dst = MakeSymbolRef(tempSym);
+	InsertStatement(statement);
+
+	m_shadow.Push(tempSym);
+}
+
 void CJitter::InsertShiftCstStatement(Jitter::OPERATION operation, uint8 amount)
 {
 	auto tempSym = MakeSymbol(SYM_TEMPORARY, m_nextTemporary++);
@@ -1543,6 +1847,57 @@ void CJitter::InsertStoreAtRefIdxStatement(Jitter::OPERATION operation, size_t s
 	InsertStatement(statement);
 }
 
+void CJitter::PushMemoryBaseRef(uint32 displacement)
+{
+	//Used when the code generator can't reserve a register for the memory base
+	if(m_memoryBaseOffset == SIZE_MAX)
+	{
+		throw std::runtime_error("Memory base was not set.");
+	}
+	PushRelRef(m_memoryBaseOffset);
+	if(displacement != 0)
+	{
+		PushCst(displacement);
+		AddRef();
+	}
+}
+
+void CJitter::InsertLoadFromMemBaseStatement(Jitter::OPERATION operation, uint32 displacement)
+{
+	if(m_memoryBaseOffset == SIZE_MAX)
+	{
+		throw std::runtime_error("Memory base was not set.");
+	}
+	m_usesMemoryBase = true;
+
+	auto tempSym = MakeSymbol(SYM_TEMPORARY, m_nextTemporary++);
+
+	STATEMENT statement;
+	statement.op = operation;
+	statement.src2 = MakeSymbolRef(MakeSymbol(SYM_CONSTANT, displacement));
+	statement.src1 = MakeSymbolRef(m_shadow.Pull());
+	statement.dst = MakeSymbolRef(tempSym);
+	InsertStatement(statement);
+
+	m_shadow.Push(tempSym);
+}
+
+void CJitter::InsertStoreAtMemBaseStatement(Jitter::OPERATION operation, uint32 displacement)
+{
+	if(m_memoryBaseOffset == SIZE_MAX)
+	{
+		throw std::runtime_error("Memory base was not set.");
+	}
+	m_usesMemoryBase = true;
+
+	STATEMENT statement;
+	statement.op = operation;
+	statement.src3 = MakeSymbolRef(m_shadow.Pull());
+	statement.src2 = MakeSymbolRef(MakeSymbol(SYM_CONSTANT, displacement));
+	statement.src1 = MakeSymbolRef(m_shadow.Pull());
+	InsertStatement(statement);
+}
+
 void CJitter::InsertBinary64Statement(Jitter::OPERATION operation)
 {
 	auto tempSym = MakeSymbol(SYM_TEMPORARY64, m_nextTemporary++);
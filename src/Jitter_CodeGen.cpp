@@ -1,12 +1,130 @@
 #include "Jitter_CodeGen.h"
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
 
 using namespace Jitter;
 
+void CCodeGen::SetColdStream(Framework::CStream* coldStream)
+{
+	if(coldStream != nullptr)
+	{
+		throw std::runtime_error("Code generator doesn't support cold code regions.");
+	}
+}
+
+bool CCodeGen::HasColdStream() const
+{
+	return m_coldStream != nullptr;
+}
+
+const CodeRegionRelocationArray& CCodeGen::GetCodeRegionRelocations() const
+{
+	return m_codeRegionRelocations;
+}
+
+void CCodeGen::ApplyCodeRegionRelocations(const CodeRegionRelocationArray& relocations, void* hotCode, void* coldCode)
+{
+	ApplyCodeRegionRelocations(relocations, hotCode, coldCode, hotCode, coldCode);
+}
+
+void CCodeGen::ApplyCodeRegionRelocations(const CodeRegionRelocationArray& relocations, void* hotCode, void* coldCode,
+                                          void* hotWritableCode, void* coldWritableCode)
+{
+	auto hotBase = reinterpret_cast<uint8*>(hotCode);
+	auto coldBase = reinterpret_cast<uint8*>(coldCode);
+	auto hotWritableBase = reinterpret_cast<uint8*>(hotWritableCode);
+	auto coldWritableBase = reinterpret_cast<uint8*>(coldWritableCode);
+	for(const auto& relocation : relocations)
+	{
+		//Displacements are computed with the executable addresses
+		auto source = (relocation.inColdRegion ? coldBase : hotBase) + relocation.offset;
+		auto target = (relocation.inColdRegion ? hotBase : coldBase) + relocation.targetOffset;
+		auto writableSource = (relocation.inColdRegion ? coldWritableBase : hotWritableBase) + relocation.offset;
+		switch(relocation.type)
+		{
+		case CODE_REGION_RELOCATION_TYPE::REL32:
+		{
+			int64 displacement = target - (source + 4);
+			if((displacement < INT32_MIN) || (displacement > INT32_MAX))
+			{
+				throw std::runtime_error("Code regions are too far apart.");
+			}
+			int32 value = static_cast<int32>(displacement);
+			memcpy(writableSource, &value, 4);
+		}
+		break;
+		case CODE_REGION_RELOCATION_TYPE::BRANCH26:
+		{
+			int64 displacement = (target - source) / 4;
+			if((displacement < -0x2000000) || (displacement >= 0x2000000))
+			{
+				throw std::runtime_error("Code regions are too far apart.");
+			}
+			uint32 opcode = 0;
+			memcpy(&opcode, writableSource, 4);
+			opcode = (opcode & ~0x03FFFFFF) | (static_cast<uint32>(displacement) & 0x03FFFFFF);
+			memcpy(writableSource, &opcode, 4);
+		}
+		break;
+		default:
+			assert(false);
+			break;
+		}
+	}
+}
+
 void CCodeGen::SetExternalSymbolReferencedHandler(const ExternalSymbolReferencedHandler& externalSymbolReferencedHandler)
 {
 	m_externalSymbolReferencedHandler = externalSymbolReferencedHandler;
 }
 
+void CCodeGen::SetMemoryBaseOffset(uint32 memoryBaseOffset)
+{
+	//Offset ends up as a signed 32-bit displacement on some platforms
+	if((memoryBaseOffset != MEMORY_BASE_NONE) && (memoryBaseOffset > static_cast<uint32>(INT32_MAX)))
+	{
+		throw std::runtime_error("Memory base offset is out of range.");
+	}
+	m_memoryBaseOffset = memoryBaseOffset;
+}
+
+bool CCodeGen::CanGenerateUnoptimized(const StatementList&) const
+{
+	return false;
+}
+
+bool CCodeGen::HasMemoryBase() const
+{
+	return m_memoryBaseOffset != MEMORY_BASE_NONE;
+}
+
+//Returns the operation that produced the flag tested by a flag branch if the processor flags still hold it
+OPERATION CCodeGen::GetLiveFlagOperation(const STATEMENT& statement) const
+{
+	if(!m_liveFlagStatement) return OP_NOP;
+	if(!m_liveFlagStatement->dst->Equals(statement.src1.get())) return OP_NOP;
+	return m_liveFlagStatement->op;
+}
+
+//Called after each statement is emitted, forgets about the live flag unless the statement is known to preserve it
+void CCodeGen::UpdateLiveFlags(const STATEMENT& statement)
+{
+	if(&statement == m_liveFlagStatement) return;
+	switch(statement.op)
+	{
+	case OP_MOV:
+	case OP_EXTLOW64:
+	case OP_EXTHIGH64:
+		//Plain moves leave the flags alone, constants might be loaded with a flag clobbering instruction
+		if(!statement.src1->GetSymbol()->IsConstant()) return;
+		break;
+	default:
+		break;
+	}
+	m_liveFlagStatement = nullptr;
+}
+
 bool CCodeGen::SymbolMatches(MATCHTYPE match, const SymbolRefPtr& symbolRef)
 {
 	if(match == MATCH_ANY) return true;
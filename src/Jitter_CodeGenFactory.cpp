@@ -1,11 +1,12 @@
 #include "Jitter_CodeGenFactory.h"
+#include "maybe_unused.h"
 
 // clang-format off
 
 #ifdef _WIN32
 
 	#ifdef _M_X64
-		#include "Jitter_CodeGen_x86_64.h"
+		#include "Jitter_CodeGen_x86_64_Stencil.h"
 	#else
 		#include "Jitter_CodeGen_x86_32.h"
 	#endif
@@ -20,7 +21,7 @@
 	#elif TARGET_CPU_X86
 		#include "Jitter_CodeGen_x86_32.h"
 	#elif TARGET_CPU_X86_64
-		#include "Jitter_CodeGen_x86_64.h"
+		#include "Jitter_CodeGen_x86_64_Stencil.h"
 	#else
 		#warning Architecture not supported
 	#endif
@@ -38,19 +39,19 @@
 	#elif defined(__i386__)
 		#include "Jitter_CodeGen_x86_32.h"
 	#elif defined(__x86_64__)
-		#include "Jitter_CodeGen_x86_64.h"
+		#include "Jitter_CodeGen_x86_64_Stencil.h"
 	#else
 		#warning Architecture not supported
 	#endif
 
 #endif
 
-Jitter::CCodeGen* Jitter::CreateCodeGen()
+Jitter::CCodeGen* Jitter::CreateCodeGen(FRAMEWORK_MAYBE_UNUSED CODEGEN_TIER tier)
 {
 #ifdef _WIN32
 	
 	#ifdef _M_X64
-		auto codeGen = new Jitter::CCodeGen_x86_64();
+		auto codeGen = (tier == CODEGEN_TIER::BASELINE) ? new Jitter::CCodeGen_x86_64_Stencil() : new Jitter::CCodeGen_x86_64();
 		codeGen->SetPlatformAbi(CCodeGen_x86_64::PLATFORM_ABI_WIN32);
 		return codeGen;
 	#else
@@ -72,7 +73,7 @@ Jitter::CCodeGen* Jitter::CreateCodeGen()
 		codeGen->SetImplicitRetValueParamFixUpRequired(true);
 		return codeGen;
 	#elif TARGET_CPU_X86_64
-		auto codeGen = new Jitter::CCodeGen_x86_64();
+		auto codeGen = (tier == CODEGEN_TIER::BASELINE) ? new Jitter::CCodeGen_x86_64_Stencil() : new Jitter::CCodeGen_x86_64();
 		codeGen->SetPlatformAbi(CCodeGen_x86_64::PLATFORM_ABI_SYSTEMV);
 		return codeGen;
 	#else
@@ -100,7 +101,7 @@ Jitter::CCodeGen* Jitter::CreateCodeGen()
 		codeGen->SetImplicitRetValueParamFixUpRequired(true);
 		return codeGen;
 	#elif defined(__x86_64__)
-		auto codeGen = new Jitter::CCodeGen_x86_64();
+		auto codeGen = (tier == CODEGEN_TIER::BASELINE) ? new Jitter::CCodeGen_x86_64_Stencil() : new Jitter::CCodeGen_x86_64();
 		codeGen->SetPlatformAbi(CCodeGen_x86_64::PLATFORM_ABI_SYSTEMV);
 		return codeGen;
 	#else
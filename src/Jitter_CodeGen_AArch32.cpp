@@ -128,6 +128,65 @@ void CCodeGen_AArch32::Emit_MulTmp64AnyAny(const STATEMENT& statement)
 	m_assembler.Str(resHiReg, CAArch32Assembler::rSP, CAArch32Assembler::MakeImmediateLdrAddress(dst->m_stackLocation + m_stackLevel + 4));
 }
 
+void CCodeGen_AArch32::Emit_AluFlag_Tmp64AnyAny(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto resultReg = CAArch32Assembler::r0;
+	auto flagReg = CAArch32Assembler::r1;
+	auto src1Reg = PrepareSymbolRegisterUse(src1, CAArch32Assembler::r2);
+	auto src2Reg = PrepareSymbolRegisterUse(src2, CAArch32Assembler::r3);
+
+	assert(dst->m_type == SYM_TEMPORARY64);
+
+	CAArch32Assembler::ImmediateAluOperand falseOperand(CAArch32Assembler::MakeImmediateAluOperand(0, 0));
+	CAArch32Assembler::ImmediateAluOperand trueOperand(CAArch32Assembler::MakeImmediateAluOperand(1, 0));
+
+	if(statement.op == OP_ADC)
+	{
+		//C is set if carry in is not 0 (carry in >= 1)
+		auto src3 = statement.src3->GetSymbol().get();
+		auto src3Reg = PrepareSymbolRegisterUse(src3, flagReg);
+		m_assembler.Cmp(src3Reg, trueOperand);
+	}
+
+	//MOV doesn't alter flags, we can clear the flag register before the operation
+	m_assembler.Mov(flagReg, falseOperand);
+
+	switch(statement.op)
+	{
+	case OP_ADDOVF:
+		m_assembler.Adds(resultReg, src1Reg, src2Reg);
+		m_assembler.MovCc(CAArch32Assembler::CONDITION_VS, flagReg, trueOperand);
+		break;
+	case OP_ADDCARRY:
+		m_assembler.Adds(resultReg, src1Reg, src2Reg);
+		m_assembler.MovCc(CAArch32Assembler::CONDITION_CS, flagReg, trueOperand);
+		break;
+	case OP_ADC:
+		m_assembler.Adcs(resultReg, src1Reg, src2Reg);
+		m_assembler.MovCc(CAArch32Assembler::CONDITION_CS, flagReg, trueOperand);
+		break;
+	case OP_SUBOVF:
+		m_assembler.Subs(resultReg, src1Reg, src2Reg);
+		m_assembler.MovCc(CAArch32Assembler::CONDITION_VS, flagReg, trueOperand);
+		break;
+	case OP_SUBBORROW:
+		//C is cleared when a borrow occurs
+		m_assembler.Subs(resultReg, src1Reg, src2Reg);
+		m_assembler.MovCc(CAArch32Assembler::CONDITION_CC, flagReg, trueOperand);
+		break;
+	default:
+		assert(false);
+		break;
+	}
+
+	m_assembler.Str(resultReg, CAArch32Assembler::rSP, CAArch32Assembler::MakeImmediateLdrAddress(dst->m_stackLocation + m_stackLevel + 0));
+	m_assembler.Str(flagReg, CAArch32Assembler::rSP, CAArch32Assembler::MakeImmediateLdrAddress(dst->m_stackLocation + m_stackLevel + 4));
+}
+
 template <CAArch32Assembler::SHIFT shiftType>
 void CCodeGen_AArch32::Emit_Shift_Generic(const STATEMENT& statement)
 {
@@ -209,6 +268,12 @@ CCodeGen_AArch32::CONSTMATCHER CCodeGen_AArch32::g_constMatchers[] =
 	{ OP_MUL,  MATCH_TEMPORARY64, MATCH_ANY, MATCH_ANY, MATCH_NIL, &CCodeGen_AArch32::Emit_MulTmp64AnyAny<false> },
 	{ OP_MULS, MATCH_TEMPORARY64, MATCH_ANY, MATCH_ANY, MATCH_NIL, &CCodeGen_AArch32::Emit_MulTmp64AnyAny<true>  },
 
+	{ OP_ADDOVF,    MATCH_TEMPORARY64, MATCH_ANY, MATCH_ANY, MATCH_NIL, &CCodeGen_AArch32::Emit_AluFlag_Tmp64AnyAny },
+	{ OP_ADDCARRY,  MATCH_TEMPORARY64, MATCH_ANY, MATCH_ANY, MATCH_NIL, &CCodeGen_AArch32::Emit_AluFlag_Tmp64AnyAny },
+	{ OP_ADC,       MATCH_TEMPORARY64, MATCH_ANY, MATCH_ANY, MATCH_ANY, &CCodeGen_AArch32::Emit_AluFlag_Tmp64AnyAny },
+	{ OP_SUBOVF,    MATCH_TEMPORARY64, MATCH_ANY, MATCH_ANY, MATCH_NIL, &CCodeGen_AArch32::Emit_AluFlag_Tmp64AnyAny },
+	{ OP_SUBBORROW, MATCH_TEMPORARY64, MATCH_ANY, MATCH_ANY, MATCH_NIL, &CCodeGen_AArch32::Emit_AluFlag_Tmp64AnyAny },
+
 	{ OP_RELTOREF, MATCH_VAR_REF, MATCH_CONSTANT, MATCH_ANY, MATCH_NIL, &CCodeGen_AArch32::Emit_RelToRef_VarCst },
 
 	{ OP_ADDREF, MATCH_VAR_REF, MATCH_VAR_REF, MATCH_ANY, MATCH_NIL, &CCodeGen_AArch32::Emit_AddRef_VarVarAny },
@@ -236,6 +301,18 @@ CCodeGen_AArch32::CONSTMATCHER CCodeGen_AArch32::g_constMatchers[] =
 	{ OP_STORE16ATREF, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY, MATCH_NIL, &CCodeGen_AArch32::Emit_Store16AtRef_VarAny },
 	{ OP_STORE16ATREF, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY, MATCH_ANY32, &CCodeGen_AArch32::Emit_Store16AtRef_VarAnyAny },
 
+	{ OP_LOADFROMREFBSWAP, MATCH_VARIABLE, MATCH_VAR_REF, MATCH_NIL,   MATCH_NIL, &CCodeGen_AArch32::Emit_LoadFromRefBSwap_VarVar    },
+	{ OP_LOADFROMREFBSWAP, MATCH_VARIABLE, MATCH_VAR_REF, MATCH_ANY32, MATCH_NIL, &CCodeGen_AArch32::Emit_LoadFromRefBSwap_VarVarAny },
+
+	{ OP_LOAD16FROMREFBSWAP, MATCH_VARIABLE, MATCH_VAR_REF, MATCH_NIL,   MATCH_NIL, &CCodeGen_AArch32::Emit_Load16FromRefBSwap_VarVar    },
+	{ OP_LOAD16FROMREFBSWAP, MATCH_VARIABLE, MATCH_VAR_REF, MATCH_ANY32, MATCH_NIL, &CCodeGen_AArch32::Emit_Load16FromRefBSwap_VarVarAny },
+
+	{ OP_STOREATREFBSWAP, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32, MATCH_NIL,   &CCodeGen_AArch32::Emit_StoreAtRefBSwap_VarAny    },
+	{ OP_STOREATREFBSWAP, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32, MATCH_ANY32, &CCodeGen_AArch32::Emit_StoreAtRefBSwap_VarAnyAny },
+
+	{ OP_STORE16ATREFBSWAP, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32, MATCH_NIL,   &CCodeGen_AArch32::Emit_Store16AtRefBSwap_VarAny    },
+	{ OP_STORE16ATREFBSWAP, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32, MATCH_ANY32, &CCodeGen_AArch32::Emit_Store16AtRefBSwap_VarAnyAny },
+
 	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
 };
 // clang-format on
@@ -286,6 +363,36 @@ bool CCodeGen_AArch32::SupportsExternalJumps() const
 	return true;
 }
 
+bool CCodeGen_AArch32::SupportsBlockPlacement() const
+{
+	return true;
+}
+
+bool CCodeGen_AArch32::SupportsColdRegion() const
+{
+	return false;
+}
+
+bool CCodeGen_AArch32::SupportsMemoryBase() const
+{
+	return false;
+}
+
+bool CCodeGen_AArch32::SupportsRefIndexDisplacement() const
+{
+	return false;
+}
+
+bool CCodeGen_AArch32::SupportsAluFlagBranches() const
+{
+	return false;
+}
+
+bool CCodeGen_AArch32::SupportsNestedLoops() const
+{
+	return true;
+}
+
 uint32 CCodeGen_AArch32::GetPointerSize() const
 {
 	return 4;
@@ -1310,6 +1417,10 @@ void CCodeGen_AArch32::Cmp_GetFlag(CAArch32Assembler::REGISTER registerId, Jitte
 		m_assembler.MovCc(CAArch32Assembler::CONDITION_LE, registerId, falseOperand);
 		m_assembler.MovCc(CAArch32Assembler::CONDITION_GT, registerId, trueOperand);
 		break;
+	case CONDITION_GE:
+		m_assembler.MovCc(CAArch32Assembler::CONDITION_LT, registerId, falseOperand);
+		m_assembler.MovCc(CAArch32Assembler::CONDITION_GE, registerId, trueOperand);
+		break;
 	case CONDITION_BL:
 		m_assembler.MovCc(CAArch32Assembler::CONDITION_CS, registerId, falseOperand);
 		m_assembler.MovCc(CAArch32Assembler::CONDITION_CC, registerId, trueOperand);
@@ -1322,6 +1433,10 @@ void CCodeGen_AArch32::Cmp_GetFlag(CAArch32Assembler::REGISTER registerId, Jitte
 		m_assembler.MovCc(CAArch32Assembler::CONDITION_LS, registerId, falseOperand);
 		m_assembler.MovCc(CAArch32Assembler::CONDITION_HI, registerId, trueOperand);
 		break;
+	case CONDITION_AE:
+		m_assembler.MovCc(CAArch32Assembler::CONDITION_CC, registerId, falseOperand);
+		m_assembler.MovCc(CAArch32Assembler::CONDITION_CS, registerId, trueOperand);
+		break;
 	default:
 		assert(0);
 		break;
@@ -1720,3 +1835,161 @@ void CCodeGen_AArch32::Emit_Store16AtRef_VarAnyAny(const STATEMENT& statement)
 		m_assembler.Strh(valueReg, addressReg, MakeScaledLdrAddress(indexReg, scale));
 	}
 }
+
+void CCodeGen_AArch32::Emit_LoadFromRefBSwap_VarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, CAArch32Assembler::r0);
+	auto dstReg = PrepareSymbolRegisterDef(dst, CAArch32Assembler::r1);
+
+	m_assembler.Ldr(dstReg, addressReg, CAArch32Assembler::MakeImmediateLdrAddress(0));
+	m_assembler.Rev(dstReg, dstReg);
+
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_AArch32::Emit_LoadFromRefBSwap_VarVarAny(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert((scale == 1) || (scale == 4));
+
+	auto dstReg = PrepareSymbolRegisterDef(dst, CAArch32Assembler::r0);
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, CAArch32Assembler::r1);
+
+	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x1000))
+	{
+		m_assembler.Ldr(dstReg, addressReg, CAArch32Assembler::MakeImmediateLdrAddress(scaledIndex));
+	}
+	else
+	{
+		auto indexReg = PrepareSymbolRegisterUse(src2, CAArch32Assembler::r2);
+		m_assembler.Ldr(dstReg, addressReg, MakeScaledLdrAddress(indexReg, scale));
+	}
+	m_assembler.Rev(dstReg, dstReg);
+
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_AArch32::Emit_Load16FromRefBSwap_VarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, CAArch32Assembler::r0);
+	auto dstReg = PrepareSymbolRegisterDef(dst, CAArch32Assembler::r1);
+
+	m_assembler.Ldrh(dstReg, addressReg, CAArch32Assembler::MakeImmediateLdrAddress(0));
+	m_assembler.Rev16(dstReg, dstReg);
+
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_AArch32::Emit_Load16FromRefBSwap_VarVarAny(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert(scale == 1);
+
+	auto dstReg = PrepareSymbolRegisterDef(dst, CAArch32Assembler::r0);
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, CAArch32Assembler::r1);
+
+	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x1000))
+	{
+		m_assembler.Ldrh(dstReg, addressReg, CAArch32Assembler::MakeImmediateLdrAddress(scaledIndex));
+	}
+	else
+	{
+		auto indexReg = PrepareSymbolRegisterUse(src2, CAArch32Assembler::r2);
+		m_assembler.Ldrh(dstReg, addressReg, MakeScaledLdrAddress(indexReg, scale));
+	}
+	m_assembler.Rev16(dstReg, dstReg);
+
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_AArch32::Emit_StoreAtRefBSwap_VarAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, CAArch32Assembler::r0);
+	auto valueReg = PrepareSymbolRegisterUse(src2, CAArch32Assembler::r1);
+	auto swapReg = CAArch32Assembler::r1;
+
+	m_assembler.Rev(swapReg, valueReg);
+	m_assembler.Str(swapReg, addressReg, CAArch32Assembler::MakeImmediateLdrAddress(0));
+}
+
+void CCodeGen_AArch32::Emit_StoreAtRefBSwap_VarAnyAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert((scale == 1) || (scale == 4));
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, CAArch32Assembler::r0);
+	auto valueReg = PrepareSymbolRegisterUse(src3, CAArch32Assembler::r2);
+	auto swapReg = CAArch32Assembler::r2;
+
+	m_assembler.Rev(swapReg, valueReg);
+
+	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x1000))
+	{
+		m_assembler.Str(swapReg, addressReg, CAArch32Assembler::MakeImmediateLdrAddress(scaledIndex));
+	}
+	else
+	{
+		auto indexReg = PrepareSymbolRegisterUse(src2, CAArch32Assembler::r1);
+		m_assembler.Str(swapReg, addressReg, MakeScaledLdrAddress(indexReg, scale));
+	}
+}
+
+void CCodeGen_AArch32::Emit_Store16AtRefBSwap_VarAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, CAArch32Assembler::r0);
+	auto valueReg = PrepareSymbolRegisterUse(src2, CAArch32Assembler::r1);
+	auto swapReg = CAArch32Assembler::r1;
+
+	m_assembler.Rev16(swapReg, valueReg);
+	m_assembler.Strh(swapReg, addressReg, CAArch32Assembler::MakeImmediateLdrAddress(0));
+}
+
+void CCodeGen_AArch32::Emit_Store16AtRefBSwap_VarAnyAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert(scale == 1);
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, CAArch32Assembler::r0);
+	auto valueReg = PrepareSymbolRegisterUse(src3, CAArch32Assembler::r2);
+	auto swapReg = CAArch32Assembler::r2;
+
+	m_assembler.Rev16(swapReg, valueReg);
+
+	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x1000))
+	{
+		m_assembler.Strh(swapReg, addressReg, CAArch32Assembler::MakeImmediateLdrAddress(scaledIndex));
+	}
+	else
+	{
+		auto indexReg = PrepareSymbolRegisterUse(src2, CAArch32Assembler::r1);
+		m_assembler.Strh(swapReg, addressReg, MakeScaledLdrAddress(indexReg, scale));
+	}
+}
@@ -289,6 +289,95 @@ void CCodeGen_AArch32::Emit_StoreAtRef_64_VarAnyAny(const STATEMENT& statement)
 	}
 }
 
+void CCodeGen_AArch32::Emit_LoadFromRefBSwap_64_MemVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, CAArch32Assembler::r2);
+	auto dstLoReg = CAArch32Assembler::r0;
+	auto dstHiReg = CAArch32Assembler::r1;
+
+	m_assembler.Ldrd(dstLoReg, addressReg, CAArch32Assembler::MakeImmediateLdrAddress(0));
+	m_assembler.Rev(dstLoReg, dstLoReg);
+	m_assembler.Rev(dstHiReg, dstHiReg);
+
+	//Swapping a 64-bit value also exchanges its halves
+	StoreRegistersInMemory64(dst, dstHiReg, dstLoReg);
+}
+
+void CCodeGen_AArch32::Emit_LoadFromRefBSwap_64_MemVarAny(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert(scale == 1);
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, CAArch32Assembler::r2);
+	auto dstLoReg = CAArch32Assembler::r0;
+	auto dstHiReg = CAArch32Assembler::r1;
+
+	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x1000))
+	{
+		m_assembler.Ldrd(dstLoReg, addressReg, CAArch32Assembler::MakeImmediateLdrAddress(scaledIndex));
+	}
+	else
+	{
+		auto indexReg = PrepareSymbolRegisterUse(src2, CAArch32Assembler::r3);
+		m_assembler.Ldrd(dstLoReg, addressReg, MakeScaledLdrAddress(indexReg, scale));
+	}
+	m_assembler.Rev(dstLoReg, dstLoReg);
+	m_assembler.Rev(dstHiReg, dstHiReg);
+
+	StoreRegistersInMemory64(dst, dstHiReg, dstLoReg);
+}
+
+void CCodeGen_AArch32::Emit_StoreAtRefBSwap_64_VarAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, CAArch32Assembler::r2);
+	auto valueLoReg = CAArch32Assembler::r0;
+	auto valueHiReg = CAArch32Assembler::r1;
+
+	//Load halves crossed so that Strd writes the swapped high word first
+	LoadSymbol64InRegisters(valueHiReg, valueLoReg, src2);
+	m_assembler.Rev(valueLoReg, valueLoReg);
+	m_assembler.Rev(valueHiReg, valueHiReg);
+	m_assembler.Strd(valueLoReg, addressReg, CAArch32Assembler::MakeImmediateLdrAddress(0));
+}
+
+void CCodeGen_AArch32::Emit_StoreAtRefBSwap_64_VarAnyAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert(scale == 1);
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, CAArch32Assembler::r2);
+	auto valueLoReg = CAArch32Assembler::r0;
+	auto valueHiReg = CAArch32Assembler::r1;
+
+	LoadSymbol64InRegisters(valueHiReg, valueLoReg, src3);
+	m_assembler.Rev(valueLoReg, valueLoReg);
+	m_assembler.Rev(valueHiReg, valueHiReg);
+
+	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x1000))
+	{
+		m_assembler.Strd(valueLoReg, addressReg, CAArch32Assembler::MakeImmediateLdrAddress(scaledIndex));
+	}
+	else
+	{
+		auto indexReg = PrepareSymbolRegisterUse(src2, CAArch32Assembler::r3);
+		m_assembler.Strd(valueLoReg, addressReg, MakeScaledLdrAddress(indexReg, scale));
+	}
+}
+
 void CCodeGen_AArch32::Emit_Add64_MemMemMem(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
@@ -939,6 +1028,12 @@ CCodeGen_AArch32::CONSTMATCHER CCodeGen_AArch32::g_64ConstMatchers[] =
 	{ OP_STOREATREF, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32,      MATCH_MEMORY64,   &CCodeGen_AArch32::Emit_StoreAtRef_64_VarAnyAny },
 	{ OP_STOREATREF, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32,      MATCH_CONSTANT64, &CCodeGen_AArch32::Emit_StoreAtRef_64_VarAnyAny },
 
+	{ OP_LOADFROMREFBSWAP, MATCH_MEMORY64, MATCH_VAR_REF, MATCH_NIL,   MATCH_NIL, &CCodeGen_AArch32::Emit_LoadFromRefBSwap_64_MemVar    },
+	{ OP_LOADFROMREFBSWAP, MATCH_MEMORY64, MATCH_VAR_REF, MATCH_ANY32, MATCH_NIL, &CCodeGen_AArch32::Emit_LoadFromRefBSwap_64_MemVarAny },
+
+	{ OP_STOREATREFBSWAP, MATCH_NIL, MATCH_VAR_REF, MATCH_MEMORY64, MATCH_NIL,      &CCodeGen_AArch32::Emit_StoreAtRefBSwap_64_VarAny    },
+	{ OP_STOREATREFBSWAP, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32,    MATCH_MEMORY64, &CCodeGen_AArch32::Emit_StoreAtRefBSwap_64_VarAnyAny },
+
 	{ OP_ADD64, MATCH_MEMORY64, MATCH_MEMORY64, MATCH_MEMORY64,   MATCH_NIL, &CCodeGen_AArch32::Emit_Add64_MemMemMem },
 	{ OP_ADD64, MATCH_MEMORY64, MATCH_MEMORY64, MATCH_CONSTANT64, MATCH_NIL, &CCodeGen_AArch32::Emit_Add64_MemMemCst },
 
@@ -85,6 +85,8 @@ CAArch64Assembler::REGISTER64 CCodeGen_AArch64::g_paramRegisters64[MAX_PARAM_REG
 // clang-format on
 
 CAArch64Assembler::REGISTER64 CCodeGen_AArch64::g_baseRegister = CAArch64Assembler::x19;
+//Same register as the last allocatable register, which is taken out of allocation when needed
+CAArch64Assembler::REGISTER64 CCodeGen_AArch64::g_memoryBaseRegister = CAArch64Assembler::x28;
 
 const LITERAL128 CCodeGen_AArch64::g_fpClampMask1(0x7F7FFFFF, 0x7F7FFFFF, 0x7F7FFFFF, 0x7F7FFFFF);
 const LITERAL128 CCodeGen_AArch64::g_fpClampMask2(0xFF7FFFFF, 0xFF7FFFFF, 0xFF7FFFFF, 0xFF7FFFFF);
@@ -99,6 +101,16 @@ static bool isShiftedMask(uint32 value)
 	return value && isMask((value - 1) | value);
 }
 
+static bool isMask64(uint64 value)
+{
+	return value && (((value + 1) & value) == 0);
+}
+
+static bool isShiftedMask64(uint64 value)
+{
+	return value && isMask64((value - 1) | value);
+}
+
 template <typename AddSubOp>
 void CCodeGen_AArch64::Emit_AddSub_VarAnyVar(const STATEMENT& statement)
 {
@@ -238,6 +250,60 @@ void CCodeGen_AArch64::Emit_Mul_Tmp64AnyAny(const STATEMENT& statement)
 	m_assembler.Str(dstReg, CAArch64Assembler::xSP, dst->m_stackLocation);
 }
 
+void CCodeGen_AArch64::Emit_AluFlag_Tmp64AnyAny(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	assert(dst->m_type == SYM_TEMPORARY64);
+
+	auto src1Reg = PrepareSymbolRegisterUse(src1, GetNextTempRegister());
+	auto src2Reg = PrepareSymbolRegisterUse(src2, GetNextTempRegister());
+	auto resultReg = GetNextTempRegister();
+	auto flagReg = GetNextTempRegister();
+
+	switch(statement.op)
+	{
+	case OP_ADDOVF:
+		m_assembler.Adds(resultReg, src1Reg, src2Reg);
+		m_assembler.Cset(flagReg, CAArch64Assembler::CONDITION_VS);
+		break;
+	case OP_ADDCARRY:
+		m_assembler.Adds(resultReg, src1Reg, src2Reg);
+		m_assembler.Cset(flagReg, CAArch64Assembler::CONDITION_CS);
+		break;
+	case OP_ADC:
+	{
+		//C is set if carry in is not 0 (carry in >= 1)
+		auto src3 = statement.src3->GetSymbol().get();
+		auto src3Reg = PrepareSymbolRegisterUse(src3, GetNextTempRegister());
+		m_assembler.Cmp(src3Reg, 1, CAArch64Assembler::ADDSUB_IMM_SHIFT_LSL0);
+		m_assembler.Adcs(resultReg, src1Reg, src2Reg);
+		m_assembler.Cset(flagReg, CAArch64Assembler::CONDITION_CS);
+	}
+	break;
+	case OP_SUBOVF:
+		m_assembler.Subs(resultReg, src1Reg, src2Reg);
+		m_assembler.Cset(flagReg, CAArch64Assembler::CONDITION_VS);
+		break;
+	case OP_SUBBORROW:
+		//C is cleared when a borrow occurs
+		m_assembler.Subs(resultReg, src1Reg, src2Reg);
+		m_assembler.Cset(flagReg, CAArch64Assembler::CONDITION_CC);
+		break;
+	default:
+		assert(false);
+		break;
+	}
+
+	m_assembler.Str(resultReg, CAArch64Assembler::xSP, dst->m_stackLocation + 0);
+	m_assembler.Str(flagReg, CAArch64Assembler::xSP, dst->m_stackLocation + 4);
+
+	//Stores don't modify the flags, a following flag branch can use them directly
+	m_liveFlagStatement = &statement;
+}
+
 template <bool isSigned>
 void CCodeGen_AArch64::Emit_Div_Tmp64AnyAny(const STATEMENT& statement)
 {
@@ -316,6 +382,22 @@ CCodeGen_AArch64::CONSTMATCHER CCodeGen_AArch64::g_constMatchers[] =
 	{ OP_STORE16ATREF,   MATCH_NIL,            MATCH_VAR_REF,        MATCH_ANY,           MATCH_NIL,      &CCodeGen_AArch64::Emit_Store16AtRef_VarAny                 },
 	{ OP_STORE16ATREF,   MATCH_NIL,            MATCH_VAR_REF,        MATCH_ANY,           MATCH_ANY,      &CCodeGen_AArch64::Emit_Store16AtRef_VarAnyAny              },
 
+	{ OP_LOADFROMREFBSWAP,    MATCH_VARIABLE,  MATCH_VAR_REF,        MATCH_NIL,           MATCH_NIL,      &CCodeGen_AArch64::Emit_LoadFromRefBSwap_VarVar             },
+	{ OP_LOADFROMREFBSWAP,    MATCH_VARIABLE,  MATCH_VAR_REF,        MATCH_ANY32,         MATCH_NIL,      &CCodeGen_AArch64::Emit_LoadFromRefBSwap_VarVarAny          },
+	{ OP_LOAD16FROMREFBSWAP,  MATCH_VARIABLE,  MATCH_VAR_REF,        MATCH_NIL,           MATCH_NIL,      &CCodeGen_AArch64::Emit_Load16FromRefBSwap_VarVar           },
+	{ OP_LOAD16FROMREFBSWAP,  MATCH_VARIABLE,  MATCH_VAR_REF,        MATCH_ANY32,         MATCH_NIL,      &CCodeGen_AArch64::Emit_Load16FromRefBSwap_VarVarAny        },
+	{ OP_STOREATREFBSWAP,     MATCH_NIL,       MATCH_VAR_REF,        MATCH_ANY32,         MATCH_NIL,      &CCodeGen_AArch64::Emit_StoreAtRefBSwap_VarAny              },
+	{ OP_STOREATREFBSWAP,     MATCH_NIL,       MATCH_VAR_REF,        MATCH_ANY32,         MATCH_ANY32,    &CCodeGen_AArch64::Emit_StoreAtRefBSwap_VarAnyAny           },
+	{ OP_STORE16ATREFBSWAP,   MATCH_NIL,       MATCH_VAR_REF,        MATCH_ANY32,         MATCH_NIL,      &CCodeGen_AArch64::Emit_Store16AtRefBSwap_VarAny            },
+	{ OP_STORE16ATREFBSWAP,   MATCH_NIL,       MATCH_VAR_REF,        MATCH_ANY32,         MATCH_ANY32,    &CCodeGen_AArch64::Emit_Store16AtRefBSwap_VarAnyAny         },
+
+	{ OP_LOADFROMMEMBASE,     MATCH_VARIABLE,  MATCH_ANY,            MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_AArch64::Emit_LoadFromMemBase_VarAnyCst           },
+	{ OP_LOAD8FROMMEMBASE,    MATCH_VARIABLE,  MATCH_ANY,            MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_AArch64::Emit_Load8FromMemBase_VarAnyCst          },
+	{ OP_LOAD16FROMMEMBASE,   MATCH_VARIABLE,  MATCH_ANY,            MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_AArch64::Emit_Load16FromMemBase_VarAnyCst         },
+	{ OP_STOREATMEMBASE,      MATCH_NIL,       MATCH_ANY,            MATCH_CONSTANT,      MATCH_ANY,      &CCodeGen_AArch64::Emit_StoreAtMemBase_AnyCstAny            },
+	{ OP_STORE8ATMEMBASE,     MATCH_NIL,       MATCH_ANY,            MATCH_CONSTANT,      MATCH_ANY,      &CCodeGen_AArch64::Emit_Store8AtMemBase_AnyCstAny           },
+	{ OP_STORE16ATMEMBASE,    MATCH_NIL,       MATCH_ANY,            MATCH_CONSTANT,      MATCH_ANY,      &CCodeGen_AArch64::Emit_Store16AtMemBase_AnyCstAny          },
+
 	{ OP_PARAM,          MATCH_NIL,            MATCH_CONTEXT,        MATCH_NIL,           MATCH_NIL,      &CCodeGen_AArch64::Emit_Param_Ctx                           },
 	{ OP_PARAM,          MATCH_NIL,            MATCH_REGISTER,       MATCH_NIL,           MATCH_NIL,      &CCodeGen_AArch64::Emit_Param_Reg                           },
 	{ OP_PARAM,          MATCH_NIL,            MATCH_MEMORY,         MATCH_NIL,           MATCH_NIL,      &CCodeGen_AArch64::Emit_Param_Mem                           },
@@ -342,6 +424,7 @@ CCodeGen_AArch64::CONSTMATCHER CCodeGen_AArch64::g_constMatchers[] =
 	{ OP_CONDJMP,        MATCH_NIL,            MATCH_VARIABLE,       MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_AArch64::Emit_CondJmp_VarCst                      },
 	
 	{ OP_CONDJMP,        MATCH_NIL,            MATCH_VAR_REF,        MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_AArch64::Emit_CondJmp_Ref_VarCst                  },
+	{ OP_CONDJMP,        MATCH_NIL,            MATCH_TEMPORARY64,    MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_AArch64::Emit_CondJmp_Tmp64Cst                    },
 	
 	{ OP_CMP,            MATCH_VARIABLE,       MATCH_ANY,            MATCH_VARIABLE,      MATCH_NIL,      &CCodeGen_AArch64::Emit_Cmp_VarAnyVar                       },
 	{ OP_CMP,            MATCH_VARIABLE,       MATCH_VARIABLE,       MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_AArch64::Emit_Cmp_VarVarCst                       },
@@ -366,10 +449,17 @@ CCodeGen_AArch64::CONSTMATCHER CCodeGen_AArch64::g_constMatchers[] =
 	{ OP_MUL,            MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_NIL,      &CCodeGen_AArch64::Emit_Mul_Tmp64AnyAny<false>              },
 	{ OP_MULS,           MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_NIL,      &CCodeGen_AArch64::Emit_Mul_Tmp64AnyAny<true>               },
 
+	{ OP_ADDOVF,         MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_NIL,      &CCodeGen_AArch64::Emit_AluFlag_Tmp64AnyAny                 },
+	{ OP_ADDCARRY,       MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_NIL,      &CCodeGen_AArch64::Emit_AluFlag_Tmp64AnyAny                 },
+	{ OP_ADC,            MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_ANY,      &CCodeGen_AArch64::Emit_AluFlag_Tmp64AnyAny                 },
+	{ OP_SUBOVF,         MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_NIL,      &CCodeGen_AArch64::Emit_AluFlag_Tmp64AnyAny                 },
+	{ OP_SUBBORROW,      MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_NIL,      &CCodeGen_AArch64::Emit_AluFlag_Tmp64AnyAny                 },
+
 	{ OP_DIV,            MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_NIL,      &CCodeGen_AArch64::Emit_Div_Tmp64AnyAny<false>              },
 	{ OP_DIVS,           MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_NIL,      &CCodeGen_AArch64::Emit_Div_Tmp64AnyAny<true>               },
 	
 	{ OP_LABEL,          MATCH_NIL,            MATCH_NIL,            MATCH_NIL,           MATCH_NIL,      &CCodeGen_AArch64::MarkLabel                                },
+	{ OP_LABEL_COLD,     MATCH_NIL,            MATCH_NIL,            MATCH_NIL,           MATCH_NIL,      &CCodeGen_AArch64::MarkColdLabel                            },
 
 	{ OP_MOV,            MATCH_NIL,            MATCH_NIL,            MATCH_NIL,           MATCH_NIL,      nullptr                                                     },
 };
@@ -405,7 +495,7 @@ void CCodeGen_AArch64::SetGenerateRelocatableCalls(bool generateRelocatableCalls
 
 unsigned int CCodeGen_AArch64::GetAvailableRegisterCount() const
 {
-	return MAX_REGISTERS;
+	return HasMemoryBase() ? (MAX_REGISTERS - 1) : MAX_REGISTERS;
 }
 
 unsigned int CCodeGen_AArch64::GetAvailableMdRegisterCount() const
@@ -428,6 +518,36 @@ bool CCodeGen_AArch64::SupportsExternalJumps() const
 	return true;
 }
 
+bool CCodeGen_AArch64::SupportsBlockPlacement() const
+{
+	return true;
+}
+
+bool CCodeGen_AArch64::SupportsColdRegion() const
+{
+	return true;
+}
+
+bool CCodeGen_AArch64::SupportsMemoryBase() const
+{
+	return true;
+}
+
+bool CCodeGen_AArch64::SupportsRefIndexDisplacement() const
+{
+	return true;
+}
+
+bool CCodeGen_AArch64::SupportsAluFlagBranches() const
+{
+	return true;
+}
+
+bool CCodeGen_AArch64::SupportsNestedLoops() const
+{
+	return true;
+}
+
 uint32 CCodeGen_AArch64::GetPointerSize() const
 {
 	return 8;
@@ -439,6 +559,12 @@ void CCodeGen_AArch64::SetStream(Framework::CStream* stream)
 	m_assembler.SetStream(stream);
 }
 
+void CCodeGen_AArch64::SetColdStream(Framework::CStream* stream)
+{
+	m_coldStream = stream;
+	m_assembler.SetColdStream(stream);
+}
+
 void CCodeGen_AArch64::RegisterExternalSymbols(CObjectFile* objectFile) const
 {
 }
@@ -447,6 +573,24 @@ void CCodeGen_AArch64::GenerateCode(const StatementList& statements, unsigned in
 {
 	m_nextTempRegister = 0;
 	m_nextTempRegisterMd = 0;
+	m_codeRegionRelocations.clear();
+	m_liveFlagStatement = nullptr;
+	ClearConstantCache();
+
+	if(m_coldStream && m_externalSymbolReferencedHandler)
+	{
+		throw std::runtime_error("Cold code region can't be used when referencing external symbols.");
+	}
+
+	//Branches need to know in which region their target will be before it is emitted
+	m_coldBlockIds.clear();
+	for(const auto& statement : statements)
+	{
+		if(statement.op != OP_LABEL_COLD) continue;
+		m_coldBlockIds.insert(statement.jmpBlock);
+	}
+	m_inColdRegion = false;
+	m_assembler.SetColdRegion(false);
 
 	//Align stack size (must be aligned on 16 bytes boundary)
 	stackSize = (stackSize + 0xF) & ~0xF;
@@ -457,6 +601,9 @@ void CCodeGen_AArch64::GenerateCode(const StatementList& statements, unsigned in
 
 	for(const auto& statement : statements)
 	{
+		//Statement boundaries are safe places to put veneers and literals if some are about to go out of range
+		m_assembler.EmitIslandIfNeeded();
+
 		bool found = false;
 		auto begin = m_matchers.lower_bound(statement.op);
 		auto end = m_matchers.upper_bound(statement.op);
@@ -477,12 +624,18 @@ void CCodeGen_AArch64::GenerateCode(const StatementList& statements, unsigned in
 		{
 			throw std::runtime_error("No suitable emitter found for statement.");
 		}
+		UpdateLiveFlags(statement);
 	}
 
+	//Epilog always goes in the hot region
+	m_inColdRegion = false;
+	m_assembler.SetColdRegion(false);
+
 	Emit_Epilog();
 	m_assembler.Ret();
 
 	m_assembler.ResolveLabelReferences();
+	m_codeRegionRelocations = m_assembler.GetRegionRelocations();
 	m_assembler.ClearLabels();
 	m_assembler.ResolveLiteralReferences();
 	m_labels.clear();
@@ -523,6 +676,7 @@ uint32 CCodeGen_AArch64::GetMaxParamSpillSize(const StatementList& statements)
 
 CAArch64Assembler::REGISTER32 CCodeGen_AArch64::GetNextTempRegister()
 {
+	m_constantCache[m_nextTempRegister].valid = false;
 	auto result = g_tempRegisters[m_nextTempRegister];
 	m_nextTempRegister++;
 	m_nextTempRegister %= MAX_TEMP_REGS;
@@ -531,6 +685,7 @@ CAArch64Assembler::REGISTER32 CCodeGen_AArch64::GetNextTempRegister()
 
 CAArch64Assembler::REGISTER64 CCodeGen_AArch64::GetNextTempRegister64()
 {
+	m_constantCache[m_nextTempRegister].valid = false;
 	auto result = g_tempRegisters64[m_nextTempRegister];
 	m_nextTempRegister++;
 	m_nextTempRegister %= MAX_TEMP_REGS;
@@ -581,6 +736,7 @@ void CCodeGen_AArch64::StoreRegisterInMemory(CSymbol* dst, CAArch64Assembler::RE
 
 void CCodeGen_AArch64::LoadConstantInRegister(CAArch64Assembler::REGISTER32 registerId, uint32 constant)
 {
+	LOGICAL_IMM_PARAMS logicalImmParams;
 	if((constant & 0x0000FFFF) == constant)
 	{
 		m_assembler.Movz(registerId, static_cast<uint16>(constant & 0xFFFF), 0);
@@ -597,13 +753,69 @@ void CCodeGen_AArch64::LoadConstantInRegister(CAArch64Assembler::REGISTER32 regi
 	{
 		m_assembler.Movn(registerId, static_cast<uint16>(~constant >> 16), 1);
 	}
-	else
+	else if(TryGetLogicalImmParams(constant, logicalImmParams))
+	{
+		m_assembler.Orr(registerId, CAArch64Assembler::wZR, logicalImmParams.n, logicalImmParams.immr, logicalImmParams.imms);
+	}
+	else if(!TryLoadCachedConstantInRegister(registerId, constant))
 	{
 		m_assembler.Movz(registerId, static_cast<uint16>(constant & 0xFFFF), 0);
 		m_assembler.Movk(registerId, static_cast<uint16>(constant >> 16), 1);
 	}
 }
 
+bool CCodeGen_AArch64::TryLoadCachedConstantInRegister(CAArch64Assembler::REGISTER32 registerId, uint32 constant)
+{
+	//Materializing this constant takes 2 instructions, see if we can get it in one
+	//from a constant that's still live in another temporary register
+	for(unsigned int i = 0; i < MAX_TEMP_REGS; i++)
+	{
+		const auto& cachedConstant = m_constantCache[i];
+		if(!cachedConstant.valid || (g_tempRegisters[i] == registerId)) continue;
+		if(cachedConstant.value != constant) continue;
+		m_assembler.Mov(registerId, g_tempRegisters[i]);
+		return true;
+	}
+
+	ADDSUB_IMM_PARAMS addSubImmParams;
+	for(unsigned int i = 0; i < MAX_TEMP_REGS; i++)
+	{
+		const auto& cachedConstant = m_constantCache[i];
+		if(!cachedConstant.valid || (g_tempRegisters[i] == registerId)) continue;
+		if(TryGetAddSubImmParams(constant - cachedConstant.value, addSubImmParams))
+		{
+			m_assembler.Add(registerId, g_tempRegisters[i], addSubImmParams.imm, addSubImmParams.shiftType);
+			return true;
+		}
+		if(TryGetAddSubImmParams(cachedConstant.value - constant, addSubImmParams))
+		{
+			m_assembler.Sub(registerId, g_tempRegisters[i], addSubImmParams.imm, addSubImmParams.shiftType);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void CCodeGen_AArch64::CacheConstantInTempRegister(CAArch64Assembler::REGISTER32 registerId, uint32 constant)
+{
+	for(unsigned int i = 0; i < MAX_TEMP_REGS; i++)
+	{
+		if(g_tempRegisters[i] != registerId) continue;
+		m_constantCache[i].valid = true;
+		m_constantCache[i].value = constant;
+		break;
+	}
+}
+
+void CCodeGen_AArch64::ClearConstantCache()
+{
+	for(auto& cachedConstant : m_constantCache)
+	{
+		cachedConstant = CACHED_CONSTANT();
+	}
+}
+
 void CCodeGen_AArch64::LoadMemoryReferenceInRegister(CAArch64Assembler::REGISTER64 registerId, CSymbol* src)
 {
 	switch(src->m_type)
@@ -659,7 +871,10 @@ CAArch64Assembler::REGISTER32 CCodeGen_AArch64::PrepareSymbolRegisterUse(CSymbol
 		return preferedRegister;
 		break;
 	case SYM_CONSTANT:
+		//Registers returned here are never written to by emitters, the constant
+		//can be reused until the temporary register is handed out again
 		LoadConstantInRegister(preferedRegister, symbol->m_valueLow);
+		CacheConstantInTempRegister(preferedRegister, symbol->m_valueLow);
 		return preferedRegister;
 		break;
 	default:
@@ -722,6 +937,27 @@ CAArch64Assembler::REGISTER64 CCodeGen_AArch64::PrepareSymbolRegisterUseRef(CSym
 	}
 }
 
+CAArch64Assembler::REGISTER64 CCodeGen_AArch64::PrepareRefBaseRegisterUse(CSymbol* symbol, uint32 displacement)
+{
+	//Indexed accesses only have a register offset form, displacement needs to be added to the base
+	auto baseRegister = PrepareSymbolRegisterUseRef(symbol, GetNextTempRegister64());
+	if(displacement == 0)
+	{
+		return baseRegister;
+	}
+	auto addressRegister = GetNextTempRegister64();
+	if(displacement < 0x1000)
+	{
+		m_assembler.Add(addressRegister, baseRegister, static_cast<uint16>(displacement), CAArch64Assembler::ADDSUB_IMM_SHIFT_LSL0);
+	}
+	else
+	{
+		LoadConstantInRegister(static_cast<CAArch64Assembler::REGISTER32>(addressRegister), displacement);
+		m_assembler.Add(addressRegister, baseRegister, addressRegister);
+	}
+	return addressRegister;
+}
+
 void CCodeGen_AArch64::CommitSymbolRegisterRef(CSymbol* symbol, CAArch64Assembler::REGISTER64 usedRegister)
 {
 	switch(symbol->m_type)
@@ -836,13 +1072,13 @@ bool CCodeGen_AArch64::TryGetLogicalImmParams(uint32 imm, LOGICAL_IMM_PARAMS& pa
 {
 	//Algorithm from LLVM, 'processLogicalImmediate' function
 
-	if((imm == 0) || (imm == ~0))
+	if((imm == 0) || (imm == ~0U))
 	{
 		return false;
 	}
 
 	int size = 32;
-	while(true)
+	do
 	{
 		size /= 2;
 		uint32 mask = (1 << size) - 1;
@@ -851,11 +1087,10 @@ bool CCodeGen_AArch64::TryGetLogicalImmParams(uint32 imm, LOGICAL_IMM_PARAMS& pa
 			size *= 2;
 			break;
 		}
-		if(size > 2) break;
-	}
+	} while(size > 2);
 
 	uint32 cto = 0, i = 0;
-	uint32 mask = (~0) >> (32 - size);
+	uint32 mask = (~0U) >> (32 - size);
 	imm &= mask;
 
 	if(isShiftedMask(imm))
@@ -888,6 +1123,61 @@ bool CCodeGen_AArch64::TryGetLogicalImmParams(uint32 imm, LOGICAL_IMM_PARAMS& pa
 	return true;
 }
 
+bool CCodeGen_AArch64::TryGetLogicalImm64Params(uint64 imm, LOGICAL_IMM_PARAMS& params)
+{
+	//Same as above, but element size can go up to 64 bits
+
+	if((imm == 0) || (imm == ~0ULL))
+	{
+		return false;
+	}
+
+	uint32 size = 64;
+	do
+	{
+		size /= 2;
+		uint64 mask = (1ULL << size) - 1;
+		if((imm & mask) != ((imm >> size) & mask))
+		{
+			size *= 2;
+			break;
+		}
+	} while(size > 2);
+
+	uint32 cto = 0, i = 0;
+	uint64 mask = (~0ULL) >> (64 - size);
+	imm &= mask;
+
+	if(isShiftedMask64(imm))
+	{
+		i = __builtin_ctzll(imm);
+		cto = __builtin_ctzll(~(imm >> i));
+	}
+	else
+	{
+		imm |= ~mask;
+		if(!isShiftedMask64(~imm))
+		{
+			return false;
+		}
+		uint32 clo = __builtin_clzll(~imm);
+		i = 64 - clo;
+		cto = clo + __builtin_ctzll(~imm) - (64 - size);
+	}
+
+	assert(size > i);
+	params.immr = (size - i) & (size - 1);
+
+	uint64 nimms = ~static_cast<uint64>(size - 1) << 1;
+	nimms |= (cto - 1);
+
+	params.n = ((nimms >> 6) & 1) ^ 1;
+
+	params.imms = nimms & 0x3F;
+
+	return true;
+}
+
 uint16 CCodeGen_AArch64::GetSavedRegisterList(uint32 registerUsage)
 {
 	uint16 registerSave = 0;
@@ -899,6 +1189,10 @@ uint16 CCodeGen_AArch64::GetSavedRegisterList(uint32 registerUsage)
 		}
 	}
 	registerSave |= (1 << (g_baseRegister / 2));
+	if(HasMemoryBase())
+	{
+		registerSave |= (1 << (g_memoryBaseRegister / 2));
+	}
 	return registerSave;
 }
 
@@ -924,6 +1218,19 @@ void CCodeGen_AArch64::Emit_Prolog(const StatementList& statements, uint32 stack
 		m_assembler.Sub(CAArch64Assembler::xSP, CAArch64Assembler::xSP, totalStackAlloc, CAArch64Assembler::ADDSUB_IMM_SHIFT_LSL0);
 	}
 	m_assembler.Mov(g_baseRegister, CAArch64Assembler::x0);
+	if(HasMemoryBase())
+	{
+		if(((m_memoryBaseOffset & 0x07) == 0) && ((m_memoryBaseOffset / 8) < 0x1000))
+		{
+			m_assembler.Ldr(g_memoryBaseRegister, g_baseRegister, m_memoryBaseOffset);
+		}
+		else
+		{
+			//Offset can't be encoded in the load, use the memory base register to hold it
+			LoadConstantInRegister(static_cast<CAArch64Assembler::REGISTER32>(g_memoryBaseRegister), m_memoryBaseOffset);
+			m_assembler.Ldr(g_memoryBaseRegister, g_baseRegister, g_memoryBaseRegister, false);
+		}
+	}
 }
 
 void CCodeGen_AArch64::Emit_Epilog()
@@ -958,9 +1265,27 @@ CAArch64Assembler::LABEL CCodeGen_AArch64::GetLabel(uint32 blockId)
 	return result;
 }
 
+bool CCodeGen_AArch64::IsInOtherCodeRegion(uint32 blockId) const
+{
+	bool isCold = (m_coldBlockIds.find(blockId) != std::end(m_coldBlockIds));
+	return isCold != m_inColdRegion;
+}
+
 void CCodeGen_AArch64::MarkLabel(const STATEMENT& statement)
 {
 	auto label = GetLabel(statement.jmpBlock);
+	ClearConstantCache();
+	m_inColdRegion = false;
+	m_assembler.SetColdRegion(false);
+	m_assembler.MarkLabel(label);
+}
+
+void CCodeGen_AArch64::MarkColdLabel(const STATEMENT& statement)
+{
+	auto label = GetLabel(statement.jmpBlock);
+	ClearConstantCache();
+	m_inColdRegion = true;
+	m_assembler.SetColdRegion(true);
 	m_assembler.MarkLabel(label);
 }
 
@@ -1170,7 +1495,7 @@ void CCodeGen_AArch64::Emit_LoadFromRef_VarVarAny(const STATEMENT& statement)
 	assert((scale == 1) || (scale == 4));
 
 	auto valueReg = PrepareSymbolRegisterDef(dst, GetNextTempRegister());
-	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
 
 	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x4000))
 	{
@@ -1246,7 +1571,7 @@ void CCodeGen_AArch64::Emit_Load8FromRef_MemVarAny(const STATEMENT& statement)
 	assert(scale == 1);
 
 	auto valueReg = PrepareSymbolRegisterDef(dst, GetNextTempRegister());
-	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
 
 	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x1000))
 	{
@@ -1284,7 +1609,7 @@ void CCodeGen_AArch64::Emit_Load16FromRef_MemVarAny(const STATEMENT& statement)
 	assert(scale == 1);
 
 	auto valueReg = PrepareSymbolRegisterDef(dst, GetNextTempRegister());
-	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
 
 	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x2000))
 	{
@@ -1319,7 +1644,7 @@ void CCodeGen_AArch64::Emit_StoreAtRef_VarAnyAny(const STATEMENT& statement)
 
 	assert((scale == 1) || (scale == 4));
 
-	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
 	auto valueReg = PrepareSymbolRegisterUse(src3, GetNextTempRegister());
 
 	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x4000))
@@ -1353,7 +1678,7 @@ void CCodeGen_AArch64::Emit_Store8AtRef_VarAnyAny(const STATEMENT& statement)
 
 	assert(scale == 1);
 
-	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
 	auto valueReg = PrepareSymbolRegisterUse(src3, GetNextTempRegister());
 
 	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x1000))
@@ -1387,7 +1712,7 @@ void CCodeGen_AArch64::Emit_Store16AtRef_VarAnyAny(const STATEMENT& statement)
 
 	assert(scale == 1);
 
-	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
 	auto valueReg = PrepareSymbolRegisterUse(src3, GetNextTempRegister());
 
 	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x2000))
@@ -1401,6 +1726,164 @@ void CCodeGen_AArch64::Emit_Store16AtRef_VarAnyAny(const STATEMENT& statement)
 	}
 }
 
+void CCodeGen_AArch64::Emit_LoadFromRefBSwap_VarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto dstReg = PrepareSymbolRegisterDef(dst, GetNextTempRegister());
+
+	m_assembler.Ldr(dstReg, addressReg, 0);
+	m_assembler.Rev(dstReg, dstReg);
+
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_AArch64::Emit_LoadFromRefBSwap_VarVarAny(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert((scale == 1) || (scale == 4));
+
+	auto valueReg = PrepareSymbolRegisterDef(dst, GetNextTempRegister());
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
+
+	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x4000))
+	{
+		m_assembler.Ldr(valueReg, addressReg, scaledIndex);
+	}
+	else
+	{
+		auto indexReg = PrepareSymbolRegisterUse(src2, GetNextTempRegister());
+		m_assembler.Ldr(valueReg, addressReg, static_cast<CAArch64Assembler::REGISTER64>(indexReg), (scale == 4));
+	}
+	m_assembler.Rev(valueReg, valueReg);
+
+	CommitSymbolRegister(dst, valueReg);
+}
+
+void CCodeGen_AArch64::Emit_Load16FromRefBSwap_VarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto dstReg = PrepareSymbolRegisterDef(dst, GetNextTempRegister());
+
+	m_assembler.Ldrh(dstReg, addressReg, 0);
+	m_assembler.Rev16(dstReg, dstReg);
+
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_AArch64::Emit_Load16FromRefBSwap_VarVarAny(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert(scale == 1);
+
+	auto valueReg = PrepareSymbolRegisterDef(dst, GetNextTempRegister());
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
+
+	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x2000))
+	{
+		m_assembler.Ldrh(valueReg, addressReg, scaledIndex);
+	}
+	else
+	{
+		auto indexReg = PrepareSymbolRegisterUse(src2, GetNextTempRegister());
+		m_assembler.Ldrh(valueReg, addressReg, static_cast<CAArch64Assembler::REGISTER64>(indexReg), false);
+	}
+	m_assembler.Rev16(valueReg, valueReg);
+
+	CommitSymbolRegister(dst, valueReg);
+}
+
+void CCodeGen_AArch64::Emit_StoreAtRefBSwap_VarAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto valueReg = PrepareSymbolRegisterUse(src2, GetNextTempRegister());
+	auto swapReg = GetNextTempRegister();
+
+	m_assembler.Rev(swapReg, valueReg);
+	m_assembler.Str(swapReg, addressReg, 0);
+}
+
+void CCodeGen_AArch64::Emit_StoreAtRefBSwap_VarAnyAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert((scale == 1) || (scale == 4));
+
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
+	auto valueReg = PrepareSymbolRegisterUse(src3, GetNextTempRegister());
+	auto swapReg = GetNextTempRegister();
+
+	m_assembler.Rev(swapReg, valueReg);
+
+	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x4000))
+	{
+		m_assembler.Str(swapReg, addressReg, scaledIndex);
+	}
+	else
+	{
+		auto indexReg = PrepareSymbolRegisterUse(src2, GetNextTempRegister());
+		m_assembler.Str(swapReg, addressReg, static_cast<CAArch64Assembler::REGISTER64>(indexReg), (scale == 4));
+	}
+}
+
+void CCodeGen_AArch64::Emit_Store16AtRefBSwap_VarAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto valueReg = PrepareSymbolRegisterUse(src2, GetNextTempRegister());
+	auto swapReg = GetNextTempRegister();
+
+	m_assembler.Rev16(swapReg, valueReg);
+	m_assembler.Strh(swapReg, addressReg, 0);
+}
+
+void CCodeGen_AArch64::Emit_Store16AtRefBSwap_VarAnyAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert(scale == 1);
+
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
+	auto valueReg = PrepareSymbolRegisterUse(src3, GetNextTempRegister());
+	auto swapReg = GetNextTempRegister();
+
+	m_assembler.Rev16(swapReg, valueReg);
+
+	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x2000))
+	{
+		m_assembler.Strh(swapReg, addressReg, scaledIndex);
+	}
+	else
+	{
+		auto indexReg = PrepareSymbolRegisterUse(src2, GetNextTempRegister());
+		m_assembler.Strh(swapReg, addressReg, static_cast<CAArch64Assembler::REGISTER64>(indexReg), false);
+	}
+}
+
 void CCodeGen_AArch64::Emit_Param_Ctx(const STATEMENT& statement)
 {
 	FRAMEWORK_MAYBE_UNUSED auto src1 = statement.src1->GetSymbol().get();
@@ -1537,6 +2020,9 @@ void CCodeGen_AArch64::Emit_Call(const STATEMENT& statement)
 		LoadConstant64InRegister(fctAddressReg, src1->GetConstantPtr());
 		m_assembler.Blr(fctAddressReg);
 	}
+
+	//Temporary registers are caller saved
+	ClearConstantCache();
 }
 
 void CCodeGen_AArch64::Emit_RetVal_Reg(const STATEMENT& statement)
@@ -1613,7 +2099,7 @@ void CCodeGen_AArch64::Emit_ExternJmpDynamic(const STATEMENT& statement)
 	m_assembler.Mov(g_paramRegisters64[0], g_baseRegister);
 	Emit_Epilog();
 	auto fctAddressReg = GetNextTempRegister64();
-	m_assembler.Ldr_Pc(fctAddressReg, 8);
+	m_assembler.Ldr_Pc(fctAddressReg, 8U);
 	m_assembler.Br(fctAddressReg);
 
 	//Write target function address
@@ -1622,7 +2108,7 @@ void CCodeGen_AArch64::Emit_ExternJmpDynamic(const STATEMENT& statement)
 		auto position = m_stream->GetLength();
 		m_externalSymbolReferencedHandler(src1->GetConstantPtr(), position, CCodeGen::SYMBOL_REF_TYPE::NATIVE_POINTER);
 	}
-	m_stream->Write64(src1->GetConstantPtr());
+	(m_inColdRegion ? m_coldStream : m_stream)->Write64(src1->GetConstantPtr());
 }
 
 void CCodeGen_AArch64::Emit_Jmp(const STATEMENT& statement)
@@ -1632,44 +2118,64 @@ void CCodeGen_AArch64::Emit_Jmp(const STATEMENT& statement)
 
 void CCodeGen_AArch64::Emit_CondJmp(const STATEMENT& statement)
 {
-	auto label = GetLabel(statement.jmpBlock);
-
+	CAArch64Assembler::CONDITION condition = CAArch64Assembler::CONDITION_AL;
 	switch(statement.jmpCondition)
 	{
 	case CONDITION_EQ:
-		m_assembler.BCc(CAArch64Assembler::CONDITION_EQ, label);
+		condition = CAArch64Assembler::CONDITION_EQ;
 		break;
 	case CONDITION_NE:
-		m_assembler.BCc(CAArch64Assembler::CONDITION_NE, label);
+		condition = CAArch64Assembler::CONDITION_NE;
 		break;
 	case CONDITION_BL:
-		m_assembler.BCc(CAArch64Assembler::CONDITION_CC, label);
+		condition = CAArch64Assembler::CONDITION_CC;
 		break;
 	case CONDITION_BE:
-		m_assembler.BCc(CAArch64Assembler::CONDITION_LS, label);
+		condition = CAArch64Assembler::CONDITION_LS;
 		break;
 	case CONDITION_AB:
-		m_assembler.BCc(CAArch64Assembler::CONDITION_HI, label);
+		condition = CAArch64Assembler::CONDITION_HI;
 		break;
 	case CONDITION_AE:
-		m_assembler.BCc(CAArch64Assembler::CONDITION_CS, label);
+		condition = CAArch64Assembler::CONDITION_CS;
 		break;
 	case CONDITION_LT:
-		m_assembler.BCc(CAArch64Assembler::CONDITION_LT, label);
+		condition = CAArch64Assembler::CONDITION_LT;
 		break;
 	case CONDITION_LE:
-		m_assembler.BCc(CAArch64Assembler::CONDITION_LE, label);
+		condition = CAArch64Assembler::CONDITION_LE;
 		break;
 	case CONDITION_GT:
-		m_assembler.BCc(CAArch64Assembler::CONDITION_GT, label);
+		condition = CAArch64Assembler::CONDITION_GT;
 		break;
 	case CONDITION_GE:
-		m_assembler.BCc(CAArch64Assembler::CONDITION_GE, label);
+		condition = CAArch64Assembler::CONDITION_GE;
 		break;
 	default:
 		assert(0);
 		break;
 	}
+
+	CondJmp_JumpTo(statement.jmpBlock, condition);
+}
+
+void CCodeGen_AArch64::CondJmp_JumpTo(uint32 jmpBlock, CAArch64Assembler::CONDITION condition)
+{
+	auto label = GetLabel(jmpBlock);
+
+	if(IsInOtherCodeRegion(jmpBlock))
+	{
+		//B.cond can't reach the other region, skip over an unconditional branch instead
+		//(conditions are encoded in pairs, flipping the lowest bit gives the opposite one)
+		auto skipLabel = m_assembler.CreateLabel();
+		m_assembler.BCc(static_cast<CAArch64Assembler::CONDITION>(condition ^ 1), skipLabel);
+		m_assembler.B(label);
+		m_assembler.MarkLabel(skipLabel);
+	}
+	else
+	{
+		m_assembler.BCc(condition, label);
+	}
 }
 
 void CCodeGen_AArch64::Emit_CondJmp_AnyVar(const STATEMENT& statement)
@@ -1695,17 +2201,21 @@ void CCodeGen_AArch64::Emit_CondJmp_VarCst(const STATEMENT& statement)
 	{
 		auto label = GetLabel(statement.jmpBlock);
 
-		switch(statement.jmpCondition)
+		//CBZ/CBNZ can't reach the other region, skip over an unconditional branch instead
+		bool otherRegion = IsInOtherCodeRegion(statement.jmpBlock);
+		auto branchLabel = otherRegion ? m_assembler.CreateLabel() : label;
+		if((statement.jmpCondition == CONDITION_EQ) != otherRegion)
 		{
-		case CONDITION_EQ:
-			m_assembler.Cbz(src1Reg, label);
-			break;
-		case CONDITION_NE:
-			m_assembler.Cbnz(src1Reg, label);
-			break;
-		default:
-			assert(false);
-			break;
+			m_assembler.Cbz(src1Reg, branchLabel);
+		}
+		else
+		{
+			m_assembler.Cbnz(src1Reg, branchLabel);
+		}
+		if(otherRegion)
+		{
+			m_assembler.B(label);
+			m_assembler.MarkLabel(branchLabel);
 		}
 	}
 	else
@@ -1741,18 +2251,64 @@ void CCodeGen_AArch64::Emit_CondJmp_Ref_VarCst(const STATEMENT& statement)
 	assert((statement.jmpCondition == CONDITION_NE) || (statement.jmpCondition == CONDITION_EQ));
 
 	auto label = GetLabel(statement.jmpBlock);
-	switch(statement.jmpCondition)
+	bool otherRegion = IsInOtherCodeRegion(statement.jmpBlock);
+	auto branchLabel = otherRegion ? m_assembler.CreateLabel() : label;
+	if((statement.jmpCondition == CONDITION_EQ) != otherRegion)
 	{
-	case CONDITION_EQ:
-		m_assembler.Cbz(src1Reg, label);
+		m_assembler.Cbz(src1Reg, branchLabel);
+	}
+	else
+	{
+		m_assembler.Cbnz(src1Reg, branchLabel);
+	}
+	if(otherRegion)
+	{
+		m_assembler.B(label);
+		m_assembler.MarkLabel(branchLabel);
+	}
+}
+
+void CCodeGen_AArch64::Emit_CondJmp_Tmp64Cst(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	FRAMEWORK_MAYBE_UNUSED auto src2 = statement.src2->GetSymbol().get();
+
+	assert(src1->m_type == SYM_TEMPORARY64);
+	assert(src2->m_type == SYM_CONSTANT);
+	assert(src2->m_valueLow == 0);
+	assert((statement.jmpCondition == CONDITION_NE) || (statement.jmpCondition == CONDITION_EQ));
+
+	//Condition under which the flag is set
+	CAArch64Assembler::CONDITION condition = CAArch64Assembler::CONDITION_NE;
+	switch(GetLiveFlagOperation(statement))
+	{
+	case OP_ADDOVF:
+	case OP_SUBOVF:
+		condition = CAArch64Assembler::CONDITION_VS;
 		break;
-	case CONDITION_NE:
-		m_assembler.Cbnz(src1Reg, label);
+	case OP_ADDCARRY:
+	case OP_ADC:
+		condition = CAArch64Assembler::CONDITION_CS;
 		break;
-	default:
-		assert(false);
+	case OP_SUBBORROW:
+		condition = CAArch64Assembler::CONDITION_CC;
 		break;
+	default:
+	{
+		//Flags were modified since the operation, test the flag saved in the high part
+		auto flagReg = GetNextTempRegister();
+		m_assembler.Ldr(flagReg, CAArch64Assembler::xSP, src1->m_stackLocation + 4);
+		m_assembler.Cmp(flagReg, 0, CAArch64Assembler::ADDSUB_IMM_SHIFT_LSL0);
+	}
+	break;
 	}
+
+	if(statement.jmpCondition == CONDITION_EQ)
+	{
+		condition = static_cast<CAArch64Assembler::CONDITION>(condition ^ 1);
+	}
+
+	CondJmp_JumpTo(statement.jmpBlock, condition);
 }
 
 void CCodeGen_AArch64::Cmp_GetFlag(CAArch64Assembler::REGISTER32 registerId, Jitter::CONDITION condition)
@@ -1774,6 +2330,9 @@ void CCodeGen_AArch64::Cmp_GetFlag(CAArch64Assembler::REGISTER32 registerId, Jit
 	case CONDITION_GT:
 		m_assembler.Cset(registerId, CAArch64Assembler::CONDITION_GT);
 		break;
+	case CONDITION_GE:
+		m_assembler.Cset(registerId, CAArch64Assembler::CONDITION_GE);
+		break;
 	case CONDITION_BL:
 		m_assembler.Cset(registerId, CAArch64Assembler::CONDITION_CC);
 		break;
@@ -1783,6 +2342,9 @@ void CCodeGen_AArch64::Cmp_GetFlag(CAArch64Assembler::REGISTER32 registerId, Jit
 	case CONDITION_AB:
 		m_assembler.Cset(registerId, CAArch64Assembler::CONDITION_HI);
 		break;
+	case CONDITION_AE:
+		m_assembler.Cset(registerId, CAArch64Assembler::CONDITION_CS);
+		break;
 	default:
 		assert(0);
 		break;
@@ -1832,3 +2394,98 @@ void CCodeGen_AArch64::Emit_Cmp_VarVarCst(const STATEMENT& statement)
 	Cmp_GetFlag(dstReg, statement.jmpCondition);
 	CommitSymbolRegister(dst, dstReg);
 }
+
+CAArch64Assembler::REGISTER64 CCodeGen_AArch64::PrepareMemBaseIndex(CSymbol* indexSymbol, CSymbol* displacementSymbol)
+{
+	assert(displacementSymbol->m_type == SYM_CONSTANT);
+
+	//32-bit registers are zero extended, we can use them as 64-bit offsets
+	auto indexReg = static_cast<CAArch64Assembler::REGISTER64>(PrepareSymbolRegisterUse(indexSymbol, GetNextTempRegister()));
+	uint32 displacement = displacementSymbol->m_valueLow;
+	if(displacement == 0)
+	{
+		return indexReg;
+	}
+
+	auto offsetReg = GetNextTempRegister64();
+	ADDSUB_IMM_PARAMS addSubImmParams;
+	if(TryGetAddSubImmParams(displacement, addSubImmParams))
+	{
+		m_assembler.Add(offsetReg, indexReg, addSubImmParams.imm, addSubImmParams.shiftType);
+	}
+	else
+	{
+		LoadConstantInRegister(static_cast<CAArch64Assembler::REGISTER32>(offsetReg), displacement);
+		m_assembler.Add(offsetReg, indexReg, offsetReg);
+	}
+	return offsetReg;
+}
+
+void CCodeGen_AArch64::Emit_LoadFromMemBase_VarAnyCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto dstReg = PrepareSymbolRegisterDef(dst, GetNextTempRegister());
+	auto offsetReg = PrepareMemBaseIndex(src1, src2);
+	m_assembler.Ldr(dstReg, g_memoryBaseRegister, offsetReg, false);
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_AArch64::Emit_Load8FromMemBase_VarAnyCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto dstReg = PrepareSymbolRegisterDef(dst, GetNextTempRegister());
+	auto offsetReg = PrepareMemBaseIndex(src1, src2);
+	m_assembler.Ldrb(dstReg, g_memoryBaseRegister, offsetReg, false);
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_AArch64::Emit_Load16FromMemBase_VarAnyCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto dstReg = PrepareSymbolRegisterDef(dst, GetNextTempRegister());
+	auto offsetReg = PrepareMemBaseIndex(src1, src2);
+	m_assembler.Ldrh(dstReg, g_memoryBaseRegister, offsetReg, false);
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_AArch64::Emit_StoreAtMemBase_AnyCstAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	auto valueReg = PrepareSymbolRegisterUse(src3, GetNextTempRegister());
+	auto offsetReg = PrepareMemBaseIndex(src1, src2);
+	m_assembler.Str(valueReg, g_memoryBaseRegister, offsetReg, false);
+}
+
+void CCodeGen_AArch64::Emit_Store8AtMemBase_AnyCstAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	auto valueReg = PrepareSymbolRegisterUse(src3, GetNextTempRegister());
+	auto offsetReg = PrepareMemBaseIndex(src1, src2);
+	m_assembler.Strb(valueReg, g_memoryBaseRegister, offsetReg, false);
+}
+
+void CCodeGen_AArch64::Emit_Store16AtMemBase_AnyCstAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	auto valueReg = PrepareSymbolRegisterUse(src3, GetNextTempRegister());
+	auto offsetReg = PrepareMemBaseIndex(src1, src2);
+	m_assembler.Strh(valueReg, g_memoryBaseRegister, offsetReg, false);
+}
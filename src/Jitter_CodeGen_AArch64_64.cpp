@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "Jitter_CodeGen_AArch64.h"
 
 using namespace Jitter;
@@ -57,38 +58,64 @@ void CCodeGen_AArch64::StoreRegisterInMemory64(CSymbol* dst, CAArch64Assembler::
 
 void CCodeGen_AArch64::LoadConstant64InRegister(CAArch64Assembler::REGISTER64 registerId, uint64 constant)
 {
-	if(constant == 0)
+	unsigned int zeroCount = 0;
+	unsigned int onesCount = 0;
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		uint16 value = static_cast<uint16>(constant >> (i * 16));
+		if(value == 0x0000) zeroCount++;
+		if(value == 0xFFFF) onesCount++;
+	}
+
+	//Try to find a single instruction that'll do it before going with a sequence of moves
+	unsigned int moveCount = 4 - std::max(zeroCount, onesCount);
+	LOGICAL_IMM_PARAMS logicalImmParams;
+	if((moveCount > 1) && TryGetLogicalImm64Params(constant, logicalImmParams))
 	{
-		m_assembler.Movz(registerId, 0, 0);
+		m_assembler.Orr(registerId, CAArch64Assembler::xZR, logicalImmParams.n, logicalImmParams.immr, logicalImmParams.imms);
 		return;
 	}
-	//TODO: Check if "movn" could be used to load constants
-	bool loaded = false;
-	// clang-format off
-	static const uint64 masks[4] =
+
+	//Loading from the literal pool is cheaper than going through 4 moves
+	if(moveCount == 4)
 	{
-		0x000000000000FFFFULL,
-		0x00000000FFFF0000ULL,
-		0x0000FFFF00000000ULL,
-		0xFFFF000000000000ULL
-	};
-	// clang-format on
+		m_assembler.Ldr_Pc(registerId, constant);
+		return;
+	}
+
+	//Use "movn" when there are more 0xFFFF halfwords than 0x0000 ones, those are skipped
+	bool useMovn = (onesCount > zeroCount);
+	uint16 skipValue = useMovn ? 0xFFFF : 0x0000;
+	bool loaded = false;
 	for(unsigned int i = 0; i < 4; i++)
 	{
-		if((constant & masks[i]) != 0)
+		uint16 value = static_cast<uint16>(constant >> (i * 16));
+		if(value == skipValue) continue;
+		if(loaded)
+		{
+			m_assembler.Movk(registerId, value, i);
+		}
+		else if(useMovn)
 		{
-			if(loaded)
-			{
-				m_assembler.Movk(registerId, constant >> (i * 16), i);
-			}
-			else
-			{
-				m_assembler.Movz(registerId, constant >> (i * 16), i);
-			}
-			loaded = true;
+			m_assembler.Movn(registerId, static_cast<uint16>(~value), i);
+		}
+		else
+		{
+			m_assembler.Movz(registerId, value, i);
+		}
+		loaded = true;
+	}
+	if(!loaded)
+	{
+		if(useMovn)
+		{
+			m_assembler.Movn(registerId, 0, 0);
+		}
+		else
+		{
+			m_assembler.Movz(registerId, 0, 0);
 		}
 	}
-	assert(loaded);
 }
 
 void CCodeGen_AArch64::LoadMemory64LowInRegister(CAArch64Assembler::REGISTER32 registerId, CSymbol* symbol)
@@ -230,7 +257,7 @@ void CCodeGen_AArch64::Emit_LoadFromRef_64_MemVarAny(const STATEMENT& statement)
 
 	assert(scale == 1);
 
-	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
 	auto dstReg = GetNextTempRegister64();
 
 	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x8000))
@@ -267,7 +294,7 @@ void CCodeGen_AArch64::Emit_StoreAtRef_64_VarAnyAny(const STATEMENT& statement)
 
 	assert(scale == 1);
 
-	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
 	auto valueReg = GetNextTempRegister64();
 
 	LoadSymbol64InRegister(valueReg, src3);
@@ -283,6 +310,85 @@ void CCodeGen_AArch64::Emit_StoreAtRef_64_VarAnyAny(const STATEMENT& statement)
 	}
 }
 
+void CCodeGen_AArch64::Emit_LoadFromRefBSwap_64_MemVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto dstReg = GetNextTempRegister64();
+
+	m_assembler.Ldr(dstReg, addressReg, 0);
+	m_assembler.Rev(dstReg, dstReg);
+
+	StoreRegisterInMemory64(dst, dstReg);
+}
+
+void CCodeGen_AArch64::Emit_LoadFromRefBSwap_64_MemVarAny(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert(scale == 1);
+
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
+	auto dstReg = GetNextTempRegister64();
+
+	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x8000))
+	{
+		m_assembler.Ldr(dstReg, addressReg, scaledIndex);
+	}
+	else
+	{
+		auto indexReg = PrepareSymbolRegisterUse(src2, GetNextTempRegister());
+		m_assembler.Ldr(dstReg, addressReg, static_cast<CAArch64Assembler::REGISTER64>(indexReg), false);
+	}
+	m_assembler.Rev(dstReg, dstReg);
+
+	StoreRegisterInMemory64(dst, dstReg);
+}
+
+void CCodeGen_AArch64::Emit_StoreAtRefBSwap_64_VarAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto valueReg = GetNextTempRegister64();
+
+	LoadSymbol64InRegister(valueReg, src2);
+	m_assembler.Rev(valueReg, valueReg);
+	m_assembler.Str(valueReg, addressReg, 0);
+}
+
+void CCodeGen_AArch64::Emit_StoreAtRefBSwap_64_VarAnyAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert(scale == 1);
+
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
+	auto valueReg = GetNextTempRegister64();
+
+	LoadSymbol64InRegister(valueReg, src3);
+	m_assembler.Rev(valueReg, valueReg);
+
+	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x8000))
+	{
+		m_assembler.Str(valueReg, addressReg, scaledIndex);
+	}
+	else
+	{
+		auto indexReg = PrepareSymbolRegisterUse(src2, GetNextTempRegister());
+		m_assembler.Str(valueReg, addressReg, static_cast<CAArch64Assembler::REGISTER64>(indexReg), false);
+	}
+}
+
 void CCodeGen_AArch64::Emit_Add64_MemMemMem(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
@@ -514,6 +620,12 @@ CCodeGen_AArch64::CONSTMATCHER CCodeGen_AArch64::g_64ConstMatchers[] =
 	{ OP_STOREATREF,     MATCH_NIL,            MATCH_VAR_REF,        MATCH_ANY32,         MATCH_MEMORY64,   &CCodeGen_AArch64::Emit_StoreAtRef_64_VarAnyAny      },
 	{ OP_STOREATREF,     MATCH_NIL,            MATCH_VAR_REF,        MATCH_ANY32,         MATCH_CONSTANT64, &CCodeGen_AArch64::Emit_StoreAtRef_64_VarAnyAny      },
 
+	{ OP_LOADFROMREFBSWAP,  MATCH_MEMORY64,    MATCH_VAR_REF,        MATCH_NIL,           MATCH_NIL,        &CCodeGen_AArch64::Emit_LoadFromRefBSwap_64_MemVar    },
+	{ OP_LOADFROMREFBSWAP,  MATCH_MEMORY64,    MATCH_VAR_REF,        MATCH_ANY32,         MATCH_NIL,        &CCodeGen_AArch64::Emit_LoadFromRefBSwap_64_MemVarAny },
+
+	{ OP_STOREATREFBSWAP,   MATCH_NIL,         MATCH_VAR_REF,        MATCH_MEMORY64,      MATCH_NIL,        &CCodeGen_AArch64::Emit_StoreAtRefBSwap_64_VarAny     },
+	{ OP_STOREATREFBSWAP,   MATCH_NIL,         MATCH_VAR_REF,        MATCH_ANY32,         MATCH_MEMORY64,   &CCodeGen_AArch64::Emit_StoreAtRefBSwap_64_VarAnyAny  },
+
 	{ OP_ADD64,          MATCH_MEMORY64,       MATCH_MEMORY64,       MATCH_MEMORY64,      MATCH_NIL, &CCodeGen_AArch64::Emit_Add64_MemMemMem                     },
 	{ OP_ADD64,          MATCH_MEMORY64,       MATCH_MEMORY64,       MATCH_CONSTANT64,    MATCH_NIL, &CCodeGen_AArch64::Emit_Add64_MemMemCst                     },
 	
@@ -303,7 +303,7 @@ void CCodeGen_AArch64::Emit_Md_LoadFromRef_VarVarAny(const STATEMENT& statement)
 
 	assert(scale == 1);
 
-	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
 	auto dstReg = PrepareSymbolRegisterDefMd(dst, GetNextTempRegisterMd());
 
 	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x10000))
@@ -339,7 +339,7 @@ void CCodeGen_AArch64::Emit_Md_StoreAtRef_VarAnyVar(const STATEMENT& statement)
 
 	assert(scale == 1);
 
-	auto addressReg = PrepareSymbolRegisterUseRef(src1, GetNextTempRegister64());
+	auto addressReg = PrepareRefBaseRegisterUse(src1, statement.displacement);
 	auto valueReg = PrepareSymbolRegisterUseMd(src3, GetNextTempRegisterMd());
 
 	if(uint32 scaledIndex = (src2->m_valueLow * scale); src2->IsConstant() && (scaledIndex < 0x10000))
@@ -1,5 +1,6 @@
 #include "Jitter_CodeGen_Wasm.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <set>
 
@@ -70,6 +71,102 @@ void CCodeGen_Wasm::Emit_Div_Tmp64AnyAny(const STATEMENT& statement)
 	CWasmModuleBuilder::WriteULeb128(m_functionStream, localIdx);
 }
 
+//Wasm doesn't expose flags, operations are done on 64-bit values and the flag
+//is extracted from the upper part of the result
+void CCodeGen_Wasm::Emit_AluFlag_Tmp64AnyAny(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	assert(dst->m_type == SYM_TEMPORARY64);
+
+	uint32 localIdx = GetTemporaryLocation(dst);
+
+	bool isOverflow = (statement.op == OP_ADDOVF) || (statement.op == OP_SUBOVF);
+	auto extendInst = isOverflow ? Wasm::INST_I64_EXTEND_I32_S : Wasm::INST_I64_EXTEND_I32_U;
+
+	PrepareSymbolUse(src1);
+	m_functionStream.Write8(extendInst);
+
+	PrepareSymbolUse(src2);
+	m_functionStream.Write8(extendInst);
+
+	switch(statement.op)
+	{
+	case OP_ADDOVF:
+	case OP_ADDCARRY:
+		m_functionStream.Write8(Wasm::INST_I64_ADD);
+		break;
+	case OP_ADC:
+	{
+		auto src3 = statement.src3->GetSymbol().get();
+		m_functionStream.Write8(Wasm::INST_I64_ADD);
+
+		//Carry in is 1 if not 0
+		PrepareSymbolUse(src3);
+		m_functionStream.Write8(Wasm::INST_I32_EQZ);
+		m_functionStream.Write8(Wasm::INST_I32_EQZ);
+		m_functionStream.Write8(Wasm::INST_I64_EXTEND_I32_U);
+
+		m_functionStream.Write8(Wasm::INST_I64_ADD);
+	}
+	break;
+	case OP_SUBOVF:
+	case OP_SUBBORROW:
+		m_functionStream.Write8(Wasm::INST_I64_SUB);
+		break;
+	default:
+		assert(false);
+		break;
+	}
+
+	if(isOverflow)
+	{
+		//Overflow occured if the result doesn't fit in 32 bits
+		m_functionStream.Write8(Wasm::INST_LOCAL_SET);
+		CWasmModuleBuilder::WriteULeb128(m_functionStream, localIdx);
+
+		m_functionStream.Write8(Wasm::INST_LOCAL_GET);
+		CWasmModuleBuilder::WriteULeb128(m_functionStream, localIdx);
+
+		m_functionStream.Write8(Wasm::INST_I64_CONST);
+		CWasmModuleBuilder::WriteSLeb128(m_functionStream, 0xFFFFFFFF);
+
+		m_functionStream.Write8(Wasm::INST_I64_AND);
+
+		m_functionStream.Write8(Wasm::INST_LOCAL_GET);
+		CWasmModuleBuilder::WriteULeb128(m_functionStream, localIdx);
+
+		m_functionStream.Write8(Wasm::INST_LOCAL_GET);
+		CWasmModuleBuilder::WriteULeb128(m_functionStream, localIdx);
+		m_functionStream.Write8(Wasm::INST_I32_WRAP_I64);
+		m_functionStream.Write8(Wasm::INST_I64_EXTEND_I32_S);
+
+		m_functionStream.Write8(Wasm::INST_I64_NE);
+		m_functionStream.Write8(Wasm::INST_I64_EXTEND_I32_U);
+
+		m_functionStream.Write8(Wasm::INST_I64_CONST);
+		CWasmModuleBuilder::WriteSLeb128(m_functionStream, 32);
+
+		m_functionStream.Write8(Wasm::INST_I64_SHL);
+
+		//Combine
+		m_functionStream.Write8(Wasm::INST_I64_OR);
+	}
+	else
+	{
+		//Carry (or borrow) ends up in bit 32
+		m_functionStream.Write8(Wasm::INST_I64_CONST);
+		CWasmModuleBuilder::WriteSLeb128(m_functionStream, 0x1FFFFFFFFLL);
+
+		m_functionStream.Write8(Wasm::INST_I64_AND);
+	}
+
+	m_functionStream.Write8(Wasm::INST_LOCAL_SET);
+	CWasmModuleBuilder::WriteULeb128(m_functionStream, localIdx);
+}
+
 // clang-format off
 CCodeGen_Wasm::CONSTMATCHER CCodeGen_Wasm::g_constMatchers[] =
 {
@@ -77,6 +174,7 @@ CCodeGen_Wasm::CONSTMATCHER CCodeGen_Wasm::g_constMatchers[] =
 	{ OP_BREAK,          MATCH_NIL,            MATCH_NIL,            MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Break                                  },
 
 	{ OP_MOV,            MATCH_VARIABLE,       MATCH_ANY,            MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Mov_VarAny                             },
+	{ OP_MOV,            MATCH_VAR_REF,        MATCH_VAR_REF,        MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Mov_VarAny                             },
 
 	{ OP_RELTOREF,       MATCH_VAR_REF,        MATCH_CONSTANT,       MATCH_ANY,           MATCH_NIL,      &CCodeGen_Wasm::Emit_RelToRef_VarCst                        },
 
@@ -104,10 +202,21 @@ CCodeGen_Wasm::CONSTMATCHER CCodeGen_Wasm::g_constMatchers[] =
 	{ OP_STORE16ATREF,   MATCH_NIL,            MATCH_VAR_REF,        MATCH_ANY,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Generic_StoreAtRef_VarAny<Wasm::INST_I32_STORE16, 1>    },
 	{ OP_STORE16ATREF,   MATCH_NIL,            MATCH_VAR_REF,        MATCH_ANY,           MATCH_ANY32,    &CCodeGen_Wasm::Emit_Generic_StoreAtRef_VarAnyAny<Wasm::INST_I32_STORE16, 1> },
 
+	{ OP_LOADFROMREFBSWAP,   MATCH_VARIABLE,   MATCH_VAR_REF,        MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Generic_LoadFromRefBSwap_MemVar<Wasm::INST_I32_LOAD, 2, 4>       },
+	{ OP_LOADFROMREFBSWAP,   MATCH_VARIABLE,   MATCH_VAR_REF,        MATCH_ANY32,         MATCH_NIL,      &CCodeGen_Wasm::Emit_Generic_LoadFromRefBSwap_MemVarAny<Wasm::INST_I32_LOAD, 2, 4>    },
+	{ OP_LOAD16FROMREFBSWAP, MATCH_VARIABLE,   MATCH_VAR_REF,        MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Generic_LoadFromRefBSwap_MemVar<Wasm::INST_I32_LOAD16_U, 1, 2>   },
+	{ OP_LOAD16FROMREFBSWAP, MATCH_VARIABLE,   MATCH_VAR_REF,        MATCH_ANY32,         MATCH_NIL,      &CCodeGen_Wasm::Emit_Generic_LoadFromRefBSwap_MemVarAny<Wasm::INST_I32_LOAD16_U, 1, 2>},
+
+	{ OP_STOREATREFBSWAP,    MATCH_NIL,        MATCH_VAR_REF,        MATCH_ANY32,         MATCH_NIL,      &CCodeGen_Wasm::Emit_Generic_StoreAtRefBSwap_VarAny<Wasm::INST_I32_STORE, 2, 4>       },
+	{ OP_STOREATREFBSWAP,    MATCH_NIL,        MATCH_VAR_REF,        MATCH_ANY32,         MATCH_ANY32,    &CCodeGen_Wasm::Emit_Generic_StoreAtRefBSwap_VarAnyAny<Wasm::INST_I32_STORE, 2, 4>    },
+	{ OP_STORE16ATREFBSWAP,  MATCH_NIL,        MATCH_VAR_REF,        MATCH_ANY32,         MATCH_NIL,      &CCodeGen_Wasm::Emit_Generic_StoreAtRefBSwap_VarAny<Wasm::INST_I32_STORE16, 1, 2>     },
+	{ OP_STORE16ATREFBSWAP,  MATCH_NIL,        MATCH_VAR_REF,        MATCH_ANY32,         MATCH_ANY32,    &CCodeGen_Wasm::Emit_Generic_StoreAtRefBSwap_VarAnyAny<Wasm::INST_I32_STORE16, 1, 2>  },
+
 	{ OP_PARAM,          MATCH_NIL,            MATCH_CONTEXT,        MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Param_Ctx                              },
 	{ OP_PARAM,          MATCH_NIL,            MATCH_ANY,            MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Param_Any                              },
 
 	{ OP_CALL,           MATCH_NIL,            MATCH_CONSTANTPTR,    MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Call                                   },
+	{ OP_RETVAL,         MATCH_REGISTER,       MATCH_NIL,            MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_RetVal_Reg                             },
 	{ OP_RETVAL,         MATCH_TEMPORARY,      MATCH_NIL,            MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_RetVal_Tmp                             },
 
 	{ OP_EXTERNJMP,      MATCH_NIL,            MATCH_CONSTANTPTR,    MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_ExternJmp                              },
@@ -137,6 +246,12 @@ CCodeGen_Wasm::CONSTMATCHER CCodeGen_Wasm::g_constMatchers[] =
 	{ OP_MUL,            MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Mul_Tmp64AnyAny<false>                 },
 	{ OP_MULS,           MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Mul_Tmp64AnyAny<true>                  },
 
+	{ OP_ADDOVF,         MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_NIL,      &CCodeGen_Wasm::Emit_AluFlag_Tmp64AnyAny                    },
+	{ OP_ADDCARRY,       MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_NIL,      &CCodeGen_Wasm::Emit_AluFlag_Tmp64AnyAny                    },
+	{ OP_ADC,            MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_ANY,      &CCodeGen_Wasm::Emit_AluFlag_Tmp64AnyAny                    },
+	{ OP_SUBOVF,         MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_NIL,      &CCodeGen_Wasm::Emit_AluFlag_Tmp64AnyAny                    },
+	{ OP_SUBBORROW,      MATCH_TEMPORARY64,    MATCH_ANY,            MATCH_ANY,           MATCH_NIL,      &CCodeGen_Wasm::Emit_AluFlag_Tmp64AnyAny                    },
+
 	{ OP_EXTLOW64,       MATCH_VARIABLE,       MATCH_MEMORY64,       MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_ExtLow64VarMem64                       },
 	{ OP_EXTHIGH64,      MATCH_VARIABLE,       MATCH_MEMORY64,       MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_ExtHigh64VarMem64                      },
 
@@ -150,7 +265,7 @@ CCodeGen_Wasm::CONSTMATCHER CCodeGen_Wasm::g_constMatchers[] =
 
 #include <emscripten.h>
 // clang-format off
-EM_JS_DEPS(WasmRegisterExternFunction, "$convertJsFunctionToWasm");
+EM_JS_DEPS(WasmRegisterExternFunction, "$addFunction");
 EM_JS(int, RegisterExternFunction, (const char* functionName, const char* functionSig), {
 	let fctName = UTF8ToString(functionName);
 	let fctSig = UTF8ToString(functionSig);
@@ -159,19 +274,9 @@ EM_JS(int, RegisterExternFunction, (const char* functionName, const char* functi
 	{
 		out(`Warning: Could not find function '${fctName}' (missing export?).`);
 	}
-	if(Module.codeGenImportTable === undefined) {
-		out("Creating import table...");
-		Module.codeGenImportTable = new WebAssembly.Table({
-			element: 'anyfunc',
-			initial: 32
-		});
-		Module.codeGenImportTableNextIndex = 0;
-	}
-	//TODO: Check how we can use the export from the WASM module directly
-	//instead of having to wrap the wrapper
-	let wrappedFct = convertJsFunctionToWasm(fct, fctSig);
-	let fctId = Module.codeGenImportTableNextIndex++;
-	Module.codeGenImportTable.set(fctId, wrappedFct);
+	//Registered functions live in the same table as generated functions, which lets
+	//generated code refer to other generated functions using their table index
+	let fctId = addFunction(fct, fctSig);
 	out(`Registered function '${fctName}(${fctSig})' = > id = ${fctId}.`);
 	return fctId;
 });
@@ -235,14 +340,23 @@ CCodeGen_Wasm::CCodeGen_Wasm()
 	copyMatchers(g_mdConstMatchers);
 }
 
+void CCodeGen_Wasm::SetGenerateTailCalls(bool generateTailCalls)
+{
+	m_generateTailCalls = generateTailCalls;
+}
+
 void CCodeGen_Wasm::GenerateCode(const StatementList& statements, unsigned int stackSize)
 {
-	CWasmModuleBuilder moduleBuilder;
+	CWasmModuleBuilder singleModuleBuilder;
+	auto& moduleBuilder = m_isBatching ? m_batchModuleBuilder : singleModuleBuilder;
 
 	assert((stackSize & 0x3) == 0);
 
 	m_functionStream.ResetBuffer();
-	m_signatures.clear();
+	if(!m_isBatching)
+	{
+		m_signatures.clear();
+	}
 	m_labelFlows.clear();
 	m_temporaryLocations.clear();
 	m_localI32Count = 0;
@@ -302,11 +416,30 @@ void CCodeGen_Wasm::GenerateCode(const StatementList& statements, unsigned int s
 	function.localV128Count = m_localV128Count;
 
 	moduleBuilder.AddFunction(std::move(function));
-	moduleBuilder.WriteModule(*m_stream);
+	if(!m_isBatching)
+	{
+		moduleBuilder.WriteModule(*m_stream);
+	}
 
 	assert(m_params.empty());
 }
 
+void CCodeGen_Wasm::BeginBatch()
+{
+	assert(!m_isBatching);
+	m_batchModuleBuilder = CWasmModuleBuilder();
+	m_signatures.clear();
+	m_isBatching = true;
+}
+
+void CCodeGen_Wasm::EndBatch(Framework::CStream& stream)
+{
+	assert(m_isBatching);
+	m_batchModuleBuilder.WriteModule(stream);
+	m_batchModuleBuilder = CWasmModuleBuilder();
+	m_isBatching = false;
+}
+
 void CCodeGen_Wasm::SetStream(Framework::CStream* stream)
 {
 	m_stream = stream;
@@ -318,12 +451,13 @@ void CCodeGen_Wasm::RegisterExternalSymbols(CObjectFile*) const
 
 unsigned int CCodeGen_Wasm::GetAvailableRegisterCount() const
 {
-	return 0;
+	//Registers are Wasm locals, the engine takes care of mapping them to machine registers
+	return MAX_REGISTERS;
 }
 
 unsigned int CCodeGen_Wasm::GetAvailableMdRegisterCount() const
 {
-	return 0;
+	return MAX_MDREGISTERS;
 }
 
 bool CCodeGen_Wasm::Has128BitsCallOperands() const
@@ -338,6 +472,39 @@ bool CCodeGen_Wasm::CanHold128BitsReturnValueInRegisters() const
 
 bool CCodeGen_Wasm::SupportsExternalJumps() const
 {
+	//Jump targets are written in the module and can't be changed once it is compiled
+	return false;
+}
+
+bool CCodeGen_Wasm::SupportsBlockPlacement() const
+{
+	//Control flow needs to keep the structure generated by the front-end
+	return false;
+}
+
+bool CCodeGen_Wasm::SupportsColdRegion() const
+{
+	return false;
+}
+
+bool CCodeGen_Wasm::SupportsMemoryBase() const
+{
+	return false;
+}
+
+bool CCodeGen_Wasm::SupportsRefIndexDisplacement() const
+{
+	return false;
+}
+
+bool CCodeGen_Wasm::SupportsAluFlagBranches() const
+{
+	return false;
+}
+
+bool CCodeGen_Wasm::SupportsNestedLoops() const
+{
+	//Only one loop block per function can be generated
 	return false;
 }
 
@@ -500,18 +667,30 @@ void CCodeGen_Wasm::BuildLabelFlows(const StatementList& statements)
 
 void CCodeGen_Wasm::PrepareSignatures(CWasmModuleBuilder& moduleBuilder, const StatementList& statements)
 {
-	//Register this function's signature
-	RegisterSignature(moduleBuilder, "vi");
+	//Register this function's signature (already registered by the first function of a batch)
+	if(m_signatures.empty())
+	{
+		RegisterSignature(moduleBuilder, "vi");
+	}
 
 	for(const auto& statement : statements)
 	{
-		if(statement.op != OP_CALL) continue;
+		if((statement.op != OP_CALL) && (statement.op != OP_EXTERNJMP)) continue;
 
 		auto src1 = statement.src1->GetSymbol().get();
 		assert(src1->m_type == SYM_CONSTANTPTR);
 
-		auto fctInfo = CWasmFunctionRegistry::FindFunction(src1->m_valueLow);
-		assert(fctInfo);
+		auto fctInfo = CWasmFunctionRegistry::FindFunction(src1->GetConstantPtr());
+		if(!fctInfo)
+		{
+			//Jumps to generated functions use the same signature as this function
+			assert(statement.op != OP_CALL);
+			if(statement.op == OP_CALL)
+			{
+				throw std::runtime_error("Called function was not registered.");
+			}
+			continue;
+		}
 
 		assert(!fctInfo->signature.empty());
 
@@ -565,6 +744,33 @@ void CCodeGen_Wasm::RegisterSignature(CWasmModuleBuilder& moduleBuilder, std::st
 
 void CCodeGen_Wasm::PrepareLocalVars(const StatementList& statements)
 {
+	//Registers come first in their local type group, temporaries follow
+	for(const auto& statement : statements)
+	{
+		statement.VisitOperands(
+		    [this](const SymbolRefPtr& symbolRef, bool) {
+			    auto symbol = symbolRef->GetSymbol();
+			    switch(symbol->m_type)
+			    {
+			    case SYM_REGISTER:
+			    case SYM_REG_REFERENCE:
+				    assert(symbol->m_valueLow < MAX_REGISTERS);
+				    m_localI32Count = std::max<uint32>(m_localI32Count, symbol->m_valueLow + 1);
+				    break;
+			    case SYM_FP_REGISTER32:
+				    assert(symbol->m_valueLow < MAX_MDREGISTERS);
+				    m_localF32Count = std::max<uint32>(m_localF32Count, symbol->m_valueLow + 1);
+				    break;
+			    case SYM_REGISTER128:
+				    assert(symbol->m_valueLow < MAX_MDREGISTERS);
+				    m_localV128Count = std::max<uint32>(m_localV128Count, symbol->m_valueLow + 1);
+				    break;
+			    default:
+				    break;
+			    }
+		    });
+	}
+
 	for(const auto& statement : statements)
 	{
 		statement.VisitOperands(
@@ -639,6 +845,31 @@ uint32 CCodeGen_Wasm::GetTemporaryLocation(CSymbol* symbol) const
 	return localIdx;
 }
 
+uint32 CCodeGen_Wasm::GetRegisterLocation(CSymbol* symbol) const
+{
+	//First local is the function's parameter
+	uint32 localIdx = 0;
+
+	switch(symbol->m_type)
+	{
+	case SYM_REGISTER:
+	case SYM_REG_REFERENCE:
+		localIdx = symbol->m_valueLow + 1;
+		break;
+	case SYM_FP_REGISTER32:
+		localIdx = symbol->m_valueLow + m_localI32Count + m_localI64Count + 1;
+		break;
+	case SYM_REGISTER128:
+		localIdx = symbol->m_valueLow + m_localI32Count + m_localI64Count + m_localF32Count + 1;
+		break;
+	default:
+		assert(false);
+		break;
+	}
+
+	return localIdx;
+}
+
 void CCodeGen_Wasm::PushContext()
 {
 	//Context is the first param
@@ -646,6 +877,22 @@ void CCodeGen_Wasm::PushContext()
 	m_functionStream.Write8(0x00);
 }
 
+void CCodeGen_Wasm::PushRegister(CSymbol* symbol)
+{
+	uint32 localIdx = GetRegisterLocation(symbol);
+
+	m_functionStream.Write8(Wasm::INST_LOCAL_GET);
+	CWasmModuleBuilder::WriteULeb128(m_functionStream, localIdx);
+}
+
+void CCodeGen_Wasm::PullRegister(CSymbol* symbol)
+{
+	uint32 localIdx = GetRegisterLocation(symbol);
+
+	m_functionStream.Write8(Wasm::INST_LOCAL_SET);
+	CWasmModuleBuilder::WriteULeb128(m_functionStream, localIdx);
+}
+
 void CCodeGen_Wasm::PushRelativeAddress(CSymbol* symbol)
 {
 	assert(
@@ -654,12 +901,8 @@ void CCodeGen_Wasm::PushRelativeAddress(CSymbol* symbol)
 	    (symbol->m_type == SYM_FP_RELATIVE32) ||
 	    (symbol->m_type == SYM_RELATIVE128));
 
+	//The symbol's offset is not added here, it goes in the memarg of the access that follows
 	PushContext();
-
-	m_functionStream.Write8(Wasm::INST_I32_CONST);
-	CWasmModuleBuilder::WriteSLeb128(m_functionStream, symbol->m_valueLow);
-
-	m_functionStream.Write8(Wasm::INST_I32_ADD);
 }
 
 void CCodeGen_Wasm::PushRelative(CSymbol* symbol)
@@ -667,8 +910,7 @@ void CCodeGen_Wasm::PushRelative(CSymbol* symbol)
 	PushRelativeAddress(symbol);
 
 	m_functionStream.Write8(Wasm::INST_I32_LOAD);
-	m_functionStream.Write8(0x02);
-	m_functionStream.Write8(0x00);
+	WriteMemArg(0x02, symbol->m_valueLow);
 }
 
 void CCodeGen_Wasm::PushTemporary(CSymbol* symbol)
@@ -693,12 +935,8 @@ void CCodeGen_Wasm::PushRelativeRefAddress(CSymbol* symbol)
 {
 	assert(symbol->m_type == SYM_REL_REFERENCE);
 
+	//Same as PushRelativeAddress, offset goes in the memarg
 	PushContext();
-
-	m_functionStream.Write8(Wasm::INST_I32_CONST);
-	CWasmModuleBuilder::WriteSLeb128(m_functionStream, symbol->m_valueLow);
-
-	m_functionStream.Write8(Wasm::INST_I32_ADD);
 }
 
 void CCodeGen_Wasm::PushRelativeRef(CSymbol* symbol)
@@ -706,8 +944,44 @@ void CCodeGen_Wasm::PushRelativeRef(CSymbol* symbol)
 	PushRelativeRefAddress(symbol);
 
 	m_functionStream.Write8(Wasm::INST_I32_LOAD);
-	m_functionStream.Write8(0x02);
-	m_functionStream.Write8(0x00);
+	WriteMemArg(0x02, symbol->m_valueLow);
+}
+
+uint32 CCodeGen_Wasm::PushRefIndexAddress(CSymbol* refSymbol, CSymbol* indexSymbol, uint8 scale)
+{
+	assert((scale == 1) || (scale == 4));
+
+	PrepareSymbolUse(refSymbol);
+
+	//Fold constant displacements in the memarg offset. This is only valid for positive
+	//displacements since the offset is unsigned and doesn't wrap around like i32.add does.
+	if(indexSymbol->m_type == SYM_CONSTANT)
+	{
+		int64 displacement = static_cast<int64>(static_cast<int32>(indexSymbol->m_valueLow)) * scale;
+		if((displacement >= 0) && (displacement <= INT32_MAX))
+		{
+			return static_cast<uint32>(displacement);
+		}
+	}
+
+	PrepareSymbolUse(indexSymbol);
+
+	if(scale == 4)
+	{
+		m_functionStream.Write8(Wasm::INST_I32_CONST);
+		m_functionStream.Write8(2);
+		m_functionStream.Write8(Wasm::INST_I32_SHL);
+	}
+
+	m_functionStream.Write8(Wasm::INST_I32_ADD);
+
+	return 0;
+}
+
+void CCodeGen_Wasm::WriteMemArg(uint8 align, uint32 offset)
+{
+	m_functionStream.Write8(align);
+	CWasmModuleBuilder::WriteULeb128(m_functionStream, offset);
 }
 
 void CCodeGen_Wasm::PushTemporaryRef(CSymbol* symbol)
@@ -734,6 +1008,12 @@ void CCodeGen_Wasm::PrepareSymbolUse(CSymbol* symbol)
 {
 	switch(symbol->m_type)
 	{
+	case SYM_REGISTER:
+	case SYM_REG_REFERENCE:
+	case SYM_FP_REGISTER32:
+	case SYM_REGISTER128:
+		PushRegister(symbol);
+		break;
 	case SYM_RELATIVE:
 		PushRelative(symbol);
 		break;
@@ -788,6 +1068,10 @@ void CCodeGen_Wasm::PrepareSymbolDef(CSymbol* symbol)
 	case SYM_FP_RELATIVE32:
 		PushRelativeAddress(symbol);
 		break;
+	case SYM_REGISTER:
+	case SYM_REG_REFERENCE:
+	case SYM_FP_REGISTER32:
+	case SYM_REGISTER128:
 	case SYM_TEMPORARY:
 	case SYM_TEMPORARY64:
 	case SYM_TEMPORARY128:
@@ -804,10 +1088,15 @@ void CCodeGen_Wasm::CommitSymbol(CSymbol* symbol)
 {
 	switch(symbol->m_type)
 	{
+	case SYM_REGISTER:
+	case SYM_REG_REFERENCE:
+	case SYM_FP_REGISTER32:
+	case SYM_REGISTER128:
+		PullRegister(symbol);
+		break;
 	case SYM_RELATIVE:
 		m_functionStream.Write8(Wasm::INST_I32_STORE);
-		m_functionStream.Write8(0x02);
-		m_functionStream.Write8(0x00);
+		WriteMemArg(0x02, symbol->m_valueLow);
 		break;
 	case SYM_TEMPORARY:
 		PullTemporary(symbol);
@@ -817,16 +1106,14 @@ void CCodeGen_Wasm::CommitSymbol(CSymbol* symbol)
 		break;
 	case SYM_RELATIVE64:
 		m_functionStream.Write8(Wasm::INST_I64_STORE);
-		m_functionStream.Write8(0x03);
-		m_functionStream.Write8(0x00);
+		WriteMemArg(0x03, symbol->m_valueLow);
 		break;
 	case SYM_TEMPORARY64:
 		PullTemporary64(symbol);
 		break;
 	case SYM_FP_RELATIVE32:
 		m_functionStream.Write8(Wasm::INST_F32_STORE);
-		m_functionStream.Write8(0x02);
-		m_functionStream.Write8(0x00);
+		WriteMemArg(0x02, symbol->m_valueLow);
 		break;
 	case SYM_FP_TEMPORARY32:
 		PullTemporaryFp32(symbol);
@@ -834,8 +1121,7 @@ void CCodeGen_Wasm::CommitSymbol(CSymbol* symbol)
 	case SYM_RELATIVE128:
 		m_functionStream.Write8(Wasm::INST_PREFIX_SIMD);
 		m_functionStream.Write8(Wasm::INST_V128_STORE);
-		m_functionStream.Write8(0x04);
-		m_functionStream.Write8(0x00);
+		WriteMemArg(0x04, symbol->m_valueLow);
 		break;
 	case SYM_TEMPORARY128:
 		PullTemporary128(symbol);
@@ -965,8 +1251,7 @@ void CCodeGen_Wasm::Emit_LoadFromRef_VarVar(const STATEMENT& statement)
 	PrepareSymbolUse(src1);
 
 	m_functionStream.Write8(Wasm::INST_I32_LOAD);
-	m_functionStream.Write8(0x02);
-	m_functionStream.Write8(0x00);
+	WriteMemArg(0x02, 0);
 
 	CommitSymbol(dst);
 }
@@ -978,32 +1263,11 @@ void CCodeGen_Wasm::Emit_LoadFromRef_VarVarAny(const STATEMENT& statement)
 	auto src2 = statement.src2->GetSymbol().get();
 	uint8 scale = static_cast<uint8>(statement.jmpCondition);
 
-	assert((scale == 1) || (scale == 4));
-
 	PrepareSymbolDef(dst);
-	PrepareSymbolUse(src1);
-	PrepareSymbolUse(src2);
-
-	switch(scale)
-	{
-	case 1:
-		//Nothing to do
-		break;
-	case 4:
-		m_functionStream.Write8(Wasm::INST_I32_CONST);
-		m_functionStream.Write8(2);
-		m_functionStream.Write8(Wasm::INST_I32_SHL);
-		break;
-	default:
-		assert(false);
-		break;
-	}
-
-	m_functionStream.Write8(Wasm::INST_I32_ADD);
+	uint32 offset = PushRefIndexAddress(src1, src2, scale);
 
 	m_functionStream.Write8(Wasm::INST_I32_LOAD);
-	m_functionStream.Write8(0x02);
-	m_functionStream.Write8(0x00);
+	WriteMemArg(0x02, offset);
 
 	CommitSymbol(dst);
 }
@@ -1017,8 +1281,7 @@ void CCodeGen_Wasm::Emit_StoreAtRef_VarAny(const STATEMENT& statement)
 	PrepareSymbolUse(src2);
 
 	m_functionStream.Write8(Wasm::INST_I32_STORE);
-	m_functionStream.Write8(0x02);
-	m_functionStream.Write8(0x00);
+	WriteMemArg(0x02, 0);
 }
 
 void CCodeGen_Wasm::Emit_StoreAtRef_VarAnyAny(const STATEMENT& statement)
@@ -1028,33 +1291,53 @@ void CCodeGen_Wasm::Emit_StoreAtRef_VarAnyAny(const STATEMENT& statement)
 	auto src3 = statement.src3->GetSymbol().get();
 	uint8 scale = static_cast<uint8>(statement.jmpCondition);
 
-	assert((scale == 1) || (scale == 4));
+	uint32 offset = PushRefIndexAddress(src1, src2, scale);
+	PrepareSymbolUse(src3);
 
-	PrepareSymbolUse(src1);
-	PrepareSymbolUse(src2);
+	m_functionStream.Write8(Wasm::INST_I32_STORE);
+	WriteMemArg(0x02, offset);
+}
+
+void CCodeGen_Wasm::SwapBytes(uint8 size)
+{
+	//Reverse bytes of the value on top of the stack using a swizzle,
+	//out of range lane indices give 0 which zero extends smaller values.
+	static const uint8 swapPattern16[0x10] = {1, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+	static const uint8 swapPattern32[0x10] = {3, 2, 1, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+	static const uint8 swapPattern64[0x10] = {7, 6, 5, 4, 3, 2, 1, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
-	switch(scale)
+	const uint8* swapPattern = nullptr;
+	switch(size)
 	{
-	case 1:
-		//Nothing to do
+	case 2:
+		swapPattern = swapPattern16;
 		break;
 	case 4:
-		m_functionStream.Write8(Wasm::INST_I32_CONST);
-		m_functionStream.Write8(2);
-		m_functionStream.Write8(Wasm::INST_I32_SHL);
+		swapPattern = swapPattern32;
+		break;
+	case 8:
+		swapPattern = swapPattern64;
 		break;
 	default:
 		assert(false);
-		break;
+		return;
 	}
 
-	m_functionStream.Write8(Wasm::INST_I32_ADD);
+	bool is64 = (size == 8);
 
-	PrepareSymbolUse(src3);
+	m_functionStream.Write8(Wasm::INST_PREFIX_SIMD);
+	CWasmModuleBuilder::WriteULeb128(m_functionStream, is64 ? Wasm::INST_I64x2_SPLAT : Wasm::INST_I32x4_SPLAT);
 
-	m_functionStream.Write8(Wasm::INST_I32_STORE);
-	m_functionStream.Write8(0x02);
-	m_functionStream.Write8(0x00);
+	m_functionStream.Write8(Wasm::INST_PREFIX_SIMD);
+	CWasmModuleBuilder::WriteULeb128(m_functionStream, Wasm::INST_V128_CONST);
+	m_functionStream.Write(swapPattern, 0x10);
+
+	m_functionStream.Write8(Wasm::INST_PREFIX_SIMD);
+	CWasmModuleBuilder::WriteULeb128(m_functionStream, Wasm::INST_I8x16_SWIZZLE);
+
+	m_functionStream.Write8(Wasm::INST_PREFIX_SIMD);
+	CWasmModuleBuilder::WriteULeb128(m_functionStream, is64 ? Wasm::INST_I64x2_EXTRACT_LANE : Wasm::INST_I32x4_EXTRACT_LANE);
+	m_functionStream.Write8(0);
 }
 
 void CCodeGen_Wasm::Emit_Param_Ctx(const STATEMENT& statement)
@@ -1087,17 +1370,23 @@ void CCodeGen_Wasm::Emit_Call(const STATEMENT& statement)
 		m_params.pop();
 	}
 
-	auto fctInfo = CWasmFunctionRegistry::FindFunction(src1->m_valueLow);
+	auto fctInfo = CWasmFunctionRegistry::FindFunction(src1->GetConstantPtr());
 	auto sigIdxIterator = m_signatures.find(fctInfo->signature);
 	assert(sigIdxIterator != std::end(m_signatures));
 	auto sigIdx = sigIdxIterator->second;
 
 	m_functionStream.Write8(Wasm::INST_I32_CONST);
-	CWasmModuleBuilder::WriteULeb128(m_functionStream, fctInfo->id);
+	CWasmModuleBuilder::WriteSLeb128(m_functionStream, fctInfo->id);
 
 	m_functionStream.Write8(Wasm::INST_CALL_INDIRECT);
-	m_functionStream.Write8(sigIdx); //Signature index
-	m_functionStream.Write8(0x00);   //Table index
+	CWasmModuleBuilder::WriteULeb128(m_functionStream, sigIdx); //Signature index
+	m_functionStream.Write8(0x00);                               //Table index
+}
+
+void CCodeGen_Wasm::Emit_RetVal_Reg(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	PullRegister(dst);
 }
 
 void CCodeGen_Wasm::Emit_RetVal_Tmp(const STATEMENT& statement)
@@ -1108,10 +1397,9 @@ void CCodeGen_Wasm::Emit_RetVal_Tmp(const STATEMENT& statement)
 
 void CCodeGen_Wasm::Emit_ExternJmp(const STATEMENT& statement)
 {
-	//Not really supported, but can be used with some caveats
-	//Implemented as a simple indirect call for now (which works fine if the caller returns immediately).
-	//This could be implemented using tail calls which doesn't seem to be widely supported.
-	//Maybe we could emit a return after the call and be done with it? (stack overflow problems maybe)
+	//Without tail calls, this is implemented as a simple indirect call
+	//(which works fine if the caller returns immediately, but grows the stack for every chained block).
+	//OP_EXTERNJMP_DYN is not supported since the target can't be changed once the module is compiled.
 
 	auto src1 = statement.src1->GetSymbol().get();
 
@@ -1119,17 +1407,25 @@ void CCodeGen_Wasm::Emit_ExternJmp(const STATEMENT& statement)
 
 	PushContext();
 
-	auto fctInfo = CWasmFunctionRegistry::FindFunction(src1->m_valueLow);
-	auto sigIdxIterator = m_signatures.find(fctInfo->signature);
+	//Generated functions aren't registered, their code pointer is their index in the function table
+	uint32 fctId = src1->m_valueLow;
+	std::string signature = "vi";
+	if(auto fctInfo = CWasmFunctionRegistry::FindFunction(src1->GetConstantPtr()))
+	{
+		fctId = fctInfo->id;
+		signature = fctInfo->signature;
+	}
+
+	auto sigIdxIterator = m_signatures.find(signature);
 	assert(sigIdxIterator != std::end(m_signatures));
 	auto sigIdx = sigIdxIterator->second;
 
 	m_functionStream.Write8(Wasm::INST_I32_CONST);
-	CWasmModuleBuilder::WriteULeb128(m_functionStream, fctInfo->id);
+	CWasmModuleBuilder::WriteSLeb128(m_functionStream, static_cast<int32>(fctId));
 
-	m_functionStream.Write8(Wasm::INST_CALL_INDIRECT);
-	m_functionStream.Write8(sigIdx); //Signature index
-	m_functionStream.Write8(0x00);   //Table index
+	m_functionStream.Write8(m_generateTailCalls ? Wasm::INST_RETURN_CALL_INDIRECT : Wasm::INST_CALL_INDIRECT);
+	CWasmModuleBuilder::WriteULeb128(m_functionStream, sigIdx); //Signature index
+	m_functionStream.Write8(0x00);                               //Table index
 }
 
 void CCodeGen_Wasm::Emit_Jmp(const STATEMENT& statement)
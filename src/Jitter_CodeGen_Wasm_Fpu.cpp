@@ -34,13 +34,23 @@ void CCodeGen_Wasm::Emit_Fpu_MemMemMem(const STATEMENT& statement)
 	CommitSymbol(dst);
 }
 
+void CCodeGen_Wasm::Emit_Fp_Mov_VarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	PrepareSymbolDef(dst);
+	PrepareSymbolUse(src1);
+
+	CommitSymbol(dst);
+}
+
 void CCodeGen_Wasm::PushRelativeFp32(CSymbol* symbol)
 {
 	PushRelativeAddress(symbol);
 
 	m_functionStream.Write8(Wasm::INST_F32_LOAD);
-	m_functionStream.Write8(0x02);
-	m_functionStream.Write8(0x00);
+	WriteMemArg(0x02, symbol->m_valueLow);
 }
 
 void CCodeGen_Wasm::PushTemporaryFp32(CSymbol* symbol)
@@ -181,15 +191,20 @@ void CCodeGen_Wasm::Emit_Fp_ToSingleI32_MemMem(const STATEMENT& statement)
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
-	assert(src1->m_type == SYM_FP_RELATIVE32);
-
 	PrepareSymbolDef(dst);
 
-	//Can't use PrepareSymbolUse here because src1 is a f32 and we need an i32
-	PushRelativeAddress(src1);
-	m_functionStream.Write8(Wasm::INST_I32_LOAD);
-	m_functionStream.Write8(0x02);
-	m_functionStream.Write8(0x00);
+	//src1 holds an integer but is typed as a f32
+	if(src1->m_type == SYM_FP_RELATIVE32)
+	{
+		PushRelativeAddress(src1);
+		m_functionStream.Write8(Wasm::INST_I32_LOAD);
+		WriteMemArg(0x02, src1->m_valueLow);
+	}
+	else
+	{
+		PrepareSymbolUse(src1);
+		m_functionStream.Write8(Wasm::INST_I32_REINTERPRET_F32);
+	}
 
 	m_functionStream.Write8(Wasm::INST_F32_CONVERT_I32_S);
 
@@ -201,18 +216,23 @@ void CCodeGen_Wasm::Emit_Fp_ToInt32TruncS_MemMem(const STATEMENT& statement)
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
-	assert(dst->m_type == SYM_FP_RELATIVE32);
-
 	PrepareSymbolDef(dst);
 	PrepareSymbolUse(src1);
 
 	m_functionStream.Write8(Wasm::INST_PREFIX_FC);
 	m_functionStream.Write8(Wasm::INST_I32_TRUNC_SAT_F32_S);
 
-	//Can't use CommitSymbol here since we got a i32 on the stack and our dst symbol is a f32.
-	m_functionStream.Write8(Wasm::INST_I32_STORE);
-	m_functionStream.Write8(0x02);
-	m_functionStream.Write8(0x00);
+	//dst will hold an integer but is typed as a f32
+	if(dst->m_type == SYM_FP_RELATIVE32)
+	{
+		m_functionStream.Write8(Wasm::INST_I32_STORE);
+		WriteMemArg(0x02, dst->m_valueLow);
+	}
+	else
+	{
+		m_functionStream.Write8(Wasm::INST_F32_REINTERPRET_I32);
+		CommitSymbol(dst);
+	}
 }
 
 void CCodeGen_Wasm::Emit_Fp_LdCst_TmpCst(const STATEMENT& statement)
@@ -220,7 +240,6 @@ void CCodeGen_Wasm::Emit_Fp_LdCst_TmpCst(const STATEMENT& statement)
 	auto dst = statement.dst->GetSymbol().get();
 	auto src1 = statement.src1->GetSymbol().get();
 
-	assert(dst->m_type == SYM_FP_TEMPORARY32);
 	assert(src1->m_type == SYM_CONSTANT);
 
 	PrepareSymbolDef(dst);
@@ -234,29 +253,31 @@ void CCodeGen_Wasm::Emit_Fp_LdCst_TmpCst(const STATEMENT& statement)
 // clang-format off
 CCodeGen_Wasm::CONSTMATCHER CCodeGen_Wasm::g_fpuConstMatchers[] =
 {
-	{ OP_FP_ADD_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_FP_MEMORY32,  MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_ADD>       },
-	{ OP_FP_SUB_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_FP_MEMORY32,  MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_SUB>       },
-	{ OP_FP_MUL_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_FP_MEMORY32,  MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_MUL>       },
-	{ OP_FP_DIV_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_FP_MEMORY32,  MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_DIV>       },
+	{ OP_MOV,                MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Mov_VarVar                           },
+
+	{ OP_FP_ADD_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32,MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_ADD>       },
+	{ OP_FP_SUB_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32,MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_SUB>       },
+	{ OP_FP_MUL_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32,MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_MUL>       },
+	{ OP_FP_DIV_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32,MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_DIV>       },
 
-	{ OP_FP_CMP_S,           MATCH_ANY,              MATCH_FP_MEMORY32,   MATCH_FP_MEMORY32,  MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Cmp_AnyMemMem                        },
+	{ OP_FP_CMP_S,           MATCH_ANY,              MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32,MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Cmp_AnyMemMem                        },
 
-	{ OP_FP_MIN_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_FP_MEMORY32,  MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_MIN>       },
-	{ OP_FP_MAX_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_FP_MEMORY32,  MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_MAX>       },
+	{ OP_FP_MIN_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32,MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_MIN>       },
+	{ OP_FP_MAX_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_FP_VARIABLE32,MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMemMem<Wasm::INST_F32_MAX>       },
 
-	{ OP_FP_RCPL_S,          MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Rcpl_MemMem                          },
-	{ OP_FP_SQRT_S,          MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMem<Wasm::INST_F32_SQRT>         },
-	{ OP_FP_RSQRT_S,         MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Rsqrt_MemMem                         },
+	{ OP_FP_RCPL_S,          MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Rcpl_MemMem                          },
+	{ OP_FP_SQRT_S,          MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMem<Wasm::INST_F32_SQRT>         },
+	{ OP_FP_RSQRT_S,         MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Rsqrt_MemMem                         },
 
-	{ OP_FP_CLAMP_S,         MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Clamp_MemMem                         },
+	{ OP_FP_CLAMP_S,         MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_Clamp_MemMem                         },
 
-	{ OP_FP_ABS_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMem<Wasm::INST_F32_ABS>          },
-	{ OP_FP_NEG_S,           MATCH_FP_MEMORY32,      MATCH_FP_MEMORY32,   MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMem<Wasm::INST_F32_NEG>          },
+	{ OP_FP_ABS_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMem<Wasm::INST_F32_ABS>          },
+	{ OP_FP_NEG_S,           MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fpu_MemMem<Wasm::INST_F32_NEG>          },
 
-	{ OP_FP_TOSINGLE_I32,    MATCH_FP_MEMORY32,      MATCH_FP_RELATIVE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_ToSingleI32_MemMem                   },
-	{ OP_FP_TOINT32_TRUNC_S, MATCH_FP_RELATIVE32,    MATCH_FP_MEMORY32,   MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_ToInt32TruncS_MemMem                 },
+	{ OP_FP_TOSINGLE_I32,    MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_ToSingleI32_MemMem                   },
+	{ OP_FP_TOINT32_TRUNC_S, MATCH_FP_VARIABLE32,    MATCH_FP_VARIABLE32, MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_ToInt32TruncS_MemMem                 },
 
-	{ OP_FP_LDCST,           MATCH_FP_TEMPORARY32,   MATCH_CONSTANT,      MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_LdCst_TmpCst                         },
+	{ OP_FP_LDCST,           MATCH_FP_VARIABLE32,    MATCH_CONSTANT,      MATCH_NIL,          MATCH_NIL,      &CCodeGen_Wasm::Emit_Fp_LdCst_TmpCst                         },
 
 	{ OP_MOV,                MATCH_NIL,              MATCH_NIL,           MATCH_NIL,          MATCH_NIL,      nullptr                                                      },
 };
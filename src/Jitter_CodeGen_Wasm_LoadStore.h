@@ -10,8 +10,7 @@ void CCodeGen_Wasm::Emit_Generic_LoadFromRef_MemVar(const STATEMENT& statement)
 	PrepareSymbolUse(src1);
 
 	m_functionStream.Write8(inst);
-	m_functionStream.Write8(align);
-	m_functionStream.Write8(0x00);
+	WriteMemArg(align, 0);
 
 	CommitSymbol(dst);
 }
@@ -27,14 +26,10 @@ void CCodeGen_Wasm::Emit_Generic_LoadFromRef_MemVarAny(const STATEMENT& statemen
 	assert(scale == 1);
 
 	PrepareSymbolDef(dst);
-	PrepareSymbolUse(src1);
-	PrepareSymbolUse(src2);
-
-	m_functionStream.Write8(Wasm::INST_I32_ADD);
+	uint32 offset = PushRefIndexAddress(src1, src2, scale);
 
 	m_functionStream.Write8(inst);
-	m_functionStream.Write8(align);
-	m_functionStream.Write8(0x00);
+	WriteMemArg(align, offset);
 
 	CommitSymbol(dst);
 }
@@ -49,8 +44,7 @@ void CCodeGen_Wasm::Emit_Generic_StoreAtRef_VarAny(const STATEMENT& statement)
 	PrepareSymbolUse(src2);
 
 	m_functionStream.Write8(inst);
-	m_functionStream.Write8(align);
-	m_functionStream.Write8(0x00);
+	WriteMemArg(align, 0);
 }
 
 template <uint8 inst, uint8 align>
@@ -63,14 +57,81 @@ void CCodeGen_Wasm::Emit_Generic_StoreAtRef_VarAnyAny(const STATEMENT& statement
 
 	assert(scale == 1);
 
+	uint32 offset = PushRefIndexAddress(src1, src2, scale);
+	PrepareSymbolUse(src3);
+
+	m_functionStream.Write8(inst);
+	WriteMemArg(align, offset);
+}
+
+template <uint8 inst, uint8 align, uint8 size>
+void CCodeGen_Wasm::Emit_Generic_LoadFromRefBSwap_MemVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	PrepareSymbolDef(dst);
+	PrepareSymbolUse(src1);
+
+	m_functionStream.Write8(inst);
+	WriteMemArg(align, 0);
+
+	SwapBytes(size);
+
+	CommitSymbol(dst);
+}
+
+template <uint8 inst, uint8 align, uint8 size>
+void CCodeGen_Wasm::Emit_Generic_LoadFromRefBSwap_MemVarAny(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert((scale == 1) || (scale == 4));
+
+	PrepareSymbolDef(dst);
+	uint32 offset = PushRefIndexAddress(src1, src2, scale);
+
+	m_functionStream.Write8(inst);
+	WriteMemArg(align, offset);
+
+	SwapBytes(size);
+
+	CommitSymbol(dst);
+}
+
+template <uint8 inst, uint8 align, uint8 size>
+void CCodeGen_Wasm::Emit_Generic_StoreAtRefBSwap_VarAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
 	PrepareSymbolUse(src1);
 	PrepareSymbolUse(src2);
 
-	m_functionStream.Write8(Wasm::INST_I32_ADD);
+	SwapBytes(size);
+
+	m_functionStream.Write8(inst);
+	WriteMemArg(align, 0);
+}
+
+template <uint8 inst, uint8 align, uint8 size>
+void CCodeGen_Wasm::Emit_Generic_StoreAtRefBSwap_VarAnyAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert((scale == 1) || (scale == 4));
 
+	uint32 offset = PushRefIndexAddress(src1, src2, scale);
 	PrepareSymbolUse(src3);
 
+	SwapBytes(size);
+
 	m_functionStream.Write8(inst);
-	m_functionStream.Write8(align);
-	m_functionStream.Write8(0x00);
+	WriteMemArg(align, offset);
 }
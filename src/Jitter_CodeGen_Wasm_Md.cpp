@@ -88,8 +88,7 @@ void CCodeGen_Wasm::PushRelative128(CSymbol* symbol)
 
 	m_functionStream.Write8(Wasm::INST_PREFIX_SIMD);
 	m_functionStream.Write8(Wasm::INST_V128_LOAD);
-	m_functionStream.Write8(0x04);
-	m_functionStream.Write8(0x00);
+	WriteMemArg(0x04, symbol->m_valueLow);
 }
 
 void CCodeGen_Wasm::PushTemporary128(CSymbol* symbol)
@@ -540,8 +539,7 @@ void CCodeGen_Wasm::Emit_Md_LoadFromRef_MemMem(const STATEMENT& statement)
 
 	m_functionStream.Write8(Wasm::INST_PREFIX_SIMD);
 	m_functionStream.Write8(Wasm::INST_V128_LOAD);
-	m_functionStream.Write8(0x04);
-	m_functionStream.Write8(0x00);
+	WriteMemArg(0x04, 0);
 
 	CommitSymbol(dst);
 }
@@ -556,15 +554,11 @@ void CCodeGen_Wasm::Emit_Md_LoadFromRef_MemMemAny(const STATEMENT& statement)
 	assert(scale == 1);
 
 	PrepareSymbolDef(dst);
-	PrepareSymbolUse(src1);
-	PrepareSymbolUse(src2);
-
-	m_functionStream.Write8(Wasm::INST_I32_ADD);
+	uint32 offset = PushRefIndexAddress(src1, src2, scale);
 
 	m_functionStream.Write8(Wasm::INST_PREFIX_SIMD);
 	m_functionStream.Write8(Wasm::INST_V128_LOAD);
-	m_functionStream.Write8(0x04);
-	m_functionStream.Write8(0x00);
+	WriteMemArg(0x04, offset);
 
 	CommitSymbol(dst);
 }
@@ -579,8 +573,7 @@ void CCodeGen_Wasm::Emit_Md_StoreAtRef_MemMem(const STATEMENT& statement)
 
 	m_functionStream.Write8(Wasm::INST_PREFIX_SIMD);
 	m_functionStream.Write8(Wasm::INST_V128_STORE);
-	m_functionStream.Write8(0x04);
-	m_functionStream.Write8(0x00);
+	WriteMemArg(0x04, 0);
 }
 
 void CCodeGen_Wasm::Emit_Md_StoreAtRef_MemAnyMem(const STATEMENT& statement)
@@ -592,17 +585,12 @@ void CCodeGen_Wasm::Emit_Md_StoreAtRef_MemAnyMem(const STATEMENT& statement)
 
 	assert(scale == 1);
 
-	PrepareSymbolUse(src1);
-	PrepareSymbolUse(src2);
-
-	m_functionStream.Write8(Wasm::INST_I32_ADD);
-
+	uint32 offset = PushRefIndexAddress(src1, src2, scale);
 	PrepareSymbolUse(src3);
 
 	m_functionStream.Write8(Wasm::INST_PREFIX_SIMD);
 	m_functionStream.Write8(Wasm::INST_V128_STORE);
-	m_functionStream.Write8(0x04);
-	m_functionStream.Write8(0x00);
+	WriteMemArg(0x04, offset);
 }
 
 void CCodeGen_Wasm::Emit_Md_MovMasked_MemMemMem(const STATEMENT& statement)
@@ -763,99 +751,99 @@ void CCodeGen_Wasm::Emit_MergeTo256_MemMemMem(const STATEMENT& statement)
 // clang-format off
 CCodeGen_Wasm::CONSTMATCHER CCodeGen_Wasm::g_mdConstMatchers[] =
 {
-	{ OP_MOV,            MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Mov_MemMem                            },
+	{ OP_MOV,            MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Mov_MemMem                            },
 
-	{ OP_MD_ADD_B,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I8x16_ADD>       },
-	{ OP_MD_ADD_H,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_ADD>       },
-	{ OP_MD_ADD_W,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I32x4_ADD>       },
+	{ OP_MD_ADD_B,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I8x16_ADD>       },
+	{ OP_MD_ADD_H,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_ADD>       },
+	{ OP_MD_ADD_W,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I32x4_ADD>       },
 
-	{ OP_MD_ADDSS_B,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I8x16_ADD_SAT_S> },
-	{ OP_MD_ADDSS_H,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_ADD_SAT_S> },
-	{ OP_MD_ADDSS_W,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_AddSSW_MemMemMem                      },
+	{ OP_MD_ADDSS_B,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I8x16_ADD_SAT_S> },
+	{ OP_MD_ADDSS_H,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_ADD_SAT_S> },
+	{ OP_MD_ADDSS_W,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_AddSSW_MemMemMem                      },
 
-	{ OP_MD_ADDUS_B,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I8x16_ADD_SAT_U> },
-	{ OP_MD_ADDUS_H,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_ADD_SAT_U> },
-	{ OP_MD_ADDUS_W,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_AddUSW_MemMemMem                      },
+	{ OP_MD_ADDUS_B,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I8x16_ADD_SAT_U> },
+	{ OP_MD_ADDUS_H,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_ADD_SAT_U> },
+	{ OP_MD_ADDUS_W,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_AddUSW_MemMemMem                      },
 
-	{ OP_MD_SUB_B,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I8x16_SUB>       },
-	{ OP_MD_SUB_H,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_SUB>       },
-	{ OP_MD_SUB_W,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I32x4_SUB>       },
+	{ OP_MD_SUB_B,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I8x16_SUB>       },
+	{ OP_MD_SUB_H,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_SUB>       },
+	{ OP_MD_SUB_W,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I32x4_SUB>       },
 
-	{ OP_MD_SUBSS_H,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_SUB_SAT_S> },
-	{ OP_MD_SUBSS_W,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_SubSSW_MemMemMem                      },
+	{ OP_MD_SUBSS_H,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_SUB_SAT_S> },
+	{ OP_MD_SUBSS_W,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_SubSSW_MemMemMem                      },
 
-	{ OP_MD_SUBUS_B,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I8x16_SUB_SAT_U> },
-	{ OP_MD_SUBUS_H,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_SUB_SAT_U> },
-	{ OP_MD_SUBUS_W,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_SubUSW_MemMemMem                      },
+	{ OP_MD_SUBUS_B,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I8x16_SUB_SAT_U> },
+	{ OP_MD_SUBUS_H,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_SUB_SAT_U> },
+	{ OP_MD_SUBUS_W,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_SubUSW_MemMemMem                      },
 
 	{ OP_MD_CLAMP_S,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_ClampS_MemMem                         },
 
-	{ OP_MD_CMPEQ_B,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I8x16_EQ>        },
-	{ OP_MD_CMPEQ_H,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_EQ>        },
-	{ OP_MD_CMPEQ_W,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I32x4_EQ>        },
+	{ OP_MD_CMPEQ_B,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I8x16_EQ>        },
+	{ OP_MD_CMPEQ_H,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_EQ>        },
+	{ OP_MD_CMPEQ_W,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I32x4_EQ>        },
 
-	{ OP_MD_CMPGT_B,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I8x16_GT_S>      },
-	{ OP_MD_CMPGT_H,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_GT_S>      },
-	{ OP_MD_CMPGT_W,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I32x4_GT_S>      },
+	{ OP_MD_CMPGT_B,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I8x16_GT_S>      },
+	{ OP_MD_CMPGT_H,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_GT_S>      },
+	{ OP_MD_CMPGT_W,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I32x4_GT_S>      },
 
-	{ OP_MD_MIN_H,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_MIN_S>     },
-	{ OP_MD_MIN_W,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I32x4_MIN_S>     },
+	{ OP_MD_MIN_H,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_MIN_S>     },
+	{ OP_MD_MIN_W,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I32x4_MIN_S>     },
 
-	{ OP_MD_MAX_H,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_MAX_S>     },
-	{ OP_MD_MAX_W,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I32x4_MAX_S>     },
+	{ OP_MD_MAX_H,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I16x8_MAX_S>     },
+	{ OP_MD_MAX_W,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_I32x4_MAX_S>     },
 
-	{ OP_MD_ADD_S,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_ADD>       },
-	{ OP_MD_SUB_S,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_SUB>       },
-	{ OP_MD_MUL_S,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_MUL>       },
-	{ OP_MD_DIV_S,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_DIV>       },
+	{ OP_MD_ADD_S,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_ADD>       },
+	{ OP_MD_SUB_S,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_SUB>       },
+	{ OP_MD_MUL_S,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_MUL>       },
+	{ OP_MD_DIV_S,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_DIV>       },
 
-	{ OP_MD_ABS_S,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMem<Wasm::INST_F32x4_ABS>          },
-	{ OP_MD_MIN_S,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_MIN>       },
-	{ OP_MD_MAX_S,       MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_MAX>       },
+	{ OP_MD_ABS_S,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMem<Wasm::INST_F32x4_ABS>          },
+	{ OP_MD_MIN_S,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_MIN>       },
+	{ OP_MD_MAX_S,       MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_MAX>       },
 
-	{ OP_MD_CMPLT_S,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_LT>        },
-	{ OP_MD_CMPGT_S,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_GT>        },
+	{ OP_MD_CMPLT_S,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_LT>        },
+	{ OP_MD_CMPGT_S,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_F32x4_GT>        },
 
-	{ OP_MD_AND,         MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_V128_AND>        },
-	{ OP_MD_OR,          MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_V128_OR>         },
-	{ OP_MD_XOR,         MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_V128_XOR>        },
-	{ OP_MD_NOT,         MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMem<Wasm::INST_V128_NOT>           },
+	{ OP_MD_AND,         MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_V128_AND>        },
+	{ OP_MD_OR,          MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_V128_OR>         },
+	{ OP_MD_XOR,         MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMemMem<Wasm::INST_V128_XOR>        },
+	{ OP_MD_NOT,         MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMem<Wasm::INST_V128_NOT>           },
 
-	{ OP_MD_SLLH,        MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Shift_MemMemCst<Wasm::INST_I16x8_SHL> },
-	{ OP_MD_SLLW,        MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Shift_MemMemCst<Wasm::INST_I32x4_SHL> },
+	{ OP_MD_SLLH,        MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Shift_MemMemCst<Wasm::INST_I16x8_SHL> },
+	{ OP_MD_SLLW,        MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Shift_MemMemCst<Wasm::INST_I32x4_SHL> },
 
-	{ OP_MD_SRLH,        MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Shift_MemMemCst<Wasm::INST_I16x8_SHR_U> },
-	{ OP_MD_SRLW,        MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Shift_MemMemCst<Wasm::INST_I32x4_SHR_U> },
+	{ OP_MD_SRLH,        MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Shift_MemMemCst<Wasm::INST_I16x8_SHR_U> },
+	{ OP_MD_SRLW,        MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Shift_MemMemCst<Wasm::INST_I32x4_SHR_U> },
 
-	{ OP_MD_SRAH,        MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Shift_MemMemCst<Wasm::INST_I16x8_SHR_S> },
-	{ OP_MD_SRAW,        MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Shift_MemMemCst<Wasm::INST_I32x4_SHR_S> },
+	{ OP_MD_SRAH,        MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Shift_MemMemCst<Wasm::INST_I16x8_SHR_S> },
+	{ OP_MD_SRAW,        MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Shift_MemMemCst<Wasm::INST_I32x4_SHR_S> },
 
-	{ OP_MD_MAKESZ,      MATCH_MEMORY,         MATCH_MEMORY128,      MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MakeSz_MemMem                           },
+	{ OP_MD_MAKESZ,      MATCH_VARIABLE,       MATCH_VARIABLE128,    MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MakeSz_MemMem                           },
 
-	{ OP_MD_TOSINGLE,           MATCH_MEMORY128,    MATCH_MEMORY128,    MATCH_NIL,        MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMem<Wasm::INST_F32x4_CONVERT_I32x4_S>   },
-	{ OP_MD_TOWORD_TRUNCATE,    MATCH_MEMORY128,    MATCH_MEMORY128,    MATCH_NIL,        MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMem<Wasm::INST_I32x4_TRUNC_SAT_F32x4_S> },
+	{ OP_MD_TOSINGLE,           MATCH_VARIABLE128,  MATCH_VARIABLE128,  MATCH_NIL,        MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMem<Wasm::INST_F32x4_CONVERT_I32x4_S>   },
+	{ OP_MD_TOWORD_TRUNCATE,    MATCH_VARIABLE128,  MATCH_VARIABLE128,  MATCH_NIL,        MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MemMem<Wasm::INST_I32x4_TRUNC_SAT_F32x4_S> },
 
-	{ OP_LOADFROMREF,    MATCH_MEMORY128,      MATCH_MEM_REF,        MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_LoadFromRef_MemMem                    },
-	{ OP_LOADFROMREF,    MATCH_MEMORY128,      MATCH_MEM_REF,        MATCH_ANY32,         MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_LoadFromRef_MemMemAny                 },
+	{ OP_LOADFROMREF,    MATCH_VARIABLE128,    MATCH_VAR_REF,        MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_LoadFromRef_MemMem                    },
+	{ OP_LOADFROMREF,    MATCH_VARIABLE128,    MATCH_VAR_REF,        MATCH_ANY32,         MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_LoadFromRef_MemMemAny                 },
 
-	{ OP_STOREATREF,     MATCH_NIL,            MATCH_MEM_REF,        MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_StoreAtRef_MemMem                     },
-	{ OP_STOREATREF,     MATCH_NIL,            MATCH_MEM_REF,        MATCH_ANY32,         MATCH_MEMORY128,&CCodeGen_Wasm::Emit_Md_StoreAtRef_MemAnyMem                  },
+	{ OP_STOREATREF,     MATCH_NIL,            MATCH_VAR_REF,        MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_StoreAtRef_MemMem                     },
+	{ OP_STOREATREF,     MATCH_NIL,            MATCH_VAR_REF,        MATCH_ANY32,         MATCH_VARIABLE128,&CCodeGen_Wasm::Emit_Md_StoreAtRef_MemAnyMem                  },
 
-	{ OP_MD_MOV_MASKED,  MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MovMasked_MemMemMem                   },
+	{ OP_MD_MOV_MASKED,  MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_MovMasked_MemMemMem                   },
 
-	{ OP_MD_EXPAND,      MATCH_MEMORY128,      MATCH_MEMORY,         MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Expand_MemAny                         },
-	{ OP_MD_EXPAND,      MATCH_MEMORY128,      MATCH_CONSTANT,       MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Expand_MemAny                         },
+	{ OP_MD_EXPAND,      MATCH_VARIABLE128,    MATCH_VARIABLE,       MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Expand_MemAny                         },
+	{ OP_MD_EXPAND,      MATCH_VARIABLE128,    MATCH_CONSTANT,       MATCH_NIL,           MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Expand_MemAny                         },
 
-	{ OP_MD_PACK_HB,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_packHBShuffle>  },
-	{ OP_MD_PACK_WH,     MATCH_MEMORY128,      MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_packWHShuffle>  },
+	{ OP_MD_PACK_HB,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_packHBShuffle>  },
+	{ OP_MD_PACK_WH,     MATCH_VARIABLE128,    MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_packWHShuffle>  },
 
-	{ OP_MD_UNPACK_LOWER_BH, MATCH_MEMORY128,  MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_unpackLowerBHShuffle> },
-	{ OP_MD_UNPACK_LOWER_HW, MATCH_MEMORY128,  MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_unpackLowerHWShuffle> },
-	{ OP_MD_UNPACK_LOWER_WD, MATCH_MEMORY128,  MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_unpackLowerWDShuffle> },
+	{ OP_MD_UNPACK_LOWER_BH, MATCH_VARIABLE128,MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_unpackLowerBHShuffle> },
+	{ OP_MD_UNPACK_LOWER_HW, MATCH_VARIABLE128,MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_unpackLowerHWShuffle> },
+	{ OP_MD_UNPACK_LOWER_WD, MATCH_VARIABLE128,MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_unpackLowerWDShuffle> },
 
-	{ OP_MD_UNPACK_UPPER_BH, MATCH_MEMORY128,  MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_unpackUpperBHShuffle> },
-	{ OP_MD_UNPACK_UPPER_HW, MATCH_MEMORY128,  MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_unpackUpperHWShuffle> },
-	{ OP_MD_UNPACK_UPPER_WD, MATCH_MEMORY128,  MATCH_MEMORY128,      MATCH_MEMORY128,     MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_unpackUpperWDShuffle> },
+	{ OP_MD_UNPACK_UPPER_BH, MATCH_VARIABLE128,MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_unpackUpperBHShuffle> },
+	{ OP_MD_UNPACK_UPPER_HW, MATCH_VARIABLE128,MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_unpackUpperHWShuffle> },
+	{ OP_MD_UNPACK_UPPER_WD, MATCH_VARIABLE128,MATCH_VARIABLE128,    MATCH_VARIABLE128,   MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Unpack_MemMemMemRev<g_unpackUpperWDShuffle> },
 
 	{ OP_MD_SRL256,      MATCH_VARIABLE128,    MATCH_MEMORY256,      MATCH_VARIABLE,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Srl256_MemMemVar                      },
 	{ OP_MD_SRL256,      MATCH_VARIABLE128,    MATCH_MEMORY256,      MATCH_CONSTANT,      MATCH_NIL,      &CCodeGen_Wasm::Emit_Md_Srl256_MemMemCst                      },
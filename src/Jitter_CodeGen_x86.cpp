@@ -19,7 +19,8 @@ CX86Assembler::REGISTER CCodeGen_x86::g_baseRegister = CX86Assembler::rBP;
 // clang-format off
 CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_constMatchers[] = 
 { 
-	{ OP_LABEL, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, &CCodeGen_x86::MarkLabel  },
+	{ OP_LABEL,      MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, &CCodeGen_x86::MarkLabel     },
+	{ OP_LABEL_COLD, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, &CCodeGen_x86::MarkColdLabel },
 
 	{ OP_NOP,   MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, &CCodeGen_x86::Emit_Nop   },
 	{ OP_BREAK, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, &CCodeGen_x86::Emit_Break },
@@ -56,6 +57,7 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_constMatchers[] =
 	{ OP_CONDJMP, MATCH_NIL, MATCH_REGISTER, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_CondJmp_RegCst },
 	{ OP_CONDJMP, MATCH_NIL, MATCH_MEMORY,   MATCH_MEMORY,   MATCH_NIL, &CCodeGen_x86::Emit_CondJmp_MemMem },
 	{ OP_CONDJMP, MATCH_NIL, MATCH_MEMORY,   MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_CondJmp_MemCst },
+	{ OP_CONDJMP, MATCH_NIL, MATCH_MEMORY64, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_CondJmp_Mem64Cst },
 
 	{ OP_DIV, MATCH_MEMORY64, MATCH_VARIABLE, MATCH_VARIABLE, MATCH_NIL, &CCodeGen_x86::Emit_DivMem64VarVar<false> },
 	{ OP_DIV, MATCH_MEMORY64, MATCH_VARIABLE, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_DivMem64VarCst<false> },
@@ -71,11 +73,18 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_constMatchers[] =
 	{ OP_MULS, MATCH_MEMORY64, MATCH_VARIABLE, MATCH_VARIABLE, MATCH_NIL, &CCodeGen_x86::Emit_MulMem64VarVar<true> },
 	{ OP_MULS, MATCH_MEMORY64, MATCH_VARIABLE, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_MulMem64VarCst<true> },
 
+	{ OP_ADDOVF,     MATCH_MEMORY64, MATCH_ANY32, MATCH_ANY32, MATCH_NIL,   &CCodeGen_x86::Emit_AluFlag_Mem64AnyAny },
+	{ OP_ADDCARRY,   MATCH_MEMORY64, MATCH_ANY32, MATCH_ANY32, MATCH_NIL,   &CCodeGen_x86::Emit_AluFlag_Mem64AnyAny },
+	{ OP_ADC,        MATCH_MEMORY64, MATCH_ANY32, MATCH_ANY32, MATCH_ANY32, &CCodeGen_x86::Emit_AluFlag_Mem64AnyAny },
+	{ OP_SUBOVF,     MATCH_MEMORY64, MATCH_ANY32, MATCH_ANY32, MATCH_NIL,   &CCodeGen_x86::Emit_AluFlag_Mem64AnyAny },
+	{ OP_SUBBORROW,  MATCH_MEMORY64, MATCH_ANY32, MATCH_ANY32, MATCH_NIL,   &CCodeGen_x86::Emit_AluFlag_Mem64AnyAny },
+
 	{ OP_MERGETO64, MATCH_MEMORY64, MATCH_REGISTER, MATCH_REGISTER, MATCH_NIL, &CCodeGen_x86::Emit_MergeTo64_Mem64RegReg },
 	{ OP_MERGETO64, MATCH_MEMORY64, MATCH_REGISTER, MATCH_MEMORY,   MATCH_NIL, &CCodeGen_x86::Emit_MergeTo64_Mem64RegMem },
 	{ OP_MERGETO64, MATCH_MEMORY64, MATCH_REGISTER, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_MergeTo64_Mem64RegCst },
 	{ OP_MERGETO64, MATCH_MEMORY64, MATCH_MEMORY,   MATCH_REGISTER, MATCH_NIL, &CCodeGen_x86::Emit_MergeTo64_Mem64MemReg },
 	{ OP_MERGETO64, MATCH_MEMORY64, MATCH_MEMORY,   MATCH_MEMORY,   MATCH_NIL, &CCodeGen_x86::Emit_MergeTo64_Mem64MemMem },
+	{ OP_MERGETO64, MATCH_MEMORY64, MATCH_MEMORY,   MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86::Emit_MergeTo64_Mem64MemCst },
 	{ OP_MERGETO64, MATCH_MEMORY64, MATCH_CONSTANT, MATCH_REGISTER, MATCH_NIL, &CCodeGen_x86::Emit_MergeTo64_Mem64CstReg },
 	{ OP_MERGETO64, MATCH_MEMORY64, MATCH_CONSTANT, MATCH_MEMORY,   MATCH_NIL, &CCodeGen_x86::Emit_MergeTo64_Mem64CstMem },
 
@@ -104,6 +113,18 @@ CCodeGen_x86::CONSTMATCHER CCodeGen_x86::g_constMatchers[] =
 	{ OP_STORE16ATREF, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32,    MATCH_VARIABLE, &CCodeGen_x86::Emit_Store16AtRef_VarAnyVar },
 	{ OP_STORE16ATREF, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32,    MATCH_CONSTANT, &CCodeGen_x86::Emit_Store16AtRef_VarAnyCst },
 
+	{ OP_LOADFROMREFBSWAP, MATCH_VARIABLE, MATCH_VAR_REF, MATCH_NIL,   MATCH_NIL, &CCodeGen_x86::Emit_LoadFromRefBSwap_VarVar    },
+	{ OP_LOADFROMREFBSWAP, MATCH_VARIABLE, MATCH_VAR_REF, MATCH_ANY32, MATCH_NIL, &CCodeGen_x86::Emit_LoadFromRefBSwap_VarVarAny },
+
+	{ OP_LOAD16FROMREFBSWAP, MATCH_VARIABLE, MATCH_VAR_REF, MATCH_NIL,   MATCH_NIL, &CCodeGen_x86::Emit_Load16FromRefBSwap_VarVar    },
+	{ OP_LOAD16FROMREFBSWAP, MATCH_VARIABLE, MATCH_VAR_REF, MATCH_ANY32, MATCH_NIL, &CCodeGen_x86::Emit_Load16FromRefBSwap_VarVarAny },
+
+	{ OP_STOREATREFBSWAP, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32, MATCH_NIL,   &CCodeGen_x86::Emit_StoreAtRefBSwap_VarAny    },
+	{ OP_STOREATREFBSWAP, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32, MATCH_ANY32, &CCodeGen_x86::Emit_StoreAtRefBSwap_VarAnyAny },
+
+	{ OP_STORE16ATREFBSWAP, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32, MATCH_NIL,   &CCodeGen_x86::Emit_Store16AtRefBSwap_VarAny    },
+	{ OP_STORE16ATREFBSWAP, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32, MATCH_ANY32, &CCodeGen_x86::Emit_Store16AtRefBSwap_VarAnyAny },
+
 	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
 };
 // clang-format on
@@ -166,6 +187,13 @@ void CCodeGen_x86::GenerateCode(const StatementList& statements, unsigned int st
 	//Align stacksize
 	stackSize = (stackSize + 0xF) & ~0xF;
 	m_stackLevel = 0;
+	m_codeRegionRelocations.clear();
+	m_liveFlagStatement = nullptr;
+
+	if(m_coldStream && m_externalSymbolReferencedHandler)
+	{
+		throw std::runtime_error("Cold code region can't be used when referencing external symbols.");
+	}
 
 	m_assembler.Begin();
 	{
@@ -196,6 +224,14 @@ void CCodeGen_x86::GenerateCode(const StatementList& statements, unsigned int st
 			{
 				throw std::exception();
 			}
+			UpdateLiveFlags(statement);
+		}
+
+		if(m_coldStream)
+		{
+			//Epilog always goes in the hot region
+			m_assembler.SetColdRegion(false);
+			m_assembler.MarkLabel(m_assembler.CreateLabel());
 		}
 
 		Emit_Epilog();
@@ -203,6 +239,8 @@ void CCodeGen_x86::GenerateCode(const StatementList& statements, unsigned int st
 	}
 	m_assembler.End();
 
+	m_codeRegionRelocations = m_assembler.GetRegionRelocations();
+
 	if(m_externalSymbolReferencedHandler)
 	{
 		for(const auto& symbolRefLabel : m_symbolReferenceLabels)
@@ -236,6 +274,12 @@ void CCodeGen_x86::SetStream(Framework::CStream* stream)
 	m_assembler.SetStream(stream);
 }
 
+void CCodeGen_x86::SetColdStream(Framework::CStream* stream)
+{
+	m_coldStream = stream;
+	m_assembler.SetColdStream(stream);
+}
+
 void CCodeGen_x86::RegisterExternalSymbols(CObjectFile*) const
 {
 	//Nothing to register
@@ -251,6 +295,36 @@ bool CCodeGen_x86::SupportsExternalJumps() const
 	return true;
 }
 
+bool CCodeGen_x86::SupportsBlockPlacement() const
+{
+	return true;
+}
+
+bool CCodeGen_x86::SupportsColdRegion() const
+{
+	return true;
+}
+
+bool CCodeGen_x86::SupportsMemoryBase() const
+{
+	return false;
+}
+
+bool CCodeGen_x86::SupportsRefIndexDisplacement() const
+{
+	return true;
+}
+
+bool CCodeGen_x86::SupportsAluFlagBranches() const
+{
+	return true;
+}
+
+bool CCodeGen_x86::SupportsNestedLoops() const
+{
+	return true;
+}
+
 CX86Assembler::LABEL CCodeGen_x86::GetLabel(uint32 blockId)
 {
 	CX86Assembler::LABEL result;
@@ -368,18 +442,18 @@ CX86Assembler::CAddress CCodeGen_x86::MakeVariableReferenceSymbolAddress(CSymbol
 }
 
 CX86Assembler::CAddress CCodeGen_x86::MakeRefBaseScaleSymbolAddress(CSymbol* baseSymbol, CX86Assembler::REGISTER baseRegister,
-                                                                    CSymbol* indexSymbol, CX86Assembler::REGISTER indexRegister, uint8 scale)
+                                                                    CSymbol* indexSymbol, CX86Assembler::REGISTER indexRegister, uint8 scale, uint32 displacement)
 {
 	baseRegister = PrepareRefSymbolRegisterUse(baseSymbol, baseRegister);
 	if(indexSymbol->IsConstant())
 	{
 		uint32 scaledIndex = indexSymbol->m_valueLow * scale;
-		return CX86Assembler::MakeIndRegOffAddress(baseRegister, scaledIndex);
+		return CX86Assembler::MakeIndRegOffAddress(baseRegister, scaledIndex + displacement);
 	}
 	else
 	{
 		indexRegister = PrepareSymbolRegisterUse(indexSymbol, indexRegister);
-		return CX86Assembler::MakeBaseOffIndexScaleAddress(baseRegister, 0, indexRegister, scale);
+		return CX86Assembler::MakeBaseOffIndexScaleAddress(baseRegister, displacement, indexRegister, scale);
 	}
 }
 
@@ -476,6 +550,14 @@ CX86Assembler::CAddress CCodeGen_x86::MakeMemory64SymbolHiAddress(CSymbol* symbo
 void CCodeGen_x86::MarkLabel(const STATEMENT& statement)
 {
 	CX86Assembler::LABEL label = GetLabel(statement.jmpBlock);
+	m_assembler.SetColdRegion(false);
+	m_assembler.MarkLabel(label);
+}
+
+void CCodeGen_x86::MarkColdLabel(const STATEMENT& statement)
+{
+	CX86Assembler::LABEL label = GetLabel(statement.jmpBlock);
+	m_assembler.SetColdRegion(true);
 	m_assembler.MarkLabel(label);
 }
 
@@ -721,6 +803,21 @@ void CCodeGen_x86::Emit_MergeTo64_Mem64MemMem(const STATEMENT& statement)
 	m_assembler.MovGd(MakeMemory64SymbolHiAddress(dst), CX86Assembler::rDX);
 }
 
+void CCodeGen_x86::Emit_MergeTo64_Mem64MemCst(const STATEMENT& statement)
+{
+	CSymbol* dst = statement.dst->GetSymbol().get();
+	CSymbol* src1 = statement.src1->GetSymbol().get();
+	CSymbol* src2 = statement.src2->GetSymbol().get();
+
+	assert(src2->m_type == SYM_CONSTANT);
+
+	m_assembler.MovEd(CX86Assembler::rAX, MakeMemorySymbolAddress(src1));
+	m_assembler.MovId(CX86Assembler::rDX, src2->m_valueLow);
+
+	m_assembler.MovGd(MakeMemory64SymbolLoAddress(dst), CX86Assembler::rAX);
+	m_assembler.MovGd(MakeMemory64SymbolHiAddress(dst), CX86Assembler::rDX);
+}
+
 void CCodeGen_x86::Emit_MergeTo64_Mem64CstReg(const STATEMENT& statement)
 {
 	CSymbol* dst = statement.dst->GetSymbol().get();
@@ -751,6 +848,103 @@ void CCodeGen_x86::Emit_MergeTo64_Mem64CstMem(const STATEMENT& statement)
 	m_assembler.MovGd(MakeMemory64SymbolHiAddress(dst), CX86Assembler::rDX);
 }
 
+void CCodeGen_x86::Emit_AluFlag_Mem64AnyAny(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto resultRegister = CX86Assembler::rAX;
+	auto flagRegister = CX86Assembler::rDX;
+	auto resultRegisterAddress = CX86Assembler::MakeRegisterAddress(resultRegister);
+
+	if(src1->m_type == SYM_CONSTANT)
+	{
+		m_assembler.MovId(resultRegister, src1->m_valueLow);
+	}
+	else
+	{
+		m_assembler.MovEd(resultRegister, MakeVariableSymbolAddress(src1));
+	}
+
+	//Flag register needs to be cleared before the operation since XOR clobbers the flags
+	m_assembler.XorEd(flagRegister, CX86Assembler::MakeRegisterAddress(flagRegister));
+
+	if(statement.op == OP_ADC)
+	{
+		//NEG sets CF if the carry in is not 0
+		auto src3 = statement.src3->GetSymbol().get();
+		auto carryRegister = PrepareSymbolRegisterUse(src3, CX86Assembler::rCX);
+		if(carryRegister != CX86Assembler::rCX)
+		{
+			m_assembler.MovEd(CX86Assembler::rCX, CX86Assembler::MakeRegisterAddress(carryRegister));
+		}
+		m_assembler.NegEd(CX86Assembler::MakeRegisterAddress(CX86Assembler::rCX));
+	}
+
+	switch(statement.op)
+	{
+	case OP_ADDOVF:
+	case OP_ADDCARRY:
+		if(src2->m_type == SYM_CONSTANT)
+		{
+			m_assembler.AddId(resultRegisterAddress, src2->m_valueLow);
+		}
+		else
+		{
+			m_assembler.AddEd(resultRegister, MakeVariableSymbolAddress(src2));
+		}
+		break;
+	case OP_ADC:
+		if(src2->m_type == SYM_CONSTANT)
+		{
+			m_assembler.AdcId(resultRegisterAddress, src2->m_valueLow);
+		}
+		else
+		{
+			m_assembler.AdcEd(resultRegister, MakeVariableSymbolAddress(src2));
+		}
+		break;
+	case OP_SUBOVF:
+	case OP_SUBBORROW:
+		if(src2->m_type == SYM_CONSTANT)
+		{
+			m_assembler.SubId(resultRegisterAddress, src2->m_valueLow);
+		}
+		else
+		{
+			m_assembler.SubEd(resultRegister, MakeVariableSymbolAddress(src2));
+		}
+		break;
+	default:
+		assert(false);
+		break;
+	}
+
+	auto flagByteAddress = CX86Assembler::MakeByteRegisterAddress(CX86Assembler::GetByteRegister(flagRegister));
+	switch(statement.op)
+	{
+	case OP_ADDOVF:
+	case OP_SUBOVF:
+		m_assembler.SetoEb(flagByteAddress);
+		break;
+	case OP_ADDCARRY:
+	case OP_ADC:
+	case OP_SUBBORROW:
+		m_assembler.SetbEb(flagByteAddress);
+		break;
+	default:
+		assert(false);
+		break;
+	}
+
+	m_assembler.MovGd(MakeMemory64SymbolLoAddress(dst), resultRegister);
+	m_assembler.MovGd(MakeMemory64SymbolHiAddress(dst), flagRegister);
+
+	//Stores don't modify the flags, a following flag branch can use them directly
+	m_liveFlagStatement = &statement;
+}
+
 void CCodeGen_x86::Emit_ExtLow64VarMem64(const STATEMENT& statement)
 {
 	auto dst = statement.dst->GetSymbol().get();
@@ -792,7 +986,7 @@ void CCodeGen_x86::Emit_LoadFromRef_VarVarAny(const STATEMENT& statement)
 	uint8 scale = static_cast<uint8>(statement.jmpCondition);
 
 	auto dstReg = PrepareSymbolRegisterDef(dst, CX86Assembler::rDX);
-	m_assembler.MovEd(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale));
+	m_assembler.MovEd(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement));
 	CommitSymbolRegister(dst, dstReg);
 }
 
@@ -819,7 +1013,7 @@ void CCodeGen_x86::Emit_Load8FromRef_VarVarAny(const STATEMENT& statement)
 	assert(scale == 1);
 
 	auto dstReg = PrepareSymbolRegisterDef(dst, CX86Assembler::rDX);
-	m_assembler.MovzxEb(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale));
+	m_assembler.MovzxEb(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement));
 	CommitSymbolRegister(dst, dstReg);
 }
 
@@ -846,7 +1040,7 @@ void CCodeGen_x86::Emit_Load16FromRef_VarVarAny(const STATEMENT& statement)
 	assert(scale == 1);
 
 	auto dstReg = PrepareSymbolRegisterDef(dst, CX86Assembler::rDX);
-	m_assembler.MovzxEw(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale));
+	m_assembler.MovzxEw(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement));
 	CommitSymbolRegister(dst, dstReg);
 }
 
@@ -879,7 +1073,7 @@ void CCodeGen_x86::Emit_StoreAtRef_VarAnyVar(const STATEMENT& statement)
 	uint8 scale = static_cast<uint8>(statement.jmpCondition);
 
 	auto valueReg = PrepareSymbolRegisterUse(src3, CX86Assembler::rDX);
-	m_assembler.MovGd(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale), valueReg);
+	m_assembler.MovGd(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement), valueReg);
 }
 
 void CCodeGen_x86::Emit_StoreAtRef_VarAnyCst(const STATEMENT& statement)
@@ -891,7 +1085,7 @@ void CCodeGen_x86::Emit_StoreAtRef_VarAnyCst(const STATEMENT& statement)
 
 	assert(src3->m_type == SYM_CONSTANT);
 
-	m_assembler.MovId(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale), src3->m_valueLow);
+	m_assembler.MovId(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement), src3->m_valueLow);
 }
 
 void CCodeGen_x86::Emit_Store8AtRef_VarCst(const STATEMENT& statement)
@@ -915,7 +1109,7 @@ void CCodeGen_x86::Emit_Store8AtRef_VarAnyCst(const STATEMENT& statement)
 	assert(src3->m_type == SYM_CONSTANT);
 	assert(scale == 1);
 
-	m_assembler.MovIb(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale), static_cast<uint8>(src3->m_valueLow));
+	m_assembler.MovIb(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement), static_cast<uint8>(src3->m_valueLow));
 }
 
 void CCodeGen_x86::Emit_Store16AtRef_VarVar(const STATEMENT& statement)
@@ -949,7 +1143,7 @@ void CCodeGen_x86::Emit_Store16AtRef_VarAnyVar(const STATEMENT& statement)
 	assert(scale == 1);
 
 	auto valueReg = PrepareSymbolRegisterUse(src3, CX86Assembler::rDX);
-	m_assembler.MovGw(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale), valueReg);
+	m_assembler.MovGw(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement), valueReg);
 }
 
 void CCodeGen_x86::Emit_Store16AtRef_VarAnyCst(const STATEMENT& statement)
@@ -962,7 +1156,149 @@ void CCodeGen_x86::Emit_Store16AtRef_VarAnyCst(const STATEMENT& statement)
 	assert(src3->m_type == SYM_CONSTANT);
 	assert(scale == 1);
 
-	m_assembler.MovIw(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale), src3->m_valueLow);
+	m_assembler.MovIw(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement), src3->m_valueLow);
+}
+
+void CCodeGen_x86::LoadBSwap32(CX86Assembler::REGISTER dstReg, const CX86Assembler::CAddress& address)
+{
+	if(m_cpuFeatures.hasMovbe)
+	{
+		m_assembler.MovbeEd(dstReg, address);
+	}
+	else
+	{
+		m_assembler.MovEd(dstReg, address);
+		m_assembler.BswapEd(dstReg);
+	}
+}
+
+void CCodeGen_x86::StoreBSwap32(const CX86Assembler::CAddress& address, CX86Assembler::REGISTER valueReg)
+{
+	if(m_cpuFeatures.hasMovbe)
+	{
+		m_assembler.MovbeGd(address, valueReg);
+	}
+	else
+	{
+		//Value register might be allocated to a symbol, swap a copy
+		if(valueReg != CX86Assembler::rDX)
+		{
+			m_assembler.MovEd(CX86Assembler::rDX, CX86Assembler::MakeRegisterAddress(valueReg));
+		}
+		m_assembler.BswapEd(CX86Assembler::rDX);
+		m_assembler.MovGd(address, CX86Assembler::rDX);
+	}
+}
+
+void CCodeGen_x86::StoreBSwap16(const CX86Assembler::CAddress& address, CX86Assembler::REGISTER valueReg)
+{
+	if(m_cpuFeatures.hasMovbe)
+	{
+		m_assembler.MovbeGw(address, valueReg);
+	}
+	else
+	{
+		if(valueReg != CX86Assembler::rDX)
+		{
+			m_assembler.MovEd(CX86Assembler::rDX, CX86Assembler::MakeRegisterAddress(valueReg));
+		}
+		m_assembler.RolEw(CX86Assembler::MakeRegisterAddress(CX86Assembler::rDX), 8);
+		m_assembler.MovGw(address, CX86Assembler::rDX);
+	}
+}
+
+void CCodeGen_x86::Emit_LoadFromRefBSwap_VarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto addressReg = PrepareRefSymbolRegisterUse(src1, CX86Assembler::rAX);
+	auto dstReg = PrepareSymbolRegisterDef(dst, CX86Assembler::rDX);
+	LoadBSwap32(dstReg, CX86Assembler::MakeIndRegAddress(addressReg));
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_x86::Emit_LoadFromRefBSwap_VarVarAny(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	auto dstReg = PrepareSymbolRegisterDef(dst, CX86Assembler::rDX);
+	LoadBSwap32(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement));
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_x86::Emit_Load16FromRefBSwap_VarVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto addressReg = PrepareRefSymbolRegisterUse(src1, CX86Assembler::rAX);
+	auto dstReg = PrepareSymbolRegisterDef(dst, CX86Assembler::rDX);
+	m_assembler.MovzxEw(dstReg, CX86Assembler::MakeIndRegAddress(addressReg));
+	m_assembler.RolEw(CX86Assembler::MakeRegisterAddress(dstReg), 8);
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_x86::Emit_Load16FromRefBSwap_VarVarAny(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert(scale == 1);
+
+	auto dstReg = PrepareSymbolRegisterDef(dst, CX86Assembler::rDX);
+	m_assembler.MovzxEw(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement));
+	m_assembler.RolEw(CX86Assembler::MakeRegisterAddress(dstReg), 8);
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_x86::Emit_StoreAtRefBSwap_VarAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto valueReg = PrepareSymbolRegisterUse(src2, CX86Assembler::rDX);
+	auto addressReg = PrepareRefSymbolRegisterUse(src1, CX86Assembler::rAX);
+	StoreBSwap32(CX86Assembler::MakeIndRegAddress(addressReg), valueReg);
+}
+
+void CCodeGen_x86::Emit_StoreAtRefBSwap_VarAnyAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	auto valueReg = PrepareSymbolRegisterUse(src3, CX86Assembler::rDX);
+	StoreBSwap32(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement), valueReg);
+}
+
+void CCodeGen_x86::Emit_Store16AtRefBSwap_VarAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto valueReg = PrepareSymbolRegisterUse(src2, CX86Assembler::rDX);
+	auto addressReg = PrepareRefSymbolRegisterUse(src1, CX86Assembler::rAX);
+	StoreBSwap16(CX86Assembler::MakeIndRegAddress(addressReg), valueReg);
+}
+
+void CCodeGen_x86::Emit_Store16AtRefBSwap_VarAnyAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+	FRAMEWORK_MAYBE_UNUSED uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert(scale == 1);
+
+	auto valueReg = PrepareSymbolRegisterUse(src3, CX86Assembler::rDX);
+	StoreBSwap16(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement), valueReg);
 }
 
 void CCodeGen_x86::Cmp_GetFlag(const CX86Assembler::CAddress& dst, CONDITION flag)
@@ -978,6 +1314,9 @@ void CCodeGen_x86::Cmp_GetFlag(const CX86Assembler::CAddress& dst, CONDITION fla
 	case CONDITION_GT:
 		m_assembler.SetgEb(dst);
 		break;
+	case CONDITION_GE:
+		m_assembler.SetgeEb(dst);
+		break;
 	case CONDITION_EQ:
 		m_assembler.SeteEb(dst);
 		break;
@@ -987,9 +1326,15 @@ void CCodeGen_x86::Cmp_GetFlag(const CX86Assembler::CAddress& dst, CONDITION fla
 	case CONDITION_BL:
 		m_assembler.SetbEb(dst);
 		break;
+	case CONDITION_BE:
+		m_assembler.SetbeEb(dst);
+		break;
 	case CONDITION_AB:
 		m_assembler.SetaEb(dst);
 		break;
+	case CONDITION_AE:
+		m_assembler.SetaeEb(dst);
+		break;
 	default:
 		assert(0);
 		break;
@@ -1113,6 +1458,51 @@ void CCodeGen_x86::Emit_CondJmp_MemCst(const STATEMENT& statement)
 	CondJmp_JumpTo(GetLabel(statement.jmpBlock), statement.jmpCondition);
 }
 
+void CCodeGen_x86::Emit_CondJmp_Mem64Cst(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	assert(src2->m_type == SYM_CONSTANT);
+	assert(src2->m_valueLow == 0);
+	assert((statement.jmpCondition == CONDITION_NE) || (statement.jmpCondition == CONDITION_EQ));
+
+	auto label = GetLabel(statement.jmpBlock);
+	bool jumpIfSet = (statement.jmpCondition == CONDITION_NE);
+
+	switch(GetLiveFlagOperation(statement))
+	{
+	case OP_ADDOVF:
+	case OP_SUBOVF:
+		if(jumpIfSet)
+		{
+			m_assembler.JoJx(label);
+		}
+		else
+		{
+			m_assembler.JnoJx(label);
+		}
+		break;
+	case OP_ADDCARRY:
+	case OP_ADC:
+	case OP_SUBBORROW:
+		if(jumpIfSet)
+		{
+			m_assembler.JbJx(label);
+		}
+		else
+		{
+			m_assembler.JnbJx(label);
+		}
+		break;
+	default:
+		//Flags were modified since the operation, test the flag saved in the high part
+		m_assembler.CmpId(MakeMemory64SymbolHiAddress(src1), 0);
+		CondJmp_JumpTo(label, statement.jmpCondition);
+		break;
+	}
+}
+
 CX86Assembler::REGISTER CCodeGen_x86::PrepareSymbolRegisterDef(CSymbol* symbol, CX86Assembler::REGISTER preferedRegister)
 {
 	switch(symbol->m_type)
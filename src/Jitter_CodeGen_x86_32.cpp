@@ -98,6 +98,12 @@ CCodeGen_x86_32::CONSTMATCHER CCodeGen_x86_32::g_constMatchers[] =
 	{ OP_STOREATREF,    MATCH_NIL,          MATCH_VAR_REF,     MATCH_ANY32,      MATCH_MEMORY64,   &CCodeGen_x86_32::Emit_StoreAtRef_64_VarAnyMem },
 	{ OP_STOREATREF,    MATCH_NIL,          MATCH_VAR_REF,     MATCH_ANY32,      MATCH_CONSTANT64, &CCodeGen_x86_32::Emit_StoreAtRef_64_VarAnyCst },
 
+	{ OP_LOADFROMREFBSWAP, MATCH_MEMORY64, MATCH_VAR_REF, MATCH_NIL,   MATCH_NIL, &CCodeGen_x86_32::Emit_LoadFromRefBSwap_64_MemVar    },
+	{ OP_LOADFROMREFBSWAP, MATCH_MEMORY64, MATCH_VAR_REF, MATCH_ANY32, MATCH_NIL, &CCodeGen_x86_32::Emit_LoadFromRefBSwap_64_MemVarAny },
+
+	{ OP_STOREATREFBSWAP, MATCH_NIL, MATCH_VAR_REF, MATCH_MEMORY64, MATCH_NIL,      &CCodeGen_x86_32::Emit_StoreAtRefBSwap_64_VarMem    },
+	{ OP_STOREATREFBSWAP, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32,    MATCH_MEMORY64, &CCodeGen_x86_32::Emit_StoreAtRefBSwap_64_VarAnyMem },
+
 	{ OP_STORE8ATREF,   MATCH_NIL,          MATCH_VAR_REF,     MATCH_VARIABLE,   MATCH_NIL,      &CCodeGen_x86_32::Emit_Store8AtRef_VarVar    },
 	{ OP_STORE8ATREF,   MATCH_NIL,          MATCH_VAR_REF,     MATCH_ANY32,      MATCH_VARIABLE, &CCodeGen_x86_32::Emit_Store8AtRef_VarAnyVar },
 
@@ -1423,7 +1429,7 @@ void CCodeGen_x86_32::Emit_LoadFromRef_64_MemVarAny(const STATEMENT& statement)
 
 	assert(scale == 1);
 
-	auto [loAddr, hiAddr] = MakeRefBaseScaleSymbolAddress64(src1, CX86Assembler::rDX, src2, CX86Assembler::rCX, scale);
+	auto [loAddr, hiAddr] = MakeRefBaseScaleSymbolAddress64(src1, CX86Assembler::rDX, src2, CX86Assembler::rCX, scale, statement.displacement);
 	auto valueReg = CX86Assembler::rAX;
 
 	m_assembler.MovEd(valueReg, loAddr);
@@ -1455,7 +1461,7 @@ void CCodeGen_x86_32::Emit_LoadFromRef_Ref_VarVarAny(const STATEMENT& statement)
 	assert(scale == 4);
 
 	auto dstReg = PrepareRefSymbolRegisterDef(dst, CX86Assembler::rDX);
-	m_assembler.MovEd(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale));
+	m_assembler.MovEd(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement));
 	CommitRefSymbolRegister(dst, dstReg);
 }
 
@@ -1498,7 +1504,7 @@ void CCodeGen_x86_32::Emit_StoreAtRef_64_VarAnyMem(const STATEMENT& statement)
 
 	assert(scale == 1);
 
-	auto [loAddr, hiAddr] = MakeRefBaseScaleSymbolAddress64(src1, CX86Assembler::rDX, src2, CX86Assembler::rCX, scale);
+	auto [loAddr, hiAddr] = MakeRefBaseScaleSymbolAddress64(src1, CX86Assembler::rDX, src2, CX86Assembler::rCX, scale, statement.displacement);
 	auto valueReg = CX86Assembler::rAX;
 
 	m_assembler.MovEd(valueReg, MakeMemory64SymbolLoAddress(src3));
@@ -1517,12 +1523,79 @@ void CCodeGen_x86_32::Emit_StoreAtRef_64_VarAnyCst(const STATEMENT& statement)
 	assert(src3->m_type == SYM_CONSTANT64);
 	assert(scale == 1);
 
-	auto [loAddr, hiAddr] = MakeRefBaseScaleSymbolAddress64(src1, CX86Assembler::rDX, src2, CX86Assembler::rCX, scale);
+	auto [loAddr, hiAddr] = MakeRefBaseScaleSymbolAddress64(src1, CX86Assembler::rDX, src2, CX86Assembler::rCX, scale, statement.displacement);
 
 	m_assembler.MovId(loAddr, src3->m_valueLow);
 	m_assembler.MovId(hiAddr, src3->m_valueHigh);
 }
 
+void CCodeGen_x86_32::Emit_LoadFromRefBSwap_64_MemVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto addressReg = PrepareRefSymbolRegisterUse(src1, CX86Assembler::rDX);
+	auto dstLoReg = CX86Assembler::rAX;
+	auto dstHiReg = CX86Assembler::rCX;
+
+	//Swapping a 64-bit value also exchanges its halves
+	LoadBSwap32(dstLoReg, CX86Assembler::MakeIndRegOffAddress(addressReg, 4));
+	LoadBSwap32(dstHiReg, CX86Assembler::MakeIndRegAddress(addressReg));
+	m_assembler.MovGd(MakeMemory64SymbolLoAddress(dst), dstLoReg);
+	m_assembler.MovGd(MakeMemory64SymbolHiAddress(dst), dstHiReg);
+}
+
+void CCodeGen_x86_32::Emit_LoadFromRefBSwap_64_MemVarAny(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert(scale == 1);
+
+	auto [loAddr, hiAddr] = MakeRefBaseScaleSymbolAddress64(src1, CX86Assembler::rDX, src2, CX86Assembler::rCX, scale, statement.displacement);
+	auto valueReg = CX86Assembler::rAX;
+
+	LoadBSwap32(valueReg, hiAddr);
+	m_assembler.MovGd(MakeMemory64SymbolLoAddress(dst), valueReg);
+	LoadBSwap32(valueReg, loAddr);
+	m_assembler.MovGd(MakeMemory64SymbolHiAddress(dst), valueReg);
+}
+
+void CCodeGen_x86_32::Emit_StoreAtRefBSwap_64_VarMem(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto addressReg = PrepareRefSymbolRegisterUse(src1, CX86Assembler::rAX);
+	auto valueReg = CX86Assembler::rDX;
+
+	m_assembler.MovEd(valueReg, MakeMemory64SymbolHiAddress(src2));
+	StoreBSwap32(CX86Assembler::MakeIndRegAddress(addressReg), valueReg);
+	m_assembler.MovEd(valueReg, MakeMemory64SymbolLoAddress(src2));
+	StoreBSwap32(CX86Assembler::MakeIndRegOffAddress(addressReg, 4), valueReg);
+}
+
+void CCodeGen_x86_32::Emit_StoreAtRefBSwap_64_VarAnyMem(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	assert(scale == 1);
+
+	//StoreBSwap32 uses rDX as a scratch register, keep the address in rAX/rCX
+	auto [loAddr, hiAddr] = MakeRefBaseScaleSymbolAddress64(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement);
+	auto valueReg = CX86Assembler::rDX;
+
+	m_assembler.MovEd(valueReg, MakeMemory64SymbolHiAddress(src3));
+	StoreBSwap32(loAddr, valueReg);
+	m_assembler.MovEd(valueReg, MakeMemory64SymbolLoAddress(src3));
+	StoreBSwap32(hiAddr, valueReg);
+}
+
 void CCodeGen_x86_32::Emit_Store8AtRef_VarVar(const STATEMENT& statement)
 {
 	auto src1 = statement.src1->GetSymbol().get();
@@ -1543,7 +1616,7 @@ void CCodeGen_x86_32::Emit_Store8AtRef_VarAnyVar(const STATEMENT& statement)
 	assert(scale == 1);
 
 	auto valueReg = PrepareSymbolByteRegisterUse(src3, CX86Assembler::rDX);
-	m_assembler.MovGb(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale), valueReg);
+	m_assembler.MovGb(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement), valueReg);
 }
 
 void CCodeGen_x86_32::Emit_CondJmp_Ref_VarCst(const STATEMENT& statement)
@@ -1615,21 +1688,21 @@ void CCodeGen_x86_32::CommitRefSymbolRegister(CSymbol* symbol, CX86Assembler::RE
 }
 
 CCodeGen_x86_32::AddressPair CCodeGen_x86_32::MakeRefBaseScaleSymbolAddress64(CSymbol* baseSymbol, CX86Assembler::REGISTER baseRegister,
-                                                                              CSymbol* indexSymbol, CX86Assembler::REGISTER indexRegister, uint8 scale)
+                                                                              CSymbol* indexSymbol, CX86Assembler::REGISTER indexRegister, uint8 scale, uint32 displacement)
 {
 	baseRegister = PrepareRefSymbolRegisterUse(baseSymbol, baseRegister);
 	if(indexSymbol->IsConstant())
 	{
 		uint32 scaledIndex = indexSymbol->m_valueLow * scale;
 		return std::make_pair(
-		    CX86Assembler::MakeIndRegOffAddress(baseRegister, scaledIndex + 0),
-		    CX86Assembler::MakeIndRegOffAddress(baseRegister, scaledIndex + 4));
+		    CX86Assembler::MakeIndRegOffAddress(baseRegister, scaledIndex + displacement + 0),
+		    CX86Assembler::MakeIndRegOffAddress(baseRegister, scaledIndex + displacement + 4));
 	}
 	else
 	{
 		indexRegister = PrepareSymbolRegisterUse(indexSymbol, indexRegister);
 		return std::make_pair(
-		    CX86Assembler::MakeBaseOffIndexScaleAddress(baseRegister, 0, indexRegister, scale),
-		    CX86Assembler::MakeBaseOffIndexScaleAddress(baseRegister, 4, indexRegister, scale));
+		    CX86Assembler::MakeBaseOffIndexScaleAddress(baseRegister, displacement + 0, indexRegister, scale),
+		    CX86Assembler::MakeBaseOffIndexScaleAddress(baseRegister, displacement + 4, indexRegister, scale));
 	}
 }
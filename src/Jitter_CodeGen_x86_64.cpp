@@ -257,11 +257,25 @@ CCodeGen_x86_64::CONSTMATCHER CCodeGen_x86_64::g_constMatchers[] =
 	{ OP_STOREATREF, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32, MATCH_MEMORY64, &CCodeGen_x86_64::Emit_StoreAtRef_64_VarAnyMem },
 	{ OP_STOREATREF, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32, MATCH_CONSTANT64, &CCodeGen_x86_64::Emit_StoreAtRef_64_VarAnyCst },
 
+	{ OP_LOADFROMREFBSWAP, MATCH_MEMORY64, MATCH_VAR_REF, MATCH_NIL,   MATCH_NIL, &CCodeGen_x86_64::Emit_LoadFromRefBSwap_64_MemVar    },
+	{ OP_LOADFROMREFBSWAP, MATCH_MEMORY64, MATCH_VAR_REF, MATCH_ANY32, MATCH_NIL, &CCodeGen_x86_64::Emit_LoadFromRefBSwap_64_MemVarAny },
+
+	{ OP_STOREATREFBSWAP, MATCH_NIL, MATCH_VAR_REF, MATCH_MEMORY64, MATCH_NIL,      &CCodeGen_x86_64::Emit_StoreAtRefBSwap_64_VarMem    },
+	{ OP_STOREATREFBSWAP, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32,    MATCH_MEMORY64, &CCodeGen_x86_64::Emit_StoreAtRefBSwap_64_VarAnyMem },
+
 	{ OP_STORE8ATREF, MATCH_NIL, MATCH_VAR_REF, MATCH_VARIABLE, MATCH_NIL,      &CCodeGen_x86_64::Emit_Store8AtRef_VarVar },
 	{ OP_STORE8ATREF, MATCH_NIL, MATCH_VAR_REF, MATCH_ANY32,    MATCH_VARIABLE, &CCodeGen_x86_64::Emit_Store8AtRef_VarAnyVar },
 
 	{ OP_CONDJMP, MATCH_NIL, MATCH_VAR_REF, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86_64::Emit_CondJmp_Ref_VarCst },
 
+	{ OP_LOADFROMMEMBASE,   MATCH_VARIABLE, MATCH_ANY, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86_64::Emit_LoadFromMemBase_VarAnyCst   },
+	{ OP_LOAD8FROMMEMBASE,  MATCH_VARIABLE, MATCH_ANY, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86_64::Emit_Load8FromMemBase_VarAnyCst  },
+	{ OP_LOAD16FROMMEMBASE, MATCH_VARIABLE, MATCH_ANY, MATCH_CONSTANT, MATCH_NIL, &CCodeGen_x86_64::Emit_Load16FromMemBase_VarAnyCst },
+
+	{ OP_STOREATMEMBASE,   MATCH_NIL, MATCH_ANY, MATCH_CONSTANT, MATCH_ANY, &CCodeGen_x86_64::Emit_StoreAtMemBase_AnyCstAny   },
+	{ OP_STORE8ATMEMBASE,  MATCH_NIL, MATCH_ANY, MATCH_CONSTANT, MATCH_ANY, &CCodeGen_x86_64::Emit_Store8AtMemBase_AnyCstAny  },
+	{ OP_STORE16ATMEMBASE, MATCH_NIL, MATCH_ANY, MATCH_CONSTANT, MATCH_ANY, &CCodeGen_x86_64::Emit_Store16AtMemBase_AnyCstAny },
+
 	{ OP_MOV, MATCH_NIL, MATCH_NIL, MATCH_NIL, MATCH_NIL, nullptr },
 };
 // clang-format on
@@ -310,9 +324,15 @@ void CCodeGen_x86_64::SetPlatformAbi(PLATFORM_ABI platformAbi)
 	}
 }
 
+CCodeGen_x86_64::PLATFORM_ABI CCodeGen_x86_64::GetPlatformAbi() const
+{
+	return m_platformAbi;
+}
+
 unsigned int CCodeGen_x86_64::GetAvailableRegisterCount() const
 {
-	return m_maxRegisters;
+	//Last register is reserved to hold the memory base pointer
+	return HasMemoryBase() ? (m_maxRegisters - 1) : m_maxRegisters;
 }
 
 unsigned int CCodeGen_x86_64::GetAvailableMdRegisterCount() const
@@ -325,6 +345,11 @@ bool CCodeGen_x86_64::CanHold128BitsReturnValueInRegisters() const
 	return m_hasMdRegRetValues;
 }
 
+bool CCodeGen_x86_64::SupportsMemoryBase() const
+{
+	return true;
+}
+
 uint32 CCodeGen_x86_64::GetPointerSize() const
 {
 	return 8;
@@ -372,6 +397,11 @@ void CCodeGen_x86_64::Emit_Prolog(const StatementList& statements, unsigned int
 	m_assembler.Push(CX86Assembler::rBP);
 	m_assembler.MovEq(CX86Assembler::rBP, CX86Assembler::MakeRegisterAddress(m_paramRegs[0]));
 
+	if(HasMemoryBase())
+	{
+		m_registerUsage |= (1 << (m_maxRegisters - 1));
+	}
+
 	uint32 savedSize = 0;
 	for(unsigned int i = 0; i < m_maxRegisters; i++)
 	{
@@ -392,6 +422,11 @@ void CCodeGen_x86_64::Emit_Prolog(const StatementList& statements, unsigned int
 
 	m_assembler.SubIq(CX86Assembler::MakeRegisterAddress(CX86Assembler::rSP), m_totalStackAlloc);
 
+	if(HasMemoryBase())
+	{
+		m_assembler.MovEq(GetMemoryBaseRegister(), CX86Assembler::MakeIndRegOffAddress(CX86Assembler::rBP, m_memoryBaseOffset));
+	}
+
 	//-------------------------------
 	//Stack Frame
 	//-------------------------------
@@ -812,7 +847,7 @@ void CCodeGen_x86_64::Emit_LoadFromRef_64_MemVarAny(const STATEMENT& statement)
 	uint8 scale = static_cast<uint8>(statement.jmpCondition);
 
 	auto dstReg = CX86Assembler::rDX;
-	m_assembler.MovEq(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale));
+	m_assembler.MovEq(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement));
 	m_assembler.MovGq(MakeMemory64SymbolAddress(dst), dstReg);
 }
 
@@ -839,7 +874,7 @@ void CCodeGen_x86_64::Emit_LoadFromRef_Ref_VarVarAny(const STATEMENT& statement)
 	assert(scale == 8);
 
 	auto dstReg = PrepareRefSymbolRegisterDef(dst, CX86Assembler::rDX);
-	m_assembler.MovEq(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale));
+	m_assembler.MovEq(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement));
 	CommitRefSymbolRegister(dst, dstReg);
 }
 
@@ -876,7 +911,7 @@ void CCodeGen_x86_64::Emit_StoreAtRef_64_VarAnyMem(const STATEMENT& statement)
 	auto valueReg = CX86Assembler::rDX;
 
 	m_assembler.MovEq(valueReg, MakeMemory64SymbolAddress(src3));
-	m_assembler.MovGq(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale), valueReg);
+	m_assembler.MovGq(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement), valueReg);
 }
 
 void CCodeGen_x86_64::Emit_StoreAtRef_64_VarAnyCst(const STATEMENT& statement)
@@ -888,10 +923,94 @@ void CCodeGen_x86_64::Emit_StoreAtRef_64_VarAnyCst(const STATEMENT& statement)
 
 	assert((scale == 1) || (scale == 8));
 
-	WriteConstant64ToAddress(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale),
+	WriteConstant64ToAddress(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement),
 	                         CX86Assembler::rDX, src3->GetConstant64());
 }
 
+void CCodeGen_x86_64::Emit_LoadFromRefBSwap_64_MemVar(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+
+	auto addressReg = PrepareRefSymbolRegisterUse(src1, CX86Assembler::rAX);
+	auto dstReg = CX86Assembler::rCX;
+
+	if(m_cpuFeatures.hasMovbe)
+	{
+		m_assembler.MovbeEq(dstReg, CX86Assembler::MakeIndRegAddress(addressReg));
+	}
+	else
+	{
+		m_assembler.MovEq(dstReg, CX86Assembler::MakeIndRegAddress(addressReg));
+		m_assembler.BswapEq(dstReg);
+	}
+	m_assembler.MovGq(MakeMemory64SymbolAddress(dst), dstReg);
+}
+
+void CCodeGen_x86_64::Emit_LoadFromRefBSwap_64_MemVarAny(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	auto dstReg = CX86Assembler::rDX;
+	auto address = MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement);
+
+	if(m_cpuFeatures.hasMovbe)
+	{
+		m_assembler.MovbeEq(dstReg, address);
+	}
+	else
+	{
+		m_assembler.MovEq(dstReg, address);
+		m_assembler.BswapEq(dstReg);
+	}
+	m_assembler.MovGq(MakeMemory64SymbolAddress(dst), dstReg);
+}
+
+void CCodeGen_x86_64::Emit_StoreAtRefBSwap_64_VarMem(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto addressReg = PrepareRefSymbolRegisterUse(src1, CX86Assembler::rAX);
+	auto valueReg = CX86Assembler::rDX;
+
+	m_assembler.MovEq(valueReg, MakeMemory64SymbolAddress(src2));
+	if(m_cpuFeatures.hasMovbe)
+	{
+		m_assembler.MovbeGq(CX86Assembler::MakeIndRegAddress(addressReg), valueReg);
+	}
+	else
+	{
+		m_assembler.BswapEq(valueReg);
+		m_assembler.MovGq(CX86Assembler::MakeIndRegAddress(addressReg), valueReg);
+	}
+}
+
+void CCodeGen_x86_64::Emit_StoreAtRefBSwap_64_VarAnyMem(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+	uint8 scale = static_cast<uint8>(statement.jmpCondition);
+
+	auto valueReg = CX86Assembler::rDX;
+
+	m_assembler.MovEq(valueReg, MakeMemory64SymbolAddress(src3));
+	auto address = MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement);
+	if(m_cpuFeatures.hasMovbe)
+	{
+		m_assembler.MovbeGq(address, valueReg);
+	}
+	else
+	{
+		m_assembler.BswapEq(valueReg);
+		m_assembler.MovGq(address, valueReg);
+	}
+}
+
 void CCodeGen_x86_64::Emit_Store8AtRef_VarVar(const STATEMENT& statement)
 {
 	auto src1 = statement.src1->GetSymbol().get();
@@ -910,7 +1029,7 @@ void CCodeGen_x86_64::Emit_Store8AtRef_VarAnyVar(const STATEMENT& statement)
 	uint8 scale = static_cast<uint8>(statement.jmpCondition);
 
 	auto valueReg = PrepareSymbolRegisterUse(src3, CX86Assembler::rDX);
-	m_assembler.MovGb(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale), valueReg);
+	m_assembler.MovGb(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement), valueReg);
 }
 
 void CCodeGen_x86_64::Emit_CondJmp_Ref_VarCst(const STATEMENT& statement)
@@ -929,6 +1048,84 @@ void CCodeGen_x86_64::Emit_CondJmp_Ref_VarCst(const STATEMENT& statement)
 	CondJmp_JumpTo(GetLabel(statement.jmpBlock), statement.jmpCondition);
 }
 
+CX86Assembler::REGISTER CCodeGen_x86_64::GetMemoryBaseRegister() const
+{
+	assert(HasMemoryBase());
+	return m_registers[m_maxRegisters - 1];
+}
+
+CX86Assembler::CAddress CCodeGen_x86_64::MakeMemBaseAddress(CSymbol* indexSymbol, CSymbol* displacementSymbol)
+{
+	assert(displacementSymbol->m_type == SYM_CONSTANT);
+	assert(displacementSymbol->m_valueLow < 0x80000000);
+	//Registers holding 32-bit values are always zero extended
+	auto indexReg = PrepareSymbolRegisterUse(indexSymbol, CX86Assembler::rCX);
+	return CX86Assembler::MakeBaseOffIndexScaleAddress(GetMemoryBaseRegister(), displacementSymbol->m_valueLow, indexReg, 1);
+}
+
+void CCodeGen_x86_64::Emit_LoadFromMemBase_VarAnyCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto dstReg = PrepareSymbolRegisterDef(dst, CX86Assembler::rDX);
+	m_assembler.MovEd(dstReg, MakeMemBaseAddress(src1, src2));
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_x86_64::Emit_Load8FromMemBase_VarAnyCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto dstReg = PrepareSymbolRegisterDef(dst, CX86Assembler::rDX);
+	m_assembler.MovzxEb(dstReg, MakeMemBaseAddress(src1, src2));
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_x86_64::Emit_Load16FromMemBase_VarAnyCst(const STATEMENT& statement)
+{
+	auto dst = statement.dst->GetSymbol().get();
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+
+	auto dstReg = PrepareSymbolRegisterDef(dst, CX86Assembler::rDX);
+	m_assembler.MovzxEw(dstReg, MakeMemBaseAddress(src1, src2));
+	CommitSymbolRegister(dst, dstReg);
+}
+
+void CCodeGen_x86_64::Emit_StoreAtMemBase_AnyCstAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	auto valueReg = PrepareSymbolRegisterUse(src3, CX86Assembler::rDX);
+	m_assembler.MovGd(MakeMemBaseAddress(src1, src2), valueReg);
+}
+
+void CCodeGen_x86_64::Emit_Store8AtMemBase_AnyCstAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	auto valueReg = PrepareSymbolRegisterUse(src3, CX86Assembler::rDX);
+	m_assembler.MovGb(MakeMemBaseAddress(src1, src2), valueReg);
+}
+
+void CCodeGen_x86_64::Emit_Store16AtMemBase_AnyCstAny(const STATEMENT& statement)
+{
+	auto src1 = statement.src1->GetSymbol().get();
+	auto src2 = statement.src2->GetSymbol().get();
+	auto src3 = statement.src3->GetSymbol().get();
+
+	auto valueReg = PrepareSymbolRegisterUse(src3, CX86Assembler::rDX);
+	m_assembler.MovGw(MakeMemBaseAddress(src1, src2), valueReg);
+}
+
 CX86Assembler::REGISTER CCodeGen_x86_64::PrepareRefSymbolRegisterDef(CSymbol* symbol, CX86Assembler::REGISTER preferedRegister)
 {
 	switch(symbol->m_type)
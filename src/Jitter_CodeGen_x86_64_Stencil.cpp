@@ -0,0 +1,527 @@
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include "Jitter_CodeGen_x86_64_Stencil.h"
+#include "MemStream.h"
+
+using namespace Jitter;
+
+enum STENCIL_OPERAND
+{
+	STENCIL_OPERAND_NONE,
+	STENCIL_OPERAND_RELATIVE,
+	STENCIL_OPERAND_TEMPORARY,
+	STENCIL_OPERAND_CONSTANT,
+};
+
+enum STENCIL_HOLE
+{
+	STENCIL_HOLE_DST,
+	STENCIL_HOLE_SRC1,
+	STENCIL_HOLE_SRC2,
+	STENCIL_HOLE_STACKSIZE,
+	STENCIL_HOLE_JUMP,
+	STENCIL_HOLE_MAX,
+};
+
+struct STENCIL
+{
+	std::vector<uint8> code;
+	uint32 holeOffsets[STENCIL_HOLE_MAX] = {};
+	uint32 holeMask = 0;
+};
+
+struct STENCIL_LIBRARY
+{
+	std::unordered_map<uint32, STENCIL> stencils;
+	STENCIL prologs[2];
+	STENCIL epilog;
+};
+
+//Values written in place of operands when assembling stencils. They are large enough to
+//force 32-bit displacements and immediates, and are replaced by the actual operand values
+//every time a stencil is copied.
+static const uint32 g_holeMarkers[STENCIL_HOLE_MAX] =
+{
+	0x11223340,
+	0x11223344,
+	0x11223348,
+	0x1122334C,
+	0x11223350,
+};
+
+//Indexed by PLATFORM_ABI
+static const CX86Assembler::REGISTER g_contextParamRegs[2] =
+{
+	CX86Assembler::rDI,
+	CX86Assembler::rCX,
+};
+
+static uint32 MakeStencilKey(OPERATION op, CONDITION condition, STENCIL_OPERAND dst, STENCIL_OPERAND src1, STENCIL_OPERAND src2)
+{
+	return (op << 16) | (condition << 8) | (dst << 4) | (src1 << 2) | src2;
+}
+
+static STENCIL_OPERAND GetStencilOperand(const SymbolRefPtr& symbolRef)
+{
+	if(!symbolRef) return STENCIL_OPERAND_NONE;
+	switch(symbolRef->GetSymbol()->m_type)
+	{
+	case SYM_RELATIVE:
+		return STENCIL_OPERAND_RELATIVE;
+	case SYM_TEMPORARY:
+		return STENCIL_OPERAND_TEMPORARY;
+	case SYM_CONSTANT:
+		return STENCIL_OPERAND_CONSTANT;
+	default:
+		return STENCIL_OPERAND_NONE;
+	}
+}
+
+static CX86Assembler::CAddress MakeStencilOperandAddress(STENCIL_OPERAND operand, STENCIL_HOLE hole)
+{
+	switch(operand)
+	{
+	case STENCIL_OPERAND_RELATIVE:
+		return CX86Assembler::MakeIndRegOffAddress(CX86Assembler::rBP, g_holeMarkers[hole]);
+	case STENCIL_OPERAND_TEMPORARY:
+		return CX86Assembler::MakeIndRegOffAddress(CX86Assembler::rSP, g_holeMarkers[hole]);
+	default:
+		assert(false);
+		throw std::runtime_error("Operand can't be addressed.");
+	}
+}
+
+static void LoadStencilOperand(CX86Assembler& assembler, CX86Assembler::REGISTER reg, STENCIL_OPERAND operand, STENCIL_HOLE hole)
+{
+	if(operand == STENCIL_OPERAND_CONSTANT)
+	{
+		assembler.MovId(reg, g_holeMarkers[hole]);
+	}
+	else
+	{
+		assembler.MovEd(reg, MakeStencilOperandAddress(operand, hole));
+	}
+}
+
+static void FindStencilHoles(STENCIL& stencil)
+{
+	for(uint32 hole = 0; hole < STENCIL_HOLE_MAX; hole++)
+	{
+		uint32 marker = g_holeMarkers[hole];
+		for(uint32 offset = 0; (offset + 4) <= stencil.code.size(); offset++)
+		{
+			if(memcmp(stencil.code.data() + offset, &marker, 4) != 0) continue;
+			assert((stencil.holeMask & (1 << hole)) == 0);
+			stencil.holeOffsets[hole] = offset;
+			stencil.holeMask |= (1 << hole);
+		}
+	}
+}
+
+template <typename EmitterType>
+static STENCIL AssembleStencil(const EmitterType& emitter)
+{
+	Framework::CMemStream stream;
+	CX86Assembler assembler;
+	assembler.SetStream(&stream);
+	assembler.Begin();
+	assembler.MarkLabel(assembler.CreateLabel());
+	emitter(assembler);
+	//Marks the end of the code, the stream also contains the literal pool's alignment padding
+	auto endLabel = assembler.CreateLabel();
+	assembler.MarkLabel(endLabel);
+	assembler.End();
+
+	STENCIL stencil;
+	stencil.code.assign(stream.GetBuffer(), stream.GetBuffer() + assembler.GetLabelOffset(endLabel));
+	return stencil;
+}
+
+static void AppendJumpStencil(STENCIL& stencil, const std::vector<uint8>& opcode)
+{
+	stencil.code.insert(stencil.code.end(), opcode.begin(), opcode.end());
+	const auto* marker = reinterpret_cast<const uint8*>(&g_holeMarkers[STENCIL_HOLE_JUMP]);
+	stencil.code.insert(stencil.code.end(), marker, marker + 4);
+}
+
+static uint8 GetConditionCode(CONDITION condition)
+{
+	switch(condition)
+	{
+	case CONDITION_EQ:
+		return 0x4;
+	case CONDITION_NE:
+		return 0x5;
+	case CONDITION_BL:
+		return 0x2;
+	case CONDITION_BE:
+		return 0x6;
+	case CONDITION_AB:
+		return 0x7;
+	case CONDITION_AE:
+		return 0x3;
+	case CONDITION_LT:
+		return 0xC;
+	case CONDITION_LE:
+		return 0xE;
+	case CONDITION_GT:
+		return 0xF;
+	case CONDITION_GE:
+		return 0xD;
+	default:
+		assert(false);
+		return 0;
+	}
+}
+
+static STENCIL_LIBRARY BuildStencilLibrary()
+{
+	typedef void (CX86Assembler::*AluEdType)(CX86Assembler::REGISTER, const CX86Assembler::CAddress&);
+	typedef void (CX86Assembler::*AluIdType)(const CX86Assembler::CAddress&, uint32);
+	typedef void (CX86Assembler::*ShiftType)(const CX86Assembler::CAddress&);
+	typedef void (CX86Assembler::*SetccType)(const CX86Assembler::CAddress&);
+
+	struct ALUOP
+	{
+		OPERATION op;
+		AluEdType opEd;
+		AluIdType opId;
+	};
+
+	struct SHIFTOP
+	{
+		OPERATION op;
+		ShiftType opCl;
+	};
+
+	struct CMPOP
+	{
+		CONDITION condition;
+		SetccType setcc;
+	};
+
+	static const ALUOP aluOps[] =
+	{
+		{ OP_ADD, &CX86Assembler::AddEd, &CX86Assembler::AddId },
+		{ OP_SUB, &CX86Assembler::SubEd, &CX86Assembler::SubId },
+		{ OP_AND, &CX86Assembler::AndEd, &CX86Assembler::AndId },
+		{ OP_OR,  &CX86Assembler::OrEd,  &CX86Assembler::OrId  },
+		{ OP_XOR, &CX86Assembler::XorEd, &CX86Assembler::XorId },
+	};
+
+	static const SHIFTOP shiftOps[] =
+	{
+		{ OP_SLL, &CX86Assembler::ShlEd },
+		{ OP_SRL, &CX86Assembler::ShrEd },
+		{ OP_SRA, &CX86Assembler::SarEd },
+	};
+
+	static const CMPOP cmpOps[] =
+	{
+		{ CONDITION_EQ, &CX86Assembler::SeteEb  },
+		{ CONDITION_NE, &CX86Assembler::SetneEb },
+		{ CONDITION_BL, &CX86Assembler::SetbEb  },
+		{ CONDITION_BE, &CX86Assembler::SetbeEb },
+		{ CONDITION_AB, &CX86Assembler::SetaEb  },
+		{ CONDITION_AE, &CX86Assembler::SetaeEb },
+		{ CONDITION_LT, &CX86Assembler::SetlEb  },
+		{ CONDITION_LE, &CX86Assembler::SetleEb },
+		{ CONDITION_GT, &CX86Assembler::SetgEb  },
+		{ CONDITION_GE, &CX86Assembler::SetgeEb },
+	};
+
+	static const CONDITION jmpConditions[] =
+	{
+		CONDITION_EQ, CONDITION_NE, CONDITION_BL, CONDITION_BE, CONDITION_AB,
+		CONDITION_AE, CONDITION_LT, CONDITION_LE, CONDITION_GT, CONDITION_GE,
+	};
+
+	static const STENCIL_OPERAND dstOperands[] = { STENCIL_OPERAND_RELATIVE, STENCIL_OPERAND_TEMPORARY };
+	static const STENCIL_OPERAND srcOperands[] = { STENCIL_OPERAND_RELATIVE, STENCIL_OPERAND_TEMPORARY, STENCIL_OPERAND_CONSTANT };
+
+	auto rAX = CX86Assembler::MakeRegisterAddress(CX86Assembler::rAX);
+	auto bAL = CX86Assembler::MakeByteRegisterAddress(CX86Assembler::bAL);
+
+	auto emitAluSrc2 = [](CX86Assembler& assembler, AluEdType opEd, AluIdType opId, STENCIL_OPERAND src2) {
+		if(src2 == STENCIL_OPERAND_CONSTANT)
+		{
+			((assembler).*(opId))(CX86Assembler::MakeRegisterAddress(CX86Assembler::rAX), g_holeMarkers[STENCIL_HOLE_SRC2]);
+		}
+		else
+		{
+			((assembler).*(opEd))(CX86Assembler::rAX, MakeStencilOperandAddress(src2, STENCIL_HOLE_SRC2));
+		}
+	};
+
+	STENCIL_LIBRARY library;
+	auto addStencil = [&](uint32 key, STENCIL stencil) {
+		FindStencilHoles(stencil);
+		library.stencils.insert(std::make_pair(key, std::move(stencil)));
+	};
+
+	for(auto dst : dstOperands)
+	{
+		for(auto src1 : srcOperands)
+		{
+			addStencil(MakeStencilKey(OP_MOV, CONDITION_NEVER, dst, src1, STENCIL_OPERAND_NONE),
+			           AssembleStencil([&](CX86Assembler& assembler) {
+				           LoadStencilOperand(assembler, CX86Assembler::rAX, src1, STENCIL_HOLE_SRC1);
+				           assembler.MovGd(MakeStencilOperandAddress(dst, STENCIL_HOLE_DST), CX86Assembler::rAX);
+			           }));
+
+			addStencil(MakeStencilKey(OP_NOT, CONDITION_NEVER, dst, src1, STENCIL_OPERAND_NONE),
+			           AssembleStencil([&](CX86Assembler& assembler) {
+				           LoadStencilOperand(assembler, CX86Assembler::rAX, src1, STENCIL_HOLE_SRC1);
+				           assembler.NotEd(rAX);
+				           assembler.MovGd(MakeStencilOperandAddress(dst, STENCIL_HOLE_DST), CX86Assembler::rAX);
+			           }));
+
+			for(auto src2 : srcOperands)
+			{
+				for(const auto& aluOp : aluOps)
+				{
+					addStencil(MakeStencilKey(aluOp.op, CONDITION_NEVER, dst, src1, src2),
+					           AssembleStencil([&](CX86Assembler& assembler) {
+						           LoadStencilOperand(assembler, CX86Assembler::rAX, src1, STENCIL_HOLE_SRC1);
+						           emitAluSrc2(assembler, aluOp.opEd, aluOp.opId, src2);
+						           assembler.MovGd(MakeStencilOperandAddress(dst, STENCIL_HOLE_DST), CX86Assembler::rAX);
+					           }));
+				}
+
+				for(const auto& shiftOp : shiftOps)
+				{
+					addStencil(MakeStencilKey(shiftOp.op, CONDITION_NEVER, dst, src1, src2),
+					           AssembleStencil([&](CX86Assembler& assembler) {
+						           LoadStencilOperand(assembler, CX86Assembler::rAX, src1, STENCIL_HOLE_SRC1);
+						           LoadStencilOperand(assembler, CX86Assembler::rCX, src2, STENCIL_HOLE_SRC2);
+						           ((assembler).*(shiftOp.opCl))(rAX);
+						           assembler.MovGd(MakeStencilOperandAddress(dst, STENCIL_HOLE_DST), CX86Assembler::rAX);
+					           }));
+				}
+
+				for(const auto& cmpOp : cmpOps)
+				{
+					addStencil(MakeStencilKey(OP_CMP, cmpOp.condition, dst, src1, src2),
+					           AssembleStencil([&](CX86Assembler& assembler) {
+						           LoadStencilOperand(assembler, CX86Assembler::rAX, src1, STENCIL_HOLE_SRC1);
+						           emitAluSrc2(assembler, &CX86Assembler::CmpEd, &CX86Assembler::CmpId, src2);
+						           ((assembler).*(cmpOp.setcc))(bAL);
+						           assembler.MovzxEb(CX86Assembler::rAX, bAL);
+						           assembler.MovGd(MakeStencilOperandAddress(dst, STENCIL_HOLE_DST), CX86Assembler::rAX);
+					           }));
+				}
+			}
+		}
+	}
+
+	for(auto src1 : srcOperands)
+	{
+		for(auto src2 : srcOperands)
+		{
+			for(auto condition : jmpConditions)
+			{
+				auto stencil = AssembleStencil([&](CX86Assembler& assembler) {
+					LoadStencilOperand(assembler, CX86Assembler::rAX, src1, STENCIL_HOLE_SRC1);
+					emitAluSrc2(assembler, &CX86Assembler::CmpEd, &CX86Assembler::CmpId, src2);
+				});
+				//Jcc rel32
+				AppendJumpStencil(stencil, {0x0F, static_cast<uint8>(0x80 | GetConditionCode(condition))});
+				addStencil(MakeStencilKey(OP_CONDJMP, condition, STENCIL_OPERAND_NONE, src1, src2), std::move(stencil));
+			}
+		}
+	}
+
+	{
+		//JMP rel32
+		STENCIL stencil;
+		AppendJumpStencil(stencil, {0xE9});
+		addStencil(MakeStencilKey(OP_JMP, CONDITION_NEVER, STENCIL_OPERAND_NONE, STENCIL_OPERAND_NONE, STENCIL_OPERAND_NONE), std::move(stencil));
+	}
+
+	for(uint32 abi = 0; abi < 2; abi++)
+	{
+		library.prologs[abi] = AssembleStencil([&](CX86Assembler& assembler) {
+			assembler.Push(CX86Assembler::rBP);
+			assembler.MovEq(CX86Assembler::rBP, CX86Assembler::MakeRegisterAddress(g_contextParamRegs[abi]));
+			assembler.SubIq(CX86Assembler::MakeRegisterAddress(CX86Assembler::rSP), g_holeMarkers[STENCIL_HOLE_STACKSIZE]);
+		});
+		FindStencilHoles(library.prologs[abi]);
+	}
+
+	library.epilog = AssembleStencil([&](CX86Assembler& assembler) {
+		assembler.AddIq(CX86Assembler::MakeRegisterAddress(CX86Assembler::rSP), g_holeMarkers[STENCIL_HOLE_STACKSIZE]);
+		assembler.Pop(CX86Assembler::rBP);
+		assembler.Ret();
+	});
+	FindStencilHoles(library.epilog);
+
+	return library;
+}
+
+static const STENCIL_LIBRARY& GetStencilLibrary()
+{
+	static const STENCIL_LIBRARY library = BuildStencilLibrary();
+	return library;
+}
+
+static const STENCIL* FindStencil(const STATEMENT& statement)
+{
+	const auto& stencils = GetStencilLibrary().stencils;
+	auto dst = GetStencilOperand(statement.dst);
+	auto src1 = GetStencilOperand(statement.src1);
+	auto src2 = GetStencilOperand(statement.src2);
+	if((statement.dst && (dst == STENCIL_OPERAND_NONE)) ||
+	   (statement.src1 && (src1 == STENCIL_OPERAND_NONE)) ||
+	   (statement.src2 && (src2 == STENCIL_OPERAND_NONE)) ||
+	   statement.src3)
+	{
+		return nullptr;
+	}
+	auto condition = ((statement.op == OP_CMP) || (statement.op == OP_CONDJMP)) ? statement.jmpCondition : CONDITION_NEVER;
+	auto stencilIterator = stencils.find(MakeStencilKey(statement.op, condition, dst, src1, src2));
+	return (stencilIterator != stencils.end()) ? &stencilIterator->second : nullptr;
+}
+
+static uint32 GetStencilOperandValue(const SymbolRefPtr& symbolRef)
+{
+	auto symbol = symbolRef->GetSymbol();
+	return (symbol->m_type == SYM_TEMPORARY) ? symbol->m_stackLocation : symbol->m_valueLow;
+}
+
+static uint32 CopyStencil(std::vector<uint8>& code, const STENCIL& stencil, const uint32 (&holeValues)[STENCIL_HOLE_MAX])
+{
+	uint32 base = static_cast<uint32>(code.size());
+	code.insert(code.end(), stencil.code.begin(), stencil.code.end());
+	for(uint32 hole = 0; hole < STENCIL_HOLE_MAX; hole++)
+	{
+		if((stencil.holeMask & (1 << hole)) == 0) continue;
+		memcpy(code.data() + base + stencil.holeOffsets[hole], &holeValues[hole], 4);
+	}
+	return base;
+}
+
+CCodeGen_x86_64_Stencil::CCodeGen_x86_64_Stencil(CX86CpuFeatures cpuFeatures)
+    : CCodeGen_x86_64(cpuFeatures)
+{
+}
+
+void CCodeGen_x86_64_Stencil::GenerateCode(const StatementList& statements, unsigned int stackSize)
+{
+	//External symbol references are only reported by the assembler based path
+	if(m_externalSymbolReferencedHandler || !CanGenerateFromStencils(statements))
+	{
+		CCodeGen_x86_64::GenerateCode(statements, stackSize);
+		return;
+	}
+
+	GenerateFromStencils(statements, stackSize);
+}
+
+bool CCodeGen_x86_64_Stencil::CanGenerateUnoptimized(const StatementList& statements) const
+{
+	//Stencils don't depend on register allocation, the optimizer would only slow down compilation
+	return !m_externalSymbolReferencedHandler && CanGenerateFromStencils(statements);
+}
+
+void CCodeGen_x86_64_Stencil::SetStream(Framework::CStream* stream)
+{
+	m_stream = stream;
+	CCodeGen_x86_64::SetStream(stream);
+}
+
+unsigned int CCodeGen_x86_64_Stencil::GetAvailableRegisterCount() const
+{
+	return 0;
+}
+
+unsigned int CCodeGen_x86_64_Stencil::GetAvailableMdRegisterCount() const
+{
+	return 0;
+}
+
+bool CCodeGen_x86_64_Stencil::SupportsBlockPlacement() const
+{
+	return false;
+}
+
+bool CCodeGen_x86_64_Stencil::SupportsColdRegion() const
+{
+	return false;
+}
+
+bool CCodeGen_x86_64_Stencil::CanGenerateFromStencils(const StatementList& statements) const
+{
+	for(const auto& statement : statements)
+	{
+		switch(statement.op)
+		{
+		case OP_NOP:
+		case OP_LABEL:
+		case OP_GOTO: //Unoptimized statements only, becomes OP_JMP
+			break;
+		default:
+			if(!FindStencil(statement)) return false;
+			break;
+		}
+	}
+	return true;
+}
+
+void CCodeGen_x86_64_Stencil::GenerateFromStencils(const StatementList& statements, unsigned int stackSize)
+{
+	const auto& library = GetStencilLibrary();
+
+	std::vector<uint8> code;
+	std::unordered_map<uint32, uint32> labelOffsets;
+	std::vector<std::pair<uint32, uint32>> jumpHoles;
+
+	uint32 holeValues[STENCIL_HOLE_MAX] = {};
+	holeValues[STENCIL_HOLE_STACKSIZE] = (stackSize + 0xF) & ~0xF;
+
+	m_codeRegionRelocations.clear();
+
+	CopyStencil(code, library.prologs[GetPlatformAbi()], holeValues);
+
+	for(const auto& statement : statements)
+	{
+		switch(statement.op)
+		{
+		case OP_NOP:
+			break;
+		case OP_LABEL:
+			labelOffsets[statement.jmpBlock] = static_cast<uint32>(code.size());
+			break;
+		default:
+		{
+			const auto* stencil = FindStencil(statement);
+			assert(stencil);
+			if(statement.dst) holeValues[STENCIL_HOLE_DST] = GetStencilOperandValue(statement.dst);
+			if(statement.src1) holeValues[STENCIL_HOLE_SRC1] = GetStencilOperandValue(statement.src1);
+			if(statement.src2) holeValues[STENCIL_HOLE_SRC2] = GetStencilOperandValue(statement.src2);
+			uint32 base = CopyStencil(code, *stencil, holeValues);
+			if(stencil->holeMask & (1 << STENCIL_HOLE_JUMP))
+			{
+				jumpHoles.push_back(std::make_pair(base + stencil->holeOffsets[STENCIL_HOLE_JUMP], statement.jmpBlock));
+			}
+		}
+		break;
+		}
+	}
+
+	CopyStencil(code, library.epilog, holeValues);
+
+	for(const auto& jumpHole : jumpHoles)
+	{
+		auto labelIterator = labelOffsets.find(jumpHole.second);
+		assert(labelIterator != labelOffsets.end());
+		if(labelIterator == labelOffsets.end())
+		{
+			throw std::runtime_error("Jump to unknown label.");
+		}
+		uint32 displacement = labelIterator->second - (jumpHole.first + 4);
+		memcpy(code.data() + jumpHole.first, &displacement, 4);
+	}
+
+	m_stream->Write(code.data(), code.size());
+}
@@ -987,7 +987,7 @@ void CCodeGen_x86::Emit_Md_LoadFromRef_VarVarAny(const STATEMENT& statement)
 	assert(scale == 1);
 
 	auto dstReg = PrepareSymbolRegisterDefMd(dst, CX86Assembler::xMM0);
-	m_assembler.MovapsVo(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale));
+	m_assembler.MovapsVo(dstReg, MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement));
 	CommitSymbolRegisterMdSse(dst, dstReg);
 }
 
@@ -1012,7 +1012,7 @@ void CCodeGen_x86::Emit_Md_StoreAtRef_VarAnyVar(const STATEMENT& statement)
 	assert(scale == 1);
 
 	auto valueReg = PrepareSymbolRegisterUseMdSse(src3, CX86Assembler::xMM0);
-	m_assembler.MovapsVo(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale), valueReg);
+	m_assembler.MovapsVo(MakeRefBaseScaleSymbolAddress(src1, CX86Assembler::rAX, src2, CX86Assembler::rCX, scale, statement.displacement), valueReg);
 }
 
 // clang-format off
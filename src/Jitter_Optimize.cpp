@@ -1,6 +1,8 @@
 #include <assert.h>
 #include <vector>
 #include <algorithm>
+#include <tuple>
+#include <set>
 #include "Jitter.h"
 #include "BitManip.h"
 
@@ -14,6 +16,338 @@
 
 using namespace Jitter;
 
+static uint32 ByteSwap32(uint32 value)
+{
+	return ((value & 0x000000FF) << 24) |
+	       ((value & 0x0000FF00) << 8) |
+	       ((value & 0x00FF0000) >> 8) |
+	       ((value & 0xFF000000) >> 24);
+}
+
+struct UNSIGNED_DIVISION_MAGIC
+{
+	uint32 multiplier;
+	uint32 shift;
+	bool needsAdd;
+};
+
+struct SIGNED_DIVISION_MAGIC
+{
+	int32 multiplier;
+	uint32 shift;
+};
+
+//Magic numbers for division by constant (from Hacker's Delight, chapter 10)
+static UNSIGNED_DIVISION_MAGIC ComputeUnsignedDivisionMagic(uint32 divisor)
+{
+	assert(divisor > 1);
+	UNSIGNED_DIVISION_MAGIC result = {};
+	uint32 p32 = 0;
+	uint32 q = 0x7FFFFFFF / divisor;
+	uint32 r = 0x7FFFFFFF - (q * divisor);
+	uint32 p = 31;
+	uint32 delta = 0;
+	do
+	{
+		p++;
+		p32 = (p == 32) ? 1 : (2 * p32);
+		if((r + 1) >= (divisor - r))
+		{
+			if(q >= 0x7FFFFFFF) result.needsAdd = true;
+			q = (2 * q) + 1;
+			r = (2 * r) + 1 - divisor;
+		}
+		else
+		{
+			if(q >= 0x80000000) result.needsAdd = true;
+			q = 2 * q;
+			r = (2 * r) + 1;
+		}
+		delta = divisor - 1 - r;
+	} while((p < 64) && (p32 < delta));
+	result.multiplier = q + 1;
+	result.shift = p - 32;
+	return result;
+}
+
+static SIGNED_DIVISION_MAGIC ComputeSignedDivisionMagic(int32 divisor)
+{
+	assert((divisor < -1) || (divisor > 1));
+	const uint32 two31 = 0x80000000;
+	uint32 ad = (divisor < 0) ? (0 - static_cast<uint32>(divisor)) : static_cast<uint32>(divisor);
+	uint32 t = two31 + (static_cast<uint32>(divisor) >> 31);
+	uint32 anc = t - 1 - (t % ad);
+	uint32 p = 31;
+	uint32 q1 = two31 / anc;
+	uint32 r1 = two31 - (q1 * anc);
+	uint32 q2 = two31 / ad;
+	uint32 r2 = two31 - (q2 * ad);
+	uint32 delta = 0;
+	do
+	{
+		p++;
+		q1 = 2 * q1;
+		r1 = 2 * r1;
+		if(r1 >= anc)
+		{
+			q1++;
+			r1 -= anc;
+		}
+		q2 = 2 * q2;
+		r2 = 2 * r2;
+		if(r2 >= ad)
+		{
+			q2++;
+			r2 -= ad;
+		}
+		delta = ad - r2;
+	} while((q1 < delta) || ((q1 == delta) && (r1 == 0)));
+	SIGNED_DIVISION_MAGIC result = {};
+	result.multiplier = static_cast<int32>(q2 + 1);
+	if(divisor < 0) result.multiplier = -result.multiplier;
+	result.shift = p - 32;
+	return result;
+}
+
+static bool IsLoadFromRefOperation(OPERATION op)
+{
+	return (op == OP_LOADFROMREF) ||
+	       (op == OP_LOAD8FROMREF) ||
+	       (op == OP_LOAD16FROMREF) ||
+	       (op == OP_LOADFROMREFBSWAP) ||
+	       (op == OP_LOAD16FROMREFBSWAP);
+}
+
+static bool IsStoreAtRefOperation(OPERATION op)
+{
+	return (op == OP_STOREATREF) ||
+	       (op == OP_STORE8ATREF) ||
+	       (op == OP_STORE16ATREF) ||
+	       (op == OP_STOREATREFBSWAP) ||
+	       (op == OP_STORE16ATREFBSWAP);
+}
+
+static uint32 GetRefAccessSize(OPERATION op, const CSymbol* valueSymbol)
+{
+	switch(op)
+	{
+	case OP_LOAD8FROMREF:
+	case OP_STORE8ATREF:
+		return 1;
+	case OP_LOAD16FROMREF:
+	case OP_STORE16ATREF:
+	case OP_LOAD16FROMREFBSWAP:
+	case OP_STORE16ATREFBSWAP:
+		return 2;
+	default:
+		return valueSymbol->GetSize();
+	}
+}
+
+//Operations that can read relatives without naming them
+static bool ExposesRelatives(const STATEMENT& statement)
+{
+	auto op = statement.op;
+	if(op == OP_CALL) return !IsContextIsolatedCall(statement);
+	return (op == OP_EXTERNJMP) ||
+	       (op == OP_EXTERNJMP_DYN) ||
+	       IsLoadFromRefOperation(op) ||
+	       IsStoreAtRefOperation(op) ||
+	       (op == OP_LOADFROMMEMBASE) ||
+	       (op == OP_LOAD8FROMMEMBASE) ||
+	       (op == OP_LOAD16FROMMEMBASE) ||
+	       (op == OP_STOREATMEMBASE) ||
+	       (op == OP_STORE8ATMEMBASE) ||
+	       (op == OP_STORE16ATMEMBASE);
+}
+
+//Operations that can write relatives without naming them
+static bool ClobbersRelatives(const STATEMENT& statement)
+{
+	auto op = statement.op;
+	if(op == OP_CALL) return CallMightWriteContext(statement);
+	return IsStoreAtRefOperation(op) ||
+	       (op == OP_STOREATMEMBASE) ||
+	       (op == OP_STORE8ATMEMBASE) ||
+	       (op == OP_STORE16ATMEMBASE);
+}
+
+//Operations producing a 64-bit result with a flag in the high part
+static bool IsAluFlagOperation(OPERATION op)
+{
+	return (op == OP_ADDOVF) ||
+	       (op == OP_ADDCARRY) ||
+	       (op == OP_ADC) ||
+	       (op == OP_SUBOVF) ||
+	       (op == OP_SUBBORROW);
+}
+
+static bool IsHoistableOperation(OPERATION op)
+{
+	//Only pure integer operations that can't fault are moved out of loops
+	switch(op)
+	{
+	case OP_ADD:
+	case OP_SUB:
+	case OP_CMP:
+	case OP_AND:
+	case OP_OR:
+	case OP_XOR:
+	case OP_NOT:
+	case OP_SRA:
+	case OP_SRL:
+	case OP_SLL:
+	case OP_MUL:
+	case OP_MULS:
+	case OP_LZC:
+	case OP_ADDOVF:
+	case OP_ADDCARRY:
+	case OP_ADC:
+	case OP_SUBOVF:
+	case OP_SUBBORROW:
+	case OP_RELTOREF:
+	case OP_ADDREF:
+	case OP_ADD64:
+	case OP_SUB64:
+	case OP_AND64:
+	case OP_CMP64:
+	case OP_MERGETO64:
+	case OP_EXTLOW64:
+	case OP_EXTHIGH64:
+	case OP_SRA64:
+	case OP_SRL64:
+	case OP_SLL64:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static bool IsCommutativeOperation(OPERATION op)
+{
+	switch(op)
+	{
+	case OP_ADD:
+	case OP_ADD64:
+	case OP_AND:
+	case OP_AND64:
+	case OP_OR:
+	case OP_XOR:
+	case OP_MUL:
+	case OP_MULS:
+	case OP_ADDOVF:
+	case OP_ADDCARRY:
+	case OP_MD_AND:
+	case OP_MD_OR:
+	case OP_MD_XOR:
+	case OP_MD_ADD_B:
+	case OP_MD_ADD_H:
+	case OP_MD_ADD_W:
+	case OP_MD_ADDSS_H:
+	case OP_MD_ADDSS_W:
+	case OP_MD_ADDUS_B:
+	case OP_MD_ADDUS_W:
+	case OP_MD_CMPEQ_B:
+	case OP_MD_CMPEQ_H:
+	case OP_MD_CMPEQ_W:
+	case OP_MD_MIN_H:
+	case OP_MD_MIN_W:
+	case OP_MD_MAX_H:
+	case OP_MD_MAX_W:
+	case OP_MD_ADD_S:
+	case OP_MD_MUL_S:
+	case OP_MD_MIN_S:
+	case OP_MD_MAX_S:
+		return true;
+	default:
+		return false;
+	}
+}
+
+//Local value numbering support
+struct VALUE_NUMBER_OPERAND
+{
+	int type = -1;
+	uint32 valueLow = 0;
+	uint32 valueHigh = 0;
+	int version = CSymbolRef::UNVERSIONED;
+
+	bool operator==(const VALUE_NUMBER_OPERAND& rhs) const
+	{
+		return (type == rhs.type) && (valueLow == rhs.valueLow) && (valueHigh == rhs.valueHigh) && (version == rhs.version);
+	}
+
+	bool operator<(const VALUE_NUMBER_OPERAND& rhs) const
+	{
+		return std::tie(type, valueLow, valueHigh, version) < std::tie(rhs.type, rhs.valueLow, rhs.valueHigh, rhs.version);
+	}
+};
+
+struct VALUE_NUMBER_KEY
+{
+	OPERATION op = OP_NOP;
+	CONDITION jmpCondition = CONDITION_NEVER;
+	uint32 displacement = 0;
+	VALUE_NUMBER_OPERAND operands[3];
+
+	bool operator==(const VALUE_NUMBER_KEY& rhs) const
+	{
+		return (op == rhs.op) && (jmpCondition == rhs.jmpCondition) && (displacement == rhs.displacement) &&
+		       (operands[0] == rhs.operands[0]) && (operands[1] == rhs.operands[1]) && (operands[2] == rhs.operands[2]);
+	}
+};
+
+struct VALUE_NUMBER_KEY_HASH
+{
+	size_t operator()(const VALUE_NUMBER_KEY& key) const
+	{
+		size_t result = (static_cast<size_t>(key.op) << 8) ^ static_cast<size_t>(key.jmpCondition);
+		result ^= static_cast<size_t>(key.displacement) * 31;
+		for(const auto& operand : key.operands)
+		{
+			size_t operandHash = static_cast<size_t>(operand.type);
+			operandHash = (operandHash * 31) + operand.valueLow;
+			operandHash = (operandHash * 31) + operand.valueHigh;
+			operandHash = (operandHash * 31) + static_cast<size_t>(operand.version);
+			result ^= operandHash + 0x9E3779B9 + (result << 6) + (result >> 2);
+		}
+		return result;
+	}
+};
+
+typedef std::unordered_map<VALUE_NUMBER_KEY, SymbolRefPtr, VALUE_NUMBER_KEY_HASH> ValueNumberMap;
+
+static VALUE_NUMBER_OPERAND MakeValueNumberOperand(const SymbolRefPtr& symbolRef)
+{
+	VALUE_NUMBER_OPERAND result;
+	if(symbolRef)
+	{
+		auto symbol = symbolRef->GetSymbol();
+		result.type = symbol->m_type;
+		result.valueLow = symbol->m_valueLow;
+		result.valueHigh = symbol->m_valueHigh;
+		result.version = symbolRef->GetVersion();
+	}
+	return result;
+}
+
+static VALUE_NUMBER_KEY MakeValueNumberKey(const STATEMENT& statement)
+{
+	VALUE_NUMBER_KEY result;
+	result.op = statement.op;
+	result.jmpCondition = statement.jmpCondition;
+	result.displacement = statement.displacement;
+	result.operands[0] = MakeValueNumberOperand(statement.src1);
+	result.operands[1] = MakeValueNumberOperand(statement.src2);
+	result.operands[2] = MakeValueNumberOperand(statement.src3);
+	//Make sure that a + b and b + a end up with the same key
+	if(IsCommutativeOperation(statement.op) && (result.operands[1] < result.operands[0]))
+	{
+		std::swap(result.operands[0], result.operands[1]);
+	}
+	return result;
+}
+
 unsigned int CJitter::CRelativeVersionManager::GetRelativeVersion(uint32 relativeId)
 {
 	RelativeVersionMap::const_iterator versionIterator(m_relativeVersions.find(relativeId));
@@ -139,10 +473,17 @@ StatementList CJitter::CollapseVersionedStatementList(const VERSIONED_STATEMENT_
 
 void CJitter::Compile()
 {
+	if(CompileUnoptimized())
+	{
+		m_labels.clear();
+		return;
+	}
+
 	while(1)
 	{
-		for(auto& basicBlock : m_basicBlocks)
+		for(auto blockIterator = m_basicBlocks.begin(); blockIterator != m_basicBlocks.end(); ++blockIterator)
 		{
+			auto& basicBlock(*blockIterator);
 			if(!basicBlock.optimized)
 			{
 				m_currentBlock = &basicBlock;
@@ -156,16 +497,23 @@ void CJitter::Compile()
 					bool dirty = false;
 					dirty |= ConstantPropagation(versionedStatements.statements);
 					dirty |= ConstantFolding(versionedStatements.statements);
+					dirty |= ReduceConstantDivisions(versionedStatements.statements);
+					dirty |= SimplifyKnownBits(versionedStatements.statements);
 					dirty |= ReorderAdd(versionedStatements.statements);
+					dirty |= FoldAddRefAddressing(versionedStatements.statements);
+					dirty |= FuseFlagBranches(versionedStatements.statements);
 					dirty |= CopyPropagation(versionedStatements.statements);
 					dirty |= DeadcodeElimination(versionedStatements);
 					dirty |= CommonExpressionElimination(versionedStatements);
+					dirty |= EliminatePureCalls(versionedStatements);
 
 					if(!dirty) break;
 				}
 
 				basicBlock.statements = CollapseVersionedStatementList(versionedStatements);
 				FixFlowControl(basicBlock.statements);
+				//Jumps might have been resolved or folded, only this block's edges can be affected
+				basicBlock.successors = ComputeBlockSuccessors(blockIterator);
 				basicBlock.optimized = true;
 			}
 		}
@@ -173,12 +521,21 @@ void CJitter::Compile()
 		bool dirty = false;
 		dirty |= PruneBlocks();
 		dirty |= MergeBlocks();
+		dirty |= ForwardRelativeConstants();
+		dirty |= EliminateDeadRelativeStores();
 
 		if(!dirty) break;
 	}
 
+	HoistLoopInvariants();
+
 	unsigned int stackSize = 0;
 
+	//Memory base register needs to be known before allocating registers since it reduces the number of available registers
+	m_codeGen->SetMemoryBaseOffset(m_usesMemoryBase ? static_cast<uint32>(m_memoryBaseOffset) : CCodeGen::MEMORY_BASE_NONE);
+
+	AssignPinnedRelativeRegisters();
+
 	//Allocate registers
 	for(auto& basicBlock : m_basicBlocks)
 	{
@@ -188,6 +545,9 @@ void CJitter::Compile()
 		RemoveSelfAssignments(basicBlock);
 		PruneSymbols(basicBlock);
 
+		bool isFirstBlock = (&basicBlock == &m_basicBlocks.front());
+		bool isLastBlock = (&basicBlock == &m_basicBlocks.back());
+		AllocatePinnedRelatives(basicBlock, isFirstBlock, isLastBlock);
 		AllocateRegisters(basicBlock);
 		unsigned int blockStackSize = AllocateStack(basicBlock);
 		stackSize = std::max<unsigned int>(stackSize, blockStackSize);
@@ -195,7 +555,15 @@ void CJitter::Compile()
 		NormalizeStatements(basicBlock);
 	}
 
-	auto result = ConcatBlocks(m_basicBlocks);
+	stackSize = AllocateHoistedTemporaries(stackSize);
+
+	bool splitColdBlocks = m_codeGen->SupportsBlockPlacement() && m_codeGen->HasColdStream();
+	if(m_codeGen->SupportsBlockPlacement())
+	{
+		PlaceBlocks(splitColdBlocks);
+	}
+
+	auto result = ConcatBlocks(m_basicBlocks, splitColdBlocks);
 
 #ifdef DUMP_STATEMENTS
 	DumpStatementList(result.statements);
@@ -205,6 +573,42 @@ void CJitter::Compile()
 	m_codeGen->GenerateCode(result.statements, stackSize);
 
 	m_labels.clear();
+	m_hoistedTemporaries.clear();
+}
+
+bool CJitter::CompileUnoptimized()
+{
+	//Code generators that don't need registers can sometimes take statements as the front end emitted them,
+	//optimizing would take more time than what is saved when running the generated code.
+	//This is checked before touching any block since the full pipeline needs them untouched.
+	for(const auto& basicBlock : m_basicBlocks)
+	{
+		if(!m_codeGen->CanGenerateUnoptimized(basicBlock.statements))
+		{
+			return false;
+		}
+	}
+
+	m_codeGen->SetMemoryBaseOffset(m_usesMemoryBase ? static_cast<uint32>(m_memoryBaseOffset) : CCodeGen::MEMORY_BASE_NONE);
+
+	unsigned int stackSize = 0;
+	for(auto& basicBlock : m_basicBlocks)
+	{
+		FixFlowControl(basicBlock.statements);
+		PruneSymbols(basicBlock);
+		unsigned int blockStackSize = AllocateStack(basicBlock);
+		stackSize = std::max<unsigned int>(stackSize, blockStackSize);
+	}
+
+	auto result = ConcatBlocks(m_basicBlocks, false);
+
+#ifdef DUMP_STATEMENTS
+	DumpStatementList(result.statements);
+	std::cout << std::endl;
+#endif
+
+	m_codeGen->GenerateCode(result.statements, stackSize);
+	return true;
 }
 
 void CJitter::InsertStatement(const STATEMENT& statement)
@@ -503,6 +907,62 @@ bool CJitter::FoldConstantOperation(STATEMENT& statement)
 			changed = true;
 		}
 	}
+	else if((statement.op == OP_ADDOVF) || (statement.op == OP_ADDCARRY) || (statement.op == OP_SUBOVF) || (statement.op == OP_SUBBORROW))
+	{
+		if(src1cst && src2cst)
+		{
+			uint32 value1 = src1cst->m_valueLow;
+			uint32 value2 = src2cst->m_valueLow;
+			uint32 result = 0;
+			uint32 flag = 0;
+			switch(statement.op)
+			{
+			case OP_ADDOVF:
+				result = value1 + value2;
+				flag = ((~(value1 ^ value2) & (value1 ^ result)) >> 31);
+				break;
+			case OP_ADDCARRY:
+				result = value1 + value2;
+				flag = (result < value1) ? 1 : 0;
+				break;
+			case OP_SUBOVF:
+				result = value1 - value2;
+				flag = (((value1 ^ value2) & (value1 ^ result)) >> 31);
+				break;
+			case OP_SUBBORROW:
+				result = value1 - value2;
+				flag = (value1 < value2) ? 1 : 0;
+				break;
+			default:
+				assert(false);
+				break;
+			}
+			statement.op = OP_MOV;
+			statement.src1 = MakeSymbolRef(MakeConstant64(static_cast<uint64>(result) | (static_cast<uint64>(flag) << 32)));
+			statement.src2.reset();
+			changed = true;
+		}
+	}
+	else if(statement.op == OP_ADC)
+	{
+		CSymbol* src3cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src3);
+		if(src1cst && src2cst && src3cst)
+		{
+			uint64 result = static_cast<uint64>(src1cst->m_valueLow) + static_cast<uint64>(src2cst->m_valueLow) + ((src3cst->m_valueLow != 0) ? 1 : 0);
+			statement.op = OP_MOV;
+			statement.src1 = MakeSymbolRef(MakeConstant64(result));
+			statement.src2.reset();
+			statement.src3.reset();
+			changed = true;
+		}
+		else if(src3cst && (src3cst->m_valueLow == 0))
+		{
+			//No carry in, same as a regular add producing a carry
+			statement.op = OP_ADDCARRY;
+			statement.src3.reset();
+			changed = true;
+		}
+	}
 	else if(statement.op == OP_DIV)
 	{
 		if(src1cst && src2cst)
@@ -523,11 +983,6 @@ bool CJitter::FoldConstantOperation(STATEMENT& statement)
 			statement.src2.reset();
 			changed = true;
 		}
-		//else if(src2cst && IsPowerOfTwo(src2cst->m_valueLow))
-		//{
-		//	statement.op = OP_SRL;
-		//	src2cst->m_valueLow = GetPowerOf2(src2cst->m_valueLow);
-		//}
 	}
 	else if(statement.op == OP_DIVS)
 	{
@@ -560,6 +1015,15 @@ bool CJitter::FoldConstantOperation(STATEMENT& statement)
 			case CONDITION_BL:
 				result = src1cst->m_valueLow < src2cst->m_valueLow;
 				break;
+			case CONDITION_BE:
+				result = src1cst->m_valueLow <= src2cst->m_valueLow;
+				break;
+			case CONDITION_AB:
+				result = src1cst->m_valueLow > src2cst->m_valueLow;
+				break;
+			case CONDITION_AE:
+				result = src1cst->m_valueLow >= src2cst->m_valueLow;
+				break;
 			case CONDITION_LT:
 				result = static_cast<int32>(src1cst->m_valueLow) < static_cast<int32>(src2cst->m_valueLow);
 				break;
@@ -569,9 +1033,15 @@ bool CJitter::FoldConstantOperation(STATEMENT& statement)
 			case CONDITION_GT:
 				result = static_cast<int32>(src1cst->m_valueLow) > static_cast<int32>(src2cst->m_valueLow);
 				break;
+			case CONDITION_GE:
+				result = static_cast<int32>(src1cst->m_valueLow) >= static_cast<int32>(src2cst->m_valueLow);
+				break;
 			case CONDITION_EQ:
 				result = static_cast<int32>(src1cst->m_valueLow) == static_cast<int32>(src2cst->m_valueLow);
 				break;
+			case CONDITION_NE:
+				result = static_cast<int32>(src1cst->m_valueLow) != static_cast<int32>(src2cst->m_valueLow);
+				break;
 			default:
 				assert(0);
 				break;
@@ -598,6 +1068,18 @@ bool CJitter::FoldConstantOperation(STATEMENT& statement)
 			case CONDITION_BL:
 				result = static_cast<uint32>(src1cst->m_valueLow) < static_cast<uint32>(src2cst->m_valueLow);
 				break;
+			case CONDITION_BE:
+				result = static_cast<uint32>(src1cst->m_valueLow) <= static_cast<uint32>(src2cst->m_valueLow);
+				break;
+			case CONDITION_AB:
+				result = static_cast<uint32>(src1cst->m_valueLow) > static_cast<uint32>(src2cst->m_valueLow);
+				break;
+			case CONDITION_AE:
+				result = static_cast<uint32>(src1cst->m_valueLow) >= static_cast<uint32>(src2cst->m_valueLow);
+				break;
+			case CONDITION_LT:
+				result = static_cast<int32>(src1cst->m_valueLow) < static_cast<int32>(src2cst->m_valueLow);
+				break;
 			case CONDITION_LE:
 				result = static_cast<int32>(src1cst->m_valueLow) <= static_cast<int32>(src2cst->m_valueLow);
 				break;
@@ -783,6 +1265,20 @@ bool CJitter::FoldConstant6432Operation(STATEMENT& statement)
 			changed = true;
 		}
 	}
+	else if(statement.op == OP_CONDJMP)
+	{
+		//Branch on the flag held in the high part of a constant ALU flag operation result
+		if(src1cst && src2cst)
+		{
+			assert(src2cst->m_valueLow == 0);
+			bool flagSet = (src1cst->m_valueHigh != 0);
+			bool result = (statement.jmpCondition == CONDITION_NE) ? flagSet : !flagSet;
+			changed = true;
+			statement.op = result ? OP_JMP : OP_NOP;
+			statement.src1.reset();
+			statement.src2.reset();
+		}
+	}
 
 	return changed;
 }
@@ -824,6 +1320,48 @@ bool CJitter::FoldConstant12832Operation(STATEMENT& statement)
 	return changed;
 }
 
+bool CJitter::FoldConstantByteSwapOperation(STATEMENT& statement)
+{
+	if(
+	    (statement.op != OP_STOREATREFBSWAP) &&
+	    (statement.op != OP_STORE16ATREFBSWAP))
+	{
+		return false;
+	}
+
+	//Value is in src3 when an index is used
+	auto& valueRef = statement.src3 ? statement.src3 : statement.src2;
+
+	//Storing a constant, swap it now and use a regular store
+	if(auto valueCst = dynamic_symbolref_cast(SYM_CONSTANT, valueRef))
+	{
+		uint32 value = valueCst->m_valueLow;
+		if(statement.op == OP_STORE16ATREFBSWAP)
+		{
+			value = ((value & 0x00FF) << 8) | ((value & 0xFF00) >> 8);
+			statement.op = OP_STORE16ATREF;
+		}
+		else
+		{
+			value = ByteSwap32(value);
+			statement.op = OP_STOREATREF;
+		}
+		valueRef = MakeSymbolRef(MakeSymbol(SYM_CONSTANT, value));
+		return true;
+	}
+	else if(auto valueCst = dynamic_symbolref_cast(SYM_CONSTANT64, valueRef))
+	{
+		assert(statement.op == OP_STOREATREFBSWAP);
+		uint64 valueLo = ByteSwap32(valueCst->m_valueHigh);
+		uint64 valueHi = ByteSwap32(valueCst->m_valueLow);
+		statement.op = OP_STOREATREF;
+		valueRef = MakeSymbolRef(MakeConstant64(valueLo | (valueHi << 32)));
+		return true;
+	}
+
+	return false;
+}
+
 bool CJitter::ConstantFolding(StatementList& statements)
 {
 	bool changed = false;
@@ -833,6 +1371,7 @@ bool CJitter::ConstantFolding(StatementList& statements)
 		changed |= FoldConstant64Operation(statement);
 		changed |= FoldConstant6432Operation(statement);
 		changed |= FoldConstant12832Operation(statement);
+		changed |= FoldConstantByteSwapOperation(statement);
 	}
 	return changed;
 }
@@ -885,14 +1424,14 @@ void CJitter::MergeBasicBlocks(BASIC_BLOCK& dstBlock, const BASIC_BLOCK& srcBloc
 	dstBlock.optimized = false;
 }
 
-CJitter::BASIC_BLOCK CJitter::ConcatBlocks(const BasicBlockList& blocks)
+CJitter::BASIC_BLOCK CJitter::ConcatBlocks(const BasicBlockList& blocks, bool splitColdBlocks)
 {
 	BASIC_BLOCK result;
 	for(const auto& basicBlock : blocks)
 	{
 		//First, add a mark label statement
 		STATEMENT labelStatement;
-		labelStatement.op = OP_LABEL;
+		labelStatement.op = (splitColdBlocks && basicBlock.isCold) ? OP_LABEL_COLD : OP_LABEL;
 		labelStatement.jmpBlock = basicBlock.id;
 		result.statements.push_back(labelStatement);
 
@@ -901,105 +1440,219 @@ CJitter::BASIC_BLOCK CJitter::ConcatBlocks(const BasicBlockList& blocks)
 	return result;
 }
 
-bool CJitter::PruneBlocks()
+bool CJitter::CONTROL_FLOW_GRAPH::IsReachable(uint32 nodeIndex) const
 {
-	bool changed = true;
-	int deletedBlocks = 0;
+	return nodes[nodeIndex].reversePostOrderIndex != INVALID_NODE;
+}
 
-	while(changed)
+bool CJitter::CONTROL_FLOW_GRAPH::Dominates(uint32 dominatorIndex, uint32 nodeIndex) const
+{
+	if(!IsReachable(nodeIndex)) return false;
+	while(1)
 	{
-		changed = false;
+		if(nodeIndex == dominatorIndex) return true;
+		uint32 immediateDominator = nodes[nodeIndex].immediateDominator;
+		//Entry block is its own dominator
+		if(immediateDominator == nodeIndex) return false;
+		nodeIndex = immediateDominator;
+	}
+}
 
-		auto toDeleteIterator = m_basicBlocks.cend();
-		for(auto outerBlockIterator(m_basicBlocks.cbegin());
-		    outerBlockIterator != m_basicBlocks.cend(); outerBlockIterator++)
-		{
-			//First block is always referenced
-			if(outerBlockIterator == m_basicBlocks.begin()) continue;
+CJitter::CONTROL_FLOW_GRAPH CJitter::BuildControlFlowGraph()
+{
+	assert(CheckBlockSuccessors());
 
-			auto candidateBlockIterator = outerBlockIterator;
-			bool referenced = false;
+	CONTROL_FLOW_GRAPH result;
+	result.nodes.reserve(m_basicBlocks.size());
 
-			//Check if there's a reference to this block in here
-			for(auto innerBlockIterator(m_basicBlocks.cbegin());
-			    innerBlockIterator != m_basicBlocks.cend(); innerBlockIterator++)
-			{
-				const auto& block(*innerBlockIterator);
-				bool referencesNext = false;
+	std::unordered_map<uint32, uint32> blockIdToNode;
+	for(auto blockIterator = m_basicBlocks.begin(); blockIterator != m_basicBlocks.end(); ++blockIterator)
+	{
+		blockIdToNode[blockIterator->id] = static_cast<uint32>(result.nodes.size());
+		CONTROL_FLOW_GRAPH::NODE node;
+		node.block = blockIterator;
+		result.nodes.push_back(std::move(node));
+	}
 
-				if(block.statements.empty())
-				{
-					//Empty blocks references next one
-					referencesNext = true;
-				}
-				else
-				{
-					//Check if this block references the next one or if it jumps to another one
-					auto lastInstruction(block.statements.end());
-					lastInstruction--;
-					const auto& statement(*lastInstruction);
+	if(result.nodes.empty()) return result;
 
-					//It jumps to a block, so check if it references the one we're looking for
-					if(statement.op == OP_JMP || statement.op == OP_CONDJMP)
-					{
-						if(statement.jmpBlock == candidateBlockIterator->id)
-						{
-							referenced = true;
-							break;
-						}
-					}
+	uint32 nodeCount = static_cast<uint32>(result.nodes.size());
+	auto addEdge =
+	    [&](uint32 from, uint32 to) {
+		    auto& successors = result.nodes[from].successors;
+		    if(std::find(successors.begin(), successors.end(), to) != successors.end()) return;
+		    successors.push_back(to);
+		    result.nodes[to].predecessors.push_back(from);
+	    };
 
-					//Otherwise, it references the next one if it's not a jump
-					if(statement.op != OP_JMP)
-					{
-						referencesNext = true;
-					}
-				}
+	for(uint32 nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++)
+	{
+		for(uint32 successorId : result.nodes[nodeIndex].block->successors)
+		{
+			auto nodeIterator = blockIdToNode.find(successorId);
+			assert(nodeIterator != std::end(blockIdToNode));
+			if(nodeIterator == std::end(blockIdToNode)) continue;
+			addEdge(nodeIndex, nodeIterator->second);
+		}
+	}
 
-				if(referencesNext)
-				{
-					auto nextBlockIterator(innerBlockIterator);
-					nextBlockIterator++;
-					if(nextBlockIterator != m_basicBlocks.end())
-					{
-						if(nextBlockIterator->id == candidateBlockIterator->id)
-						{
-							referenced = true;
-							break;
-						}
-					}
-				}
+	//Compute reverse post order from the entry block
+	{
+		std::vector<uint32> postOrder;
+		postOrder.reserve(nodeCount);
+		std::vector<bool> visited(nodeCount, false);
+		//Stack of (node, next successor to visit)
+		std::vector<std::pair<uint32, uint32>> workStack;
+		workStack.emplace_back(0, 0);
+		visited[0] = true;
+		while(!workStack.empty())
+		{
+			auto& [nodeIndex, successorIndex] = workStack.back();
+			const auto& successors = result.nodes[nodeIndex].successors;
+			if(successorIndex == successors.size())
+			{
+				postOrder.push_back(nodeIndex);
+				workStack.pop_back();
+				continue;
 			}
+			uint32 successor = successors[successorIndex++];
+			if(visited[successor]) continue;
+			visited[successor] = true;
+			workStack.emplace_back(successor, 0);
+		}
+		result.reversePostOrder.assign(postOrder.rbegin(), postOrder.rend());
+		for(uint32 i = 0; i < result.reversePostOrder.size(); i++)
+		{
+			result.nodes[result.reversePostOrder[i]].reversePostOrderIndex = i;
+		}
+	}
 
-			if(!referenced)
+	//Compute dominator tree (Cooper, Harvey & Kennedy)
+	{
+		auto intersect =
+		    [&](uint32 node1, uint32 node2) {
+			    while(node1 != node2)
+			    {
+				    while(result.nodes[node1].reversePostOrderIndex > result.nodes[node2].reversePostOrderIndex)
+				    {
+					    node1 = result.nodes[node1].immediateDominator;
+				    }
+				    while(result.nodes[node2].reversePostOrderIndex > result.nodes[node1].reversePostOrderIndex)
+				    {
+					    node2 = result.nodes[node2].immediateDominator;
+				    }
+			    }
+			    return node1;
+		    };
+
+		result.nodes[0].immediateDominator = 0;
+		bool changed = true;
+		while(changed)
+		{
+			changed = false;
+			for(uint32 nodeIndex : result.reversePostOrder)
 			{
-				toDeleteIterator = candidateBlockIterator;
-				break;
+				if(nodeIndex == 0) continue;
+				auto& node = result.nodes[nodeIndex];
+				uint32 newDominator = CONTROL_FLOW_GRAPH::INVALID_NODE;
+				for(uint32 predecessor : node.predecessors)
+				{
+					if(result.nodes[predecessor].immediateDominator == CONTROL_FLOW_GRAPH::INVALID_NODE) continue;
+					newDominator = (newDominator == CONTROL_FLOW_GRAPH::INVALID_NODE) ? predecessor : intersect(predecessor, newDominator);
+				}
+				if(node.immediateDominator != newDominator)
+				{
+					node.immediateDominator = newDominator;
+					changed = true;
+				}
 			}
 		}
-		if(toDeleteIterator == m_basicBlocks.end()) continue;
-
-		m_basicBlocks.erase(toDeleteIterator);
-		deletedBlocks++;
-		changed = true;
 	}
 
-	HarmonizeBlocks();
-	return deletedBlocks != 0;
+	return result;
 }
 
-void CJitter::HarmonizeBlocks()
+void CJitter::AddBlockSuccessor(BASIC_BLOCK& basicBlock, uint32 successorId)
 {
-	//Remove any jumps that jump to the next block
-	for(BasicBlockList::iterator blockIterator(m_basicBlocks.begin());
-	    blockIterator != m_basicBlocks.end(); ++blockIterator)
-	{
-		BasicBlockList::iterator nextBlockIterator(blockIterator);
-		++nextBlockIterator;
-		if(nextBlockIterator == m_basicBlocks.end()) continue;
-
-		auto& basicBlock(*blockIterator);
-		if(basicBlock.statements.size() == 0) continue;
+	auto& successors = basicBlock.successors;
+	if(std::find(successors.begin(), successors.end(), successorId) != successors.end()) return;
+	successors.push_back(successorId);
+}
+
+void CJitter::ReplaceBlockSuccessor(BASIC_BLOCK& basicBlock, uint32 oldSuccessorId, uint32 newSuccessorId)
+{
+	auto& successors = basicBlock.successors;
+	successors.erase(std::remove(successors.begin(), successors.end(), oldSuccessorId), successors.end());
+	AddBlockSuccessor(basicBlock, newSuccessorId);
+}
+
+std::vector<uint32> CJitter::ComputeBlockSuccessors(BasicBlockList::const_iterator blockIterator) const
+{
+	//Successors according to the block's last statement and its position
+	std::vector<uint32> result;
+	bool fallsThrough = true;
+	if(!blockIterator->statements.empty())
+	{
+		const auto& statement = blockIterator->statements.back();
+		assert(statement.op != OP_GOTO);
+		if((statement.op == OP_JMP) || (statement.op == OP_CONDJMP))
+		{
+			result.push_back(statement.jmpBlock);
+		}
+		fallsThrough = (statement.op != OP_JMP);
+	}
+	auto nextBlockIterator = std::next(blockIterator);
+	if(fallsThrough && (nextBlockIterator != m_basicBlocks.end()) &&
+	   (std::find(result.begin(), result.end(), nextBlockIterator->id) == result.end()))
+	{
+		result.push_back(nextBlockIterator->id);
+	}
+	return result;
+}
+
+bool CJitter::CheckBlockSuccessors() const
+{
+	//Makes sure that edges maintained along the way match the flow control of the blocks
+	for(auto blockIterator = m_basicBlocks.begin(); blockIterator != m_basicBlocks.end(); ++blockIterator)
+	{
+		auto expectedSuccessors = ComputeBlockSuccessors(blockIterator);
+		auto successors = blockIterator->successors;
+		std::sort(expectedSuccessors.begin(), expectedSuccessors.end());
+		std::sort(successors.begin(), successors.end());
+		if(successors != expectedSuccessors) return false;
+	}
+	return true;
+}
+
+bool CJitter::PruneBlocks()
+{
+	int deletedBlocks = 0;
+
+	//Remove all blocks that can't be reached from the entry block
+	auto controlFlowGraph = BuildControlFlowGraph();
+	for(uint32 nodeIndex = 0; nodeIndex < controlFlowGraph.nodes.size(); nodeIndex++)
+	{
+		if(controlFlowGraph.IsReachable(nodeIndex)) continue;
+		m_basicBlocks.erase(controlFlowGraph.nodes[nodeIndex].block);
+		deletedBlocks++;
+	}
+
+	HarmonizeBlocks();
+	return deletedBlocks != 0;
+}
+
+void CJitter::HarmonizeBlocks()
+{
+	//Remove any jumps that jump to the next block
+	for(BasicBlockList::iterator blockIterator(m_basicBlocks.begin());
+	    blockIterator != m_basicBlocks.end(); ++blockIterator)
+	{
+		BasicBlockList::iterator nextBlockIterator(blockIterator);
+		++nextBlockIterator;
+		if(nextBlockIterator == m_basicBlocks.end()) continue;
+
+		auto& basicBlock(*blockIterator);
+		if(basicBlock.statements.size() == 0) continue;
 
 		StatementList::iterator lastStatementIterator(basicBlock.statements.end());
 		--lastStatementIterator;
@@ -1012,112 +1665,1240 @@ void CJitter::HarmonizeBlocks()
 	}
 
 	//Flag any block that have a reference from a jump
-	for(BasicBlockList::iterator outerBlockIterator(m_basicBlocks.begin());
-	    outerBlockIterator != m_basicBlocks.end(); ++outerBlockIterator)
+	std::unordered_set<uint32> jumpTargets;
+	for(const auto& basicBlock : m_basicBlocks)
+	{
+		if(basicBlock.statements.empty()) continue;
+		const auto& statement = basicBlock.statements.back();
+		if((statement.op != OP_JMP) && (statement.op != OP_CONDJMP)) continue;
+		jumpTargets.insert(statement.jmpBlock);
+	}
+	for(auto& basicBlock : m_basicBlocks)
 	{
-		auto& outerBlock(*outerBlockIterator);
-		outerBlock.hasJumpRef = false;
+		basicBlock.hasJumpRef = (jumpTargets.find(basicBlock.id) != std::end(jumpTargets));
+	}
+}
 
-		for(const auto& block : m_basicBlocks)
+bool CJitter::MergeBlocks()
+{
+	int deletedBlocks = 0;
+	for(BasicBlockList::iterator blockIterator(m_basicBlocks.begin());
+	    m_basicBlocks.end() != blockIterator; ++blockIterator)
+	{
+		auto& basicBlock(*blockIterator);
+
+		//Absorb as many following blocks as possible
+		while(1)
 		{
-			if(block.statements.size() == 0) continue;
+			BasicBlockList::iterator nextBlockIterator(blockIterator);
+			++nextBlockIterator;
+			if(nextBlockIterator == m_basicBlocks.end()) break;
 
-			//Check if this block references the next one or if it jumps to another one
-			StatementList::const_iterator lastInstruction(block.statements.end());
-			--lastInstruction;
-			const STATEMENT& statement(*lastInstruction);
+			auto& nextBlock(*nextBlockIterator);
+
+			if(nextBlock.hasJumpRef) break;
 
-			//It jumps to a block, so check if it references the one we're looking for
-			if(statement.op == OP_JMP || statement.op == OP_CONDJMP)
+			//Check if the last statement is a jump
+			if(!basicBlock.statements.empty())
 			{
-				if(statement.jmpBlock == outerBlockIterator->id)
+				const auto& statement(basicBlock.statements.back());
+				if(statement.op == OP_CONDJMP) break;
+				if(statement.op == OP_JMP) break;
+			}
+
+			//Blocks can be merged, the result is only cold if both parts are
+			MergeBasicBlocks(basicBlock, nextBlock);
+			basicBlock.isCold = basicBlock.isCold && nextBlock.isCold;
+			basicBlock.successors = std::move(nextBlock.successors);
+
+			m_basicBlocks.erase(nextBlockIterator);
+
+			++deletedBlocks;
+		}
+	}
+	return deletedBlocks != 0;
+}
+
+void CJitter::PlaceBlocks(bool splitColdBlocks)
+{
+	//Moves cold blocks after all the other blocks while keeping the order within both groups.
+	//Conditional jumps are inverted when possible to let the hot path fall through, otherwise
+	//a jump is added to keep going to the block that used to follow.
+	//When cold blocks are split in their own code region, blocks can only fall through to
+	//blocks of the same region and the function needs to end in the hot region.
+
+	if(m_basicBlocks.size() < 2) return;
+
+	//Entry block needs to stay first
+	m_basicBlocks.front().isCold = false;
+
+	bool hasColdBlocks = std::any_of(m_basicBlocks.begin(), m_basicBlocks.end(),
+	                                 [](const BASIC_BLOCK& basicBlock) { return basicBlock.isCold; });
+	if(hasColdBlocks)
+	{
+		const uint32 exitBlockId = CONTROL_FLOW_GRAPH::INVALID_NODE;
+
+		//Remember which block each block used to fall through to
+		std::unordered_map<uint32, uint32> fallthroughBlockIds;
+		for(auto blockIterator = m_basicBlocks.begin(); blockIterator != m_basicBlocks.end(); ++blockIterator)
+		{
+			auto nextBlockIterator = std::next(blockIterator);
+			fallthroughBlockIds[blockIterator->id] = (nextBlockIterator == m_basicBlocks.end()) ? exitBlockId : nextBlockIterator->id;
+		}
+
+		//Sorting is stable, relative order of hot and cold blocks is preserved
+		m_basicBlocks.sort(
+		    [](const BASIC_BLOCK& block1, const BASIC_BLOCK& block2) {
+			    return !block1.isCold && block2.isCold;
+		    });
+
+		//Falling through the end of the function is not possible anymore for blocks that moved, add an empty block to jump to
+		if(splitColdBlocks || (fallthroughBlockIds[m_basicBlocks.back().id] != exitBlockId))
+		{
+			uint32 newExitBlockId = m_nextBlockId++;
+			for(auto& fallthroughBlockIdPair : fallthroughBlockIds)
+			{
+				if(fallthroughBlockIdPair.second != exitBlockId) continue;
+				fallthroughBlockIdPair.second = newExitBlockId;
+			}
+			//Epilog is emitted in the hot region, exit block needs to be the last hot block if splitting
+			auto exitBlockPosition = splitColdBlocks ?
+			                             std::find_if(m_basicBlocks.begin(), m_basicBlocks.end(),
+			                                          [](const BASIC_BLOCK& basicBlock) { return basicBlock.isCold; }) :
+			                             m_basicBlocks.end();
+			auto& exitBlock = *m_basicBlocks.emplace(exitBlockPosition, BASIC_BLOCK());
+			exitBlock.id = newExitBlockId;
+			exitBlock.isCold = !splitColdBlocks;
+			fallthroughBlockIds[newExitBlockId] = exitBlockId;
+		}
+
+		for(auto blockIterator = m_basicBlocks.begin(); blockIterator != m_basicBlocks.end(); ++blockIterator)
+		{
+			auto& basicBlock = *blockIterator;
+			auto nextBlockIterator = std::next(blockIterator);
+			bool hasNextBlock = (nextBlockIterator != m_basicBlocks.end()) &&
+			                    (!splitColdBlocks || (nextBlockIterator->isCold == basicBlock.isCold));
+			uint32 nextBlockId = hasNextBlock ? nextBlockIterator->id : exitBlockId;
+			uint32 fallthroughBlockId = fallthroughBlockIds[basicBlock.id];
+
+			auto& statements = basicBlock.statements;
+			if(!statements.empty())
+			{
+				auto& statement = statements.back();
+				if(statement.op == OP_JMP)
+				{
+					if(statement.jmpBlock == nextBlockId)
+					{
+						statements.pop_back();
+					}
+					continue;
+				}
+				if(fallthroughBlockId == nextBlockId) continue;
+				if((statement.op == OP_CONDJMP) && (statement.jmpBlock == nextBlockId))
 				{
-					outerBlock.hasJumpRef = true;
-					break;
+					statement.jmpCondition = GetReverseCondition(statement.jmpCondition);
+					statement.jmpBlock = fallthroughBlockId;
+					AddBlockSuccessor(basicBlock, fallthroughBlockId);
+					continue;
 				}
 			}
+			else if(fallthroughBlockId == nextBlockId)
+			{
+				continue;
+			}
+
+			//Successors stay the same, unless the block used to fall through the end of the function
+			STATEMENT statement;
+			statement.op = OP_JMP;
+			statement.jmpBlock = fallthroughBlockId;
+			statements.push_back(statement);
+			AddBlockSuccessor(basicBlock, fallthroughBlockId);
+		}
+	}
+
+	//Let conditional jumps skip over blocks that only contain a jump (ie.: loop back edges)
+	//Before:          After:
+	// CONDJMP y        CONDJMP z (reversed)
+	//x:               x:
+	// JMP z
+	//y:               y:
+	std::unordered_set<uint32> jumpTargets;
+	for(const auto& basicBlock : m_basicBlocks)
+	{
+		for(const auto& statement : basicBlock.statements)
+		{
+			if((statement.op != OP_JMP) && (statement.op != OP_CONDJMP)) continue;
+			jumpTargets.insert(statement.jmpBlock);
+		}
+	}
+
+	for(auto blockIterator = m_basicBlocks.begin(); blockIterator != m_basicBlocks.end(); ++blockIterator)
+	{
+		auto jumpBlockIterator = std::next(blockIterator);
+		if(jumpBlockIterator == m_basicBlocks.end()) break;
+		auto nextBlockIterator = std::next(jumpBlockIterator);
+		if(nextBlockIterator == m_basicBlocks.end()) break;
+
+		if(blockIterator->statements.empty()) continue;
+		if(splitColdBlocks &&
+		   ((blockIterator->isCold != jumpBlockIterator->isCold) || (blockIterator->isCold != nextBlockIterator->isCold))) continue;
+		auto& condJumpStatement = blockIterator->statements.back();
+		if(condJumpStatement.op != OP_CONDJMP) continue;
+		if(condJumpStatement.jmpBlock != nextBlockIterator->id) continue;
+
+		auto& jumpBlock = *jumpBlockIterator;
+		if(jumpBlock.statements.size() != 1) continue;
+		if(jumpBlock.statements.front().op != OP_JMP) continue;
+		if(jumpTargets.find(jumpBlock.id) != std::end(jumpTargets)) continue;
+
+		condJumpStatement.jmpCondition = GetReverseCondition(condJumpStatement.jmpCondition);
+		condJumpStatement.jmpBlock = jumpBlock.statements.front().jmpBlock;
+		jumpBlock.statements.clear();
+
+		blockIterator->successors.clear();
+		AddBlockSuccessor(*blockIterator, condJumpStatement.jmpBlock);
+		AddBlockSuccessor(*blockIterator, jumpBlock.id);
+		jumpBlock.successors = {nextBlockIterator->id};
+	}
+}
+
+bool CJitter::ForwardRelativeConstants()
+{
+	//Known constant values of relatives, keyed by offset
+	typedef std::map<uint32, uint32> RelativeConstantMap;
+
+	auto controlFlowGraph = BuildControlFlowGraph();
+	uint32 nodeCount = static_cast<uint32>(controlFlowGraph.nodes.size());
+
+	auto transfer =
+	    [](const STATEMENT& statement, RelativeConstantMap& constants) {
+		    if(ClobbersRelatives(statement))
+		    {
+			    constants.clear();
+			    return;
+		    }
+		    if(!statement.dst) return;
+		    auto dstSymbol = statement.dst->GetSymbol().get();
+		    if(!dstSymbol->IsRelative()) return;
+		    uint32 dstStart = dstSymbol->m_valueLow;
+		    uint32 dstEnd = dstStart + dstSymbol->GetSize();
+		    for(auto constantIterator = constants.begin(); constantIterator != constants.end();)
+		    {
+			    uint32 start = constantIterator->first;
+			    if((start < dstEnd) && (dstStart < (start + 4)))
+			    {
+				    constantIterator = constants.erase(constantIterator);
+			    }
+			    else
+			    {
+				    ++constantIterator;
+			    }
+		    }
+		    if((statement.op == OP_MOV) && (dstSymbol->m_type == SYM_RELATIVE))
+		    {
+			    if(auto constant = dynamic_symbolref_cast(SYM_CONSTANT, statement.src1))
+			    {
+				    constants[dstStart] = constant->m_valueLow;
+			    }
+		    }
+	    };
+
+	std::vector<RelativeConstantMap> outStates(nodeCount);
+	std::vector<bool> outValid(nodeCount, false);
+
+	auto computeInState =
+	    [&](uint32 nodeIndex) {
+		    RelativeConstantMap result;
+		    //Nothing is known when entering the function
+		    if(nodeIndex == 0) return result;
+		    bool first = true;
+		    for(uint32 predecessor : controlFlowGraph.nodes[nodeIndex].predecessors)
+		    {
+			    if(!outValid[predecessor]) continue;
+			    const auto& predecessorState = outStates[predecessor];
+			    if(first)
+			    {
+				    result = predecessorState;
+				    first = false;
+				    continue;
+			    }
+			    for(auto constantIterator = result.begin(); constantIterator != result.end();)
+			    {
+				    auto predecessorIterator = predecessorState.find(constantIterator->first);
+				    if((predecessorIterator == std::end(predecessorState)) || (predecessorIterator->second != constantIterator->second))
+				    {
+					    constantIterator = result.erase(constantIterator);
+				    }
+				    else
+				    {
+					    ++constantIterator;
+				    }
+			    }
+		    }
+		    return result;
+	    };
+
+	bool stateChanged = true;
+	while(stateChanged)
+	{
+		stateChanged = false;
+		for(uint32 nodeIndex : controlFlowGraph.reversePostOrder)
+		{
+			auto constants = computeInState(nodeIndex);
+			for(const auto& statement : controlFlowGraph.nodes[nodeIndex].block->statements)
+			{
+				transfer(statement, constants);
+			}
+			if(!outValid[nodeIndex] || (outStates[nodeIndex] != constants))
+			{
+				outStates[nodeIndex] = std::move(constants);
+				outValid[nodeIndex] = true;
+				stateChanged = true;
+			}
 		}
 	}
+
+	bool changed = false;
+	for(uint32 nodeIndex : controlFlowGraph.reversePostOrder)
+	{
+		auto constants = computeInState(nodeIndex);
+		if(constants.empty()) continue;
+
+		auto& basicBlock = *controlFlowGraph.nodes[nodeIndex].block;
+		bool blockChanged = false;
+		for(auto& statement : basicBlock.statements)
+		{
+			if(constants.empty()) break;
+			statement.VisitSources(
+			    [&](SymbolRefPtr& symbolRef, bool) {
+				    auto symbol = symbolRef->GetSymbol();
+				    if(symbol->m_type != SYM_RELATIVE) return;
+				    auto constantIterator = constants.find(symbol->m_valueLow);
+				    if(constantIterator == std::end(constants)) return;
+				    symbolRef = MakeSymbolRef(MakeSymbol(&basicBlock, SYM_CONSTANT, constantIterator->second, 0));
+				    blockChanged = true;
+			    });
+			transfer(statement, constants);
+		}
+
+		if(blockChanged)
+		{
+			//Let the block optimizer fold the new constants
+			basicBlock.optimized = false;
+			changed = true;
+		}
+	}
+
+	return changed;
 }
 
-bool CJitter::MergeBlocks()
+bool CJitter::EliminateDeadRelativeStores()
 {
-	int deletedBlocks = 0;
-	bool changed = true;
-	while(changed)
+	//Offsets of relative words that are overwritten on every path before being read
+	typedef std::set<uint32> RelativeWordSet;
+
+	auto controlFlowGraph = BuildControlFlowGraph();
+	uint32 nodeCount = static_cast<uint32>(controlFlowGraph.nodes.size());
+
+	//Walks a block backwards, removing dead stores if requested
+	auto transfer =
+	    [](StatementList& statements, RelativeWordSet& words, bool removeDeadStores) {
+		    bool removed = false;
+		    for(auto statementIterator = statements.end(); statementIterator != statements.begin();)
+		    {
+			    --statementIterator;
+			    const auto& statement = *statementIterator;
+			    if(ExposesRelatives(statement))
+			    {
+				    words.clear();
+				    continue;
+			    }
+			    if(statement.dst)
+			    {
+				    auto dstSymbol = statement.dst->GetSymbol().get();
+				    uint32 dstStart = dstSymbol->m_valueLow;
+				    if(dstSymbol->IsRelative() && ((dstStart & 3) == 0))
+				    {
+					    uint32 dstEnd = dstStart + dstSymbol->GetSize();
+					    bool dead = true;
+					    for(uint32 word = dstStart; word < dstEnd; word += 4)
+					    {
+						    dead &= (words.find(word) != std::end(words));
+						    words.insert(word);
+					    }
+					    if(dead && removeDeadStores)
+					    {
+						    statementIterator = statements.erase(statementIterator);
+						    removed = true;
+						    continue;
+					    }
+				    }
+			    }
+			    statement.VisitSources(
+			        [&](const SymbolRefPtr& symbolRef, bool) {
+				        auto symbol = symbolRef->GetSymbol();
+				        if(!symbol->IsRelative()) return;
+				        uint32 start = symbol->m_valueLow & ~3;
+				        uint32 end = symbol->m_valueLow + symbol->GetSize();
+				        words.erase(words.lower_bound(start), words.lower_bound(end));
+			        });
+		    }
+		    return removed;
+	    };
+
+	std::vector<RelativeWordSet> inStates(nodeCount);
+	std::vector<bool> inValid(nodeCount, false);
+
+	auto computeOutState =
+	    [&](uint32 nodeIndex, RelativeWordSet& result) {
+		    //Everything is observable once we leave the function
+		    const auto& successors = controlFlowGraph.nodes[nodeIndex].successors;
+		    if(successors.empty()) return true;
+		    bool first = true;
+		    for(uint32 successor : successors)
+		    {
+			    if(!inValid[successor]) continue;
+			    const auto& successorState = inStates[successor];
+			    if(first)
+			    {
+				    result = successorState;
+				    first = false;
+				    continue;
+			    }
+			    for(auto wordIterator = result.begin(); wordIterator != result.end();)
+			    {
+				    if(successorState.find(*wordIterator) == std::end(successorState))
+				    {
+					    wordIterator = result.erase(wordIterator);
+				    }
+				    else
+				    {
+					    ++wordIterator;
+				    }
+			    }
+		    }
+		    return !first;
+	    };
+
+	bool stateChanged = true;
+	while(stateChanged)
+	{
+		stateChanged = false;
+		for(auto nodeIterator = controlFlowGraph.reversePostOrder.rbegin();
+		    nodeIterator != controlFlowGraph.reversePostOrder.rend(); ++nodeIterator)
+		{
+			uint32 nodeIndex = *nodeIterator;
+			RelativeWordSet words;
+			if(!computeOutState(nodeIndex, words)) continue;
+			transfer(controlFlowGraph.nodes[nodeIndex].block->statements, words, false);
+			if(!inValid[nodeIndex] || (inStates[nodeIndex] != words))
+			{
+				inStates[nodeIndex] = std::move(words);
+				inValid[nodeIndex] = true;
+				stateChanged = true;
+			}
+		}
+	}
+
+	bool changed = false;
+	for(uint32 nodeIndex : controlFlowGraph.reversePostOrder)
 	{
-		changed = false;
-		for(BasicBlockList::iterator blockIterator(m_basicBlocks.begin());
-		    m_basicBlocks.end() != blockIterator; ++blockIterator)
+		RelativeWordSet words;
+		if(!computeOutState(nodeIndex, words)) continue;
+		if(words.empty()) continue;
+
+		auto& basicBlock = *controlFlowGraph.nodes[nodeIndex].block;
+		if(transfer(basicBlock.statements, words, true))
 		{
-			BasicBlockList::iterator nextBlockIterator(blockIterator);
-			++nextBlockIterator;
-			if(nextBlockIterator == m_basicBlocks.end()) continue;
+			//Values feeding the removed stores might be dead now
+			basicBlock.optimized = false;
+			changed = true;
+		}
+	}
 
-			auto& basicBlock(*blockIterator);
-			auto& nextBlock(*nextBlockIterator);
+	return changed;
+}
 
-			if(nextBlock.hasJumpRef) continue;
+bool CJitter::IsHoistedTemporary(const CSymbol* symbol) const
+{
+	if(!symbol->IsTemporary()) return false;
+	return m_hoistedTemporaries.find(symbol->m_valueLow) != std::end(m_hoistedTemporaries);
+}
 
-			//Check if the last statement is a jump
-			if(!basicBlock.statements.empty())
+bool CJitter::HoistLoopInvariants()
+{
+	bool changed = false;
+	std::unordered_set<uint32> processedHeaders;
+	while(1)
+	{
+		auto controlFlowGraph = BuildControlFlowGraph();
+		uint32 nodeCount = static_cast<uint32>(controlFlowGraph.nodes.size());
+
+		//Find natural loops (back edges to a dominating block), loops sharing a header are merged
+		std::map<uint32, std::vector<bool>> loops;
+		for(uint32 nodeIndex : controlFlowGraph.reversePostOrder)
+		{
+			for(uint32 successor : controlFlowGraph.nodes[nodeIndex].successors)
+			{
+				if(!controlFlowGraph.Dominates(successor, nodeIndex)) continue;
+				uint32 headerId = controlFlowGraph.nodes[successor].block->id;
+				if(processedHeaders.find(headerId) != std::end(processedHeaders)) continue;
+
+				auto& loopNodes = loops[successor];
+				loopNodes.resize(nodeCount, false);
+				loopNodes[successor] = true;
+				std::vector<uint32> workList;
+				workList.push_back(nodeIndex);
+				while(!workList.empty())
+				{
+					uint32 loopNode = workList.back();
+					workList.pop_back();
+					if(loopNodes[loopNode]) continue;
+					loopNodes[loopNode] = true;
+					for(uint32 predecessor : controlFlowGraph.nodes[loopNode].predecessors)
+					{
+						if(!controlFlowGraph.IsReachable(predecessor)) continue;
+						workList.push_back(predecessor);
+					}
+				}
+			}
+		}
+
+		if(loops.empty()) break;
+
+		//Process inner loops first, invariants can then bubble up to the outer loops
+		auto loopIterator = std::min_element(loops.begin(), loops.end(),
+		                                     [](const auto& loop1, const auto& loop2) {
+			                                     return std::count(loop1.second.begin(), loop1.second.end(), true) <
+			                                            std::count(loop2.second.begin(), loop2.second.end(), true);
+		                                     });
+
+		uint32 headerIndex = loopIterator->first;
+		processedHeaders.insert(controlFlowGraph.nodes[headerIndex].block->id);
+		changed |= HoistLoopInvariants(controlFlowGraph, headerIndex, loopIterator->second);
+	}
+
+	if(changed)
+	{
+		HarmonizeBlocks();
+	}
+
+	return changed;
+}
+
+bool CJitter::HoistLoopInvariants(const CONTROL_FLOW_GRAPH& controlFlowGraph, uint32 headerIndex, const std::vector<bool>& loopNodes)
+{
+	uint32 nodeCount = static_cast<uint32>(controlFlowGraph.nodes.size());
+
+	bool clobbersAll = false;
+	std::vector<CSymbol*> writtenRelatives;
+	std::unordered_set<uint32> loopHoistedTemporaries;
+	for(uint32 nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++)
+	{
+		if(!loopNodes[nodeIndex]) continue;
+		for(const auto& statement : controlFlowGraph.nodes[nodeIndex].block->statements)
+		{
+			if(ClobbersRelatives(statement))
+			{
+				clobbersAll = true;
+			}
+			if(!statement.dst) continue;
+			auto dstSymbol = statement.dst->GetSymbol().get();
+			if(dstSymbol->IsRelative())
+			{
+				writtenRelatives.push_back(dstSymbol);
+			}
+			else if(IsHoistedTemporary(dstSymbol))
+			{
+				loopHoistedTemporaries.insert(dstSymbol->m_valueLow);
+			}
+		}
+	}
+
+	auto isInvariant =
+	    [&](const CSymbol* symbol) {
+		    if(symbol->IsConstant()) return true;
+		    if(symbol->m_type == SYM_CONTEXT) return true;
+		    if(symbol->IsRelative())
+		    {
+			    if(clobbersAll) return false;
+			    return std::none_of(writtenRelatives.begin(), writtenRelatives.end(),
+			                        [&](CSymbol* writtenRelative) { return writtenRelative->Aliases(const_cast<CSymbol*>(symbol)); });
+		    }
+		    if(IsHoistedTemporary(symbol))
+		    {
+			    return loopHoistedTemporaries.find(symbol->m_valueLow) == std::end(loopHoistedTemporaries);
+		    }
+		    return false;
+	    };
+
+	auto headerBlockIterator = controlFlowGraph.nodes[headerIndex].block;
+	BASIC_BLOCK* preheader = nullptr;
+
+	auto getPreheader =
+	    [&]() -> BASIC_BLOCK* {
+		    if(preheader) return preheader;
+
+		    std::vector<uint32> outsidePredecessors;
+		    for(uint32 predecessor : controlFlowGraph.nodes[headerIndex].predecessors)
+		    {
+			    if(loopNodes[predecessor]) continue;
+			    outsidePredecessors.push_back(predecessor);
+		    }
+
+		    bool isEntry = (headerIndex == 0);
+		    if(!isEntry)
+		    {
+			    if(outsidePredecessors.empty()) return nullptr;
+			    if(outsidePredecessors.size() == 1)
+			    {
+				    const auto& predecessorNode = controlFlowGraph.nodes[outsidePredecessors[0]];
+				    if(predecessorNode.successors.size() == 1)
+				    {
+					    preheader = &(*predecessorNode.block);
+					    return preheader;
+				    }
+			    }
+			    //Can't insert a block if something in the loop falls through to the header
+			    uint32 previousIndex = headerIndex - 1;
+			    const auto& previousBlock = *controlFlowGraph.nodes[previousIndex].block;
+			    if(loopNodes[previousIndex] && (previousBlock.statements.empty() || (previousBlock.statements.back().op != OP_JMP)))
+			    {
+				    return nullptr;
+			    }
+		    }
+
+		    BASIC_BLOCK newBlock;
+		    newBlock.id = m_nextBlockId++;
+		    newBlock.optimized = true;
+		    newBlock.isCold = headerBlockIterator->isCold;
+		    newBlock.successors.push_back(headerBlockIterator->id);
+		    auto newBlockIterator = m_basicBlocks.insert(headerBlockIterator, std::move(newBlock));
+
+		    //Outside predecessors either jump or fall through to the new block
+		    for(uint32 predecessor : outsidePredecessors)
+		    {
+			    auto& predecessorBlock = *controlFlowGraph.nodes[predecessor].block;
+			    ReplaceBlockSuccessor(predecessorBlock, headerBlockIterator->id, newBlockIterator->id);
+			    if(predecessorBlock.statements.empty()) continue;
+			    auto& statement = predecessorBlock.statements.back();
+			    if((statement.op != OP_JMP) && (statement.op != OP_CONDJMP)) continue;
+			    if(statement.jmpBlock != headerBlockIterator->id) continue;
+			    statement.jmpBlock = newBlockIterator->id;
+		    }
+
+		    preheader = &(*newBlockIterator);
+		    return preheader;
+	    };
+
+	bool changed = false;
+	for(uint32 nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++)
+	{
+		if(!loopNodes[nodeIndex]) continue;
+		auto& basicBlock = *controlFlowGraph.nodes[nodeIndex].block;
+
+		for(auto statementIterator = basicBlock.statements.begin();
+		    statementIterator != basicBlock.statements.end();)
+		{
+			auto& statement = *statementIterator;
+
+			bool hoistable = IsHoistableOperation(statement.op) && statement.dst;
+			if(hoistable)
+			{
+				auto dstType = statement.dst->GetSymbol()->m_type;
+				hoistable = (dstType == SYM_TEMPORARY) || (dstType == SYM_TEMPORARY64) || (dstType == SYM_TMP_REFERENCE);
+			}
+			if(hoistable)
+			{
+				statement.VisitSources(
+				    [&](const SymbolRefPtr& symbolRef, bool) {
+					    hoistable &= isInvariant(symbolRef->GetSymbol().get());
+				    });
+			}
+			if(hoistable)
+			{
+				//Temporary must only be defined once in this block
+				auto dstSymbol = statement.dst->GetSymbol();
+				hoistable = std::count_if(basicBlock.statements.begin(), basicBlock.statements.end(),
+				                          [&](const STATEMENT& otherStatement) {
+					                          return otherStatement.dst && otherStatement.dst->GetSymbol()->Equals(dstSymbol.get());
+				                          }) == 1;
+			}
+			if(!hoistable || !getPreheader())
+			{
+				++statementIterator;
+				continue;
+			}
+
+			//Give the temporary an identity that can be shared between blocks
+			auto dstSymbol = statement.dst->GetSymbol();
+			if(IsHoistedTemporary(dstSymbol.get()))
+			{
+				loopHoistedTemporaries.erase(dstSymbol->m_valueLow);
+			}
+			else
+			{
+				uint32 hoistedTemporary = m_nextTemporary++;
+				m_hoistedTemporaries.insert(hoistedTemporary);
+				auto hoistedSymbol = MakeSymbol(&basicBlock, dstSymbol->m_type, hoistedTemporary, 0);
+				for(auto& otherStatement : basicBlock.statements)
+				{
+					otherStatement.VisitOperands(
+					    [&](SymbolRefPtr& symbolRef, bool) {
+						    if(symbolRef->GetSymbol()->Equals(dstSymbol.get()))
+						    {
+							    symbolRef = MakeSymbolRef(hoistedSymbol);
+						    }
+					    });
+				}
+			}
+
+			auto hoistedStatement = statement;
+			hoistedStatement.VisitOperands(
+			    [&](SymbolRefPtr& symbolRef, bool) {
+				    auto symbol = symbolRef->GetSymbol();
+				    symbolRef = MakeSymbolRef(MakeSymbol(preheader, symbol->m_type, symbol->m_valueLow, symbol->m_valueHigh));
+			    });
+
+			auto insertIterator = preheader->statements.end();
+			if(!preheader->statements.empty())
+			{
+				auto lastOp = preheader->statements.back().op;
+				if((lastOp == OP_JMP) || (lastOp == OP_CONDJMP))
+				{
+					--insertIterator;
+				}
+			}
+			preheader->statements.insert(insertIterator, hoistedStatement);
+
+			statementIterator = basicBlock.statements.erase(statementIterator);
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+bool CJitter::ConstantPropagation(StatementList& statements)
+{
+	bool changed = false;
+
+	for(StatementList::iterator outerStatementIterator(statements.begin());
+	    statements.end() != outerStatementIterator; ++outerStatementIterator)
+	{
+		STATEMENT& outerStatement(*outerStatementIterator);
+
+		if(outerStatement.op != OP_MOV) continue;
+
+		CSymbol* constant = dynamic_symbolref_cast(SYM_CONSTANT, outerStatement.src1);
+		if(constant == NULL)
+		{
+			constant = dynamic_symbolref_cast(SYM_CONSTANT64, outerStatement.src1);
+		}
+		if(!constant) continue;
+
+		//Find anything that uses this operand and replace it with the constant
+		for(StatementList::iterator innerStatementIterator(outerStatementIterator);
+		    statements.end() != innerStatementIterator; ++innerStatementIterator)
+		{
+			if(outerStatementIterator == innerStatementIterator) continue;
+
+			auto& innerStatement(*innerStatementIterator);
+
+			innerStatement.VisitSources(
+			    [&](SymbolRefPtr& symbol, bool) {
+				    if(symbol->Equals(outerStatement.dst.get()))
+				    {
+					    symbol = outerStatement.src1;
+					    changed = true;
+				    }
+			    });
+		}
+	}
+	return changed;
+}
+
+bool CJitter::SimplifyKnownBits(StatementList& statements)
+{
+	//Tracks bits of temporaries known to be 0 or 1 and the number of leading bits that are copies of the sign bit
+	struct KNOWN_BITS
+	{
+		uint32 zero = 0;
+		uint32 one = 0;
+		uint32 signBits = 1;
+	};
+
+	auto makeConstantBits =
+	    [](uint32 value) {
+		    KNOWN_BITS result;
+		    result.zero = ~value;
+		    result.one = value;
+		    return result;
+	    };
+
+	auto countLeadingKnownSignBits =
+	    [](const KNOWN_BITS& bits) -> uint32 {
+		    if(bits.zero & 0x80000000) return (~bits.zero == 0) ? 32 : __builtin_clz(~bits.zero);
+		    if(bits.one & 0x80000000) return (~bits.one == 0) ? 32 : __builtin_clz(~bits.one);
+		    return 1;
+	    };
+
+	auto countTrailingKnownZeros =
+	    [](const KNOWN_BITS& bits) -> uint32 {
+		    return (~bits.zero == 0) ? 32 : __builtin_ctz(~bits.zero);
+	    };
+
+	std::unordered_map<CSymbol*, KNOWN_BITS> knownBits;
+	//Temporaries produced by a left shift of another temporary by a constant amount
+	std::unordered_map<CSymbol*, std::pair<SymbolRefPtr, uint32>> shiftedValues;
+
+	auto getBits =
+	    [&](const SymbolRefPtr& symbolRef) {
+		    if(auto constant = dynamic_symbolref_cast(SYM_CONSTANT, symbolRef))
+		    {
+			    return makeConstantBits(constant->m_valueLow);
+		    }
+		    auto symbol = symbolRef->GetSymbol().get();
+		    if(auto bitsIterator = knownBits.find(symbol); bitsIterator != std::end(knownBits))
+		    {
+			    return bitsIterator->second;
+		    }
+		    return KNOWN_BITS();
+	    };
+
+	//Returns 1 if the condition always holds, 0 if it never holds and -1 if unknown
+	auto evaluateCondition =
+	    [](CONDITION condition, const KNOWN_BITS& bits1, const KNOWN_BITS& bits2) -> int {
+		    uint32 umin1 = bits1.one, umax1 = ~bits1.zero;
+		    uint32 umin2 = bits2.one, umax2 = ~bits2.zero;
+		    auto signedRange =
+		        [](const KNOWN_BITS& bits) {
+			        if((bits.zero | bits.one) & 0x80000000)
+			        {
+				        return std::make_pair(static_cast<int32>(bits.one), static_cast<int32>(~bits.zero));
+			        }
+			        return std::make_pair(static_cast<int32>(bits.one | 0x80000000), static_cast<int32>(~bits.zero & 0x7FFFFFFF));
+		        };
+		    auto [smin1, smax1] = signedRange(bits1);
+		    auto [smin2, smax2] = signedRange(bits2);
+		    bool conflicting = ((bits1.zero & bits2.one) | (bits1.one & bits2.zero)) != 0;
+		    switch(condition)
+		    {
+		    case CONDITION_EQ:
+			    return conflicting ? 0 : -1;
+		    case CONDITION_NE:
+			    return conflicting ? 1 : -1;
+		    case CONDITION_BL:
+			    return (umax1 < umin2) ? 1 : ((umin1 >= umax2) ? 0 : -1);
+		    case CONDITION_BE:
+			    return (umax1 <= umin2) ? 1 : ((umin1 > umax2) ? 0 : -1);
+		    case CONDITION_AB:
+			    return (umin1 > umax2) ? 1 : ((umax1 <= umin2) ? 0 : -1);
+		    case CONDITION_AE:
+			    return (umin1 >= umax2) ? 1 : ((umax1 < umin2) ? 0 : -1);
+		    case CONDITION_LT:
+			    return (smax1 < smin2) ? 1 : ((smin1 >= smax2) ? 0 : -1);
+		    case CONDITION_LE:
+			    return (smax1 <= smin2) ? 1 : ((smin1 > smax2) ? 0 : -1);
+		    case CONDITION_GT:
+			    return (smin1 > smax2) ? 1 : ((smax1 <= smin2) ? 0 : -1);
+		    case CONDITION_GE:
+			    return (smin1 >= smax2) ? 1 : ((smax1 < smin2) ? 0 : -1);
+		    default:
+			    return -1;
+		    }
+	    };
+
+	bool changed = false;
+
+	for(auto& statement : statements)
+	{
+		auto src2cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2);
+		auto replaceWithMove =
+		    [&](const SymbolRefPtr& src) {
+			    statement.op = OP_MOV;
+			    statement.src1 = src;
+			    statement.src2.reset();
+			    changed = true;
+		    };
+
+		//Remove operations whose result is already implied
+		switch(statement.op)
+		{
+		case OP_AND:
+			if(src2cst && ((~src2cst->m_valueLow & ~getBits(statement.src1).zero) == 0))
+			{
+				replaceWithMove(statement.src1);
+			}
+			break;
+		case OP_OR:
+			if(src2cst && ((src2cst->m_valueLow & ~getBits(statement.src1).one) == 0))
+			{
+				replaceWithMove(statement.src1);
+			}
+			break;
+		case OP_SRA:
+		case OP_SRL:
+			if(src2cst && (src2cst->m_valueLow != 0) && (src2cst->m_valueLow < 32))
+			{
+				uint32 shiftAmount = src2cst->m_valueLow;
+				//Shifting back a value that was shifted left and fits in the remaining bits
+				auto shiftedIterator = shiftedValues.find(statement.src1->GetSymbol().get());
+				if((shiftedIterator != std::end(shiftedValues)) && (shiftedIterator->second.second == shiftAmount))
+				{
+					const auto& originalValue = shiftedIterator->second.first;
+					auto originalBits = getBits(originalValue);
+					uint32 highMask = ~(0xFFFFFFFF >> shiftAmount);
+					bool fits = (statement.op == OP_SRA) ? (originalBits.signBits > shiftAmount) : ((originalBits.zero & highMask) == highMask);
+					if(fits)
+					{
+						replaceWithMove(originalValue);
+						break;
+					}
+				}
+				if((statement.op == OP_SRA) && (getBits(statement.src1).zero & 0x80000000))
+				{
+					statement.op = OP_SRL;
+					changed = true;
+				}
+			}
+			break;
+		case OP_CMP:
+			if(int result = evaluateCondition(statement.jmpCondition, getBits(statement.src1), getBits(statement.src2)); result != -1)
+			{
+				replaceWithMove(MakeSymbolRef(MakeSymbol(SYM_CONSTANT, result)));
+			}
+			break;
+		case OP_CONDJMP:
+			if(int result = evaluateCondition(statement.jmpCondition, getBits(statement.src1), getBits(statement.src2)); result != -1)
+			{
+				statement.op = (result != 0) ? OP_JMP : OP_NOP;
+				statement.src1.reset();
+				statement.src2.reset();
+				changed = true;
+			}
+			break;
+		case OP_DIVS:
+		case OP_MULS:
+			//Signed and unsigned forms agree when both operands are positive
+			if((getBits(statement.src1).zero & getBits(statement.src2).zero) & 0x80000000)
+			{
+				statement.op = (statement.op == OP_DIVS) ? OP_DIV : OP_MUL;
+				changed = true;
+			}
+			break;
+		default:
+			break;
+		}
+
+		if(!statement.dst) continue;
+		auto dstSymbol = statement.dst->GetSymbol().get();
+		if(dstSymbol->m_type != SYM_TEMPORARY)
+		{
+			continue;
+		}
+
+		//Forget anything known about the previous value of this temporary
+		knownBits.erase(dstSymbol);
+		shiftedValues.erase(dstSymbol);
+		for(auto shiftedIterator = shiftedValues.begin(); shiftedIterator != shiftedValues.end();)
+		{
+			if(shiftedIterator->second.first->GetSymbol().get() == dstSymbol)
+			{
+				shiftedIterator = shiftedValues.erase(shiftedIterator);
+			}
+			else
+			{
+				++shiftedIterator;
+			}
+		}
+
+		src2cst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2);
+		uint32 shiftAmount = src2cst ? src2cst->m_valueLow : 32;
+
+		KNOWN_BITS bits;
+		bool isKnown = true;
+		switch(statement.op)
+		{
+		case OP_MOV:
+			bits = getBits(statement.src1);
+			break;
+		case OP_AND:
+		case OP_OR:
+		case OP_XOR:
+		{
+			auto bits1 = getBits(statement.src1);
+			auto bits2 = getBits(statement.src2);
+			if(statement.op == OP_AND)
+			{
+				bits.zero = bits1.zero | bits2.zero;
+				bits.one = bits1.one & bits2.one;
+			}
+			else if(statement.op == OP_OR)
+			{
+				bits.zero = bits1.zero & bits2.zero;
+				bits.one = bits1.one | bits2.one;
+			}
+			else
+			{
+				bits.zero = (bits1.zero & bits2.zero) | (bits1.one & bits2.one);
+				bits.one = (bits1.zero & bits2.one) | (bits1.one & bits2.zero);
+			}
+			bits.signBits = std::min(bits1.signBits, bits2.signBits);
+		}
+		break;
+		case OP_NOT:
+		{
+			auto bits1 = getBits(statement.src1);
+			bits.zero = bits1.one;
+			bits.one = bits1.zero;
+			bits.signBits = bits1.signBits;
+		}
+		break;
+		case OP_ADD:
+		case OP_SUB:
+		{
+			//Only low zero bits shared by both operands are known
+			uint32 trailingZeros = std::min(countTrailingKnownZeros(getBits(statement.src1)), countTrailingKnownZeros(getBits(statement.src2)));
+			bits.zero = (trailingZeros >= 32) ? ~0U : ((1U << trailingZeros) - 1);
+		}
+		break;
+		case OP_SLL:
+			if(shiftAmount < 32)
+			{
+				auto bits1 = getBits(statement.src1);
+				bits.zero = (bits1.zero << shiftAmount) | ((1U << shiftAmount) - 1);
+				bits.one = bits1.one << shiftAmount;
+				bits.signBits = (bits1.signBits > shiftAmount) ? (bits1.signBits - shiftAmount) : 1;
+				if((shiftAmount != 0) && statement.src1->GetSymbol()->m_type == SYM_TEMPORARY)
+				{
+					shiftedValues[dstSymbol] = std::make_pair(statement.src1, shiftAmount);
+				}
+			}
+			else
+			{
+				isKnown = false;
+			}
+			break;
+		case OP_SRL:
+			if(shiftAmount < 32)
+			{
+				auto bits1 = getBits(statement.src1);
+				bits.zero = (bits1.zero >> shiftAmount) | ~(0xFFFFFFFF >> shiftAmount);
+				bits.one = bits1.one >> shiftAmount;
+				bits.signBits = (shiftAmount != 0) ? shiftAmount : bits1.signBits;
+			}
+			else
+			{
+				isKnown = false;
+			}
+			break;
+		case OP_SRA:
+			if(shiftAmount < 32)
 			{
-				auto lastStatementIterator(basicBlock.statements.end());
-				--lastStatementIterator;
-				const auto& statement(*lastStatementIterator);
-				if(statement.op == OP_CONDJMP) continue;
-				if(statement.op == OP_JMP) continue;
+				auto bits1 = getBits(statement.src1);
+				bits.zero = static_cast<uint32>(static_cast<int32>(bits1.zero) >> shiftAmount);
+				bits.one = static_cast<uint32>(static_cast<int32>(bits1.one) >> shiftAmount);
+				bits.signBits = std::min<uint32>(32, bits1.signBits + shiftAmount);
 			}
+			else
+			{
+				isKnown = false;
+			}
+			break;
+		case OP_CMP:
+			bits.zero = ~1U;
+			break;
+		case OP_LZC:
+			bits.zero = ~0x1FU;
+			break;
+		case OP_LOAD8FROMREF:
+		case OP_LOAD8FROMMEMBASE:
+			bits.zero = ~0xFFU;
+			break;
+		case OP_LOAD16FROMREF:
+		case OP_LOAD16FROMMEMBASE:
+			bits.zero = ~0xFFFFU;
+			break;
+		default:
+			isKnown = false;
+			break;
+		}
 
-			//Blocks can be merged
-			MergeBasicBlocks(basicBlock, nextBlock);
-
-			m_basicBlocks.erase(nextBlockIterator);
+		if(!isKnown) continue;
 
-			++deletedBlocks;
-			changed = true;
-			break;
+		bits.signBits = std::max(bits.signBits, countLeadingKnownSignBits(bits));
+		if(((bits.zero | bits.one) == ~0U) && (statement.op != OP_MOV))
+		{
+			replaceWithMove(MakeSymbolRef(MakeSymbol(SYM_CONSTANT, bits.one)));
 		}
+		knownBits[dstSymbol] = bits;
 	}
-	return deletedBlocks != 0;
+
+	return changed;
 }
 
-bool CJitter::ConstantPropagation(StatementList& statements)
+bool CJitter::ReduceConstantDivisions(StatementList& statements)
 {
 	bool changed = false;
 
-	for(StatementList::iterator outerStatementIterator(statements.begin());
-	    statements.end() != outerStatementIterator; ++outerStatementIterator)
+	for(auto statementIterator = statements.begin();
+	    statementIterator != statements.end(); ++statementIterator)
 	{
-		STATEMENT& outerStatement(*outerStatementIterator);
-
-		if(outerStatement.op != OP_MOV) continue;
-
-		CSymbol* constant = dynamic_symbolref_cast(SYM_CONSTANT, outerStatement.src1);
-		if(constant == NULL)
+		auto& statement = *statementIterator;
+		if((statement.op != OP_DIV) && (statement.op != OP_DIVS)) continue;
+
+		auto divisorCst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2);
+		if(!divisorCst) continue;
+		//Leave divisions by zero to the code generators
+		if(divisorCst->m_valueLow == 0) continue;
+
+		bool isSigned = (statement.op == OP_DIVS);
+		uint32 divisor = divisorCst->m_valueLow;
+		auto dividend = statement.src1;
+
+		auto makeConstant = [&](uint32 value) { return MakeSymbolRef(MakeSymbol(SYM_CONSTANT, value)); };
+		auto emit =
+		    [&](OPERATION op, const SymbolRefPtr& src1, const SymbolRefPtr& src2, SYM_TYPE dstType = SYM_TEMPORARY) {
+			    STATEMENT newStatement;
+			    newStatement.op = op;
+			    newStatement.src1 = src1;
+			    newStatement.src2 = src2;
+			    newStatement.dst = MakeSymbolRef(MakeSymbol(dstType, m_nextTemporary++));
+			    statements.insert(statementIterator, newStatement);
+			    return newStatement.dst;
+		    };
+		auto emitCompare =
+		    [&](const SymbolRefPtr& src1, const SymbolRefPtr& src2, CONDITION condition) {
+			    STATEMENT newStatement;
+			    newStatement.op = OP_CMP;
+			    newStatement.src1 = src1;
+			    newStatement.src2 = src2;
+			    newStatement.jmpCondition = condition;
+			    newStatement.dst = MakeSymbolRef(MakeSymbol(SYM_TEMPORARY, m_nextTemporary++));
+			    statements.insert(statementIterator, newStatement);
+			    return newStatement.dst;
+		    };
+		auto emitMultiplyHigh =
+		    [&](const SymbolRefPtr& src, uint32 multiplier) {
+			    auto product = emit(isSigned ? OP_MULS : OP_MUL, src, makeConstant(multiplier), SYM_TEMPORARY64);
+			    return emit(OP_EXTHIGH64, product, SymbolRefPtr());
+		    };
+
+		SymbolRefPtr quotient;
+		SymbolRefPtr remainder;
+
+		if(!isSigned)
+		{
+			if(divisor == 1)
+			{
+				quotient = dividend;
+				remainder = makeConstant(0);
+			}
+			else if((divisor & (divisor - 1)) == 0)
+			{
+				quotient = emit(OP_SRL, dividend, makeConstant(__builtin_ctz(divisor)));
+				remainder = emit(OP_AND, dividend, makeConstant(divisor - 1));
+			}
+			else if(divisor & 0x80000000)
+			{
+				//Quotient can only be 0 or 1 (n >= d is checked as n > d - 1, code generators don't all support AE)
+				quotient = emitCompare(dividend, makeConstant(divisor - 1), CONDITION_AB);
+				auto mask = emit(OP_SUB, makeConstant(0), quotient);
+				auto product = emit(OP_AND, mask, makeConstant(divisor));
+				remainder = emit(OP_SUB, dividend, product);
+			}
+			else
+			{
+				auto magic = ComputeUnsignedDivisionMagic(divisor);
+				auto high = emitMultiplyHigh(dividend, magic.multiplier);
+				if(magic.needsAdd)
+				{
+					auto difference = emit(OP_SUB, dividend, high);
+					auto halfDifference = emit(OP_SRL, difference, makeConstant(1));
+					auto sum = emit(OP_ADD, halfDifference, high);
+					quotient = emit(OP_SRL, sum, makeConstant(magic.shift - 1));
+				}
+				else
+				{
+					quotient = (magic.shift != 0) ? emit(OP_SRL, high, makeConstant(magic.shift)) : high;
+				}
+			}
+		}
+		else
 		{
-			constant = dynamic_symbolref_cast(SYM_CONSTANT64, outerStatement.src1);
+			int32 signedDivisor = static_cast<int32>(divisor);
+			uint32 absDivisor = (signedDivisor < 0) ? (0 - divisor) : divisor;
+			if(signedDivisor == 1)
+			{
+				quotient = dividend;
+				remainder = makeConstant(0);
+			}
+			else if(signedDivisor == -1)
+			{
+				quotient = emit(OP_SUB, makeConstant(0), dividend);
+				remainder = makeConstant(0);
+			}
+			else if((absDivisor & (absDivisor - 1)) == 0)
+			{
+				//Bias negative dividends so that the shift rounds toward zero
+				uint32 shift = __builtin_ctz(absDivisor);
+				auto sign = emit(OP_SRA, dividend, makeConstant(31));
+				auto bias = emit(OP_SRL, sign, makeConstant(32 - shift));
+				auto sum = emit(OP_ADD, dividend, bias);
+				quotient = emit(OP_SRA, sum, makeConstant(shift));
+				if(signedDivisor < 0)
+				{
+					quotient = emit(OP_SUB, makeConstant(0), quotient);
+				}
+				auto truncated = emit(OP_AND, sum, makeConstant(~(absDivisor - 1)));
+				remainder = emit(OP_SUB, dividend, truncated);
+			}
+			else
+			{
+				auto magic = ComputeSignedDivisionMagic(signedDivisor);
+				auto high = emitMultiplyHigh(dividend, static_cast<uint32>(magic.multiplier));
+				if((signedDivisor > 0) && (magic.multiplier < 0))
+				{
+					high = emit(OP_ADD, high, dividend);
+				}
+				else if((signedDivisor < 0) && (magic.multiplier > 0))
+				{
+					high = emit(OP_SUB, high, dividend);
+				}
+				if(magic.shift != 0)
+				{
+					high = emit(OP_SRA, high, makeConstant(magic.shift));
+				}
+				auto roundUp = emit(OP_SRL, high, makeConstant(31));
+				quotient = emit(OP_ADD, high, roundUp);
+			}
 		}
-		if(!constant) continue;
 
-		//Find anything that uses this operand and replace it with the constant
-		for(StatementList::iterator innerStatementIterator(outerStatementIterator);
-		    statements.end() != innerStatementIterator; ++innerStatementIterator)
+		if(!remainder)
 		{
-			if(outerStatementIterator == innerStatementIterator) continue;
-
-			auto& innerStatement(*innerStatementIterator);
+			auto product = emit(OP_MUL, quotient, makeConstant(divisor), SYM_TEMPORARY64);
+			auto productLow = emit(OP_EXTLOW64, product, SymbolRefPtr());
+			remainder = emit(OP_SUB, dividend, productLow);
+		}
 
-			innerStatement.VisitSources(
-			    [&](SymbolRefPtr& symbol, bool) {
-				    if(symbol->Equals(outerStatement.dst.get()))
-				    {
-					    symbol = outerStatement.src1;
-					    changed = true;
-				    }
-			    });
+		//Results are usually split right away, use them directly
+		auto result = statement.dst;
+		for(auto useIterator = std::next(statementIterator); useIterator != statements.end(); ++useIterator)
+		{
+			auto& useStatement = *useIterator;
+			if((useStatement.op != OP_EXTLOW64) && (useStatement.op != OP_EXTHIGH64)) continue;
+			if(!useStatement.src1->Equals(result.get())) continue;
+			useStatement.src1 = (useStatement.op == OP_EXTLOW64) ? quotient : remainder;
+			useStatement.op = OP_MOV;
 		}
+
+		statement.op = OP_MERGETO64;
+		statement.src1 = quotient;
+		statement.src2 = remainder;
+		changed = true;
 	}
+
 	return changed;
 }
 
@@ -1166,6 +2947,227 @@ bool CJitter::ReorderAdd(StatementList& statements)
 	return changed;
 }
 
+bool CJitter::FoldAddRefAddressing(StatementList& statements)
+{
+	//Folds OP_ADDREF (and a shifted index feeding it) into the indexed form of the
+	//memory access that uses its result, letting code generators use a single
+	//base + index * scale + displacement addressing mode
+	bool changed = false;
+	bool supportsDisplacement = m_codeGen->SupportsRefIndexDisplacement();
+
+	std::map<CSymbol*, StatementList::iterator> tempDefs;
+
+	//Only allow folding if nothing between the definition and the access redefines the
+	//operands used by the definition. Relatives can also be modified through memory writes.
+	auto isRangeSafe =
+	    [](StatementList::iterator defIterator, StatementList::iterator endIterator) {
+		    const auto& defStatement(*defIterator);
+		    bool hasRelativeSource = false;
+		    defStatement.VisitSources(
+		        [&](const SymbolRefPtr& symbolRef, bool) {
+			        if(symbolRef->GetSymbol()->IsRelative()) hasRelativeSource = true;
+		        });
+		    for(auto statementIterator = std::next(defIterator); statementIterator != endIterator; statementIterator++)
+		    {
+			    const auto& statement(*statementIterator);
+			    if(hasRelativeSource && ClobbersRelatives(statement)) return false;
+			    if(!statement.dst) continue;
+			    auto dstSymbol = statement.dst->GetSymbol().get();
+			    bool redefinesSource = false;
+			    defStatement.VisitSources(
+			        [&](const SymbolRefPtr& symbolRef, bool) {
+				        auto symbol = symbolRef->GetSymbol().get();
+				        if(symbol->Equals(dstSymbol) || symbol->Aliases(dstSymbol)) redefinesSource = true;
+			        });
+			    if(redefinesSource) return false;
+		    }
+		    return true;
+	    };
+
+	for(auto statementIterator(statements.begin());
+	    statements.end() != statementIterator; ++statementIterator)
+	{
+		auto& statement(*statementIterator);
+
+		if(statement.dst && statement.dst->GetSymbol()->IsTemporary())
+		{
+			tempDefs[statement.dst->GetSymbol().get()] = statementIterator;
+		}
+
+		bool isLoad = IsLoadFromRefOperation(statement.op);
+		bool isStore = IsStoreAtRefOperation(statement.op);
+		if(!isLoad && !isStore) continue;
+
+		//References used by more than one access are folded in all of them, addressing
+		//modes make the addition free and the definition ends up unused
+		auto refSymbol = dynamic_symbolref_cast(SYM_TMP_REFERENCE, statement.src1);
+		if(!refSymbol) continue;
+
+		auto refDefIterator = tempDefs.find(refSymbol);
+		if(refDefIterator == std::end(tempDefs)) continue;
+		auto addRefIterator = refDefIterator->second;
+		const auto& addRefStatement(*addRefIterator);
+		if(addRefStatement.op != OP_ADDREF) continue;
+		if(!isRangeSafe(addRefIterator, statementIterator)) continue;
+
+		const auto& valueSymbolRef = isLoad ? statement.dst : (statement.src3 ? statement.src3 : statement.src2);
+		auto valueSymbol = valueSymbolRef->GetSymbol().get();
+		//Reference loads use the pointer size as scale, don't bother with those
+		if(
+		    (valueSymbol->m_type == SYM_TMP_REFERENCE) ||
+		    (valueSymbol->m_type == SYM_REL_REFERENCE) ||
+		    (valueSymbol->m_type == SYM_REG_REFERENCE))
+		{
+			continue;
+		}
+
+		//Indices are 32-bit values and x86 sign extends displacements, make sure
+		//the displacement fits in a positive signed 32-bit value
+		auto offsetCst = dynamic_symbolref_cast(SYM_CONSTANT, addRefStatement.src2);
+		if(offsetCst && (offsetCst->m_valueLow >= 0x80000000)) continue;
+
+		//Constant indices end up as immediate offsets, some code generators (ie.: AArch64)
+		//can only encode those if they are multiples of the access size
+		uint32 accessSize = GetRefAccessSize(statement.op, valueSymbol);
+
+		//Check if the offset is a scaled index we can use directly
+		SymbolRefPtr indexSymbolRef = addRefStatement.src2;
+		uint32 indexScale = 1;
+		bool isWordAccess = ((statement.op == OP_LOADFROMREF) || (statement.op == OP_STOREATREF) ||
+		                     (statement.op == OP_LOADFROMREFBSWAP) || (statement.op == OP_STOREATREFBSWAP)) &&
+		                    (valueSymbol->GetSize() == 4);
+		if(auto offsetTemp = dynamic_symbolref_cast(SYM_TEMPORARY, addRefStatement.src2); offsetTemp && isWordAccess)
+		{
+			auto offsetDefIterator = tempDefs.find(offsetTemp);
+			if(offsetDefIterator != std::end(tempDefs))
+			{
+				auto shiftIterator = offsetDefIterator->second;
+				const auto& shiftStatement(*shiftIterator);
+				auto shiftCst = dynamic_symbolref_cast(SYM_CONSTANT, shiftStatement.src2);
+				if(
+				    (shiftStatement.op == OP_SLL) && shiftCst && (shiftCst->m_valueLow == 2) &&
+				    isRangeSafe(shiftIterator, statementIterator))
+				{
+					indexSymbolRef = shiftStatement.src1;
+					indexScale = 4;
+				}
+			}
+		}
+
+		bool isIndexed = isLoad ? (statement.src2 != nullptr) : (statement.src3 != nullptr);
+		if(isIndexed)
+		{
+			auto indexCst = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2);
+			uint32 scale = static_cast<uint32>(statement.jmpCondition);
+			if(offsetCst && indexCst)
+			{
+				//Both constant, merge everything in the index
+				uint64 index = static_cast<uint64>(offsetCst->m_valueLow) + (static_cast<uint64>(indexCst->m_valueLow) * scale) +
+				               static_cast<uint64>(statement.displacement);
+				if(index >= 0x80000000) continue;
+				if((index % accessSize) != 0) continue;
+				statement.src1 = addRefStatement.src1;
+				statement.src2 = MakeSymbolRef(MakeSymbol(SYM_CONSTANT, static_cast<uint32>(index)));
+				statement.jmpCondition = static_cast<CONDITION>(1);
+				statement.displacement = 0;
+				changed = true;
+				continue;
+			}
+
+			//Otherwise, one of them needs to go in the displacement
+			if(!supportsDisplacement) continue;
+			uint64 displacement = statement.displacement;
+			if(offsetCst && !indexCst)
+			{
+				//base + cst, indexed by a variable
+				displacement += offsetCst->m_valueLow;
+				if(displacement >= 0x80000000) continue;
+				statement.src1 = addRefStatement.src1;
+			}
+			else if(!offsetCst && indexCst)
+			{
+				//base + variable, indexed by a constant
+				displacement += static_cast<uint64>(indexCst->m_valueLow) * scale;
+				if(displacement >= 0x80000000) continue;
+				statement.src1 = addRefStatement.src1;
+				statement.src2 = indexSymbolRef;
+				statement.jmpCondition = static_cast<CONDITION>(indexScale);
+			}
+			else
+			{
+				//Two variable indices, can't be merged
+				continue;
+			}
+			statement.displacement = static_cast<uint32>(displacement);
+			changed = true;
+			continue;
+		}
+
+		if(offsetCst && ((offsetCst->m_valueLow % accessSize) != 0)) continue;
+
+		statement.src1 = addRefStatement.src1;
+		if(isLoad)
+		{
+			statement.src2 = indexSymbolRef;
+		}
+		else
+		{
+			statement.src3 = statement.src2;
+			statement.src2 = indexSymbolRef;
+		}
+		statement.jmpCondition = static_cast<CONDITION>(indexScale);
+		changed = true;
+	}
+	return changed;
+}
+
+bool CJitter::FuseFlagBranches(StatementList& statements)
+{
+	//Makes a conditional jump on the flag extracted from an ALU flag operation test the
+	//operation's result directly, allowing code generators to branch on the processor flags
+	if(!m_codeGen->SupportsAluFlagBranches()) return false;
+	if(statements.empty()) return false;
+
+	auto& jumpStatement(statements.back());
+	if(jumpStatement.op != OP_CONDJMP) return false;
+	if((jumpStatement.jmpCondition != CONDITION_NE) && (jumpStatement.jmpCondition != CONDITION_EQ)) return false;
+
+	auto flagRef = jumpStatement.src1;
+	auto zeroCst = dynamic_symbolref_cast(SYM_CONSTANT, jumpStatement.src2);
+	if(!zeroCst)
+	{
+		flagRef = jumpStatement.src2;
+		zeroCst = dynamic_symbolref_cast(SYM_CONSTANT, jumpStatement.src1);
+	}
+	if(!zeroCst || (zeroCst->m_valueLow != 0)) return false;
+
+	auto flagSymbol = dynamic_symbolref_cast(SYM_TEMPORARY, flagRef);
+	if(!flagSymbol) return false;
+
+	auto findDefinition =
+	    [&](CSymbol* symbol) {
+		    return std::find_if(statements.rbegin(), statements.rend(),
+		                        [&](const STATEMENT& statement) { return statement.dst && statement.dst->GetSymbol()->Equals(symbol); });
+	    };
+
+	auto extHighIterator = findDefinition(flagSymbol);
+	if(extHighIterator == statements.rend()) return false;
+	if(extHighIterator->op != OP_EXTHIGH64) return false;
+
+	auto resultSymbol = dynamic_symbolref_cast(SYM_TEMPORARY64, extHighIterator->src1);
+	if(!resultSymbol) return false;
+
+	//Result must not be redefined between the flag extraction and the jump
+	auto resultDefIterator = findDefinition(resultSymbol);
+	if(resultDefIterator == statements.rend()) return false;
+	if(std::distance(statements.rbegin(), resultDefIterator) <= std::distance(statements.rbegin(), extHighIterator)) return false;
+	if(!IsAluFlagOperation(resultDefIterator->op)) return false;
+
+	jumpStatement.src1 = extHighIterator->src1;
+	jumpStatement.src2 = MakeSymbolRef(MakeSymbol(SYM_CONSTANT, 0));
+	return true;
+}
+
 bool CJitter::CopyPropagation(StatementList& statements)
 {
 	bool changed = false;
@@ -1246,6 +3248,7 @@ bool CJitter::CopyPropagation(StatementList& statements)
 			innerStatement.src2 = outerStatement.src2;
 			innerStatement.src3 = outerStatement.src3;
 			innerStatement.jmpCondition = outerStatement.jmpCondition;
+			innerStatement.displacement = outerStatement.displacement;
 			changed = true;
 		}
 		//Find all the add/sub constant and add them together
@@ -1280,63 +3283,119 @@ bool CJitter::CopyPropagation(StatementList& statements)
 bool CJitter::CommonExpressionElimination(VERSIONED_STATEMENT_LIST& versionedStatementList)
 {
 	bool changed = false;
-	std::vector<StatementList::const_iterator> tempDefs;
-	std::unordered_map<SymbolPtr, SymbolPtr> tempReplaceMap;
-	tempDefs.reserve(versionedStatementList.statements.size());
-
-	for(auto statementIterator(versionedStatementList.statements.begin());
-	    versionedStatementList.statements.end() != statementIterator; ++statementIterator)
+	ValueNumberMap valueNumbers;
+	std::unordered_map<SymbolPtr, SymbolRefPtr> tempReplaceMap;
+	//Expressions whose value lives in a relative, indexed by relative offset
+	std::unordered_map<uint32, VALUE_NUMBER_KEY> relativeValues;
+	valueNumbers.reserve(versionedStatementList.statements.size());
+
+	//Temporaries replaced by a relative can't be replaced anymore once that relative changes
+	auto invalidateTempReplacements =
+	    [&](uint32 offset, uint32 size) {
+		    for(auto tempReplaceIterator = tempReplaceMap.begin(); tempReplaceIterator != tempReplaceMap.end();)
+		    {
+			    auto valueSymbol = tempReplaceIterator->second->GetSymbol();
+			    if(valueSymbol->IsRelative() && (valueSymbol->m_valueLow >= offset) && (valueSymbol->m_valueLow < (offset + size)))
+			    {
+				    tempReplaceIterator = tempReplaceMap.erase(tempReplaceIterator);
+			    }
+			    else
+			    {
+				    ++tempReplaceIterator;
+			    }
+		    }
+	    };
+
+	auto invalidateRelativeValues =
+	    [&](uint32 offset, uint32 size) {
+		    for(uint32 i = 0; i < size; i += 4)
+		    {
+			    auto relativeValueIterator = relativeValues.find(offset + i);
+			    if(relativeValueIterator == std::end(relativeValues)) continue;
+			    valueNumbers.erase(relativeValueIterator->second);
+			    relativeValues.erase(relativeValueIterator);
+		    }
+		    invalidateTempReplacements(offset, size);
+	    };
+
+	for(auto& statement : versionedStatementList.statements)
 	{
-		auto& statement(*statementIterator);
-
-		//If this is a statement defining a temporary
-		if(
-		    (statement.op != OP_RETVAL) &&
-		    (statement.dst) &&
-		    (statement.dst->GetSymbol()->IsTemporary()))
-		{
-			const auto& newTemp = statement.dst->GetSymbol();
-
-			bool found = false;
-			//Check if our temporary already has a similar definition
-			for(const auto& tempDef : tempDefs)
-			{
-				const auto& tempDefStatement = *tempDef;
-				assert(tempDefStatement.dst);
-				const auto& temp = tempDefStatement.dst;
-				if(statement.op != tempDefStatement.op) continue;
-				if(statement.jmpCondition != tempDefStatement.jmpCondition) continue;
-				if(statement.src1 && !statement.src1->Equals(tempDefStatement.src1.get())) continue;
-				if(statement.src2 && !statement.src2->Equals(tempDefStatement.src2.get())) continue;
-				if(statement.src3 && !statement.src3->Equals(tempDefStatement.src3.get())) continue;
-				auto [_, inserted] = tempReplaceMap.insert(std::make_pair(newTemp, temp->GetSymbol()));
-				assert(inserted);
-				found = true;
-				//We assume the first replacement we find is gonna be the best
-				break;
-			}
+		if(!tempReplaceMap.empty())
+		{
+			statement.VisitSources(
+			    [&](SymbolRefPtr& innerSymbolRef, bool) {
+				    if(!innerSymbolRef->GetSymbol()->IsTemporary()) return;
+				    if(auto tempReplaceIterator = tempReplaceMap.find(innerSymbolRef->GetSymbol()); tempReplaceIterator != std::end(tempReplaceMap))
+				    {
+					    innerSymbolRef = tempReplaceIterator->second;
+					    changed = true;
+				    }
+			    });
+		}
 
-			//We haven't found a replacement for our definition, assume it's new
-			if(!found)
+		//Calls and stores through references could modify relatives behind our back
+		if(!relativeValues.empty() && ClobbersRelatives(statement))
+		{
+			for(const auto& relativeValuePair : relativeValues)
 			{
-				tempDefs.push_back(statementIterator);
+				valueNumbers.erase(relativeValuePair.second);
 			}
+			relativeValues.clear();
+			invalidateTempReplacements(0, UINT32_MAX);
+		}
+
+		if(!statement.dst) continue;
+
+		auto dstSymbol = statement.dst->GetSymbol();
+		if(dstSymbol->IsRelative())
+		{
+			invalidateRelativeValues(dstSymbol->m_valueLow, dstSymbol->GetSize());
+		}
+
+		//Memory base loads are not eliminated since stores could have modified memory in between
+		if(
+		    (statement.op == OP_RETVAL) ||
+		    (statement.op == OP_LOADFROMMEMBASE) ||
+		    (statement.op == OP_LOAD8FROMMEMBASE) ||
+		    (statement.op == OP_LOAD16FROMMEMBASE))
+		{
+			continue;
 		}
 
-		if(tempReplaceMap.empty())
+		bool isTemporaryDef = dstSymbol->IsTemporary();
+		//Only 32-bit relatives are versioned when defined, we can't refer to other relative kinds later on
+		bool isRelativeDef = (dstSymbol->m_type == SYM_RELATIVE) && statement.dst->IsVersioned() && (statement.op != OP_MOV);
+		if(!isTemporaryDef && !isRelativeDef) continue;
+
+		auto key = MakeValueNumberKey(statement);
+		auto valueNumberIterator = valueNumbers.find(key);
+		if(valueNumberIterator == std::end(valueNumbers))
 		{
+			valueNumbers.insert(std::make_pair(key, statement.dst));
+			if(isRelativeDef)
+			{
+				relativeValues[dstSymbol->m_valueLow] = key;
+			}
 			continue;
 		}
 
-		statement.VisitSources(
-		    [&](SymbolRefPtr& innerSymbolRef, bool) {
-			    if(!innerSymbolRef->GetSymbol()->IsTemporary()) return;
-			    if(auto tempReplaceIterator = tempReplaceMap.find(innerSymbolRef->GetSymbol()); tempReplaceIterator != std::end(tempReplaceMap))
-			    {
-				    innerSymbolRef = MakeSymbolRef(tempReplaceIterator->second);
-				    changed = true;
-			    }
-		    });
+		const auto& value = valueNumberIterator->second;
+		if(isTemporaryDef)
+		{
+			auto [_, inserted] = tempReplaceMap.insert(std::make_pair(dstSymbol, value));
+			assert(inserted);
+		}
+		else
+		{
+			//Value was already computed, copy it
+			assert(isRelativeDef);
+			statement.op = OP_MOV;
+			statement.src1 = value;
+			statement.src2.reset();
+			statement.src3.reset();
+			statement.jmpCondition = CONDITION_NEVER;
+			changed = true;
+		}
 	}
 
 	return changed;
@@ -1416,6 +3475,85 @@ bool CJitter::DeadcodeElimination(VERSIONED_STATEMENT_LIST& versionedStatementLi
 	return changed;
 }
 
+bool CJitter::EliminatePureCalls(VERSIONED_STATEMENT_LIST& versionedStatementList)
+{
+	//Pure calls can be dropped when their result is unused (dead code elimination removes the OP_RETVAL)
+	//and can reuse the result of an earlier identical call (same function and same parameters).
+
+	bool changed = false;
+	auto& statements = versionedStatementList.statements;
+
+	//Function, followed by parameters
+	typedef std::vector<VALUE_NUMBER_OPERAND> PureCallKey;
+	std::map<PureCallKey, SymbolRefPtr> pureCallResults;
+
+	auto statementIterator = statements.begin();
+	while(statementIterator != statements.end())
+	{
+		auto callIterator = statementIterator++;
+		const auto& statement = *callIterator;
+		if(ClobbersRelatives(statement))
+		{
+			//Relatives passed as parameters don't get a new version when something writes to them behind our back
+			pureCallResults.clear();
+			continue;
+		}
+		if((statement.op != OP_CALL) || !(statement.callAttributes & CALL_ATTRIBUTE_PURE)) continue;
+
+		auto paramCountSymbol = dynamic_symbolref_cast(SYM_CONSTANT, statement.src2);
+		assert(paramCountSymbol);
+		uint32 paramCount = paramCountSymbol->m_valueLow;
+
+		PureCallKey key;
+		key.push_back(MakeValueNumberOperand(statement.src1));
+
+		//Parameters are inserted right before the call
+		auto firstParamIterator = callIterator;
+		bool validParams = true;
+		for(uint32 i = 0; i < paramCount; i++)
+		{
+			if(firstParamIterator == statements.begin())
+			{
+				validParams = false;
+				break;
+			}
+			--firstParamIterator;
+			if(firstParamIterator->op != OP_PARAM)
+			{
+				validParams = false;
+				break;
+			}
+			key.push_back(MakeValueNumberOperand(firstParamIterator->src1));
+		}
+		if(!validParams) continue;
+
+		auto retValIterator = statementIterator;
+		bool hasResult = (retValIterator != statements.end()) && (retValIterator->op == OP_RETVAL);
+		if(hasResult)
+		{
+			auto retValSymbol = dynamic_symbolref_cast(SYM_TEMPORARY, retValIterator->dst);
+			if(!retValSymbol) continue;
+
+			auto pureCallResultIterator = pureCallResults.find(key);
+			if(pureCallResultIterator == std::end(pureCallResults))
+			{
+				pureCallResults.insert(std::make_pair(key, retValIterator->dst));
+				continue;
+			}
+
+			auto& retValStatement = *retValIterator;
+			retValStatement.op = OP_MOV;
+			retValStatement.src1 = pureCallResultIterator->second;
+		}
+
+		//Nothing depends on this call anymore
+		statementIterator = statements.erase(firstParamIterator, std::next(callIterator));
+		changed = true;
+	}
+
+	return changed;
+}
+
 void CJitter::CoalesceTemporaries(BASIC_BLOCK& basicBlock)
 {
 	typedef std::vector<CSymbol*> EncounteredTempList;
@@ -1428,6 +3566,8 @@ void CJitter::CoalesceTemporaries(BASIC_BLOCK& basicBlock)
 
 		if(!outerStatement.dst) continue;
 		if(!outerStatement.dst->GetSymbol()->IsTemporary()) continue;
+		//Hoisted temporaries are live across blocks
+		if(IsHoistedTemporary(outerStatement.dst->GetSymbol().get())) continue;
 
 		auto tempSymbol = outerStatement.dst->GetSymbol().get();
 		CSymbol* candidate = nullptr;
@@ -1572,6 +3712,7 @@ unsigned int CJitter::AllocateStack(BASIC_BLOCK& basicBlock)
 	unsigned int stackAlloc = 0;
 	for(const auto& symbol : basicBlock.symbolTable.GetSymbols())
 	{
+		if(IsHoistedTemporary(symbol.get())) continue;
 		if((symbol->m_type == SYM_TEMPORARY) || (symbol->m_type == SYM_FP_TEMPORARY32))
 		{
 			symbol->m_stackLocation = stackAlloc;
@@ -1623,6 +3764,37 @@ unsigned int CJitter::AllocateStack(BASIC_BLOCK& basicBlock)
 	return stackAlloc;
 }
 
+unsigned int CJitter::AllocateHoistedTemporaries(unsigned int stackSize)
+{
+	//Hoisted temporaries are placed after the block local temporaries since those overlap between blocks
+	std::map<uint32, unsigned int> hoistedLocations;
+	for(auto& basicBlock : m_basicBlocks)
+	{
+		for(const auto& symbol : basicBlock.symbolTable.GetSymbols())
+		{
+			if(!IsHoistedTemporary(symbol.get())) continue;
+			auto locationIterator = hoistedLocations.find(symbol->m_valueLow);
+			if(locationIterator == std::end(hoistedLocations))
+			{
+				unsigned int symbolSize = 4;
+				if(symbol->m_type == SYM_TEMPORARY64)
+				{
+					symbolSize = 8;
+				}
+				else if(symbol->m_type == SYM_TMP_REFERENCE)
+				{
+					symbolSize = sizeof(void*);
+				}
+				stackSize = (stackSize + symbolSize - 1) & ~(symbolSize - 1);
+				locationIterator = hoistedLocations.insert(std::make_pair(symbol->m_valueLow, stackSize)).first;
+				stackSize += symbolSize;
+			}
+			symbol->m_stackLocation = locationIterator->second;
+		}
+	}
+	return stackSize;
+}
+
 void CJitter::NormalizeStatements(BASIC_BLOCK& basicBlock)
 {
 	//Reorganize the commutative statements
@@ -1636,37 +3808,6 @@ void CJitter::NormalizeStatements(BASIC_BLOCK& basicBlock)
 
 		switch(statement.op)
 		{
-		case OP_ADD:
-		case OP_ADD64:
-		case OP_AND:
-		case OP_AND64:
-		case OP_OR:
-		case OP_XOR:
-		case OP_MUL:
-		case OP_MULS:
-		case OP_MD_AND:
-		case OP_MD_OR:
-		case OP_MD_XOR:
-		case OP_MD_ADD_B:
-		case OP_MD_ADD_H:
-		case OP_MD_ADD_W:
-		case OP_MD_ADDSS_H:
-		case OP_MD_ADDSS_W:
-		case OP_MD_ADDUS_B:
-		case OP_MD_ADDUS_W:
-		case OP_MD_CMPEQ_B:
-		case OP_MD_CMPEQ_H:
-		case OP_MD_CMPEQ_W:
-		case OP_MD_MIN_H:
-		case OP_MD_MIN_W:
-		case OP_MD_MAX_H:
-		case OP_MD_MAX_W:
-		case OP_MD_ADD_S:
-		case OP_MD_MUL_S:
-		case OP_MD_MIN_S:
-		case OP_MD_MAX_S:
-			isCommutative = true;
-			break;
 		case OP_CMP:
 		case OP_CMP64:
 		case OP_CONDJMP:
@@ -1674,7 +3815,7 @@ void CJitter::NormalizeStatements(BASIC_BLOCK& basicBlock)
 			conditionSwapRequired = true;
 			break;
 		default:
-			isCommutative = false;
+			isCommutative = IsCommutativeOperation(statement.op);
 			break;
 		}
 
@@ -1727,12 +3868,24 @@ void CJitter::NormalizeStatements(BASIC_BLOCK& basicBlock)
 			case CONDITION_AB:
 				statement.jmpCondition = CONDITION_BL;
 				break;
+			case CONDITION_BE:
+				statement.jmpCondition = CONDITION_AE;
+				break;
+			case CONDITION_AE:
+				statement.jmpCondition = CONDITION_BE;
+				break;
 			case CONDITION_LT:
 				statement.jmpCondition = CONDITION_GT;
 				break;
 			case CONDITION_GT:
 				statement.jmpCondition = CONDITION_LT;
 				break;
+			case CONDITION_LE:
+				statement.jmpCondition = CONDITION_GE;
+				break;
+			case CONDITION_GE:
+				statement.jmpCondition = CONDITION_LE;
+				break;
 			default:
 				assert(0);
 				break;
@@ -26,7 +26,7 @@ void CJitter::AllocateRegisters(BASIC_BLOCK& basicBlock)
 	//Register allocation is done per "range". A range is a sequence of instructions
 	//that ends with a OP_CALL or with the block's end. We do allocation per range
 	//because changes to relative symbols might need to be visible by functions
-	//called by the block.
+	//called by the block. Calls that can't write to the context don't end a range.
 
 	//There's a downside to this which is that temporaries also get the same treatment
 	//and are spilled at the end of a range which might not always be useful.
@@ -42,7 +42,25 @@ void CJitter::AllocateRegisters(BASIC_BLOCK& basicBlock)
 
 		MarkAliasedSymbols(basicBlock, allocRange, symbolRegAllocs);
 
-		AssociateSymbolsToRegisters(symbolRegAllocs);
+		//Calls inside a range only preserve callee saved registers, which excludes MD registers.
+		//Calls reading the context need to see the latest value of relatives.
+		bool hasInnerCall = false;
+		std::vector<unsigned int> contextReadingCalls;
+		for(const auto& statementInfo : ConstIndexedStatementList(basicBlock.statements))
+		{
+			const auto& statement(statementInfo.statement);
+			const auto& statementIdx(statementInfo.index);
+			if(statementIdx < allocRange.first) continue;
+			if(statementIdx >= allocRange.second) break;
+			if(statement.op != OP_CALL) continue;
+			hasInnerCall = true;
+			if(!IsContextIsolatedCall(statement))
+			{
+				contextReadingCalls.push_back(statementIdx);
+			}
+		}
+
+		AssociateSymbolsToRegisters(symbolRegAllocs, !hasInnerCall);
 
 		//Replace all references to symbols by references to allocated registers
 		for(const auto& statementInfo : IndexedStatementList(basicBlock.statements))
@@ -93,8 +111,8 @@ void CJitter::AllocateRegisters(BASIC_BLOCK& basicBlock)
 			}
 
 			//If symbol is defined, we need to save it at the end
-			//Exception: Temporaries can be discarded if we're in the last range of the block
-			bool deadTemporary = symbol->IsTemporary() && isLastRange;
+			//Exception: Temporaries can be discarded if we're in the last range of the block (unless they were hoisted out of a loop)
+			bool deadTemporary = symbol->IsTemporary() && !IsHoistedTemporary(symbol.get()) && isLastRange;
 			if(!deadTemporary && (symbolRegAlloc.firstDef != -1))
 			{
 				STATEMENT statement;
@@ -105,6 +123,20 @@ void CJitter::AllocateRegisters(BASIC_BLOCK& basicBlock)
 
 				spillStatements.insert(std::make_pair(allocRange.second, statement));
 			}
+
+			if(!symbol->IsRelative() || (symbolRegAlloc.firstDef == -1)) continue;
+			for(auto callIdx : contextReadingCalls)
+			{
+				if(symbolRegAlloc.firstDef >= callIdx) continue;
+
+				STATEMENT statement;
+				statement.op = OP_MOV;
+				statement.dst = std::make_shared<CSymbolRef>(symbol);
+				statement.src1 = std::make_shared<CSymbolRef>(
+				    symbolTable.MakeSymbol(symbolRegAlloc.registerType, symbolRegAlloc.registerId));
+
+				spillStatements.insert(std::make_pair(callIdx, statement));
+			}
 		}
 	}
 
@@ -179,7 +211,136 @@ void CJitter::AllocateRegisters(BASIC_BLOCK& basicBlock)
 #endif
 }
 
-void CJitter::AssociateSymbolsToRegisters(SymbolRegAllocInfo& symbolRegAllocs) const
+void CJitter::AssignPinnedRelativeRegisters()
+{
+	m_pinnedRelativeRegisters.clear();
+
+	//Leave at least half of the registers to the allocator
+	unsigned int regCount = m_codeGen->GetAvailableRegisterCount();
+	unsigned int pinnedCount = std::min<unsigned int>(static_cast<unsigned int>(m_pinnedRelatives.size()), regCount / 2);
+	for(unsigned int i = 0; i < pinnedCount; i++)
+	{
+		m_pinnedRelativeRegisters.insert(std::make_pair(m_pinnedRelatives[i], regCount - 1 - i));
+	}
+}
+
+void CJitter::AllocatePinnedRelatives(BASIC_BLOCK& basicBlock, bool isFirstBlock, bool isLastBlock)
+{
+	//Pinned relatives live in their register for the whole function. The context copy is only
+	//brought up to date when something else might observe it (calls, external jumps, aliased
+	//accesses and function exit) and the register is reloaded if something might have changed it.
+
+	if(m_pinnedRelativeRegisters.empty()) return;
+
+	auto& symbolTable = basicBlock.symbolTable;
+
+	auto makeLoadStatement =
+	    [&](uint32 offset, unsigned int registerId) {
+		    STATEMENT statement;
+		    statement.op = OP_MOV;
+		    statement.dst = MakeSymbolRef(symbolTable.MakeSymbol(SYM_REGISTER, registerId));
+		    statement.src1 = MakeSymbolRef(symbolTable.MakeSymbol(SYM_RELATIVE, offset));
+		    return statement;
+	    };
+
+	auto makeSpillStatement =
+	    [&](uint32 offset, unsigned int registerId) {
+		    STATEMENT statement;
+		    statement.op = OP_MOV;
+		    statement.dst = MakeSymbolRef(symbolTable.MakeSymbol(SYM_RELATIVE, offset));
+		    statement.src1 = MakeSymbolRef(symbolTable.MakeSymbol(SYM_REGISTER, registerId));
+		    return statement;
+	    };
+
+	auto& statements = basicBlock.statements;
+	for(auto statementIterator = statements.begin(); statementIterator != statements.end(); statementIterator++)
+	{
+		auto& statement(*statementIterator);
+
+		bool isCall = (statement.op == OP_CALL) && !IsContextIsolatedCall(statement);
+		bool isExternJump = (statement.op == OP_EXTERNJMP) || (statement.op == OP_EXTERNJMP_DYN);
+
+		//Find pinned relatives accessed in a way we can't replace by a register
+		std::set<uint32> aliasedRelatives;
+		statement.VisitOperands(
+		    [&](SymbolRefPtr& symbolRef, bool) {
+			    auto symbol = symbolRef->GetSymbol();
+			    for(const auto& pinnedRelativePair : m_pinnedRelativeRegisters)
+			    {
+				    auto pinnedSymbol = symbolTable.MakeSymbol(SYM_RELATIVE, pinnedRelativePair.first);
+				    bool isPinned = symbol->Equals(pinnedSymbol.get());
+				    if((isPinned && (statement.op == OP_PARAM_RET)) || (!isPinned && symbol->Aliases(pinnedSymbol.get())))
+				    {
+					    aliasedRelatives.insert(pinnedRelativePair.first);
+				    }
+			    }
+		    });
+
+		statement.VisitOperands(
+		    [&](SymbolRefPtr& symbolRef, bool) {
+			    auto symbol = dynamic_symbolref_cast(SYM_RELATIVE, symbolRef);
+			    if(!symbol) return;
+			    if(statement.op == OP_PARAM_RET) return;
+			    auto pinnedRelativeIterator = m_pinnedRelativeRegisters.find(symbol->m_valueLow);
+			    if(pinnedRelativeIterator == std::end(m_pinnedRelativeRegisters)) return;
+			    symbolRef = MakeSymbolRef(symbolTable.MakeSymbol(SYM_REGISTER, pinnedRelativeIterator->second));
+		    });
+
+		if(isCall || isExternJump)
+		{
+			for(const auto& pinnedRelativePair : m_pinnedRelativeRegisters)
+			{
+				aliasedRelatives.insert(pinnedRelativePair.first);
+			}
+		}
+
+		if(aliasedRelatives.empty()) continue;
+
+		for(auto aliasedRelative : aliasedRelatives)
+		{
+			statements.insert(statementIterator, makeSpillStatement(aliasedRelative, m_pinnedRelativeRegisters[aliasedRelative]));
+		}
+
+		//Nothing comes back from an external jump and calls that only read the context leave it as is
+		if(isExternJump) continue;
+		if(isCall && !CallMightWriteContext(statement)) continue;
+
+		auto nextStatementIterator = std::next(statementIterator);
+		for(auto aliasedRelative : aliasedRelatives)
+		{
+			statements.insert(nextStatementIterator, makeLoadStatement(aliasedRelative, m_pinnedRelativeRegisters[aliasedRelative]));
+		}
+		statementIterator = std::prev(nextStatementIterator);
+	}
+
+	if(isFirstBlock)
+	{
+		for(const auto& pinnedRelativePair : m_pinnedRelativeRegisters)
+		{
+			statements.push_front(makeLoadStatement(pinnedRelativePair.first, pinnedRelativePair.second));
+		}
+	}
+
+	if(isLastBlock)
+	{
+		//Spill before a final jump, code after it would never be executed
+		auto spillIterator = std::end(statements);
+		if(!statements.empty())
+		{
+			const auto& lastStatement = statements.back();
+			if((lastStatement.op == OP_JMP) || (lastStatement.op == OP_CONDJMP))
+			{
+				spillIterator = std::prev(spillIterator);
+			}
+		}
+		for(const auto& pinnedRelativePair : m_pinnedRelativeRegisters)
+		{
+			statements.insert(spillIterator, makeSpillStatement(pinnedRelativePair.first, pinnedRelativePair.second));
+		}
+	}
+}
+
+void CJitter::AssociateSymbolsToRegisters(SymbolRegAllocInfo& symbolRegAllocs, bool useMdRegisters) const
 {
 	//Some notes:
 	//- MD and FP registers are lumped together since MD registers are used for both
@@ -187,13 +348,15 @@ void CJitter::AssociateSymbolsToRegisters(SymbolRegAllocInfo& symbolRegAllocs) c
 
 	std::multimap<SYM_TYPE, unsigned int> availableRegisters;
 	{
-		unsigned int regCount = m_codeGen->GetAvailableRegisterCount();
+		//Registers used by pinned relatives are taken from the end of the register list
+		unsigned int regCount = m_codeGen->GetAvailableRegisterCount() - static_cast<unsigned int>(m_pinnedRelativeRegisters.size());
 		for(unsigned int i = 0; i < regCount; i++)
 		{
 			availableRegisters.insert(std::make_pair(SYM_REGISTER, i));
 		}
 	}
 
+	if(useMdRegisters)
 	{
 		unsigned int regCount = m_codeGen->GetAvailableMdRegisterCount();
 		for(unsigned int i = 0; i < regCount; i++)
@@ -295,7 +458,7 @@ CJitter::AllocationRangeArray CJitter::ComputeAllocationRanges(const BASIC_BLOCK
 	{
 		const auto& statement(statementInfo.statement);
 		const auto& statementIdx(statementInfo.index);
-		if(statement.op == OP_CALL)
+		if((statement.op == OP_CALL) && CallMightWriteContext(statement))
 		{
 			//Gotta split here
 			result.push_back(std::make_pair(currentStart, statementIdx));
@@ -376,4 +539,23 @@ void CJitter::MarkAliasedSymbols(const BASIC_BLOCK& basicBlock, const Allocation
 			    });
 		}
 	}
+
+	//Symbols overlapping pinned relatives are synchronized around every access, keep them in memory
+	for(auto& symbolRegAlloc : symbolRegAllocs)
+	{
+		if(symbolRegAlloc.second.aliased) continue;
+		const auto& symbol = symbolRegAlloc.first;
+		if(!symbol->IsRelative()) continue;
+		for(const auto& pinnedRelativePair : m_pinnedRelativeRegisters)
+		{
+			uint32 pinnedStart = pinnedRelativePair.first;
+			uint32 pinnedEnd = pinnedStart + 4;
+			uint32 symbolStart = symbol->m_valueLow;
+			uint32 symbolEnd = symbolStart + symbol->GetSize();
+			if((symbolStart < pinnedEnd) && (pinnedStart < symbolEnd))
+			{
+				symbolRegAlloc.second.aliased = true;
+			}
+		}
+	}
 }
@@ -1,8 +1,20 @@
 #include <iostream>
+#include <cassert>
 #include "Jitter_Statement.h"
 
 using namespace Jitter;
 
+bool Jitter::IsContextIsolatedCall(const STATEMENT& statement)
+{
+	assert(statement.op == OP_CALL);
+	return (statement.callAttributes & (CALL_ATTRIBUTE_NO_CONTEXT_ACCESS | CALL_ATTRIBUTE_PURE)) != 0;
+}
+
+bool Jitter::CallMightWriteContext(const STATEMENT& statement)
+{
+	return !IsContextIsolatedCall(statement) && !(statement.callAttributes & CALL_ATTRIBUTE_READS_CONTEXT_ONLY);
+}
+
 std::string Jitter::ConditionToString(CONDITION condition)
 {
 	switch(condition)
@@ -82,6 +94,21 @@ void Jitter::DumpStatementList(std::ostream& outputStream, const StatementList&
 		case OP_FP_DIV_S:
 			outputStream << " / ";
 			break;
+		case OP_ADDOVF:
+			outputStream << " +OVF ";
+			break;
+		case OP_ADDCARRY:
+			outputStream << " +CARRY ";
+			break;
+		case OP_ADC:
+			outputStream << " ADC ";
+			break;
+		case OP_SUBOVF:
+			outputStream << " -OVF ";
+			break;
+		case OP_SUBBORROW:
+			outputStream << " -BORROW ";
+			break;
 		case OP_AND:
 		case OP_AND64:
 		case OP_MD_AND:
@@ -125,6 +152,24 @@ void Jitter::DumpStatementList(std::ostream& outputStream, const StatementList&
 		case OP_LOADFROMREF:
 			outputStream << " LOADFROM ";
 			break;
+		case OP_STOREATREFBSWAP:
+		case OP_STORE16ATREFBSWAP:
+			outputStream << " <-BSWAP ";
+			break;
+		case OP_LOADFROMREFBSWAP:
+		case OP_LOAD16FROMREFBSWAP:
+			outputStream << " LOADFROM(BSWAP) ";
+			break;
+		case OP_STOREATMEMBASE:
+		case OP_STORE8ATMEMBASE:
+		case OP_STORE16ATMEMBASE:
+			outputStream << " <-MEMBASE ";
+			break;
+		case OP_LOADFROMMEMBASE:
+		case OP_LOAD8FROMMEMBASE:
+		case OP_LOAD16FROMMEMBASE:
+			outputStream << " LOADFROM(MEMBASE) ";
+			break;
 		case OP_RELTOREF:
 			outputStream << " TOREF ";
 			break;
@@ -153,6 +198,9 @@ void Jitter::DumpStatementList(std::ostream& outputStream, const StatementList&
 		case OP_LABEL:
 			outputStream << "LABEL_" << statement.jmpBlock << ":";
 			break;
+		case OP_LABEL_COLD:
+			outputStream << "LABEL_" << statement.jmpBlock << ": (COLD)";
+			break;
 		case OP_EXTLOW64:
 			outputStream << " EXTLOW64";
 			break;
@@ -352,6 +400,11 @@ void Jitter::DumpStatementList(std::ostream& outputStream, const StatementList&
 			outputStream << statement.src2->ToString();
 		}
 
+		if(statement.displacement != 0)
+		{
+			outputStream << " +DISP(" << statement.displacement << ")";
+		}
+
 		if(statement.src3)
 		{
 			outputStream << ", ";
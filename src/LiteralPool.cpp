@@ -1,3 +1,4 @@
+#include <assert.h>
 #include "LiteralPool.h"
 
 CLiteralPool::CLiteralPool(Framework::CStream* stream)
@@ -32,3 +33,21 @@ uint64 CLiteralPool::GetLiteralPosition(const LITERAL128& literal)
 		return literalPosIterator->second;
 	}
 }
+
+uint64 CLiteralPool::GetLiteralPosition(uint64 literal)
+{
+	auto literalPosIterator = m_literal64Positions.find(literal);
+	if(literalPosIterator == std::end(m_literal64Positions))
+	{
+		m_stream->Seek(0, Framework::STREAM_SEEK_END);
+		uint32 literalPos = m_stream->Tell();
+		assert((literalPos & 0x07) == 0);
+		m_stream->Write64(literal);
+		m_literal64Positions.insert(std::make_pair(literal, literalPos));
+		return literalPos;
+	}
+	else
+	{
+		return literalPosIterator->second;
+	}
+}
@@ -3,12 +3,14 @@
 #include <assert.h>
 #include <algorithm>
 #include <cstdint>
+#include <stdexcept>
 #include "AlignedAlloc.h"
 #include "MemoryFunction.h"
 
 // clang-format off
 
 #define BLOCK_ALIGN 0x10
+#define HUGE_PAGE_SIZE 0x200000
 
 #ifdef _WIN32
 	#define MEMFUNC_USE_WIN32
@@ -33,6 +35,9 @@
 	#define MEMFUNC_USE_WASM
 #else
 	#define MEMFUNC_USE_MMAP
+	#if defined(__linux__)
+		#define MEMFUNC_MMAP_DUAL_MAPPING
+	#endif
 #endif
 
 #if defined(MEMFUNC_USE_WIN32)
@@ -43,21 +48,53 @@
 #elif defined(MEMFUNC_USE_MMAP)
 #include <sys/mman.h>
 #include <pthread.h>
+#if defined(MEMFUNC_MMAP_DUAL_MAPPING)
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#ifndef MFD_HUGETLB
+#define MFD_HUGETLB 0x0004U
+#endif
+#endif
 #elif defined(MEMFUNC_USE_WASM)
 EM_JS_DEPS(WasmMemoryFunction, "$addFunction,$removeFunction");
-EM_JS(int, WasmCreateFunction, (emscripten::EM_VAL moduleHandle),
+EM_JS(int, WasmCreateFunction, (emscripten::EM_VAL moduleHandle, int fctIndex),
 {
 	let module = Emval.toValue(moduleHandle);
 	let moduleInstance = new WebAssembly.Instance(module, {
 		env: {
 			memory: wasmMemory,
-			fctTable : Module.codeGenImportTable
+			fctTable : wasmTable
 		}
 	});
-	let fct = moduleInstance.exports.codeGenFunc;
+	//Single function modules export "codeGenFunc", batches number their functions
+	let fct = moduleInstance.exports.codeGenFunc || moduleInstance.exports['codeGenFunc' + fctIndex];
 	let fctId = addFunction(fct, 'vi');
 	return fctId;
 });
+EM_JS(void, WasmCreateFunctions, (emscripten::EM_VAL moduleHandle, int* fctIds, int fctCount),
+{
+	//Instantiate once and register every function exported by the module
+	let module = Emval.toValue(moduleHandle);
+	let moduleInstance = new WebAssembly.Instance(module, {
+		env: {
+			memory: wasmMemory,
+			fctTable : wasmTable
+		}
+	});
+	for(let i = 0; i < fctCount; i++)
+	{
+		let fct = moduleInstance.exports.codeGenFunc || moduleInstance.exports['codeGenFunc' + i];
+		HEAP32[(fctIds >> 2) + i] = addFunction(fct, 'vi');
+	}
+});
 EM_JS(void, WasmDeleteFunction, (int fctId),
 {
 	removeFunction(fctId);
@@ -80,6 +117,147 @@ EM_JS(emscripten::EM_VAL, WasmCreateModule, (uintptr_t code, uintptr_t size),
 #error "No API to use for CMemoryFunction"
 #endif
 
+#if defined(MEMFUNC_USE_MMAP)
+
+//Maps memory that is both writable and executable
+static void* MapSingleCodeMemory(size_t size)
+{
+	uint32 additionalMapFlags = 0;
+	#ifdef MEMFUNC_MMAP_ADDITIONAL_FLAGS
+		additionalMapFlags = MEMFUNC_MMAP_ADDITIONAL_FLAGS;
+	#endif
+	void* code = mmap(nullptr, size, PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS | additionalMapFlags, -1, 0);
+	if(code == MAP_FAILED)
+	{
+		throw std::runtime_error("Failed to map code memory.");
+	}
+	return code;
+}
+
+#endif
+
+#if defined(MEMFUNC_MMAP_DUAL_MAPPING)
+
+//Maps the same memory twice, once writable and once executable, to avoid having pages that
+//are both writable and executable while still allowing code to be patched without syscalls.
+//Each call costs a memory file and two mappings that can't be merged with others, only use
+//this for large regions that functions are sub-allocated from, not for every function.
+//Fails if memory files can't be created (old kernels or sandboxed processes).
+static bool MapDualCodeMemory(size_t size, unsigned int fileFlags, void*& code, void*& writableCode)
+{
+	int fd = static_cast<int>(syscall(SYS_memfd_create, "CodeGen", MFD_CLOEXEC | fileFlags));
+	if(fd == -1)
+	{
+		return false;
+	}
+	code = MAP_FAILED;
+	writableCode = MAP_FAILED;
+	if(ftruncate(fd, size) == 0)
+	{
+		writableCode = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		code = mmap(nullptr, size, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+	}
+	close(fd);
+	if((code == MAP_FAILED) || (writableCode == MAP_FAILED))
+	{
+		if(code != MAP_FAILED) munmap(code, size);
+		if(writableCode != MAP_FAILED) munmap(writableCode, size);
+		return false;
+	}
+	return true;
+}
+
+//Maps private memory aligned on a huge page boundary and asks for transparent huge pages.
+//Succeeding doesn't mean huge pages will be used, the kernel is free to ignore the hint.
+static bool MapTransparentHugePageMemory(size_t size, void*& code)
+{
+#if defined(MADV_HUGEPAGE)
+	size_t mapSize = size + HUGE_PAGE_SIZE;
+	void* mapping = mmap(nullptr, mapSize, PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(mapping == MAP_FAILED)
+	{
+		return false;
+	}
+	auto base = reinterpret_cast<uint8*>(mapping);
+	auto alignedBase = reinterpret_cast<uint8*>((reinterpret_cast<uintptr_t>(base) + HUGE_PAGE_SIZE - 1) & ~static_cast<uintptr_t>(HUGE_PAGE_SIZE - 1));
+	size_t headSize = alignedBase - base;
+	size_t tailSize = mapSize - headSize - size;
+	if(headSize != 0) munmap(base, headSize);
+	if(tailSize != 0) munmap(alignedBase + size, tailSize);
+	if(madvise(alignedBase, size, MADV_HUGEPAGE) != 0)
+	{
+		munmap(alignedBase, size);
+		return false;
+	}
+	code = alignedBase;
+	return true;
+#else
+	return false;
+#endif
+}
+
+//Asks for transparent huge pages on both views of memory mapped by MapDualCodeMemory.
+//Memory files only get them if allowed for shared memory (transparent_hugepage/shmem_enabled).
+static bool AdviseDualCodeMemoryHugePages(size_t size, void* code, void* writableCode)
+{
+#if defined(MADV_HUGEPAGE)
+	return (madvise(code, size, MADV_HUGEPAGE) == 0) && (madvise(writableCode, size, MADV_HUGEPAGE) == 0);
+#else
+	return false;
+#endif
+}
+
+//Functions that are not allocated from a specific region share the regions of this heap.
+//Mapping a memory file for each function would quickly run into the limit on the number
+//of mappings a process can have (vm.max_map_count).
+struct CODE_HEAP
+{
+	typedef std::map<const uint8*, std::unique_ptr<CMemoryFunctionRegion>> RegionMap;
+
+	std::mutex mutex;
+	RegionMap regions;
+};
+
+static CODE_HEAP& GetCodeHeap()
+{
+	//Never destroyed, functions held by static objects could be released after it otherwise
+	static auto codeHeap = new CODE_HEAP();
+	return *codeHeap;
+}
+
+//Returns how much of the mapping starting at the specified address is backed by transparent huge pages.
+//Reads the whole mapping list of the process, don't call this while holding locks.
+static size_t GetTransparentHugePageSize(const void* address)
+{
+	std::ifstream smaps("/proc/self/smaps");
+	auto mappingAddress = reinterpret_cast<uintptr_t>(address);
+	bool inMapping = false;
+	size_t result = 0;
+	std::string line;
+	while(std::getline(smaps, line))
+	{
+		uintptr_t start = 0;
+		uintptr_t end = 0;
+		unsigned long hugePageSize = 0;
+		if(sscanf(line.c_str(), "%" SCNxPTR "-%" SCNxPTR " ", &start, &end) == 2)
+		{
+			if(inMapping) break;
+			inMapping = (mappingAddress >= start) && (mappingAddress < end);
+		}
+		else if(inMapping && (sscanf(line.c_str(), "AnonHugePages: %lu kB", &hugePageSize) == 1))
+		{
+			result += hugePageSize * 1024;
+		}
+		else if(inMapping && (sscanf(line.c_str(), "ShmemPmdMapped: %lu kB", &hugePageSize) == 1))
+		{
+			result += hugePageSize * 1024;
+		}
+	}
+	return result;
+}
+
+#endif
+
 CMemoryFunction::CMemoryFunction()
 : m_code(nullptr)
 , m_size(0)
@@ -89,12 +267,68 @@ CMemoryFunction::CMemoryFunction()
 
 CMemoryFunction::CMemoryFunction(const void* code, size_t size)
 : m_code(nullptr)
+, m_size(0)
+{
+#if defined(MEMFUNC_USE_WASM)
+	m_wasmModule = emscripten::val::take_ownership(WasmCreateModule(reinterpret_cast<uintptr_t>(code), size));
+	m_size = size;
+	m_code = reinterpret_cast<void*>(WasmCreateFunction(m_wasmModule.as_handle(), 0));
+	ClearCache();
+#else
+	Allocate(size);
+	BeginModify();
+	memcpy(GetWritableCode(), code, size);
+	EndModify();
+#endif
+}
+
+CMemoryFunction::CMemoryFunction(CMemoryFunction&& rhs)
+: m_code(nullptr)
+, m_size(0)
+{
+	(*this) = std::move(rhs);
+}
+
+CMemoryFunction::~CMemoryFunction()
+{
+	Reset();
+}
+
+#if !defined(__EMSCRIPTEN__)
+
+CMemoryFunction::CMemoryFunction(CMemoryFunctionRegion& region, const void* code, size_t size)
+: CMemoryFunction(Reserve(region, size))
+{
+	BeginModify();
+	memcpy(GetWritableCode(), code, size);
+	EndModify();
+}
+
+CMemoryFunction CMemoryFunction::Reserve(size_t size)
+{
+	CMemoryFunction result;
+	result.Allocate(size);
+	return result;
+}
+
+CMemoryFunction CMemoryFunction::Reserve(CMemoryFunctionRegion& region, size_t size)
+{
+	size_t offset = region.Allocate(size);
+	CMemoryFunction result;
+	result.m_code = region.m_code + offset;
+	result.m_writableCode = region.m_writableCode + offset;
+	result.m_size = size;
+	result.m_region = &region;
+	return result;
+}
+
+void CMemoryFunction::Allocate(size_t size)
 {
+	assert(m_code == nullptr);
 #if defined(MEMFUNC_USE_WIN32)
 	m_size = size;
 	m_code = framework_aligned_alloc(size, BLOCK_ALIGN);
-	memcpy(m_code, code, size);
-	
+
 	DWORD oldProtect = 0;
 	BOOL result = VirtualProtect(m_code, size, PAGE_EXECUTE_READWRITE, &oldProtect);
 	assert(result == TRUE);
@@ -103,46 +337,50 @@ CMemoryFunction::CMemoryFunction(const void* code, size_t size)
 	host_page_size(mach_task_self(), &page_size);
 	unsigned int allocSize = ((size + page_size - 1) / page_size) * page_size;
 	vm_allocate(mach_task_self(), reinterpret_cast<vm_address_t*>(&m_code), allocSize, TRUE); 
-	memcpy(m_code, code, size);
 	vm_prot_t protection =
 	#ifdef MEMFUNC_MACHVM_STRICT_PROTECTION
 		VM_PROT_READ | VM_PROT_EXECUTE;
 	#else
 		VM_PROT_READ | VM_PROT_WRITE | VM_PROT_EXECUTE;
 	#endif
-	kern_return_t result = vm_protect(mach_task_self(), reinterpret_cast<vm_address_t>(m_code), size, 0, protection);
+	kern_return_t result = vm_protect(mach_task_self(), reinterpret_cast<vm_address_t>(m_code), allocSize, 0, protection);
 	assert(result == 0);
 	m_size = allocSize;
+#elif defined(MEMFUNC_MMAP_DUAL_MAPPING)
+	auto& codeHeap = GetCodeHeap();
+	std::lock_guard<std::mutex> lock(codeHeap.mutex);
+	CMemoryFunctionRegion* region = nullptr;
+	size_t offset = 0;
+	for(const auto& regionPair : codeHeap.regions)
+	{
+		if(regionPair.second->TryAllocate(size, offset))
+		{
+			region = regionPair.second.get();
+			break;
+		}
+	}
+	if(region == nullptr)
+	{
+		//Regions fall back to a single writable and executable view if memory files are not available
+		auto newRegion = std::make_unique<CMemoryFunctionRegion>(std::max<size_t>(size, HUGE_PAGE_SIZE));
+		region = newRegion.get();
+		offset = region->Allocate(size);
+		codeHeap.regions.insert(std::make_pair(region->m_code, std::move(newRegion)));
+	}
+	m_code = region->m_code + offset;
+	m_writableCode = region->m_writableCode + offset;
+	m_size = size;
 #elif defined(MEMFUNC_USE_MMAP)
-	uint32 additionalMapFlags = 0;
-	#ifdef MEMFUNC_MMAP_ADDITIONAL_FLAGS
-		additionalMapFlags = MEMFUNC_MMAP_ADDITIONAL_FLAGS;
-	#endif
+	m_code = MapSingleCodeMemory(size);
 	m_size = size;
-	m_code = mmap(nullptr, size, PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS | additionalMapFlags, -1, 0);
-	assert(m_code != MAP_FAILED);
-#ifdef MEMFUNC_MMAP_REQUIRES_JIT_WRITE_PROTECT
-	pthread_jit_write_protect_np(false);
 #endif
-	memcpy(m_code, code, size);
-#ifdef MEMFUNC_MMAP_REQUIRES_JIT_WRITE_PROTECT
-	pthread_jit_write_protect_np(true);
-#endif
-#elif defined(MEMFUNC_USE_WASM)
-	m_wasmModule = emscripten::val::take_ownership(WasmCreateModule(reinterpret_cast<uintptr_t>(code), size));
-	m_size = size;
-	m_code = reinterpret_cast<void*>(WasmCreateFunction(m_wasmModule.as_handle()));
+#if !defined(MEMFUNC_MMAP_DUAL_MAPPING)
+	m_writableCode = m_code;
 #endif
-	ClearCache();
-#if !defined(MEMFUNC_USE_WASM)
 	assert((reinterpret_cast<uintptr_t>(m_code) & (BLOCK_ALIGN - 1)) == 0);
-#endif
 }
 
-CMemoryFunction::~CMemoryFunction()
-{
-	Reset();
-}
+#endif
 
 void CMemoryFunction::ClearCache()
 {
@@ -157,12 +395,29 @@ void CMemoryFunction::ClearCache()
 
 void CMemoryFunction::Reset()
 {
-	if(m_code != nullptr)
+	if(m_region != nullptr)
+	{
+		m_region->Free(reinterpret_cast<uint8*>(m_code) - m_region->m_code, m_size);
+	}
+	else if(m_code != nullptr)
 	{
 #if defined(MEMFUNC_USE_WIN32)
 		framework_aligned_free(m_code);
 #elif defined(MEMFUNC_USE_MACHVM)
 		vm_deallocate(mach_task_self(), reinterpret_cast<vm_address_t>(m_code), m_size);
+#elif defined(MEMFUNC_MMAP_DUAL_MAPPING)
+		auto& codeHeap = GetCodeHeap();
+		std::lock_guard<std::mutex> lock(codeHeap.mutex);
+		auto regionIterator = codeHeap.regions.upper_bound(reinterpret_cast<const uint8*>(m_code));
+		assert(regionIterator != codeHeap.regions.begin());
+		regionIterator--;
+		auto& region = regionIterator->second;
+		region->Free(reinterpret_cast<uint8*>(m_code) - region->m_code, m_size);
+		//Keep the last region around, avoids mapping memory again when functions are compiled and released in a loop
+		if((region->m_functionCount == 0) && (codeHeap.regions.size() != 1))
+		{
+			codeHeap.regions.erase(regionIterator);
+		}
 #elif defined(MEMFUNC_USE_MMAP)
 		munmap(m_code, m_size);
 #elif defined(MEMFUNC_USE_WASM)
@@ -170,9 +425,12 @@ void CMemoryFunction::Reset()
 #endif
 	}
 	m_code = nullptr;
+	m_writableCode = nullptr;
 	m_size = 0;
+	m_region = nullptr;
 #if defined(MEMFUNC_USE_WASM)
 	m_wasmModule = emscripten::val();
+	m_wasmFunctionIndex = 0;
 #endif
 }
 
@@ -185,9 +443,12 @@ CMemoryFunction& CMemoryFunction::operator =(CMemoryFunction&& rhs)
 {
 	Reset();
 	std::swap(m_code, rhs.m_code);
+	std::swap(m_writableCode, rhs.m_writableCode);
+	std::swap(m_region, rhs.m_region);
 	std::swap(m_size, rhs.m_size);
 #if defined(MEMFUNC_USE_WASM)
 	std::swap(m_wasmModule, rhs.m_wasmModule);
+	std::swap(m_wasmFunctionIndex, rhs.m_wasmFunctionIndex);
 #endif
 	return (*this);
 }
@@ -209,6 +470,11 @@ size_t CMemoryFunction::GetSize() const
 	return m_size;
 }
 
+void* CMemoryFunction::GetWritableCode() const
+{
+	return m_writableCode;
+}
+
 void CMemoryFunction::BeginModify()
 {
 #if defined(MEMFUNC_USE_MACHVM) && defined(MEMFUNC_MACHVM_STRICT_PROTECTION)
@@ -236,9 +502,201 @@ CMemoryFunction CMemoryFunction::CreateInstance()
 	CMemoryFunction result;
 	result.m_wasmModule = m_wasmModule;
 	result.m_size = m_size;
-	result.m_code = reinterpret_cast<void*>(WasmCreateFunction(m_wasmModule.as_handle()));
+	result.m_wasmFunctionIndex = m_wasmFunctionIndex;
+	result.m_code = reinterpret_cast<void*>(WasmCreateFunction(m_wasmModule.as_handle(), m_wasmFunctionIndex));
 	return result;
 #else
+	if(m_region != nullptr)
+	{
+		return CMemoryFunction(*m_region, GetCode(), GetSize());
+	}
 	return CMemoryFunction(GetCode(), GetSize());
 #endif
 }
+
+#if defined(__EMSCRIPTEN__)
+
+std::vector<CMemoryFunction> CMemoryFunction::CreateBatch(const void* code, size_t size, uint32 functionCount)
+{
+	auto wasmModule = emscripten::val::take_ownership(WasmCreateModule(reinterpret_cast<uintptr_t>(code), size));
+	std::vector<int> fctIds(functionCount);
+	WasmCreateFunctions(wasmModule.as_handle(), fctIds.data(), functionCount);
+	std::vector<CMemoryFunction> result(functionCount);
+	for(uint32 i = 0; i < functionCount; i++)
+	{
+		auto& function = result[i];
+		function.m_wasmModule = wasmModule;
+		function.m_size = size;
+		function.m_wasmFunctionIndex = i;
+		function.m_code = reinterpret_cast<void*>(fctIds[i]);
+	}
+	return result;
+}
+
+#endif
+
+#if !defined(__EMSCRIPTEN__)
+
+CMemoryFunctionRegion::CMemoryFunctionRegion(size_t size, HUGE_PAGE_POLICY hugePagePolicy)
+{
+#if defined(MEMFUNC_USE_MACHVM) && defined(MEMFUNC_MACHVM_STRICT_PROTECTION)
+	//Protection changes can only be done on whole pages, which would affect neighboring functions
+	throw std::runtime_error("Code regions are not supported on this platform.");
+#endif
+	m_size = (size + HUGE_PAGE_SIZE - 1) & ~static_cast<size_t>(HUGE_PAGE_SIZE - 1);
+#if defined(MEMFUNC_MMAP_DUAL_MAPPING)
+	//Explicit huge pages need to be reserved by the system administrator, mapping fails otherwise
+	void* code = nullptr;
+	void* writableCode = nullptr;
+	bool mapped = false;
+	if(MapDualCodeMemory(m_size, MFD_HUGETLB, code, writableCode))
+	{
+		m_hugePageMode = HUGE_PAGE_MODE_EXPLICIT;
+		mapped = true;
+	}
+	else if((hugePagePolicy == HUGE_PAGE_POLICY_ALLOW_WRITABLE_EXECUTABLE) && MapTransparentHugePageMemory(m_size, code))
+	{
+		//Private memory gets transparent huge pages with the default settings, but can only be mapped once
+		writableCode = code;
+		m_hugePageMode = HUGE_PAGE_MODE_TRANSPARENT;
+		mapped = true;
+	}
+	else if(MapDualCodeMemory(m_size, 0, code, writableCode))
+	{
+		if(AdviseDualCodeMemoryHugePages(m_size, code, writableCode))
+		{
+			m_hugePageMode = HUGE_PAGE_MODE_TRANSPARENT;
+		}
+		mapped = true;
+	}
+	if(mapped)
+	{
+		m_code = reinterpret_cast<uint8*>(code);
+		m_writableCode = reinterpret_cast<uint8*>(writableCode);
+	}
+#endif
+	if(m_code == nullptr)
+	{
+#if defined(MEMFUNC_USE_MMAP)
+		//Memory files are not available, fall back to a single view
+		m_code = reinterpret_cast<uint8*>(MapSingleCodeMemory(m_size));
+		m_writableCode = m_code;
+#else
+		m_memory = CMemoryFunction::Reserve(m_size);
+		m_code = reinterpret_cast<uint8*>(m_memory.GetCode());
+		m_writableCode = reinterpret_cast<uint8*>(m_memory.GetWritableCode());
+#endif
+	}
+	m_freeBlocks.insert(std::make_pair(0, m_size));
+}
+
+CMemoryFunctionRegion::~CMemoryFunctionRegion()
+{
+	assert(m_functionCount == 0);
+#if defined(MEMFUNC_USE_MMAP)
+	munmap(m_code, m_size);
+	if(m_writableCode != m_code)
+	{
+		munmap(m_writableCode, m_size);
+	}
+#endif
+}
+
+CMemoryFunctionRegion::STATS CMemoryFunctionRegion::GetStats() const
+{
+	STATS stats;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		stats.usedSize = m_usedSize;
+		stats.functionCount = m_functionCount;
+		for(const auto& freeBlock : m_freeBlocks)
+		{
+			stats.largestFreeBlockSize = std::max(stats.largestFreeBlockSize, freeBlock.second);
+		}
+	}
+	//Mappings don't change after construction and can be looked at without holding the lock
+	stats.capacity = m_size;
+	stats.mappingMode = (m_writableCode != m_code) ? MAPPING_MODE_DUAL : MAPPING_MODE_SINGLE;
+	switch(m_hugePageMode)
+	{
+	case HUGE_PAGE_MODE_EXPLICIT:
+		stats.hugePageMode = HUGE_PAGE_MODE_EXPLICIT;
+		stats.hugePageBackedSize = m_size;
+		break;
+#if defined(MEMFUNC_MMAP_DUAL_MAPPING)
+	case HUGE_PAGE_MODE_TRANSPARENT:
+		//The hint might have been ignored, only report what the kernel actually provided
+		stats.hugePageBackedSize = GetTransparentHugePageSize(m_code);
+		if(stats.hugePageBackedSize != 0)
+		{
+			stats.hugePageMode = HUGE_PAGE_MODE_TRANSPARENT;
+		}
+		break;
+#endif
+	default:
+		break;
+	}
+	return stats;
+}
+
+size_t CMemoryFunctionRegion::Allocate(size_t size)
+{
+	size_t offset = 0;
+	if(!TryAllocate(size, offset))
+	{
+		throw std::runtime_error("Not enough space left in code region.");
+	}
+	return offset;
+}
+
+bool CMemoryFunctionRegion::TryAllocate(size_t size, size_t& offset)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	size = (size + BLOCK_ALIGN - 1) & ~static_cast<size_t>(BLOCK_ALIGN - 1);
+	//First fit, keeps functions packed towards the start of the region
+	for(auto freeBlockIterator = m_freeBlocks.begin(); freeBlockIterator != m_freeBlocks.end(); freeBlockIterator++)
+	{
+		size_t blockOffset = freeBlockIterator->first;
+		size_t blockSize = freeBlockIterator->second;
+		if(blockSize < size) continue;
+		m_freeBlocks.erase(freeBlockIterator);
+		if(blockSize != size)
+		{
+			m_freeBlocks.insert(std::make_pair(blockOffset + size, blockSize - size));
+		}
+		m_usedSize += size;
+		m_functionCount++;
+		offset = blockOffset;
+		return true;
+	}
+	return false;
+}
+
+void CMemoryFunctionRegion::Free(size_t offset, size_t size)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	size = (size + BLOCK_ALIGN - 1) & ~static_cast<size_t>(BLOCK_ALIGN - 1);
+	assert(m_functionCount != 0);
+	m_usedSize -= size;
+	m_functionCount--;
+
+	//Merge with adjacent free blocks
+	auto nextBlockIterator = m_freeBlocks.lower_bound(offset);
+	if((nextBlockIterator != m_freeBlocks.end()) && (nextBlockIterator->first == (offset + size)))
+	{
+		size += nextBlockIterator->second;
+		nextBlockIterator = m_freeBlocks.erase(nextBlockIterator);
+	}
+	if(nextBlockIterator != m_freeBlocks.begin())
+	{
+		auto prevBlockIterator = std::prev(nextBlockIterator);
+		if((prevBlockIterator->first + prevBlockIterator->second) == offset)
+		{
+			prevBlockIterator->second += size;
+			return;
+		}
+	}
+	m_freeBlocks.insert(std::make_pair(offset, size));
+}
+
+#endif
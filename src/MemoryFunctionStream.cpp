@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "MemoryFunctionStream.h"
+
+CMemoryFunctionStream::CMemoryFunctionStream(CMemoryFunction& function)
+    : m_code(reinterpret_cast<uint8*>(function.GetWritableCode()))
+    , m_capacity(function.GetSize())
+{
+}
+
+void CMemoryFunctionStream::Seek(int64 position, Framework::STREAM_SEEK_DIRECTION direction)
+{
+	//End is the end of the code written so far, not the end of the reserved memory
+	switch(direction)
+	{
+	case Framework::STREAM_SEEK_SET:
+		m_position = position;
+		break;
+	case Framework::STREAM_SEEK_CUR:
+		m_position += position;
+		break;
+	case Framework::STREAM_SEEK_END:
+		m_position = m_size + position;
+		break;
+	}
+	if(m_position > m_capacity)
+	{
+		throw std::runtime_error("Seeking outside of reserved code memory.");
+	}
+}
+
+uint64 CMemoryFunctionStream::Tell()
+{
+	return m_position;
+}
+
+uint64 CMemoryFunctionStream::Read(void* buffer, uint64 size)
+{
+	size = std::min<uint64>(size, m_size - std::min<uint64>(m_position, m_size));
+	memcpy(buffer, m_code + m_position, size);
+	m_position += size;
+	return size;
+}
+
+uint64 CMemoryFunctionStream::Write(const void* buffer, uint64 size)
+{
+	if((m_capacity - m_position) < size)
+	{
+		throw std::runtime_error("Generated code doesn't fit in reserved code memory.");
+	}
+	memcpy(m_code + m_position, buffer, size);
+	m_position += size;
+	m_size = std::max<uint64>(m_size, m_position);
+	return size;
+}
+
+bool CMemoryFunctionStream::IsEOF()
+{
+	return m_position >= m_size;
+}
+
+uint64 CMemoryFunctionStream::GetSize() const
+{
+	return m_size;
+}
@@ -1,6 +1,7 @@
 #include "WasmModuleBuilder.h"
 #include <cassert>
 #include <cstring>
+#include <string>
 #include "WasmDefs.h"
 
 static void WriteName(Framework::CStream& stream, const char* str)
@@ -11,6 +12,37 @@ static void WriteName(Framework::CStream& stream, const char* str)
 	stream.Write(str, length);
 }
 
+static std::string GetFunctionExportName(uint32 functionIndex, size_t functionCount)
+{
+	//Modules holding a single function keep the name they always had
+	if(functionCount == 1) return "codeGenFunc";
+	return std::string("codeGenFunc") + std::to_string(functionIndex);
+}
+
+typedef std::pair<uint32, uint8> LocalDecl;
+
+static std::vector<LocalDecl> GetLocalDecls(const CWasmModuleBuilder::FUNCTION& function)
+{
+	std::vector<LocalDecl> localDecls;
+	if(function.localI32Count != 0) localDecls.emplace_back(function.localI32Count, Wasm::TYPE_I32);
+	if(function.localI64Count != 0) localDecls.emplace_back(function.localI64Count, Wasm::TYPE_I64);
+	if(function.localF32Count != 0) localDecls.emplace_back(function.localF32Count, Wasm::TYPE_F32);
+	if(function.localV128Count != 0) localDecls.emplace_back(function.localV128Count, Wasm::TYPE_V128);
+	return localDecls;
+}
+
+static uint32 GetFunctionBodySize(const CWasmModuleBuilder::FUNCTION& function)
+{
+	auto localDecls = GetLocalDecls(function);
+	uint32 size = CWasmModuleBuilder::GetULeb128Size(localDecls.size());
+	for(const auto& localDecl : localDecls)
+	{
+		size += CWasmModuleBuilder::GetULeb128Size(localDecl.first) + 1;
+	}
+	size += static_cast<uint32>(function.code.size());
+	return size;
+}
+
 void CWasmModuleBuilder::WriteSLeb128(Framework::CStream& stream, int64 value)
 {
 	bool more = true;
@@ -77,8 +109,7 @@ void CWasmModuleBuilder::AddFunction(FUNCTION function)
 
 void CWasmModuleBuilder::WriteModule(Framework::CStream& stream)
 {
-	//We only support a single function at the moment
-	assert(m_functions.size() == 1);
+	assert(!m_functions.empty());
 
 	stream.Write32(Wasm::BINARY_MAGIC);
 	stream.Write32(Wasm::BINARY_VERSION);
@@ -145,77 +176,72 @@ void CWasmModuleBuilder::WriteModule(Framework::CStream& stream)
 
 	//Section "Function"
 	{
-		WriteSectionHeader(stream, Wasm::SECTION_ID_FUNCTION, 0x02);
+		uint32 sectionSize =
+		    GetULeb128Size(m_functions.size()) +
+		    static_cast<uint32>(m_functions.size());
+
+		WriteSectionHeader(stream, Wasm::SECTION_ID_FUNCTION, sectionSize);
 
-		stream.Write8(1); //Function vector size
+		WriteULeb128(stream, m_functions.size()); //Function vector size
 
-		//Function 0
-		stream.Write8(0); //Signature index
+		for(uint32 i = 0; i < m_functions.size(); i++)
+		{
+			stream.Write8(0); //Signature index
+		}
 	}
 
 	//Section "Export"
 	{
-		WriteSectionHeader(stream, Wasm::SECTION_ID_EXPORT, 15);
+		uint32 sectionSize = GetULeb128Size(m_functions.size());
+		for(uint32 i = 0; i < m_functions.size(); i++)
+		{
+			auto exportName = GetFunctionExportName(i, m_functions.size());
+			sectionSize +=
+			    1 + static_cast<uint32>(exportName.size()) + //Name
+			    1 +                                          //Type
+			    GetULeb128Size(i);                           //Function index
+		}
 
-		stream.Write8(1); //Export vector size
+		WriteSectionHeader(stream, Wasm::SECTION_ID_EXPORT, sectionSize);
 
-		//Export 0
-		WriteName(stream, "codeGenFunc");
-		stream.Write8(Wasm::IMPORT_EXPORT_TYPE_FUNCTION);
-		stream.Write8(0); //Function index
+		WriteULeb128(stream, m_functions.size()); //Export vector size
+
+		for(uint32 i = 0; i < m_functions.size(); i++)
+		{
+			auto exportName = GetFunctionExportName(i, m_functions.size());
+			WriteName(stream, exportName.c_str());
+			stream.Write8(Wasm::IMPORT_EXPORT_TYPE_FUNCTION);
+			WriteULeb128(stream, i); //Function index
+		}
 	}
 
 	//Section "Code"
 	{
-		const auto& function = m_functions[0];
-
-		assert(function.localI32Count < 0x80);
-		assert(function.localI64Count < 0x80);
-		assert(function.localF32Count < 0x80);
-		assert(function.localV128Count < 0x80);
-
-		uint32 localDeclCount = 0;
-		if(function.localI32Count != 0) localDeclCount++;
-		if(function.localI64Count != 0) localDeclCount++;
-		if(function.localF32Count != 0) localDeclCount++;
-		if(function.localV128Count != 0) localDeclCount++;
-		uint32 localDeclSize = (localDeclCount * 2) + 1;
-		uint32 functionBodySize = function.code.size() + localDeclSize;
-
-		uint32 sectionSize =
-		    1 + //Vector size
-		    GetULeb128Size(functionBodySize) +
-		    functionBodySize;
+		uint32 sectionSize = GetULeb128Size(m_functions.size());
+		for(const auto& function : m_functions)
+		{
+			uint32 functionBodySize = GetFunctionBodySize(function);
+			sectionSize += GetULeb128Size(functionBodySize) + functionBodySize;
+		}
 
 		WriteSectionHeader(stream, Wasm::SECTION_ID_CODE, sectionSize);
 
-		stream.Write8(1); //Function vector size
+		WriteULeb128(stream, m_functions.size()); //Function vector size
 
-		//Function 0
-		WriteULeb128(stream, functionBodySize); //Function body size
-		WriteULeb128(stream, localDeclCount);   //Local declaration count
-		if(function.localI32Count != 0)
-		{
-			WriteULeb128(stream, function.localI32Count); //Local type count
-			stream.Write8(Wasm::TYPE_I32);
-		}
-		if(function.localI64Count != 0)
-		{
-			WriteULeb128(stream, function.localI64Count);
-			stream.Write8(Wasm::TYPE_I64);
-		}
-		if(function.localF32Count != 0)
-		{
-			WriteULeb128(stream, function.localF32Count);
-			stream.Write8(Wasm::TYPE_F32);
-		}
-		if(function.localV128Count != 0)
+		for(const auto& function : m_functions)
 		{
-			WriteULeb128(stream, function.localV128Count);
-			stream.Write8(Wasm::TYPE_V128);
-		}
+			WriteULeb128(stream, GetFunctionBodySize(function)); //Function body size
 
-		stream.Write(function.code.data(), function.code.size());
+			auto localDecls = GetLocalDecls(function);
+			WriteULeb128(stream, localDecls.size()); //Local declaration count
+			for(const auto& localDecl : localDecls)
+			{
+				WriteULeb128(stream, localDecl.first); //Local type count
+				stream.Write8(localDecl.second);
+			}
+
+			stream.Write(function.code.data(), function.code.size());
+		}
 	}
 }
 
@@ -1,4 +1,5 @@
 #include "X86Assembler.h"
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 #include "LiteralPool.h"
@@ -12,6 +13,8 @@ void CX86Assembler::Begin()
 	m_tmpStream.ResetBuffer();
 	m_labels.clear();
 	m_labelOrder.clear();
+	m_coldRegion = false;
+	m_regionRelocations.clear();
 }
 
 void CX86Assembler::End()
@@ -23,145 +26,168 @@ void CX86Assembler::End()
 		m_currentLabel->size = currentPos - m_currentLabel->start;
 	}
 
-	//Initialize
-	for(auto& labelPair : m_labels)
+	//Cold labels are laid out after all hot labels, as if both regions were contiguous
+	std::stable_partition(m_labelOrder.begin(), m_labelOrder.end(),
+	                      [this](LABEL labelId) { return !m_labels[labelId].isCold; });
+
+	//Flatten jumps in layout order. Jumps start short, except the ones going to the other region
+	//since the distance between regions is unknown.
+	std::vector<LABELREF*> jumps;
+	std::vector<uint32> labelFirstJumps;
+	labelFirstJumps.reserve(m_labelOrder.size());
+	for(const auto& labelId : m_labelOrder)
 	{
-		auto& label = labelPair.second;
-		label.projectedStart = label.start;
+		auto& label = m_labels[labelId];
+		labelFirstJumps.push_back(static_cast<uint32>(jumps.size()));
+		for(auto& labelRef : label.labelRefs)
+		{
+			bool crossesRegions = (m_labels[labelRef.label].isCold != label.isCold);
+			labelRef.length = crossesRegions ? JMP_FAR : JMP_NEAR;
+			jumps.push_back(&labelRef);
+		}
 	}
 
+	//Jumps only grow, each pass computes all positions in one sweep and lengthens the
+	//short jumps that went out of range until nothing changes anymore.
+	std::vector<uint32> jumpOffsets(jumps.size() + 1);
+	uint32 projectedSize = 0;
 	while(1)
 	{
-		bool changed = false;
+		jumpOffsets[0] = 0;
+		for(uint32 jumpIndex = 0; jumpIndex < jumps.size(); jumpIndex++)
+		{
+			const auto& labelRef = *jumps[jumpIndex];
+			jumpOffsets[jumpIndex + 1] = jumpOffsets[jumpIndex] + GetJumpSize(labelRef.type, labelRef.length);
+		}
 
-		for(LabelArray::const_iterator labelIterator(m_labelOrder.begin());
-		    labelIterator != m_labelOrder.end(); ++labelIterator)
+		uint32 baseStart = 0;
+		for(uint32 labelIndex = 0; labelIndex < m_labelOrder.size(); labelIndex++)
 		{
-			auto& label = m_labels[*labelIterator];
+			auto& label = m_labels[m_labelOrder[labelIndex]];
+			label.projectedStart = baseStart + jumpOffsets[labelFirstJumps[labelIndex]];
+			baseStart += label.size;
+		}
+		projectedSize = baseStart + jumpOffsets[jumps.size()];
 
-			for(LabelRefArray::iterator labelRefIterator(label.labelRefs.begin());
-			    labelRefIterator != label.labelRefs.end(); ++labelRefIterator)
+		bool changed = false;
+		for(uint32 labelIndex = 0; labelIndex < m_labelOrder.size(); labelIndex++)
+		{
+			auto& label = m_labels[m_labelOrder[labelIndex]];
+			uint32 jumpIndex = labelFirstJumps[labelIndex];
+			for(auto& labelRef : label.labelRefs)
 			{
-				auto& labelRef(*labelRefIterator);
-				switch(labelRef.length)
-				{
-				case JMP_NOTSET:
-				{
-					//Assume a short jump first.
-					unsigned int jumpSize = GetJumpSize(labelRef.type, JMP_NEAR);
-					labelRef.length = JMP_NEAR;
-					IncrementJumpOffsetsLocal(label, labelRefIterator + 1, jumpSize);
-					IncrementJumpOffsets(labelIterator + 1, jumpSize);
-					changed = true;
-				}
-				break;
-				case JMP_NEAR:
+				if(labelRef.length == JMP_NEAR)
 				{
-					//We need to verify if the jump is still good for us, since sizes might have changed
-					LABELINFO& referencedLabel(m_labels[labelRef.label]);
-					unsigned int smallJumpSize = GetJumpSize(labelRef.type, JMP_NEAR);
-					uint32 offset = referencedLabel.projectedStart - (labelRef.offset + smallJumpSize);
-					uint32 offsetSize = GetMinimumConstantSize(offset);
-					if(offsetSize != 1)
+					uint32 jumpStart = label.projectedStart + (labelRef.offset - label.start) +
+					                   (jumpOffsets[jumpIndex] - jumpOffsets[labelFirstJumps[labelIndex]]);
+					const auto& referencedLabel(m_labels[labelRef.label]);
+					uint32 offset = referencedLabel.projectedStart - (jumpStart + GetJumpSize(labelRef.type, JMP_NEAR));
+					if(GetMinimumConstantSize(offset) != 1)
 					{
-						//Doesn't fit, recompute offsets
 						labelRef.length = JMP_FAR;
-						unsigned int longJumpSize = GetJumpSize(labelRef.type, JMP_FAR);
-						unsigned int incrementAmount = longJumpSize - smallJumpSize;
-						IncrementJumpOffsetsLocal(label, labelRefIterator + 1, incrementAmount);
-						IncrementJumpOffsets(labelIterator + 1, incrementAmount);
 						changed = true;
 					}
 				}
-				break;
-				case JMP_FAR:
-					break;
-				default:
-					assert(false);
-					break;
-				}
+				jumpIndex++;
 			}
 		}
 
 		if(!changed) break;
 	}
 
+	auto firstColdLabelIterator = std::find_if(m_labelOrder.begin(), m_labelOrder.end(),
+	                                           [this](LABEL labelId) { return m_labels[labelId].isCold; });
+	uint32 coldRegionStart = (firstColdLabelIterator == m_labelOrder.end()) ? projectedSize : m_labels[*firstColdLabelIterator].projectedStart;
+
 	assert(m_outputStream != nullptr);
-	m_tmpStream.Seek(0, Framework::STREAM_SEEK_SET);
+	assert((firstColdLabelIterator == m_labelOrder.end()) || (m_coldStream != nullptr));
 
+	//Code is copied straight from the temporary buffer with jumps written in between
+	const uint8* tmpBuffer = m_tmpStream.GetBuffer();
 	for(const auto& labelId : m_labelOrder)
 	{
 		const auto& label = m_labels[labelId];
+		auto outputStream = label.isCold ? m_coldStream : m_outputStream;
+		uint32 regionStart = label.isCold ? coldRegionStart : 0;
 
-		unsigned int currentPos = label.start;
-		unsigned int currentProjectedPos = label.projectedStart;
-		unsigned int endPos = label.start + label.size;
+		uint32 currentPos = label.start;
+		uint32 currentProjectedPos = label.projectedStart;
+		uint32 endPos = label.start + label.size;
 
 		for(const auto& labelRef : label.labelRefs)
 		{
+			//Make sure any literal ref happens before a label ref
+			for(const auto& literalRefPair : label.literal128Refs)
+			{
+				FRAMEWORK_MAYBE_UNUSED const auto& literalRef = literalRefPair.second;
+				assert(literalRef.offset < labelRef.offset);
+			}
+
 			const auto& referencedLabel(m_labels[labelRef.label]);
 
-			unsigned int readSize = labelRef.offset - currentProjectedPos;
-			if(readSize != 0)
+			uint32 copySize = labelRef.offset - currentPos;
+			if(copySize != 0)
 			{
-				m_copyBuffer.resize(readSize);
-				m_tmpStream.Read(m_copyBuffer.data(), readSize);
-				m_outputStream->Write(m_copyBuffer.data(), readSize);
+				outputStream->Write(tmpBuffer + currentPos, copySize);
 			}
+			currentPos += copySize;
+			currentProjectedPos += copySize;
 
 			//Write our jump here.
 			unsigned int jumpSize = GetJumpSize(labelRef.type, labelRef.length);
-			uint32 distance = referencedLabel.projectedStart - (labelRef.offset + jumpSize);
-			WriteJump(m_outputStream, labelRef.type, labelRef.length, distance);
-
-			currentProjectedPos += readSize + jumpSize;
-			currentPos += readSize;
+			uint32 distance = referencedLabel.projectedStart - (currentProjectedPos + jumpSize);
+			if(referencedLabel.isCold != label.isCold)
+			{
+				static const uint32 displacementSize = 4;
+				assert(labelRef.length == JMP_FAR);
+				CODE_REGION_RELOCATION relocation;
+				relocation.type = CODE_REGION_RELOCATION_TYPE::REL32;
+				relocation.inColdRegion = label.isCold;
+				relocation.offset = currentProjectedPos + jumpSize - displacementSize - regionStart;
+				relocation.targetOffset = referencedLabel.projectedStart - (referencedLabel.isCold ? coldRegionStart : 0);
+				m_regionRelocations.push_back(relocation);
+				distance = 0;
+			}
+			WriteJump(outputStream, labelRef.type, labelRef.length, distance);
+			currentProjectedPos += jumpSize;
 		}
 
-		unsigned int lastCopySize = endPos - currentPos;
+		uint32 lastCopySize = endPos - currentPos;
 		if(lastCopySize != 0)
 		{
-			m_copyBuffer.resize(lastCopySize);
-			m_tmpStream.Read(m_copyBuffer.data(), lastCopySize);
-			m_outputStream->Write(m_copyBuffer.data(), lastCopySize);
+			outputStream->Write(tmpBuffer + currentPos, lastCopySize);
 		}
 	}
 
+	//Make cold label positions relative to the start of the cold region
+	for(auto labelIterator = firstColdLabelIterator; labelIterator != m_labelOrder.end(); ++labelIterator)
+	{
+		m_labels[*labelIterator].projectedStart -= coldRegionStart;
+	}
+
 	ResolveLiteralReferences();
 }
 
-void CX86Assembler::IncrementJumpOffsets(LabelArray::const_iterator startLabel, unsigned int amount)
+void CX86Assembler::SetStream(Framework::CStream* stream)
 {
-	for(LabelArray::const_iterator labelIterator(startLabel);
-	    labelIterator != m_labelOrder.end(); ++labelIterator)
-	{
-		LABELINFO& label = m_labels[*labelIterator];
-		label.projectedStart += amount;
-		IncrementJumpOffsetsLocal(label, label.labelRefs.begin(), amount);
-	}
+	m_outputStream = stream;
 }
 
-void CX86Assembler::IncrementJumpOffsetsLocal(LABELINFO& label, LabelRefArray::iterator startJump, unsigned int amount)
+void CX86Assembler::SetColdStream(Framework::CStream* stream)
 {
-	for(LabelRefArray::iterator labelRefIterator(startJump);
-	    labelRefIterator != label.labelRefs.end(); ++labelRefIterator)
-	{
-		auto& labelRef(*labelRefIterator);
-
-		//Make sure any literal ref happens before a label ref
-		for(const auto& literalRefPair : label.literal128Refs)
-		{
-			FRAMEWORK_MAYBE_UNUSED const auto& literalRef = literalRefPair.second;
-			assert(literalRef.offset < labelRef.offset);
-		}
+	m_coldStream = stream;
+}
 
-		labelRef.offset += amount;
-	}
+void CX86Assembler::SetColdRegion(bool coldRegion)
+{
+	//Applies to labels marked after this call
+	assert(!coldRegion || (m_coldStream != nullptr));
+	m_coldRegion = coldRegion;
 }
 
-void CX86Assembler::SetStream(Framework::CStream* stream)
+const CodeRegionRelocationArray& CX86Assembler::GetRegionRelocations() const
 {
-	m_outputStream = stream;
+	return m_regionRelocations;
 }
 
 CX86Assembler::CAddress CX86Assembler::MakeRegisterAddress(REGISTER nRegister)
@@ -370,6 +396,7 @@ void CX86Assembler::MarkLabel(LABEL label, int32 offset)
 	assert(labelIterator != m_labels.end());
 	auto& labelInfo(labelIterator->second);
 	labelInfo.start = currentPos;
+	labelInfo.isCold = m_coldRegion;
 	m_currentLabel = &labelInfo;
 	m_labelOrder.push_back(label);
 }
@@ -394,27 +421,36 @@ CX86Assembler::LITERAL128ID CX86Assembler::CreateLiteral128(const LITERAL128& li
 
 void CX86Assembler::ResolveLiteralReferences()
 {
-	CLiteralPool literalPool(m_outputStream);
+	ResolveRegionLiteralReferences(m_outputStream, false);
+	if(m_coldStream != nullptr)
+	{
+		ResolveRegionLiteralReferences(m_coldStream, true);
+	}
+}
+
+void CX86Assembler::ResolveRegionLiteralReferences(Framework::CStream* stream, bool isCold)
+{
+	//Each region gets its own pool, literals need to be reachable with a 32-bit displacement
+	CLiteralPool literalPool(stream);
 	literalPool.AlignPool();
 
 	for(const auto& labelId : m_labelOrder)
 	{
 		const auto& label = m_labels[labelId];
-		assert(label.projectedStart >= label.start);
-		uint32 projectedDiff = label.projectedStart - label.start;
+		if(label.isCold != isCold) continue;
 		for(const auto& literalRefPair : label.literal128Refs)
 		{
 			const auto& literal = literalRefPair.second;
 			auto literalPos = static_cast<uint32>(literalPool.GetLiteralPosition(literal.value));
-			uint32 projectedOffset = literal.offset + projectedDiff;
-			m_outputStream->Seek(projectedOffset, Framework::STREAM_SEEK_SET);
+			uint32 projectedOffset = literal.offset - label.start + label.projectedStart;
+			stream->Seek(projectedOffset, Framework::STREAM_SEEK_SET);
 			static const uint32 opcodeSize = 4;
 			auto offset = literalPos - projectedOffset - opcodeSize;
-			m_outputStream->Write32(offset);
+			stream->Write32(offset);
 		}
 	}
 
-	m_outputStream->Seek(0, Framework::STREAM_SEEK_END);
+	stream->Seek(0, Framework::STREAM_SEEK_END);
 }
 
 void CX86Assembler::AdcEd(REGISTER registerId, const CAddress& address)
@@ -478,6 +514,22 @@ void CX86Assembler::BsrEd(REGISTER registerId, const CAddress& address)
 	WriteEvGvOp0F(0xBD, false, address, registerId);
 }
 
+void CX86Assembler::BswapEd(REGISTER registerId)
+{
+	CAddress address(MakeRegisterAddress(registerId));
+	WriteRexByte(false, address);
+	WriteByte(0x0F);
+	WriteByte(0xC8 | address.ModRm.nRM);
+}
+
+void CX86Assembler::BswapEq(REGISTER registerId)
+{
+	CAddress address(MakeRegisterAddress(registerId));
+	WriteRexByte(true, address);
+	WriteByte(0x0F);
+	WriteByte(0xC8 | address.ModRm.nRM);
+}
+
 void CX86Assembler::CallEd(const CAddress& address)
 {
 	WriteEvOp(0xFF, 0x02, false, address);
@@ -620,6 +672,11 @@ void CX86Assembler::JnsJx(LABEL label)
 	CreateLabelReference(label, JMP_NS);
 }
 
+void CX86Assembler::JoJx(LABEL label)
+{
+	CreateLabelReference(label, JMP_O);
+}
+
 void CX86Assembler::LeaGd(REGISTER registerId, const CAddress& address)
 {
 	WriteEvGvOp(0x8D, false, address, registerId);
@@ -740,6 +797,38 @@ void CX86Assembler::MovIq(const CX86Assembler::CAddress& address, uint32 constan
 	WriteDWord(constant);
 }
 
+void CX86Assembler::MovbeEw(REGISTER registerId, const CAddress& address)
+{
+	WriteByte(0x66);
+	WriteEvGvOp0F38(0xF0, false, address, registerId);
+}
+
+void CX86Assembler::MovbeEd(REGISTER registerId, const CAddress& address)
+{
+	WriteEvGvOp0F38(0xF0, false, address, registerId);
+}
+
+void CX86Assembler::MovbeEq(REGISTER registerId, const CAddress& address)
+{
+	WriteEvGvOp0F38(0xF0, true, address, registerId);
+}
+
+void CX86Assembler::MovbeGw(const CAddress& address, REGISTER registerId)
+{
+	WriteByte(0x66);
+	WriteEvGvOp0F38(0xF1, false, address, registerId);
+}
+
+void CX86Assembler::MovbeGd(const CAddress& address, REGISTER registerId)
+{
+	WriteEvGvOp0F38(0xF1, false, address, registerId);
+}
+
+void CX86Assembler::MovbeGq(const CAddress& address, REGISTER registerId)
+{
+	WriteEvGvOp0F38(0xF1, true, address, registerId);
+}
+
 void CX86Assembler::MovsxEb(REGISTER registerId, const CAddress& address)
 {
 	WriteEbGvOp0F(0xBE, false, address, registerId);
@@ -827,6 +916,13 @@ void CX86Assembler::RepMovsb()
 	WriteByte(0xA4);
 }
 
+void CX86Assembler::RolEw(const CAddress& address, uint8 amount)
+{
+	WriteByte(0x66);
+	WriteEvOp(0xC1, 0x00, false, address);
+	WriteByte(amount);
+}
+
 void CX86Assembler::Ret()
 {
 	WriteByte(0xC3);
@@ -871,7 +967,7 @@ void CX86Assembler::SetaEb(const CAddress& address)
 
 void CX86Assembler::SetaeEb(const CAddress& address)
 {
-	throw std::exception();
+	WriteEbOp_0F(0x93, 0x00, address);
 }
 
 void CX86Assembler::SetbEb(const CAddress& address)
@@ -909,6 +1005,16 @@ void CX86Assembler::SetgEb(const CAddress& address)
 	WriteEbOp_0F(0x9F, 0x00, address);
 }
 
+void CX86Assembler::SetgeEb(const CAddress& address)
+{
+	WriteEbOp_0F(0x9D, 0x00, address);
+}
+
+void CX86Assembler::SetoEb(const CAddress& address)
+{
+	WriteEbOp_0F(0x90, 0x00, address);
+}
+
 void CX86Assembler::ShlEd(const CAddress& address)
 {
 	WriteEvOp(0xD3, 0x04, false, address);
@@ -1129,6 +1235,17 @@ void CX86Assembler::WriteEvGvOp0F(uint8 nOp, bool nIs64, const CAddress& Address
 	NewAddress.Write(&m_tmpStream);
 }
 
+void CX86Assembler::WriteEvGvOp0F38(uint8 op, bool is64, const CAddress& address, REGISTER registerId)
+{
+	WriteRexByte(is64, address, registerId);
+	WriteByte(0x0F);
+	WriteByte(0x38);
+	CAddress newAddress(address);
+	newAddress.ModRm.nFnReg = registerId;
+	WriteByte(op);
+	newAddress.Write(&m_tmpStream);
+}
+
 void CX86Assembler::WriteEvIb(uint8 op, const CAddress& address, uint8 constant)
 {
 	WriteRexByte(false, address);
@@ -33,6 +33,7 @@ CX86CpuFeatures CX86CpuFeatures::AutoDetect()
 #ifdef HAS_CPUID
 	static const uint32 CPUID_FLAG_SSSE3 = 0x000200;
 	static const uint32 CPUID_FLAG_SSE41 = 0x080000;
+	static const uint32 CPUID_FLAG_MOVBE = 0x400000;
 	static const uint32 CPUID_FLAG_AVX = 0x10000000;
 	static const uint32 CPUID_FLAG_AVX2 = 0x20;
 
@@ -54,6 +55,7 @@ CX86CpuFeatures CX86CpuFeatures::AutoDetect()
 	features.hasSse41 = (cpuInfo1[2] & CPUID_FLAG_SSE41) != 0;
 	features.hasAvx = (cpuInfo1[2] & CPUID_FLAG_AVX) != 0;
 	features.hasAvx2 = (cpuInfo7[1] & CPUID_FLAG_AVX2) != 0;
+	features.hasMovbe = (cpuInfo1[2] & CPUID_FLAG_MOVBE) != 0;
 
 #endif //HAS_CPUID
 
@@ -0,0 +1,108 @@
+#include "AArch64ConstantTest.h"
+#include "MemStream.h"
+#include "maybe_unused.h"
+#include "Jitter_CodeGen_AArch64.h"
+
+#define CONSTANT_CACHED (0x12345678)
+#define CONSTANT_BITMASK32 (0x00FF00FF)
+#define CONSTANT_BITMASK64 (0x5555555555555555ULL)
+#define CONSTANT_MOVN64 (0xFFFFFFFF1234FFFFULL)
+#define CONSTANT_LITERAL64 (0x123456789ABCDEF0ULL)
+
+void CAArch64ConstantTest::Compile(FRAMEWORK_MAYBE_UNUSED Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+
+	Jitter::CJitter constantJitter(new Jitter::CCodeGen_AArch64());
+	constantJitter.SetStream(&codeStream);
+
+	constantJitter.Begin();
+	{
+		//Needs movz+movk, next ones can be derived from the register holding it
+		constantJitter.PushRel(offsetof(CONTEXT, value32[0]));
+		constantJitter.PushCst(CONSTANT_CACHED);
+		constantJitter.Add();
+		constantJitter.PullRel(offsetof(CONTEXT, value32[1]));
+
+		constantJitter.PushRel(offsetof(CONTEXT, value32[2]));
+		constantJitter.PushCst(CONSTANT_CACHED + 1);
+		constantJitter.Add();
+		constantJitter.PullRel(offsetof(CONTEXT, value32[3]));
+
+		constantJitter.PushRel(offsetof(CONTEXT, value32[4]));
+		constantJitter.PushCst(CONSTANT_CACHED);
+		constantJitter.Add();
+		constantJitter.PullRel(offsetof(CONTEXT, value32[5]));
+
+		constantJitter.PushCst(CONSTANT_BITMASK32);
+		constantJitter.PullRel(offsetof(CONTEXT, bitmask32));
+
+		constantJitter.PushCst64(CONSTANT_BITMASK64);
+		constantJitter.PullRel64(offsetof(CONTEXT, bitmask64));
+
+		constantJitter.PushCst64(CONSTANT_MOVN64);
+		constantJitter.PullRel64(offsetof(CONTEXT, movn64));
+
+		constantJitter.PushCst64(CONSTANT_LITERAL64);
+		constantJitter.PullRel64(offsetof(CONTEXT, literal64));
+	}
+	constantJitter.End();
+
+	auto code = codeStream.GetBuffer();
+	m_code.assign(code, code + codeStream.GetSize());
+}
+
+void CAArch64ConstantTest::Run()
+{
+	//Cached constant is loaded once, the others are derived from it
+	TEST_VERIFY(CountInstructions(0xFFFFFFE0, 0x72A00000 | ((CONSTANT_CACHED >> 16) << 5)) == 1);
+	TEST_VERIFY(CountInstructions(0xFFFFFC00, 0x11000400) == 1);
+	TEST_VERIFY(CountInstructions(0xFFE0FFE0, 0x2A0003E0) == 1);
+
+	//ORR wd, wzr, #imm
+	TEST_VERIFY(CountInstructions(0xFF8003E0, 0x320003E0) == 1);
+
+	//ORR xd, xzr, #imm
+	TEST_VERIFY(CountInstructions(0xFF8003E0, 0xB20003E0) == 1);
+
+	//MOVN xd, #~0x1234, LSL #16, other halfwords are all ones
+	TEST_VERIFY(CountInstructions(0xFFFFFFE0, 0x92A00000 | (static_cast<uint16>(~0x1234) << 5)) == 1);
+	TEST_VERIFY(CountInstructions(0xFF800000, 0xF2800000) == 0);
+
+	//LDR xd, literal, pool entry only takes 8 bytes
+	uint32 literalLoad = FindInstruction(0xFF000000, 0x58000000);
+	uint32 literalOffset = literalLoad + (((ReadInstruction(literalLoad) >> 5) & 0x7FFFF) * 4);
+	TEST_VERIFY((literalOffset & 0x07) == 0);
+	TEST_VERIFY((literalOffset + 8) == m_code.size());
+	uint64 literal = 0;
+	memcpy(&literal, m_code.data() + literalOffset, 8);
+	TEST_VERIFY(literal == CONSTANT_LITERAL64);
+}
+
+uint32 CAArch64ConstantTest::ReadInstruction(uint32 offset) const
+{
+	TEST_VERIFY((offset + 4) <= m_code.size());
+	uint32 opcode = 0;
+	memcpy(&opcode, m_code.data() + offset, 4);
+	return opcode;
+}
+
+unsigned int CAArch64ConstantTest::CountInstructions(uint32 mask, uint32 value) const
+{
+	unsigned int count = 0;
+	for(uint32 offset = 0; (offset + 4) <= m_code.size(); offset += 4)
+	{
+		if((ReadInstruction(offset) & mask) == value) count++;
+	}
+	return count;
+}
+
+uint32 CAArch64ConstantTest::FindInstruction(uint32 mask, uint32 value) const
+{
+	for(uint32 offset = 0; (offset + 4) <= m_code.size(); offset += 4)
+	{
+		if((ReadInstruction(offset) & mask) == value) return offset;
+	}
+	TEST_VERIFY(false);
+	return 0;
+}
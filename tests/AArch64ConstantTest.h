@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+#include "Test.h"
+
+//Checks the instructions picked by the AArch64 code generator to
+//materialize constants. Only generates code, can run on any host.
+class CAArch64ConstantTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	struct CONTEXT
+	{
+		uint32 value32[6];
+		uint32 bitmask32;
+		uint64 bitmask64;
+		uint64 movn64;
+		uint64 literal64;
+	};
+
+	uint32 ReadInstruction(uint32) const;
+	unsigned int CountInstructions(uint32, uint32) const;
+	uint32 FindInstruction(uint32, uint32) const;
+
+	std::vector<uint8> m_code;
+};
@@ -0,0 +1,198 @@
+#include "AArch64IslandTest.h"
+#include "MemStream.h"
+#include "maybe_unused.h"
+
+static const LITERAL128 g_firstLiteral(0x01234567, 0x89ABCDEF, 0xFEDCBA98, 0x76543210);
+static const LITERAL128 g_secondLiteral(0x55555555, 0xAAAAAAAA, 0x33333333, 0xCCCCCCCC);
+
+void CAArch64IslandTest::Compile(FRAMEWORK_MAYBE_UNUSED Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+
+	CAArch64Assembler assembler;
+	assembler.SetStream(&codeStream);
+
+	auto firstLabel = assembler.CreateLabel();
+	auto secondLabel = assembler.CreateLabel();
+	auto backwardLabel = assembler.CreateLabel();
+
+	m_backwardTarget = static_cast<uint32>(codeStream.Tell());
+	assembler.MarkLabel(backwardLabel);
+	assembler.Add(CAArch64Assembler::w0, CAArch64Assembler::w0, CAArch64Assembler::w1);
+
+	EmitReferences(assembler, codeStream, m_firstReferences, firstLabel, g_firstLiteral);
+
+	//Island will be emitted after one of the unconditional branches
+	EmitFiller(assembler, codeStream, 0x100000, true);
+
+	EmitReferences(assembler, codeStream, m_secondReferences, secondLabel, g_secondLiteral);
+
+	m_backwardCondBranch = static_cast<uint32>(codeStream.Tell());
+	assembler.BCc(CAArch64Assembler::CONDITION_GE, backwardLabel);
+	m_backwardCbzBranch = static_cast<uint32>(codeStream.Tell());
+	assembler.Cbz(CAArch64Assembler::w2, backwardLabel);
+
+	//Island needs to be emitted in straight line code with a branch over it
+	EmitFiller(assembler, codeStream, 0x100000, false);
+
+	m_firstTarget = static_cast<uint32>(codeStream.Tell());
+	assembler.MarkLabel(firstLabel);
+	assembler.Add(CAArch64Assembler::w0, CAArch64Assembler::w0, CAArch64Assembler::w1);
+
+	m_secondTarget = static_cast<uint32>(codeStream.Tell());
+	assembler.MarkLabel(secondLabel);
+	assembler.Add(CAArch64Assembler::w0, CAArch64Assembler::w0, CAArch64Assembler::w1);
+
+	//Uses the pool at the end of the function
+	m_finalLiteralLoad = static_cast<uint32>(codeStream.Tell());
+	assembler.Ldr_Pc(CAArch64Assembler::v2, g_firstLiteral);
+
+	assembler.Ret();
+
+	assembler.ResolveLabelReferences();
+	assembler.ResolveLiteralReferences();
+
+	auto code = codeStream.GetBuffer();
+	m_code.assign(code, code + codeStream.GetSize());
+}
+
+void CAArch64IslandTest::Run()
+{
+	TEST_VERIFY(m_code.size() > 0x200000);
+
+	CheckReferences(m_firstReferences, m_firstTarget, g_firstLiteral);
+	CheckReferences(m_secondReferences, m_secondTarget, g_secondLiteral);
+
+	//Backward branches that are out of range skip over an unconditional branch
+	{
+		uint32 opcode = ReadInstruction(m_backwardCondBranch);
+		TEST_VERIFY((opcode & 0xFF000010) == 0x54000000);
+		TEST_VERIFY((opcode & 0x0F) == CAArch64Assembler::CONDITION_LT);
+		TEST_VERIFY(GetBranchTarget(m_backwardCondBranch) == (m_backwardCondBranch + 8));
+		TEST_VERIFY((ReadInstruction(m_backwardCondBranch + 4) & 0xFC000000) == 0x14000000);
+		TEST_VERIFY(GetBranchTarget(m_backwardCondBranch + 4) == m_backwardTarget);
+	}
+
+	{
+		uint32 opcode = ReadInstruction(m_backwardCbzBranch);
+		TEST_VERIFY((opcode & 0xFF00001F) == (0x35000000 | CAArch64Assembler::w2));
+		TEST_VERIFY(GetBranchTarget(m_backwardCbzBranch) == (m_backwardCbzBranch + 8));
+		TEST_VERIFY((ReadInstruction(m_backwardCbzBranch + 4) & 0xFC000000) == 0x14000000);
+		TEST_VERIFY(GetBranchTarget(m_backwardCbzBranch + 4) == m_backwardTarget);
+	}
+
+	CheckLiteralLoad(m_finalLiteralLoad, CAArch64Assembler::v2, g_firstLiteral);
+}
+
+void CAArch64IslandTest::EmitReferences(CAArch64Assembler& assembler, Framework::CStream& stream, REFERENCES& references, CAArch64Assembler::LABEL label, const LITERAL128& literal)
+{
+	references.condBranch = static_cast<uint32>(stream.Tell());
+	assembler.BCc(CAArch64Assembler::CONDITION_NE, label);
+
+	references.cbzBranch = static_cast<uint32>(stream.Tell());
+	assembler.Cbz(CAArch64Assembler::w3, label);
+
+	references.cbnzBranch = static_cast<uint32>(stream.Tell());
+	assembler.Cbnz(CAArch64Assembler::x4, label);
+
+	references.literalLoad = static_cast<uint32>(stream.Tell());
+	assembler.Ldr_Pc(CAArch64Assembler::v1, literal);
+}
+
+void CAArch64IslandTest::EmitFiller(CAArch64Assembler& assembler, Framework::CStream& stream, uint32 size, bool hasBranches)
+{
+	//Code generator checks for islands at each statement boundary, do the same here
+	static const uint32 branchInterval = 0x4000;
+	uint32 startPos = static_cast<uint32>(stream.Tell());
+	uint32 nextBranchPos = startPos + branchInterval;
+	while(true)
+	{
+		uint32 currentPos = static_cast<uint32>(stream.Tell());
+		if((currentPos - startPos) >= size) break;
+		if(hasBranches && (currentPos >= nextBranchPos))
+		{
+			auto nextLabel = assembler.CreateLabel();
+			assembler.B(nextLabel);
+			assembler.EmitIslandIfNeeded();
+			assembler.MarkLabel(nextLabel);
+			nextBranchPos = currentPos + branchInterval;
+		}
+		assembler.EmitIslandIfNeeded();
+		assembler.Add(CAArch64Assembler::w0, CAArch64Assembler::w0, CAArch64Assembler::w1);
+	}
+}
+
+uint32 CAArch64IslandTest::ReadInstruction(uint32 offset) const
+{
+	TEST_VERIFY((offset + 4) <= m_code.size());
+	uint32 opcode = 0;
+	memcpy(&opcode, m_code.data() + offset, 4);
+	return opcode;
+}
+
+uint32 CAArch64IslandTest::GetBranchTarget(uint32 offset) const
+{
+	uint32 opcode = ReadInstruction(offset);
+	int32 displacement = 0;
+	if((opcode & 0xFC000000) == 0x14000000)
+	{
+		//B
+		displacement = static_cast<int32>(opcode << 6) >> 6;
+	}
+	else if(((opcode & 0xFF000010) == 0x54000000) || ((opcode & 0x7E000000) == 0x34000000))
+	{
+		//B.cond, CBZ, CBNZ
+		displacement = static_cast<int32>((opcode >> 5) << 13) >> 13;
+	}
+	else
+	{
+		TEST_VERIFY(false);
+	}
+	return offset + static_cast<uint32>(displacement * 4);
+}
+
+uint32 CAArch64IslandTest::FollowVeneer(uint32 offset) const
+{
+	if((ReadInstruction(offset) & 0xFC000000) != 0x14000000) return offset;
+	return GetBranchTarget(offset);
+}
+
+void CAArch64IslandTest::CheckReferences(const REFERENCES& references, uint32 target, const LITERAL128& literal) const
+{
+	TEST_VERIFY((target - references.condBranch) > 0x100000);
+
+	uint32 condOpcode = ReadInstruction(references.condBranch);
+	TEST_VERIFY((condOpcode & 0xFF000010) == 0x54000000);
+	TEST_VERIFY((condOpcode & 0x0F) == CAArch64Assembler::CONDITION_NE);
+
+	uint32 cbzOpcode = ReadInstruction(references.cbzBranch);
+	TEST_VERIFY((cbzOpcode & 0xFF00001F) == (0x34000000 | CAArch64Assembler::w3));
+
+	uint32 cbnzOpcode = ReadInstruction(references.cbnzBranch);
+	TEST_VERIFY((cbnzOpcode & 0xFF00001F) == (0xB5000000 | CAArch64Assembler::x4));
+
+	//Targets are too far, branches go through veneers
+	for(auto branch : {references.condBranch, references.cbzBranch, references.cbnzBranch})
+	{
+		uint32 veneer = GetBranchTarget(branch);
+		TEST_VERIFY(veneer > branch);
+		TEST_VERIFY(veneer < target);
+		TEST_VERIFY(FollowVeneer(veneer) == target);
+	}
+
+	CheckLiteralLoad(references.literalLoad, CAArch64Assembler::v1, literal);
+}
+
+void CAArch64IslandTest::CheckLiteralLoad(uint32 offset, uint32 rt, const LITERAL128& literal) const
+{
+	//LDR (literal, 128-bit SIMD)
+	uint32 opcode = ReadInstruction(offset);
+	TEST_VERIFY((opcode & 0xFF00001F) == (0x9C000000 | rt));
+	uint32 literalOffset = offset + (((opcode >> 5) & 0x7FFFF) * 4);
+	TEST_VERIFY((literalOffset & 0x0F) == 0);
+	TEST_VERIFY((literalOffset + 0x10) <= m_code.size());
+	uint64 value[2];
+	memcpy(value, m_code.data() + literalOffset, 0x10);
+	TEST_VERIFY(value[0] == literal.lo);
+	TEST_VERIFY(value[1] == literal.hi);
+}
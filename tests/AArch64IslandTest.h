@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include "Test.h"
+#include "AArch64Assembler.h"
+
+//Assembles AArch64 code larger than the +/-1MB reach of conditional branches
+//and literal loads, then decodes it to check that every reference lands on its
+//target, directly or through a veneer. Only assembles, can run on any host.
+class CAArch64IslandTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	struct REFERENCES
+	{
+		uint32 condBranch = 0;
+		uint32 cbzBranch = 0;
+		uint32 cbnzBranch = 0;
+		uint32 literalLoad = 0;
+	};
+
+	void EmitReferences(CAArch64Assembler&, Framework::CStream&, REFERENCES&, CAArch64Assembler::LABEL, const LITERAL128&);
+	void EmitFiller(CAArch64Assembler&, Framework::CStream&, uint32, bool);
+
+	uint32 ReadInstruction(uint32) const;
+	uint32 GetBranchTarget(uint32) const;
+	uint32 FollowVeneer(uint32) const;
+	void CheckReferences(const REFERENCES&, uint32, const LITERAL128&) const;
+	void CheckLiteralLoad(uint32, uint32, const LITERAL128&) const;
+
+	std::vector<uint8> m_code;
+
+	REFERENCES m_firstReferences;
+	REFERENCES m_secondReferences;
+	uint32 m_firstTarget = 0;
+	uint32 m_secondTarget = 0;
+	uint32 m_backwardTarget = 0;
+	uint32 m_backwardCondBranch = 0;
+	uint32 m_backwardCbzBranch = 0;
+	uint32 m_finalLiteralLoad = 0;
+};
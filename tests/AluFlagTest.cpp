@@ -0,0 +1,268 @@
+#include "AluFlagTest.h"
+#include "MemStream.h"
+
+enum FLAG_OPERATION
+{
+	FLAG_OPERATION_ADDOVF,
+	FLAG_OPERATION_ADDCARRY,
+	FLAG_OPERATION_ADC,
+	FLAG_OPERATION_SUBOVF,
+	FLAG_OPERATION_SUBBORROW,
+};
+
+struct FLAG_TEST_CASE
+{
+	FLAG_OPERATION operation;
+	uint32 src1;
+	uint32 src2;
+	uint32 carryIn;
+};
+
+// clang-format off
+static const FLAG_TEST_CASE g_testCases[] =
+{
+	{ FLAG_OPERATION_ADDOVF,    0x7FFFFFFF, 0x00000001, 0 },
+	{ FLAG_OPERATION_ADDOVF,    0xFFFFFFFF, 0x00000001, 0 },
+	{ FLAG_OPERATION_ADDOVF,    0x80000000, 0x80000000, 0 },
+	{ FLAG_OPERATION_ADDOVF,    0x00000005, 0x00000007, 0 },
+
+	{ FLAG_OPERATION_ADDCARRY,  0xFFFFFFFF, 0x00000001, 0 },
+	{ FLAG_OPERATION_ADDCARRY,  0x7FFFFFFF, 0x00000001, 0 },
+	{ FLAG_OPERATION_ADDCARRY,  0x80000000, 0x80000000, 0 },
+	{ FLAG_OPERATION_ADDCARRY,  0x12345678, 0x00001000, 0 },
+
+	{ FLAG_OPERATION_ADC,       0xFFFFFFFF, 0x00000000, 1 },
+	{ FLAG_OPERATION_ADC,       0xFFFFFFFE, 0x00000001, 0 },
+	{ FLAG_OPERATION_ADC,       0x80000000, 0x7FFFFFFF, 1 },
+	{ FLAG_OPERATION_ADC,       0x00000001, 0x00000002, 5 },
+	{ FLAG_OPERATION_ADC,       0xFFFFFFFF, 0xFFFFFFFF, 1 },
+
+	{ FLAG_OPERATION_SUBOVF,    0x80000000, 0x00000001, 0 },
+	{ FLAG_OPERATION_SUBOVF,    0x7FFFFFFF, 0xFFFFFFFF, 0 },
+	{ FLAG_OPERATION_SUBOVF,    0x00000005, 0x00000007, 0 },
+	{ FLAG_OPERATION_SUBOVF,    0xFFFFFFFF, 0x7FFFFFFF, 0 },
+
+	{ FLAG_OPERATION_SUBBORROW, 0x00000005, 0x00000007, 0 },
+	{ FLAG_OPERATION_SUBBORROW, 0x00000007, 0x00000005, 0 },
+	{ FLAG_OPERATION_SUBBORROW, 0x00000000, 0x00000000, 0 },
+	{ FLAG_OPERATION_SUBBORROW, 0x00000000, 0xFFFFFFFF, 0 },
+};
+// clang-format on
+
+static const size_t g_testCaseCount = sizeof(g_testCases) / sizeof(g_testCases[0]);
+
+static void ComputeExpected(const FLAG_TEST_CASE& testCase, uint32& value, uint32& flag)
+{
+	int64 signedSrc1 = static_cast<int32>(testCase.src1);
+	int64 signedSrc2 = static_cast<int32>(testCase.src2);
+	uint64 unsignedSrc1 = testCase.src1;
+	uint64 unsignedSrc2 = testCase.src2;
+	switch(testCase.operation)
+	{
+	case FLAG_OPERATION_ADDOVF:
+	{
+		int64 result = signedSrc1 + signedSrc2;
+		value = static_cast<uint32>(result);
+		flag = (result != static_cast<int32>(result)) ? 1 : 0;
+	}
+	break;
+	case FLAG_OPERATION_ADDCARRY:
+	{
+		uint64 result = unsignedSrc1 + unsignedSrc2;
+		value = static_cast<uint32>(result);
+		flag = static_cast<uint32>(result >> 32);
+	}
+	break;
+	case FLAG_OPERATION_ADC:
+	{
+		uint64 result = unsignedSrc1 + unsignedSrc2 + ((testCase.carryIn != 0) ? 1 : 0);
+		value = static_cast<uint32>(result);
+		flag = static_cast<uint32>(result >> 32);
+	}
+	break;
+	case FLAG_OPERATION_SUBOVF:
+	{
+		int64 result = signedSrc1 - signedSrc2;
+		value = static_cast<uint32>(result);
+		flag = (result != static_cast<int32>(result)) ? 1 : 0;
+	}
+	break;
+	case FLAG_OPERATION_SUBBORROW:
+		value = testCase.src1 - testCase.src2;
+		flag = (testCase.src1 < testCase.src2) ? 1 : 0;
+		break;
+	default:
+		assert(false);
+		break;
+	}
+}
+
+static void EmitOperation(Jitter::CJitter& jitter, FLAG_OPERATION operation)
+{
+	switch(operation)
+	{
+	case FLAG_OPERATION_ADDOVF:
+		jitter.AddOvf();
+		break;
+	case FLAG_OPERATION_ADDCARRY:
+		jitter.AddCarry();
+		break;
+	case FLAG_OPERATION_ADC:
+		jitter.Adc();
+		break;
+	case FLAG_OPERATION_SUBOVF:
+		jitter.SubOvf();
+		break;
+	case FLAG_OPERATION_SUBBORROW:
+		jitter.SubBorrow();
+		break;
+	default:
+		assert(false);
+		break;
+	}
+}
+
+static void PullResult(Jitter::CJitter& jitter, size_t valueOffset, size_t flagOffset)
+{
+	jitter.PushTop();
+
+	jitter.ExtLow64();
+	jitter.PullRel(valueOffset);
+
+	jitter.ExtHigh64();
+	jitter.PullRel(flagOffset);
+}
+
+void CAluFlagTest::Run()
+{
+	memset(&m_context, 0, sizeof(m_context));
+
+	for(size_t i = 0; i < g_testCaseCount; i++)
+	{
+		const auto& testCase = g_testCases[i];
+		m_context.src1[i] = testCase.src1;
+		m_context.src2[i] = testCase.src2;
+		m_context.carryIn[i] = testCase.carryIn;
+	}
+
+	m_function(&m_context);
+
+	for(size_t i = 0; i < g_testCaseCount; i++)
+	{
+		uint32 value = 0, flag = 0;
+		ComputeExpected(g_testCases[i], value, flag);
+
+		TEST_VERIFY(m_context.relRelResult[i].value == value);
+		TEST_VERIFY(m_context.relRelResult[i].flag == flag);
+		TEST_VERIFY(m_context.relCstResult[i].value == value);
+		TEST_VERIFY(m_context.relCstResult[i].flag == flag);
+		TEST_VERIFY(m_context.cstCstResult[i].value == value);
+		TEST_VERIFY(m_context.cstCstResult[i].flag == flag);
+		TEST_VERIFY(m_context.branchSetResult[i].value == value);
+		TEST_VERIFY(m_context.branchSetResult[i].flag == flag);
+		TEST_VERIFY(m_context.branchClearResult[i] == (flag ^ 1));
+		TEST_VERIFY(m_context.branchClobberResult[i].value == (g_testCases[i].src1 + g_testCases[i].src2));
+		TEST_VERIFY(m_context.branchClobberResult[i].flag == flag);
+	}
+}
+
+void CAluFlagTest::Compile(Jitter::CJitter& jitter)
+{
+	static_assert(g_testCaseCount <= MAX_CASES, "Too many test cases.");
+
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		for(size_t i = 0; i < g_testCaseCount; i++)
+		{
+			const auto& testCase = g_testCases[i];
+			bool hasCarryIn = (testCase.operation == FLAG_OPERATION_ADC);
+
+			auto emitRelRelOperation =
+			    [&]() {
+				    jitter.PushRel(offsetof(CONTEXT, src1) + (i * sizeof(uint32)));
+				    jitter.PushRel(offsetof(CONTEXT, src2) + (i * sizeof(uint32)));
+				    if(hasCarryIn)
+				    {
+					    jitter.PushRel(offsetof(CONTEXT, carryIn) + (i * sizeof(uint32)));
+				    }
+				    EmitOperation(jitter, testCase.operation);
+			    };
+
+			//Rel, Rel
+			emitRelRelOperation();
+			PullResult(jitter,
+			           offsetof(CONTEXT, relRelResult) + (i * sizeof(RESULT)) + offsetof(RESULT, value),
+			           offsetof(CONTEXT, relRelResult) + (i * sizeof(RESULT)) + offsetof(RESULT, flag));
+
+			//Rel, Cst
+			jitter.PushRel(offsetof(CONTEXT, src1) + (i * sizeof(uint32)));
+			jitter.PushCst(testCase.src2);
+			if(hasCarryIn)
+			{
+				jitter.PushCst(testCase.carryIn);
+			}
+			EmitOperation(jitter, testCase.operation);
+			PullResult(jitter,
+			           offsetof(CONTEXT, relCstResult) + (i * sizeof(RESULT)) + offsetof(RESULT, value),
+			           offsetof(CONTEXT, relCstResult) + (i * sizeof(RESULT)) + offsetof(RESULT, flag));
+
+			//Cst, Cst
+			jitter.PushCst(testCase.src1);
+			jitter.PushCst(testCase.src2);
+			if(hasCarryIn)
+			{
+				jitter.PushCst(testCase.carryIn);
+			}
+			EmitOperation(jitter, testCase.operation);
+			PullResult(jitter,
+			           offsetof(CONTEXT, cstCstResult) + (i * sizeof(RESULT)) + offsetof(RESULT, value),
+			           offsetof(CONTEXT, cstCstResult) + (i * sizeof(RESULT)) + offsetof(RESULT, flag));
+
+			//Branch taken when flag is set, with the result's low part stored in between
+			emitRelRelOperation();
+			jitter.PushTop();
+			jitter.ExtLow64();
+			jitter.PullRel(offsetof(CONTEXT, branchSetResult) + (i * sizeof(RESULT)) + offsetof(RESULT, value));
+			jitter.ExtHigh64();
+			jitter.PushCst(0);
+			jitter.BeginIf(Jitter::CONDITION_NE);
+			{
+				jitter.PushCst(1);
+				jitter.PullRel(offsetof(CONTEXT, branchSetResult) + (i * sizeof(RESULT)) + offsetof(RESULT, flag));
+			}
+			jitter.EndIf();
+
+			//Branch taken when flag is clear
+			emitRelRelOperation();
+			jitter.ExtHigh64();
+			jitter.PushCst(0);
+			jitter.BeginIf(Jitter::CONDITION_EQ);
+			{
+				jitter.PushCst(1);
+				jitter.PullRel(offsetof(CONTEXT, branchClearResult) + (i * sizeof(uint32)));
+			}
+			jitter.EndIf();
+
+			//Flags modified by another operation before the branch
+			emitRelRelOperation();
+			jitter.ExtHigh64();
+			jitter.PushRel(offsetof(CONTEXT, src1) + (i * sizeof(uint32)));
+			jitter.PushRel(offsetof(CONTEXT, src2) + (i * sizeof(uint32)));
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, branchClobberResult) + (i * sizeof(RESULT)) + offsetof(RESULT, value));
+			jitter.PushCst(0);
+			jitter.BeginIf(Jitter::CONDITION_NE);
+			{
+				jitter.PushCst(1);
+				jitter.PullRel(offsetof(CONTEXT, branchClobberResult) + (i * sizeof(RESULT)) + offsetof(RESULT, flag));
+			}
+			jitter.EndIf();
+		}
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Test.h"
+
+class CAluFlagTest : public CTest
+{
+public:
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	enum
+	{
+		MAX_CASES = 32,
+	};
+
+	struct RESULT
+	{
+		uint32 value;
+		uint32 flag;
+	};
+
+	struct CONTEXT
+	{
+		uint32 src1[MAX_CASES];
+		uint32 src2[MAX_CASES];
+		uint32 carryIn[MAX_CASES];
+
+		RESULT relRelResult[MAX_CASES];
+		RESULT relCstResult[MAX_CASES];
+		RESULT cstCstResult[MAX_CASES];
+
+		//Flag tested by conditional branches
+		RESULT branchSetResult[MAX_CASES];
+		uint32 branchClearResult[MAX_CASES];
+		RESULT branchClobberResult[MAX_CASES];
+	};
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
@@ -0,0 +1,134 @@
+#include "BranchHintTest.h"
+#include "MemStream.h"
+
+#define ZERO_RESULT (0xDEAD)
+#define FLAG_SMALL (0x01)
+#define FLAG_LARGE (0x02)
+#define FLAG_ODD (0x04)
+#define FLAG_EVEN (0x08)
+#define SPECIAL_BIT (0x100)
+#define LOOP_COUNT (5)
+
+void CBranchHintTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_EQ, Jitter::CJitter::BRANCH_HINT_UNLIKELY);
+		{
+			jitter.PushCst(ZERO_RESULT);
+			jitter.PullRel(offsetof(CONTEXT, result));
+		}
+		jitter.EndIf();
+
+		//Else path is the one moved away
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(10);
+		jitter.BeginIf(Jitter::CONDITION_BL, Jitter::CJitter::BRANCH_HINT_LIKELY);
+		{
+			jitter.PushRel(offsetof(CONTEXT, flags));
+			jitter.PushCst(FLAG_SMALL);
+			jitter.Or();
+			jitter.PullRel(offsetof(CONTEXT, flags));
+		}
+		jitter.Else();
+		{
+			jitter.PushRel(offsetof(CONTEXT, flags));
+			jitter.PushCst(FLAG_LARGE);
+			jitter.Or();
+			jitter.PullRel(offsetof(CONTEXT, flags));
+		}
+		jitter.EndIf();
+
+		//Cold region containing nested control flow
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(SPECIAL_BIT);
+		jitter.And();
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_NE, Jitter::CJitter::BRANCH_HINT_UNLIKELY);
+		{
+			jitter.PushRel(offsetof(CONTEXT, input));
+			jitter.PushCst(1);
+			jitter.And();
+			jitter.PushCst(0);
+			jitter.BeginIf(Jitter::CONDITION_NE);
+			{
+				jitter.PushRel(offsetof(CONTEXT, flags));
+				jitter.PushCst(FLAG_ODD);
+				jitter.Or();
+				jitter.PullRel(offsetof(CONTEXT, flags));
+			}
+			jitter.Else();
+			{
+				jitter.PushRel(offsetof(CONTEXT, flags));
+				jitter.PushCst(FLAG_EVEN);
+				jitter.Or();
+				jitter.PullRel(offsetof(CONTEXT, flags));
+			}
+			jitter.EndIf();
+		}
+		jitter.EndIf();
+
+		//Loop with a likely back edge
+		jitter.PushCst(0);
+		jitter.PullRel(offsetof(CONTEXT, counter));
+
+		auto loopLabel = jitter.CreateLabel();
+		jitter.MarkLabel(loopLabel);
+		{
+			jitter.PushRel(offsetof(CONTEXT, result));
+			jitter.PushRel(offsetof(CONTEXT, input));
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, result));
+
+			jitter.PushRel(offsetof(CONTEXT, counter));
+			jitter.PushCst(1);
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, counter));
+
+			jitter.PushRel(offsetof(CONTEXT, counter));
+			jitter.PushCst(LOOP_COUNT);
+			jitter.BeginIf(Jitter::CONDITION_BL, Jitter::CJitter::BRANCH_HINT_LIKELY);
+			{
+				jitter.Goto(loopLabel, Jitter::CJitter::BRANCH_HINT_LIKELY);
+			}
+			jitter.EndIf();
+		}
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CBranchHintTest::RunWithInput(uint32 input)
+{
+	memset(&m_context, 0, sizeof(CONTEXT));
+	m_context.input = input;
+	m_function(&m_context);
+
+	uint32 result = (input == 0) ? ZERO_RESULT : 0;
+	result += input * LOOP_COUNT;
+
+	uint32 flags = (input < 10) ? FLAG_SMALL : FLAG_LARGE;
+	if(input & SPECIAL_BIT)
+	{
+		flags |= (input & 1) ? FLAG_ODD : FLAG_EVEN;
+	}
+
+	TEST_VERIFY(m_context.result == result);
+	TEST_VERIFY(m_context.flags == flags);
+	TEST_VERIFY(m_context.counter == LOOP_COUNT);
+}
+
+void CBranchHintTest::Run()
+{
+	RunWithInput(0);
+	RunWithInput(3);
+	RunWithInput(42);
+	RunWithInput(SPECIAL_BIT);
+	RunWithInput(SPECIAL_BIT | 1);
+}
@@ -0,0 +1,115 @@
+#include "CallAttributeTest.h"
+#include "MemStream.h"
+#include "Jitter_CodeGen_Wasm.h"
+
+#define ACCUMULATE_COUNT (3)
+#define ACCUMULATE_ADJUST (5)
+
+static unsigned int g_hashCallCount = 0;
+
+extern "C" uint32 CallAttributeTest_Hash(uint32 value)
+{
+	g_hashCallCount++;
+	return (value * 0x9E3779B1) ^ (value >> 7);
+}
+
+extern "C" uint32 CallAttributeTest_Increment(uint32 value)
+{
+	return value + 1;
+}
+
+extern "C" void CallAttributeTest_Observe(void* context)
+{
+	auto attributeContext = reinterpret_cast<CCallAttributeTest::CONTEXT*>(context);
+	attributeContext->observed = attributeContext->accumulator;
+}
+
+void CCallAttributeTest::PrepareExternalFunctions()
+{
+	Jitter::CWasmFunctionRegistry::RegisterFunction(reinterpret_cast<uintptr_t>(&CallAttributeTest_Hash), "_CallAttributeTest_Hash", "ii");
+	Jitter::CWasmFunctionRegistry::RegisterFunction(reinterpret_cast<uintptr_t>(&CallAttributeTest_Increment), "_CallAttributeTest_Increment", "ii");
+	Jitter::CWasmFunctionRegistry::RegisterFunction(reinterpret_cast<uintptr_t>(&CallAttributeTest_Observe), "_CallAttributeTest_Observe", "vi");
+}
+
+void CCallAttributeTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		//Second call is identical to the first one and should reuse its result
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.Call(reinterpret_cast<void*>(&CallAttributeTest_Hash), 1, Jitter::CJitter::RETURN_VALUE_32, Jitter::CALL_ATTRIBUTE_PURE);
+		jitter.PullRel(offsetof(CONTEXT, hash0));
+
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.Call(reinterpret_cast<void*>(&CallAttributeTest_Hash), 1, Jitter::CJitter::RETURN_VALUE_32, Jitter::CALL_ATTRIBUTE_PURE);
+		jitter.PullRel(offsetof(CONTEXT, hash1));
+
+		//Result is never used, call should be removed
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(1);
+		jitter.Add();
+		jitter.Call(reinterpret_cast<void*>(&CallAttributeTest_Hash), 1, Jitter::CJitter::RETURN_VALUE_32, Jitter::CALL_ATTRIBUTE_PURE);
+		jitter.PullTop();
+
+		//Accumulator can stay in a register across these calls
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PullRel(offsetof(CONTEXT, accumulator));
+
+		for(unsigned int i = 0; i < ACCUMULATE_COUNT; i++)
+		{
+			jitter.PushRel(offsetof(CONTEXT, accumulator));
+			jitter.PushRel(offsetof(CONTEXT, accumulator));
+			jitter.Call(reinterpret_cast<void*>(&CallAttributeTest_Increment), 1, Jitter::CJitter::RETURN_VALUE_32, Jitter::CALL_ATTRIBUTE_NO_CONTEXT_ACCESS);
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, accumulator));
+		}
+
+		//Callee reads the context, accumulator needs to be written back before the call
+		jitter.PushRel(offsetof(CONTEXT, accumulator));
+		jitter.PushCst(ACCUMULATE_ADJUST);
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, accumulator));
+
+		jitter.PushCtx();
+		jitter.Call(reinterpret_cast<void*>(&CallAttributeTest_Observe), 1, Jitter::CJitter::RETURN_VALUE_NONE, Jitter::CALL_ATTRIBUTE_READS_CONTEXT_ONLY);
+
+		jitter.PushRel(offsetof(CONTEXT, accumulator));
+		jitter.PushCst(1);
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, accumulator));
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CCallAttributeTest::RunWithInput(uint32 input)
+{
+	memset(&m_context, 0, sizeof(CONTEXT));
+	m_context.input = input;
+	g_hashCallCount = 0;
+	m_function(&m_context);
+
+	uint32 accumulator = input;
+	for(unsigned int i = 0; i < ACCUMULATE_COUNT; i++)
+	{
+		accumulator = accumulator + (accumulator + 1);
+	}
+	accumulator += ACCUMULATE_ADJUST;
+
+	TEST_VERIFY(g_hashCallCount == 1);
+	TEST_VERIFY(m_context.hash0 == CallAttributeTest_Hash(input));
+	TEST_VERIFY(m_context.hash1 == m_context.hash0);
+	TEST_VERIFY(m_context.observed == accumulator);
+	TEST_VERIFY(m_context.accumulator == (accumulator + 1));
+}
+
+void CCallAttributeTest::Run()
+{
+	RunWithInput(0);
+	RunWithInput(3);
+	RunWithInput(0x12345678);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Test.h"
+
+extern "C" uint32 CallAttributeTest_Hash(uint32);
+extern "C" uint32 CallAttributeTest_Increment(uint32);
+extern "C" void CallAttributeTest_Observe(void*);
+
+class CCallAttributeTest : public CTest
+{
+public:
+	static void PrepareExternalFunctions();
+
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	friend void ::CallAttributeTest_Observe(void*);
+
+	struct CONTEXT
+	{
+		uint32 input;
+		uint32 hash0;
+		uint32 hash1;
+		uint32 accumulator;
+		uint32 observed;
+	};
+
+	void RunWithInput(uint32);
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
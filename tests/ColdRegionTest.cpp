@@ -0,0 +1,181 @@
+#include "ColdRegionTest.h"
+#include "MemStream.h"
+
+#define ZERO_RESULT (0xDEAD)
+#define FLAG_SMALL (0x01)
+#define FLAG_LARGE (0x02)
+#define FLAG_ODD (0x04)
+#define FLAG_EVEN (0x08)
+#define FLAG_ERROR (0x10)
+#define SPECIAL_BIT (0x100)
+#define ERROR_BIT (0x8000)
+#define LOOP_COUNT (5)
+
+void CColdRegionTest::Compile(Jitter::CJitter& jitter)
+{
+	auto codeGen = jitter.GetCodeGen();
+	bool splitCode = codeGen->SupportsColdRegion();
+
+	Framework::CMemStream codeStream;
+	Framework::CMemStream coldCodeStream;
+	jitter.SetStream(&codeStream);
+	if(splitCode)
+	{
+		codeGen->SetColdStream(&coldCodeStream);
+	}
+
+	jitter.Begin();
+	{
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_EQ, Jitter::CJitter::BRANCH_HINT_UNLIKELY);
+		{
+			jitter.PushCst(ZERO_RESULT);
+			jitter.PullRel(offsetof(CONTEXT, result));
+		}
+		jitter.EndIf();
+
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(10);
+		jitter.BeginIf(Jitter::CONDITION_BL, Jitter::CJitter::BRANCH_HINT_LIKELY);
+		{
+			jitter.PushRel(offsetof(CONTEXT, flags));
+			jitter.PushCst(FLAG_SMALL);
+			jitter.Or();
+			jitter.PullRel(offsetof(CONTEXT, flags));
+		}
+		jitter.Else();
+		{
+			jitter.PushRel(offsetof(CONTEXT, flags));
+			jitter.PushCst(FLAG_LARGE);
+			jitter.Or();
+			jitter.PullRel(offsetof(CONTEXT, flags));
+		}
+		jitter.EndIf();
+
+		//Cold code containing branches that stay in the cold region
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(SPECIAL_BIT);
+		jitter.And();
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_NE, Jitter::CJitter::BRANCH_HINT_UNLIKELY);
+		{
+			jitter.PushRel(offsetof(CONTEXT, input));
+			jitter.PushCst(1);
+			jitter.And();
+			jitter.PushCst(0);
+			jitter.BeginIf(Jitter::CONDITION_NE);
+			{
+				jitter.PushRel(offsetof(CONTEXT, flags));
+				jitter.PushCst(FLAG_ODD);
+				jitter.Or();
+				jitter.PullRel(offsetof(CONTEXT, flags));
+			}
+			jitter.Else();
+			{
+				jitter.PushRel(offsetof(CONTEXT, flags));
+				jitter.PushCst(FLAG_EVEN);
+				jitter.Or();
+				jitter.PullRel(offsetof(CONTEXT, flags));
+			}
+			jitter.EndIf();
+		}
+		jitter.EndIf();
+
+		//Hot loop
+		jitter.PushCst(0);
+		jitter.PullRel(offsetof(CONTEXT, counter));
+
+		auto loopLabel = jitter.CreateLabel();
+		jitter.MarkLabel(loopLabel);
+		{
+			jitter.PushRel(offsetof(CONTEXT, result));
+			jitter.PushRel(offsetof(CONTEXT, input));
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, result));
+
+			jitter.PushRel(offsetof(CONTEXT, counter));
+			jitter.PushCst(1);
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, counter));
+
+			jitter.PushRel(offsetof(CONTEXT, counter));
+			jitter.PushCst(LOOP_COUNT);
+			jitter.BeginIf(Jitter::CONDITION_BL, Jitter::CJitter::BRANCH_HINT_LIKELY);
+			{
+				jitter.Goto(loopLabel, Jitter::CJitter::BRANCH_HINT_LIKELY);
+			}
+			jitter.EndIf();
+		}
+
+		//Cold block ending the function
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(ERROR_BIT);
+		jitter.And();
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_NE, Jitter::CJitter::BRANCH_HINT_UNLIKELY);
+		{
+			jitter.PushRel(offsetof(CONTEXT, flags));
+			jitter.PushCst(FLAG_ERROR);
+			jitter.Or();
+			jitter.PullRel(offsetof(CONTEXT, flags));
+		}
+		jitter.EndIf();
+	}
+	jitter.End();
+
+	if(splitCode)
+	{
+		codeGen->SetColdStream(nullptr);
+		TEST_VERIFY(coldCodeStream.GetSize() != 0);
+		TEST_VERIFY(!codeGen->GetCodeRegionRelocations().empty());
+	}
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+	if(splitCode)
+	{
+		m_coldFunction = FunctionType(coldCodeStream.GetBuffer(), coldCodeStream.GetSize());
+		m_function.BeginModify();
+		m_coldFunction.BeginModify();
+		Jitter::CCodeGen::ApplyCodeRegionRelocations(codeGen->GetCodeRegionRelocations(),
+		                                             m_function.GetCode(), m_coldFunction.GetCode(),
+		                                             m_function.GetWritableCode(), m_coldFunction.GetWritableCode());
+		m_coldFunction.EndModify();
+		m_function.EndModify();
+	}
+}
+
+void CColdRegionTest::RunWithInput(uint32 input)
+{
+	memset(&m_context, 0, sizeof(CONTEXT));
+	m_context.input = input;
+	m_function(&m_context);
+
+	uint32 result = (input == 0) ? ZERO_RESULT : 0;
+	result += input * LOOP_COUNT;
+
+	uint32 flags = (input < 10) ? FLAG_SMALL : FLAG_LARGE;
+	if(input & SPECIAL_BIT)
+	{
+		flags |= (input & 1) ? FLAG_ODD : FLAG_EVEN;
+	}
+	if(input & ERROR_BIT)
+	{
+		flags |= FLAG_ERROR;
+	}
+
+	TEST_VERIFY(m_context.result == result);
+	TEST_VERIFY(m_context.flags == flags);
+	TEST_VERIFY(m_context.counter == LOOP_COUNT);
+}
+
+void CColdRegionTest::Run()
+{
+	RunWithInput(0);
+	RunWithInput(3);
+	RunWithInput(42);
+	RunWithInput(SPECIAL_BIT);
+	RunWithInput(SPECIAL_BIT | 1);
+	RunWithInput(ERROR_BIT | 7);
+	RunWithInput(ERROR_BIT | SPECIAL_BIT | 1);
+}
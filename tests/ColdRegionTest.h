@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Test.h"
+
+class CColdRegionTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	struct CONTEXT
+	{
+		uint32 input;
+		uint32 result;
+		uint32 flags;
+		uint32 counter;
+	};
+
+	void RunWithInput(uint32);
+
+	CONTEXT m_context;
+	FunctionType m_function;
+	FunctionType m_coldFunction;
+};
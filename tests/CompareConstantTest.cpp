@@ -0,0 +1,101 @@
+#include "CompareConstantTest.h"
+#include "MemStream.h"
+
+const Jitter::CONDITION CCompareConstantTest::g_conditions[CONDITION_COUNT] =
+{
+	Jitter::CONDITION_EQ,
+	Jitter::CONDITION_NE,
+	Jitter::CONDITION_BL,
+	Jitter::CONDITION_BE,
+	Jitter::CONDITION_AB,
+	Jitter::CONDITION_AE,
+	Jitter::CONDITION_LT,
+	Jitter::CONDITION_LE,
+	Jitter::CONDITION_GT,
+	Jitter::CONDITION_GE,
+};
+
+static bool EvaluateCondition(Jitter::CONDITION condition, uint32 value0, uint32 value1)
+{
+	switch(condition)
+	{
+	case Jitter::CONDITION_EQ:
+		return value0 == value1;
+	case Jitter::CONDITION_NE:
+		return value0 != value1;
+	case Jitter::CONDITION_BL:
+		return value0 < value1;
+	case Jitter::CONDITION_BE:
+		return value0 <= value1;
+	case Jitter::CONDITION_AB:
+		return value0 > value1;
+	case Jitter::CONDITION_AE:
+		return value0 >= value1;
+	case Jitter::CONDITION_LT:
+		return static_cast<int32>(value0) < static_cast<int32>(value1);
+	case Jitter::CONDITION_LE:
+		return static_cast<int32>(value0) <= static_cast<int32>(value1);
+	case Jitter::CONDITION_GT:
+		return static_cast<int32>(value0) > static_cast<int32>(value1);
+	case Jitter::CONDITION_GE:
+		return static_cast<int32>(value0) >= static_cast<int32>(value1);
+	default:
+		assert(false);
+		return false;
+	}
+}
+
+CCompareConstantTest::CCompareConstantTest(uint32 constant, uint32 value)
+    : m_constant(constant)
+    , m_value(value)
+{
+}
+
+void CCompareConstantTest::Run()
+{
+	memset(&m_context, 0xCC, sizeof(m_context));
+	m_context.value = m_value;
+
+	m_function(&m_context);
+
+	for(unsigned int i = 0; i < CONDITION_COUNT; i++)
+	{
+		uint32 result = EvaluateCondition(g_conditions[i], m_constant, m_value) ? 1 : 0;
+		TEST_VERIFY(m_context.cmpResults[i] == result);
+		TEST_VERIFY(m_context.ifResults[i] == result);
+	}
+}
+
+void CCompareConstantTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		for(unsigned int i = 0; i < CONDITION_COUNT; i++)
+		{
+			jitter.PushCst(m_constant);
+			jitter.PushRel(offsetof(CONTEXT, value));
+			jitter.Cmp(g_conditions[i]);
+			jitter.PullRel(offsetof(CONTEXT, cmpResults) + (i * sizeof(uint32)));
+
+			jitter.PushCst(m_constant);
+			jitter.PushRel(offsetof(CONTEXT, value));
+			jitter.BeginIf(g_conditions[i]);
+			{
+				jitter.PushCst(1);
+				jitter.PullRel(offsetof(CONTEXT, ifResults) + (i * sizeof(uint32)));
+			}
+			jitter.Else();
+			{
+				jitter.PushCst(0);
+				jitter.PullRel(offsetof(CONTEXT, ifResults) + (i * sizeof(uint32)));
+			}
+			jitter.EndIf();
+		}
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
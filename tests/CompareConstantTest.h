@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Test.h"
+
+//Compares with a constant as the first operand, operands need to be swapped by the jitter
+class CCompareConstantTest : public CTest
+{
+public:
+	CCompareConstantTest(uint32, uint32);
+
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	enum
+	{
+		CONDITION_COUNT = 10,
+	};
+
+	struct CONTEXT
+	{
+		uint32 value;
+		uint32 cmpResults[CONDITION_COUNT];
+		uint32 ifResults[CONDITION_COUNT];
+	};
+
+	static const Jitter::CONDITION g_conditions[CONDITION_COUNT];
+
+	uint32 m_constant = 0;
+	uint32 m_value = 0;
+	CONTEXT m_context;
+	FunctionType m_function;
+};
@@ -0,0 +1,109 @@
+#include "DivConstantTest.h"
+#include "MemStream.h"
+
+// clang-format off
+static const uint32 g_unsignedDivisors[] =
+{
+	1, 2, 3, 5, 6, 7, 10, 16, 25, 100,
+	641, 1000, 0x10000, 0x12345, 0x7FFFFFFF, 0x80000000, 0x80000001, 0xC0000000, 0xFFFFFFFE, 0xFFFFFFFF
+};
+
+static const uint32 g_signedDivisors[] =
+{
+	1, static_cast<uint32>(-1), 2, static_cast<uint32>(-2), 3, static_cast<uint32>(-3), 5, static_cast<uint32>(-7), 7, 10,
+	16, static_cast<uint32>(-16), 100, static_cast<uint32>(-1000), 0x12345, 0x40000000, 0x7FFFFFFF, static_cast<uint32>(-0x7FFFFFFF), 0x80000000, 6
+};
+
+static const uint32 g_dividends[] =
+{
+	0, 1, 2, 3, 7, 15, 16, 17, 99, 100, 101, 999, 1000, 0x12344, 0x12345, 0x12346,
+	0x3FFFFFFF, 0x40000000, 0x7FFFFFFE, 0x7FFFFFFF, 0x80000000, 0x80000001, 0xBFFFFFFF, 0xC0000000,
+	0xFFFF8000, 0xFFFFFF9C, 0xFFFFFFF0, 0xFFFFFFFD, 0xFFFFFFFE, 0xFFFFFFFF, 0x12345678, 0x87654321
+};
+// clang-format on
+
+static_assert(sizeof(g_unsignedDivisors) / sizeof(uint32) == 20, "Divisor count mismatch");
+static_assert(sizeof(g_signedDivisors) / sizeof(uint32) == 20, "Divisor count mismatch");
+
+CDivConstantTest::CDivConstantTest(bool isSigned)
+    : m_isSigned(isSigned)
+{
+}
+
+const uint32* CDivConstantTest::GetDivisors() const
+{
+	return m_isSigned ? g_signedDivisors : g_unsignedDivisors;
+}
+
+void CDivConstantTest::Run()
+{
+	const auto divisors = GetDivisors();
+	for(auto dividend : g_dividends)
+	{
+		memset(&m_context, 0, sizeof(m_context));
+		m_context.dividend = dividend;
+
+		m_function(&m_context);
+
+		for(uint32 i = 0; i < DIVISOR_COUNT; i++)
+		{
+			uint32 divisor = divisors[i];
+			if(m_isSigned)
+			{
+				int32 signedDividend = static_cast<int32>(dividend);
+				int32 signedDivisor = static_cast<int32>(divisor);
+				//Avoid overflow, result is the same as negation with wrap around
+				if((signedDividend == INT32_MIN) && (signedDivisor == -1))
+				{
+					TEST_VERIFY(m_context.quotients[i] == dividend);
+					TEST_VERIFY(m_context.remainders[i] == 0);
+					continue;
+				}
+				TEST_VERIFY(m_context.quotients[i] == static_cast<uint32>(signedDividend / signedDivisor));
+				TEST_VERIFY(m_context.remainders[i] == static_cast<uint32>(signedDividend % signedDivisor));
+			}
+			else
+			{
+				TEST_VERIFY(m_context.quotients[i] == dividend / divisor);
+				TEST_VERIFY(m_context.remainders[i] == dividend % divisor);
+			}
+		}
+	}
+}
+
+void CDivConstantTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	const auto divisors = GetDivisors();
+
+	jitter.Begin();
+	{
+		for(uint32 i = 0; i < DIVISOR_COUNT; i++)
+		{
+			jitter.PushRel(offsetof(CONTEXT, dividend));
+			jitter.PushCst(divisors[i]);
+
+			if(m_isSigned)
+			{
+				jitter.DivS();
+			}
+			else
+			{
+				jitter.Div();
+			}
+
+			jitter.PushTop();
+
+			jitter.ExtLow64();
+			jitter.PullRel(offsetof(CONTEXT, quotients) + (i * sizeof(uint32)));
+
+			jitter.ExtHigh64();
+			jitter.PullRel(offsetof(CONTEXT, remainders) + (i * sizeof(uint32)));
+		}
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Test.h"
+
+class CDivConstantTest : public CTest
+{
+public:
+	CDivConstantTest(bool);
+
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	enum
+	{
+		DIVISOR_COUNT = 20,
+	};
+
+	struct CONTEXT
+	{
+		uint32 dividend;
+		uint32 quotients[DIVISOR_COUNT];
+		uint32 remainders[DIVISOR_COUNT];
+	};
+
+	const uint32* GetDivisors() const;
+
+	bool m_isSigned;
+	CONTEXT m_context;
+	FunctionType m_function;
+};
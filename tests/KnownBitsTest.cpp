@@ -0,0 +1,161 @@
+#include "KnownBitsTest.h"
+#include "MemStream.h"
+
+void CKnownBitsTest::Compile(Jitter::CJitter& jitter)
+{
+	//Reference function is written without the operations that known bits make redundant
+	auto compileFunction =
+	    [&](Framework::CMemStream& codeStream, bool isReference) {
+		    jitter.SetStream(&codeStream);
+
+		    jitter.Begin();
+		    {
+			    //Mask after a byte load is redundant
+			    jitter.PushRelAddrRef(offsetof(CONTEXT, byteValue));
+			    jitter.Load8FromRef();
+			    if(!isReference)
+			    {
+				    jitter.PushCst(0xFF);
+				    jitter.And();
+			    }
+			    jitter.PullRel(offsetof(CONTEXT, maskedByte));
+
+			    //Second sign extension is redundant
+			    jitter.PushRelAddrRef(offsetof(CONTEXT, halfValue));
+			    jitter.Load16FromRef();
+			    jitter.SignExt16();
+			    if(!isReference)
+			    {
+				    jitter.SignExt16();
+			    }
+			    jitter.PullRel(offsetof(CONTEXT, doubleSignExt16));
+
+			    //Sign bit of the byte is known to be clear, sign extension is redundant
+			    jitter.PushRelAddrRef(offsetof(CONTEXT, byteValue));
+			    jitter.Load8FromRef();
+			    jitter.PushCst(0x7F);
+			    jitter.And();
+			    if(!isReference)
+			    {
+				    jitter.SignExt8();
+			    }
+			    jitter.PullRel(offsetof(CONTEXT, maskedSignExt8));
+
+			    //Masked value is always in range
+			    if(isReference)
+			    {
+				    jitter.PushCst(1);
+			    }
+			    else
+			    {
+				    jitter.PushRel(offsetof(CONTEXT, value1));
+				    jitter.PushCst(0xFF);
+				    jitter.And();
+				    jitter.PushCst(0x100);
+				    jitter.Cmp(Jitter::CONDITION_BL);
+			    }
+			    jitter.PullRel(offsetof(CONTEXT, rangeCompare));
+
+			    if(isReference)
+			    {
+				    jitter.PushCst(2);
+				    jitter.PullRel(offsetof(CONTEXT, rangeBranch));
+			    }
+			    else
+			    {
+				    jitter.PushRel(offsetof(CONTEXT, value1));
+				    jitter.PushCst(0x0F);
+				    jitter.And();
+				    jitter.PushCst(0x10);
+				    jitter.BeginIf(Jitter::CONDITION_GE);
+				    {
+					    jitter.PushCst(1);
+					    jitter.PullRel(offsetof(CONTEXT, rangeBranch));
+				    }
+				    jitter.Else();
+				    {
+					    jitter.PushCst(2);
+					    jitter.PullRel(offsetof(CONTEXT, rangeBranch));
+				    }
+				    jitter.EndIf();
+			    }
+
+			    //Both operands are positive, signed division can be done as unsigned
+			    jitter.PushRel(offsetof(CONTEXT, value1));
+			    jitter.PushCst(0xFFFF);
+			    jitter.And();
+			    jitter.PushRel(offsetof(CONTEXT, value2));
+			    jitter.PushCst(0xFF);
+			    jitter.And();
+			    jitter.PushCst(1);
+			    jitter.Or();
+			    if(isReference)
+			    {
+				    jitter.Div();
+			    }
+			    else
+			    {
+				    jitter.DivS();
+			    }
+			    jitter.PushTop();
+			    jitter.ExtLow64();
+			    jitter.PullRel(offsetof(CONTEXT, positiveDiv));
+			    jitter.ExtHigh64();
+			    jitter.PullRel(offsetof(CONTEXT, positiveRem));
+
+			    //Sign bit is clear after a logical shift, arithmetic shift can be logical
+			    jitter.PushRel(offsetof(CONTEXT, value2));
+			    jitter.Srl(1);
+			    if(isReference)
+			    {
+				    jitter.Srl(3);
+			    }
+			    else
+			    {
+				    jitter.Sra(3);
+			    }
+			    jitter.PullRel(offsetof(CONTEXT, positiveSra));
+		    }
+		    jitter.End();
+	    };
+
+	Framework::CMemStream codeStream;
+	compileFunction(codeStream, false);
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+
+	//Simplified function should end up exactly like the reference
+	Framework::CMemStream referenceCodeStream;
+	compileFunction(referenceCodeStream, true);
+	m_codeSize = codeStream.GetSize();
+	m_referenceCodeSize = referenceCodeStream.GetSize();
+}
+
+void CKnownBitsTest::RunWithValues(uint8 byteValue, uint16 halfValue, uint32 value1, uint32 value2)
+{
+	memset(&m_context, 0, sizeof(CONTEXT));
+	m_context.byteValue = byteValue;
+	m_context.halfValue = halfValue;
+	m_context.value1 = value1;
+	m_context.value2 = value2;
+	m_function(&m_context);
+
+	uint32 divisor = (value2 & 0xFF) | 1;
+	TEST_VERIFY(m_context.maskedByte == byteValue);
+	TEST_VERIFY(m_context.doubleSignExt16 == static_cast<uint32>(static_cast<int16>(halfValue)));
+	TEST_VERIFY(m_context.maskedSignExt8 == (byteValue & 0x7FU));
+	TEST_VERIFY(m_context.rangeCompare == 1);
+	TEST_VERIFY(m_context.rangeBranch == 2);
+	TEST_VERIFY(m_context.positiveDiv == ((value1 & 0xFFFF) / divisor));
+	TEST_VERIFY(m_context.positiveRem == ((value1 & 0xFFFF) % divisor));
+	TEST_VERIFY(m_context.positiveSra == ((value2 >> 1) >> 3));
+}
+
+void CKnownBitsTest::Run()
+{
+	TEST_VERIFY(m_codeSize == m_referenceCodeSize);
+
+	RunWithValues(0x00, 0x0000, 0, 0);
+	RunWithValues(0x7F, 0x7FFF, 0x12345678, 0x87654321);
+	RunWithValues(0x80, 0x8000, 0xFFFFFFFF, 0xFFFFFFFE);
+	RunWithValues(0xFF, 0xFFFF, 0x8000FFFF, 0x80000000);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Test.h"
+
+class CKnownBitsTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	struct CONTEXT
+	{
+		uint8 byteValue;
+		uint8 padding;
+		uint16 halfValue;
+		uint32 value1;
+		uint32 value2;
+
+		uint32 maskedByte;
+		uint32 doubleSignExt16;
+		uint32 maskedSignExt8;
+		uint32 rangeCompare;
+		uint32 rangeBranch;
+		uint32 positiveDiv;
+		uint32 positiveRem;
+		uint32 positiveSra;
+	};
+
+	void RunWithValues(uint8, uint16, uint32, uint32);
+
+	CONTEXT m_context;
+	FunctionType m_function;
+	uint64 m_codeSize = 0;
+	uint64 m_referenceCodeSize = 0;
+};
@@ -0,0 +1,221 @@
+#include "LoopInvariantTest.h"
+#include "MemStream.h"
+
+static constexpr uint32 OUTER_COUNT = 3;
+static constexpr uint32 BASE_VALUE = 0x1234;
+static constexpr uint32 SCALE_VALUE = 0x10;
+
+void CLoopInvariantTest::Compile(Jitter::CJitter& jitter)
+{
+	//Loops are compiled in separate functions since some code generators only support
+	//one loop per function. Nested loops can't be split up and are skipped on those.
+	if(!jitter.GetCodeGen()->SupportsNestedLoops())
+	{
+		printf("Warning: Skipping nested loops in LoopInvariantTest because they are not supported.\n");
+	}
+	else
+	{
+		CompileNestedFunction(jitter);
+	}
+	CompileVariantFunction(jitter);
+	CompileStoreFunction(jitter);
+}
+
+void CLoopInvariantTest::CompileNestedFunction(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		auto outerLabel = jitter.CreateLabel();
+		auto innerLabel = jitter.CreateLabel();
+
+		//Nested loops, ((base + scale) << 2) and the array address only depend on values that are never written
+		jitter.MarkLabel(outerLabel);
+		{
+			jitter.PushCst(0);
+			jitter.PullRel(offsetof(CONTEXT, innerCounter));
+
+			jitter.MarkLabel(innerLabel);
+			{
+				jitter.PushRel(offsetof(CONTEXT, invariantSum));
+				jitter.PushRel(offsetof(CONTEXT, base));
+				jitter.PushRel(offsetof(CONTEXT, scale));
+				jitter.Add();
+				jitter.Shl(2);
+				jitter.Add();
+				jitter.PullRel(offsetof(CONTEXT, invariantSum));
+
+				jitter.PushRel(offsetof(CONTEXT, arraySum));
+				jitter.PushRelAddrRef(offsetof(CONTEXT, array));
+				jitter.PushRel(offsetof(CONTEXT, innerCounter));
+				jitter.LoadFromRefIdx();
+				jitter.Add();
+				jitter.PullRel(offsetof(CONTEXT, arraySum));
+
+				jitter.PushRel(offsetof(CONTEXT, innerCounter));
+				jitter.PushCst(1);
+				jitter.Add();
+				jitter.PullRel(offsetof(CONTEXT, innerCounter));
+
+				jitter.PushRel(offsetof(CONTEXT, innerCounter));
+				jitter.PushCst(ARRAY_SIZE);
+				jitter.BeginIf(Jitter::CONDITION_BL);
+				{
+					jitter.Goto(innerLabel);
+				}
+				jitter.EndIf();
+			}
+
+			jitter.PushRel(offsetof(CONTEXT, outerCounter));
+			jitter.PushCst(1);
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, outerCounter));
+
+			jitter.PushRel(offsetof(CONTEXT, outerCounter));
+			jitter.PushCst(OUTER_COUNT);
+			jitter.BeginIf(Jitter::CONDITION_BL);
+			{
+				jitter.Goto(outerLabel);
+			}
+			jitter.EndIf();
+		}
+	}
+	jitter.End();
+
+	m_nestedFunction = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CLoopInvariantTest::CompileVariantFunction(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		auto variantLabel = jitter.CreateLabel();
+
+		//Step is written inside the loop, (step << 1) must be computed on every iteration
+		jitter.PushCst(0);
+		jitter.PullRel(offsetof(CONTEXT, innerCounter));
+
+		jitter.MarkLabel(variantLabel);
+		{
+			jitter.PushRel(offsetof(CONTEXT, variantSum));
+			jitter.PushRel(offsetof(CONTEXT, step));
+			jitter.Shl(1);
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, variantSum));
+
+			jitter.PushRel(offsetof(CONTEXT, step));
+			jitter.PushCst(1);
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, step));
+
+			jitter.PushRel(offsetof(CONTEXT, innerCounter));
+			jitter.PushCst(1);
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, innerCounter));
+
+			jitter.PushRel(offsetof(CONTEXT, innerCounter));
+			jitter.PushCst(ARRAY_SIZE);
+			jitter.BeginIf(Jitter::CONDITION_BL);
+			{
+				jitter.Goto(variantLabel);
+			}
+			jitter.EndIf();
+		}
+	}
+	jitter.End();
+
+	m_variantFunction = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CLoopInvariantTest::CompileStoreFunction(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		auto storeLabel = jitter.CreateLabel();
+
+		//Bias is modified through a reference, (bias + 1) must be computed on every iteration
+		jitter.PushCst(0);
+		jitter.PullRel(offsetof(CONTEXT, innerCounter));
+
+		jitter.MarkLabel(storeLabel);
+		{
+			jitter.PushRel(offsetof(CONTEXT, storeSum));
+			jitter.PushRel(offsetof(CONTEXT, bias));
+			jitter.PushCst(1);
+			jitter.Add();
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, storeSum));
+
+			jitter.PushRelAddrRef(offsetof(CONTEXT, bias));
+			jitter.PushRel(offsetof(CONTEXT, innerCounter));
+			jitter.StoreAtRef();
+
+			jitter.PushRel(offsetof(CONTEXT, innerCounter));
+			jitter.PushCst(1);
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, innerCounter));
+
+			jitter.PushRel(offsetof(CONTEXT, innerCounter));
+			jitter.PushCst(ARRAY_SIZE);
+			jitter.BeginIf(Jitter::CONDITION_BL);
+			{
+				jitter.Goto(storeLabel);
+			}
+			jitter.EndIf();
+		}
+	}
+	jitter.End();
+
+	m_storeFunction = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CLoopInvariantTest::Run()
+{
+	memset(&m_context, 0, sizeof(CONTEXT));
+	m_context.base = BASE_VALUE;
+	m_context.scale = SCALE_VALUE;
+	for(uint32 i = 0; i < ARRAY_SIZE; i++)
+	{
+		m_context.array[i] = (i + 1) * 0x11;
+	}
+	if(!m_nestedFunction.IsEmpty())
+	{
+		m_nestedFunction(&m_context);
+	}
+	m_variantFunction(&m_context);
+	m_storeFunction(&m_context);
+
+	uint32 arraySum = 0;
+	for(uint32 i = 0; i < ARRAY_SIZE; i++)
+	{
+		arraySum += m_context.array[i];
+	}
+
+	uint32 variantSum = 0;
+	uint32 storeSum = 0;
+	for(uint32 i = 0; i < ARRAY_SIZE; i++)
+	{
+		variantSum += (i << 1);
+		//Bias holds the previous iteration's counter
+		storeSum += ((i == 0) ? 0 : (i - 1)) + 1;
+	}
+
+	if(!m_nestedFunction.IsEmpty())
+	{
+		TEST_VERIFY(m_context.outerCounter == OUTER_COUNT);
+		TEST_VERIFY(m_context.invariantSum == ((BASE_VALUE + SCALE_VALUE) << 2) * ARRAY_SIZE * OUTER_COUNT);
+		TEST_VERIFY(m_context.arraySum == arraySum * OUTER_COUNT);
+	}
+	TEST_VERIFY(m_context.step == ARRAY_SIZE);
+	TEST_VERIFY(m_context.variantSum == variantSum);
+	TEST_VERIFY(m_context.bias == (ARRAY_SIZE - 1));
+	TEST_VERIFY(m_context.storeSum == storeSum);
+}
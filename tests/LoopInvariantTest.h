@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Test.h"
+
+class CLoopInvariantTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	enum
+	{
+		ARRAY_SIZE = 8,
+	};
+
+	struct CONTEXT
+	{
+		uint32 base;
+		uint32 scale;
+		uint32 outerCounter;
+		uint32 innerCounter;
+		uint32 invariantSum;
+		uint32 arraySum;
+		uint32 step;
+		uint32 variantSum;
+		uint32 bias;
+		uint32 storeSum;
+		uint32 array[ARRAY_SIZE];
+	};
+
+	void CompileNestedFunction(Jitter::CJitter&);
+	void CompileVariantFunction(Jitter::CJitter&);
+	void CompileStoreFunction(Jitter::CJitter&);
+
+	CONTEXT m_context;
+	FunctionType m_nestedFunction;
+	FunctionType m_variantFunction;
+	FunctionType m_storeFunction;
+};
@@ -3,11 +3,18 @@
 #include "Crc32Test.h"
 #include "CursorTest.h"
 #include "MultTest.h"
+#include "AluFlagTest.h"
 #include "DivTest.h"
+#include "DivConstantTest.h"
+#include "KnownBitsTest.h"
 #include "RandomAluTest.h"
 #include "RandomAluTest2.h"
 #include "RandomAluTest3.h"
 #include "ShiftTest.h"
+#include "StencilTest.h"
+#include "WasmBatchTest.h"
+#include "MemoryFunctionStreamTest.h"
+#include "MemoryFunctionRegionTest.h"
 #include "LogicTest.h"
 #include "LoopTest.h"
 #include "AliasTest.h"
@@ -32,25 +39,42 @@
 #include "CompareTest.h"
 #include "RegAllocTest.h"
 #include "RegAllocTempTest.h"
+#include "RegAllocPressureTest.h"
 #include "ReorderAddTest.h"
+#include "ValueNumberingTest.h"
 #include "MemAccessTest.h"
 #include "MemAccessIdxTest.h"
 #include "MemAccess8Test.h"
 #include "MemAccess16Test.h"
 #include "MemAccessRefTest.h"
 #include "GotoTest.h"
+#include "UnreachableBlockTest.h"
+#include "LoopInvariantTest.h"
+#include "RelativeForwardingTest.h"
+#include "CallAttributeTest.h"
 #include "HugeJumpTest.h"
 #include "HugeJumpTestLiteral.h"
+#include "AArch64IslandTest.h"
+#include "AArch64ConstantTest.h"
+#include "ManyJumpsTest.h"
 #include "Alu64Test.h"
 #include "ConditionTest.h"
+#include "CompareConstantTest.h"
 #include "Cmp64Test.h"
 #include "Shift64Test.h"
 #include "Logic64Test.h"
 #include "Call64Test.h"
 #include "Merge64Test.h"
 #include "MemAccess64Test.h"
+#include "MemAccessBSwapTest.h"
+#include "MemAccessMemBaseTest.h"
+#include "MemAccessAddRefTest.h"
+#include "MemAccessLargeOffsetTest.h"
+#include "PinnedRelativeTest.h"
 #include "LzcTest.h"
 #include "NestedIfTest.h"
+#include "BranchHintTest.h"
+#include "ColdRegionTest.h"
 #include "ExternJumpTest.h"
 
 typedef std::function<CTest*()> TestFactoryFunction;
@@ -61,6 +85,7 @@ static const TestFactoryFunction s_factories[] =
 	[] () { return new CCompareTest(); },
 	[] () { return new CRegAllocTest(); },
 	[] () { return new CRegAllocTempTest(); },
+	[] () { return new CRegAllocPressureTest(); },
 	[] () { return new CRandomAluTest(true); },
 	[] () { return new CRandomAluTest(false); },
 	[] () { return new CRandomAluTest2(true); },
@@ -73,6 +98,7 @@ static const TestFactoryFunction s_factories[] =
 	[] () { return new CShiftTest(32); },
 	[] () { return new CShiftTest(44); },
 	[] () { return new CReorderAddTest(); },
+	[] () { return new CValueNumberingTest(); },
 	[] () { return new CCrc32Test("Hello World!", 0x67FCDACC); },
 	[] () { return new CCursorTest(); },
 	[] () { return new CLogicTest(0, false, ~0, false); },
@@ -84,8 +110,12 @@ static const TestFactoryFunction s_factories[] =
 	[] () { return new CLogicTest(0x89ABCDEF, false, 0x01234567, true); },
 	[] () { return new CMultTest(true); },
 	[] () { return new CMultTest(false); },
+	[] () { return new CAluFlagTest(); },
 	[] () { return new CDivTest(true); },
 	[] () { return new CDivTest(false); },
+	[] () { return new CDivConstantTest(true); },
+	[] () { return new CDivConstantTest(false); },
+	[] () { return new CKnownBitsTest(); },
 	[] () { return new CMemAccessTest(); },
 	[] () { return new CMemAccessIdxTest(true); },
 	[] () { return new CMemAccessIdxTest(false); },
@@ -95,10 +125,19 @@ static const TestFactoryFunction s_factories[] =
 	[] () { return new CMemAccess16Test(false); },
 	[] () { return new CMemAccessRefTest(); },
 	[] () { return new CGotoTest(); },
+	[] () { return new CUnreachableBlockTest(); },
+	[] () { return new CLoopInvariantTest(); },
+	[] () { return new CRelativeForwardingTest(); },
+	[] () { return new CCallAttributeTest(); },
 	[] () { return new CHugeJumpTest(); },
 	[] () { return new CHugeJumpTestLiteral(); },
+	[] () { return new CAArch64IslandTest(); },
+	[] () { return new CAArch64ConstantTest(); },
+	[] () { return new CManyJumpsTest(); },
 	[] () { return new CLoopTest(); },
 	[] () { return new CNestedIfTest(); },
+	[] () { return new CBranchHintTest(); },
+	[] () { return new CColdRegionTest(); },
 	[] () { return new CLzcTest(); },
 	[] () { return new CAliasTest(); },
 	[] () { return new CAliasTest2(); },
@@ -152,6 +191,9 @@ static const TestFactoryFunction s_factories[] =
 	[]() { return new CConditionTest(true,	0x000000FF, 0x0000000F); },
 	[]() { return new CConditionTest(true,	0x0000000F, 0x000000FF); },
 	[]() { return new CConditionTest(true,	0x000000FF, 0x000000FF); },
+	[] () { return new CCompareConstantTest(0x00000002, 0xFFFFFFFE); },
+	[] () { return new CCompareConstantTest(0xFFFFFFFE, 0x00000002); },
+	[] () { return new CCompareConstantTest(0x00000002, 0x00000002); },
 	[] () { return new CCmp64Test(false, false, 0xFEDCBA9876543210ULL, 0x012389AB4567CDEFULL); },
 	[] () { return new CCmp64Test(false, true,  0xFEDCBA9876543210ULL, 0x012389AB4567CDEFULL); },
 	[] () { return new CCmp64Test(true,  true,  0xFEDCBA9876543210ULL, 0x012389AB4567CDEFULL); },
@@ -176,8 +218,21 @@ static const TestFactoryFunction s_factories[] =
 	[] () { return new CMerge64Test(); },
 	[] () { return new CMemAccess64Test(false); },
 	[] () { return new CMemAccess64Test(true); },
+	[] () { return new CMemAccessBSwapTest(false); },
+	[] () { return new CMemAccessBSwapTest(true); },
+	[] () { return new CMemAccessMemBaseTest(false); },
+	[] () { return new CMemAccessMemBaseTest(true); },
+	[] () { return new CMemAccessAddRefTest(); },
+	[] () { return new CMemAccessLargeOffsetTest(); },
+	[] () { return new CPinnedRelativeTest(); },
 	[] () { return new CCall64Test(); },
-	[] () { return new CExternJumpTest(); }
+	[] () { return new CExternJumpTest(); },
+	[] () { return new CStencilTest(); },
+	[] () { return new CMemoryFunctionStreamTest(); },
+	[] () { return new CMemoryFunctionRegionTest(); },
+#ifdef __EMSCRIPTEN__
+	[] () { return new CWasmBatchTest(); },
+#endif
 };
 // clang-format on
 
@@ -186,6 +241,9 @@ void PrepareExternalFunctions()
 	CCrc32Test::PrepareExternalFunctions();
 	CCall64Test::PrepareExternalFunctions();
 	CRegAllocTempTest::PrepareExternalFunctions();
+	CPinnedRelativeTest::PrepareExternalFunctions();
+	CRelativeForwardingTest::PrepareExternalFunctions();
+	CCallAttributeTest::PrepareExternalFunctions();
 }
 
 int main(int argc, const char** argv)
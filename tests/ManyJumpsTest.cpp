@@ -0,0 +1,102 @@
+#include "ManyJumpsTest.h"
+#include "MemStream.h"
+
+//Lots of conditional blocks of varying size, some jumps over them fit in
+//a short displacement while others need a long one
+
+unsigned int CManyJumpsTest::GetBlockSize(unsigned int blockIndex)
+{
+	return (blockIndex * 7) % 23;
+}
+
+void CManyJumpsTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		jitter.PushCst(0);
+		jitter.PullRel(offsetof(CONTEXT, counter));
+
+		auto loopLabel = jitter.CreateLabel();
+		jitter.MarkLabel(loopLabel);
+
+		for(unsigned int i = 0; i < BLOCK_COUNT; i++)
+		{
+			jitter.PushRel(offsetof(CONTEXT, input));
+			jitter.PushCst(1 << (i % 32));
+			jitter.And();
+			jitter.PushCst(0);
+			jitter.BeginIf(Jitter::CONDITION_NE);
+			{
+				for(unsigned int j = 0; j < GetBlockSize(i); j++)
+				{
+					unsigned int dstIndex = (i + j) % MAX_VARS;
+					unsigned int srcIndex = (i * 3 + j) % MAX_VARS;
+					jitter.PushRel(offsetof(CONTEXT, number[dstIndex]));
+					jitter.PushRel(offsetof(CONTEXT, number[srcIndex]));
+					jitter.Add();
+					jitter.PushCst(i + j);
+					jitter.Xor();
+					jitter.PullRel(offsetof(CONTEXT, number[dstIndex]));
+				}
+			}
+			jitter.EndIf();
+		}
+
+		//Back edge spans the whole function
+		jitter.PushRel(offsetof(CONTEXT, counter));
+		jitter.PushCst(1);
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, counter));
+
+		jitter.PushRel(offsetof(CONTEXT, counter));
+		jitter.PushCst(LOOP_COUNT);
+		jitter.BeginIf(Jitter::CONDITION_BL);
+		{
+			jitter.Goto(loopLabel);
+		}
+		jitter.EndIf();
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CManyJumpsTest::RunWithInput(uint32 input)
+{
+	memset(&m_context, 0, sizeof(CONTEXT));
+	m_context.input = input;
+	m_function(&m_context);
+
+	uint32 number[MAX_VARS] = {};
+	for(unsigned int loop = 0; loop < LOOP_COUNT; loop++)
+	{
+		for(unsigned int i = 0; i < BLOCK_COUNT; i++)
+		{
+			if((input & (1 << (i % 32))) == 0) continue;
+			for(unsigned int j = 0; j < GetBlockSize(i); j++)
+			{
+				unsigned int dstIndex = (i + j) % MAX_VARS;
+				unsigned int srcIndex = (i * 3 + j) % MAX_VARS;
+				number[dstIndex] = (number[dstIndex] + number[srcIndex]) ^ (i + j);
+			}
+		}
+	}
+
+	TEST_VERIFY(m_context.counter == LOOP_COUNT);
+	for(unsigned int i = 0; i < MAX_VARS; i++)
+	{
+		TEST_VERIFY(m_context.number[i] == number[i]);
+	}
+}
+
+void CManyJumpsTest::Run()
+{
+	RunWithInput(0);
+	RunWithInput(0x00000001);
+	RunWithInput(0x80000000);
+	RunWithInput(0x5A5A5A5A);
+	RunWithInput(~0U);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Test.h"
+
+class CManyJumpsTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	enum
+	{
+		MAX_VARS = 16,
+		BLOCK_COUNT = 200,
+		LOOP_COUNT = 3,
+	};
+
+	struct CONTEXT
+	{
+		uint32 input;
+		uint32 counter;
+		uint32 number[MAX_VARS];
+	};
+
+	static unsigned int GetBlockSize(unsigned int);
+	void RunWithInput(uint32);
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
@@ -0,0 +1,261 @@
+#include "MemAccessAddRefTest.h"
+#include "MemStream.h"
+
+#define LOAD_CST_IDX (2)
+#define LOAD_VAR_IDX (3)
+#define LOAD_SCALED_IDX (4)
+#define LOAD_CHAIN_IDX (5)
+#define LOAD_64_IDX (6)
+#define LOAD_UNALIGNED_OFFSET ((LOAD_CST_IDX * sizeof(uint32)) - 2)
+#define STORE_CST_IDX (10)
+#define STORE_VAR_IDX (11)
+#define STORE_SCALED_IDX (12)
+#define STORE_CHAIN_IDX (13)
+#define STORE_BYTE_IDX (14)
+#define STORE_64_IDX (16)
+#define LOAD_DISP_IDX (18)
+#define LOAD_CST_INDEX_IDX (19)
+#define LOAD_VAR_INDEX_IDX (20)
+#define LOAD_16_DISP_IDX (21)
+#define LOAD_SEPARATED_IDX (22)
+#define STORE_DISP_IDX (24)
+#define STORE_BYTE_DISP_IDX (25)
+#define STORE_16_DISP_IDX (26)
+
+#define VALUE_0 (0x01234567)
+#define VALUE_1 (0x89ABCDEF)
+#define VALUE_2 (0xFEDCBA98)
+#define VALUE_3 (0x76543210)
+#define VALUE_4 (0x13579BDF)
+#define VALUE_5 (0x2468ACE0)
+#define VALUE_6 (0xCAFEBABE)
+#define VALUE_7 (0xDEADBEEF)
+#define VALUE_8 (0x0F1E2D3C)
+#define VALUE_64 (0x0011223344556677ULL)
+
+void CMemAccessAddRefTest::Run()
+{
+	memset(&m_context, 0, sizeof(m_context));
+	memset(&m_memory, 0xFF, sizeof(m_memory));
+
+	m_memory[LOAD_CST_IDX] = VALUE_0;
+	m_memory[LOAD_VAR_IDX] = VALUE_1;
+	m_memory[LOAD_SCALED_IDX] = VALUE_2;
+	m_memory[LOAD_CHAIN_IDX] = VALUE_3;
+	m_memory[LOAD_64_IDX + 0] = static_cast<uint32>(VALUE_64);
+	m_memory[LOAD_64_IDX + 1] = static_cast<uint32>(VALUE_64 >> 32);
+	m_memory[LOAD_DISP_IDX] = VALUE_4;
+	m_memory[LOAD_CST_INDEX_IDX] = VALUE_5;
+	m_memory[LOAD_VAR_INDEX_IDX] = VALUE_6;
+	m_memory[LOAD_16_DISP_IDX] = VALUE_7;
+	m_memory[LOAD_SEPARATED_IDX] = VALUE_8;
+
+	m_context.memory = m_memory;
+	m_context.offset = LOAD_VAR_IDX * sizeof(uint32);
+	m_context.index = LOAD_SCALED_IDX;
+
+	m_function(&m_context);
+
+	TEST_VERIFY(m_context.cstOffsetValue == VALUE_0);
+	TEST_VERIFY(m_context.varOffsetValue == VALUE_1);
+	TEST_VERIFY(m_context.scaledIndexValue == VALUE_2);
+	TEST_VERIFY(m_context.chainValue == VALUE_3);
+	TEST_VERIFY(m_context.byteValue == (VALUE_2 & 0xFF));
+	TEST_VERIFY(m_context.value64 == VALUE_64);
+	TEST_VERIFY(m_context.unalignedValue == ((static_cast<uint32>(VALUE_0) << 16) | 0xFFFF));
+	TEST_VERIFY(m_context.dispValue == VALUE_4);
+	TEST_VERIFY(m_context.cstIndexValue == VALUE_5);
+	TEST_VERIFY(m_context.varIndexValue == VALUE_6);
+	TEST_VERIFY(m_context.load16DispValue == (VALUE_7 & 0xFFFF));
+	TEST_VERIFY(m_context.separatedValue == VALUE_8);
+	TEST_VERIFY(m_context.unrelatedValue == VALUE_0);
+
+	TEST_VERIFY(m_memory[STORE_CST_IDX] == VALUE_0);
+	TEST_VERIFY(m_memory[STORE_VAR_IDX] == VALUE_1);
+	TEST_VERIFY(m_memory[STORE_SCALED_IDX] == VALUE_2);
+	TEST_VERIFY(m_memory[STORE_CHAIN_IDX] == VALUE_3);
+	TEST_VERIFY(m_memory[STORE_BYTE_IDX] == 0xFFFFFF67);
+	TEST_VERIFY(m_memory[STORE_64_IDX + 0] == static_cast<uint32>(VALUE_64));
+	TEST_VERIFY(m_memory[STORE_64_IDX + 1] == static_cast<uint32>(VALUE_64 >> 32));
+	TEST_VERIFY(m_memory[STORE_DISP_IDX] == VALUE_4);
+	TEST_VERIFY(m_memory[STORE_BYTE_DISP_IDX] == 0xFFFFFFBE);
+	TEST_VERIFY(m_memory[STORE_16_DISP_IDX] == 0xFFFFBEEF);
+}
+
+void CMemAccessAddRefTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		//Constant offset
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushCst(LOAD_CST_IDX * sizeof(uint32));
+		jitter.AddRef();
+		jitter.LoadFromRef();
+		jitter.PullRel(offsetof(CONTEXT, cstOffsetValue));
+
+		//Constant offset that isn't a multiple of the access size
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushCst(LOAD_UNALIGNED_OFFSET);
+		jitter.AddRef();
+		jitter.LoadFromRef();
+		jitter.PullRel(offsetof(CONTEXT, unalignedValue));
+
+		//Variable offset
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushRel(offsetof(CONTEXT, offset));
+		jitter.AddRef();
+		jitter.LoadFromRef();
+		jitter.PullRel(offsetof(CONTEXT, varOffsetValue));
+
+		//Scaled index
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushRel(offsetof(CONTEXT, index));
+		jitter.Shl(2);
+		jitter.AddRef();
+		jitter.LoadFromRef();
+		jitter.PullRel(offsetof(CONTEXT, scaledIndexValue));
+
+		//Constant offset followed by constant index
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushCst(sizeof(uint32));
+		jitter.AddRef();
+		jitter.PushCst(LOAD_CHAIN_IDX - 1);
+		jitter.LoadFromRefIdx(sizeof(uint32));
+		jitter.PullRel(offsetof(CONTEXT, chainValue));
+
+		//Byte access, scaled index can't be used here
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushRel(offsetof(CONTEXT, index));
+		jitter.Shl(2);
+		jitter.AddRef();
+		jitter.Load8FromRef();
+		jitter.PullRel(offsetof(CONTEXT, byteValue));
+
+		//64-bit access
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushCst(LOAD_64_IDX * sizeof(uint32));
+		jitter.AddRef();
+		jitter.Load64FromRef();
+		jitter.PullRel64(offsetof(CONTEXT, value64));
+
+		//Scaled index followed by constant offset
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushRel(offsetof(CONTEXT, index));
+		jitter.Shl(2);
+		jitter.AddRef();
+		jitter.PushCst((LOAD_DISP_IDX - LOAD_SCALED_IDX) * sizeof(uint32));
+		jitter.AddRef();
+		jitter.LoadFromRef();
+		jitter.PullRel(offsetof(CONTEXT, dispValue));
+
+		//Variable offset followed by constant index
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushRel(offsetof(CONTEXT, offset));
+		jitter.AddRef();
+		jitter.PushCst(LOAD_CST_INDEX_IDX - LOAD_VAR_IDX);
+		jitter.LoadFromRefIdx(sizeof(uint32));
+		jitter.PullRel(offsetof(CONTEXT, cstIndexValue));
+
+		//Constant offset followed by variable index
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushCst((LOAD_VAR_INDEX_IDX - LOAD_SCALED_IDX) * sizeof(uint32));
+		jitter.AddRef();
+		jitter.PushRel(offsetof(CONTEXT, index));
+		jitter.LoadFromRefIdx(sizeof(uint32));
+		jitter.PullRel(offsetof(CONTEXT, varIndexValue));
+
+		//16-bit access with variable offset and constant offset
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushRel(offsetof(CONTEXT, offset));
+		jitter.AddRef();
+		jitter.PushCst((LOAD_16_DISP_IDX - LOAD_VAR_IDX) * sizeof(uint32));
+		jitter.AddRef();
+		jitter.Load16FromRef();
+		jitter.PullRel(offsetof(CONTEXT, load16DispValue));
+
+		//Unrelated context write between the address computation and the access
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushRel(offsetof(CONTEXT, offset));
+		jitter.AddRef();
+		jitter.PushCst(VALUE_0);
+		jitter.PullRel(offsetof(CONTEXT, unrelatedValue));
+		jitter.PushCst((LOAD_SEPARATED_IDX - LOAD_VAR_IDX) * sizeof(uint32));
+		jitter.AddRef();
+		jitter.LoadFromRef();
+		jitter.PullRel(offsetof(CONTEXT, separatedValue));
+
+		//Stores
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushCst(STORE_CST_IDX * sizeof(uint32));
+		jitter.AddRef();
+		jitter.PushRel(offsetof(CONTEXT, cstOffsetValue));
+		jitter.StoreAtRef();
+
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushRel(offsetof(CONTEXT, offset));
+		jitter.PushCst((STORE_VAR_IDX - LOAD_VAR_IDX) * sizeof(uint32));
+		jitter.Add();
+		jitter.AddRef();
+		jitter.PushRel(offsetof(CONTEXT, varOffsetValue));
+		jitter.StoreAtRef();
+
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushRel(offsetof(CONTEXT, index));
+		jitter.PushCst(STORE_SCALED_IDX - LOAD_SCALED_IDX);
+		jitter.Add();
+		jitter.Shl(2);
+		jitter.AddRef();
+		jitter.PushRel(offsetof(CONTEXT, scaledIndexValue));
+		jitter.StoreAtRef();
+
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushCst(sizeof(uint32));
+		jitter.AddRef();
+		jitter.PushCst(STORE_CHAIN_IDX - 1);
+		jitter.PushRel(offsetof(CONTEXT, chainValue));
+		jitter.StoreAtRefIdx(sizeof(uint32));
+
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushCst(STORE_BYTE_IDX * sizeof(uint32));
+		jitter.AddRef();
+		jitter.PushCst(VALUE_0);
+		jitter.Store8AtRef();
+
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushCst(STORE_64_IDX * sizeof(uint32));
+		jitter.AddRef();
+		jitter.PushRel64(offsetof(CONTEXT, value64));
+		jitter.Store64AtRef();
+
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushRel(offsetof(CONTEXT, index));
+		jitter.Shl(2);
+		jitter.AddRef();
+		jitter.PushCst((STORE_DISP_IDX - LOAD_SCALED_IDX) * sizeof(uint32));
+		jitter.AddRef();
+		jitter.PushRel(offsetof(CONTEXT, dispValue));
+		jitter.StoreAtRef();
+
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushRel(offsetof(CONTEXT, offset));
+		jitter.AddRef();
+		jitter.PushCst((STORE_BYTE_DISP_IDX - LOAD_VAR_IDX) * sizeof(uint32));
+		jitter.AddRef();
+		jitter.PushCst(VALUE_6);
+		jitter.Store8AtRef();
+
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushRel(offsetof(CONTEXT, offset));
+		jitter.AddRef();
+		jitter.PushCst((STORE_16_DISP_IDX - LOAD_VAR_IDX) * sizeof(uint32));
+		jitter.AddRef();
+		jitter.PushCst(VALUE_7);
+		jitter.Store16AtRef();
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Test.h"
+
+class CMemAccessAddRefTest : public CTest
+{
+public:
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	struct CONTEXT
+	{
+		void* memory;
+		uint32 offset;
+		uint32 index;
+		uint32 cstOffsetValue;
+		uint32 varOffsetValue;
+		uint32 scaledIndexValue;
+		uint32 chainValue;
+		uint32 byteValue;
+		uint32 unalignedValue;
+		uint32 dispValue;
+		uint32 cstIndexValue;
+		uint32 varIndexValue;
+		uint32 load16DispValue;
+		uint32 separatedValue;
+		uint32 unrelatedValue;
+		uint64 value64;
+	};
+
+	CONTEXT m_context;
+	uint32 m_memory[0x20];
+	FunctionType m_function;
+};
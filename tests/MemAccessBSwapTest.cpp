@@ -0,0 +1,203 @@
+#include "MemAccessBSwapTest.h"
+#include "MemStream.h"
+
+#define CONSTANT_1 (0x01234567)
+#define CONSTANT_2 (0x89ABCDEF)
+#define CONSTANT_3 (0xFEDC)
+#define CONSTANT_64 (0x0123456789ABCDEFULL)
+
+#define STORE_OFFSET (0x00)
+#define STORE_CST_OFFSET (0x04)
+#define STORE_IDX_OFFSET (0x08)
+#define STORE16_OFFSET (0x0C)
+#define STORE16_IDX_OFFSET (0x0E)
+#define STORE16_CST_OFFSET (0x10)
+#define STORE64_OFFSET (0x18)
+#define STORE64_IDX_OFFSET (0x20)
+#define LOAD_OFFSET (0x28)
+#define LOAD16_OFFSET (0x2C)
+#define LOAD64_OFFSET (0x30)
+
+static const uint8 g_bigEndian32[] = {0x01, 0x23, 0x45, 0x67};
+static const uint8 g_bigEndian16[] = {0xFE, 0xDC};
+static const uint8 g_bigEndian64[] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF};
+
+CMemAccessBSwapTest::CMemAccessBSwapTest(bool useVariableIndices)
+    : m_useVariableIndices(useVariableIndices)
+{
+}
+
+void CMemAccessBSwapTest::Run()
+{
+	m_context = {};
+	m_context.storeIdx = STORE_IDX_OFFSET;
+	m_context.storeIdx16 = STORE16_IDX_OFFSET;
+	m_context.storeIdx64 = STORE64_IDX_OFFSET;
+	m_context.loadIdx = LOAD_OFFSET;
+	m_context.loadIdx16 = LOAD16_OFFSET;
+	m_context.loadIdx64 = LOAD64_OFFSET;
+
+	memset(&m_memory, 0x80, sizeof(m_memory));
+	memcpy(m_memory + LOAD_OFFSET, g_bigEndian32, sizeof(g_bigEndian32));
+	memcpy(m_memory + LOAD16_OFFSET, g_bigEndian16, sizeof(g_bigEndian16));
+	memcpy(m_memory + LOAD64_OFFSET, g_bigEndian64, sizeof(g_bigEndian64));
+
+	m_context.writeValue = CONSTANT_1;
+	m_context.writeValue64 = CONSTANT_64;
+	m_context.memory = m_memory;
+
+	m_function(&m_context);
+
+	static const uint8 bigEndianCst[] = {0x89, 0xAB, 0xCD, 0xEF};
+	static const uint8 bigEndian16[] = {0x45, 0x67};
+	static const uint8 bigEndian16Cst[] = {0xFE, 0xDC};
+
+	TEST_VERIFY(!memcmp(m_memory + STORE_OFFSET, g_bigEndian32, sizeof(g_bigEndian32)));
+	TEST_VERIFY(!memcmp(m_memory + STORE_CST_OFFSET, bigEndianCst, sizeof(bigEndianCst)));
+	TEST_VERIFY(!memcmp(m_memory + STORE_IDX_OFFSET, g_bigEndian32, sizeof(g_bigEndian32)));
+	TEST_VERIFY(!memcmp(m_memory + STORE16_OFFSET, bigEndian16, sizeof(bigEndian16)));
+	TEST_VERIFY(!memcmp(m_memory + STORE16_IDX_OFFSET, bigEndian16, sizeof(bigEndian16)));
+	TEST_VERIFY(!memcmp(m_memory + STORE16_CST_OFFSET, bigEndian16Cst, sizeof(bigEndian16Cst)));
+	TEST_VERIFY(m_memory[STORE16_CST_OFFSET + 2] == 0x80);
+	TEST_VERIFY(!memcmp(m_memory + STORE64_OFFSET, g_bigEndian64, sizeof(g_bigEndian64)));
+	TEST_VERIFY(!memcmp(m_memory + STORE64_IDX_OFFSET, g_bigEndian64, sizeof(g_bigEndian64)));
+
+	TEST_VERIFY(m_context.readValue == CONSTANT_1);
+	TEST_VERIFY(m_context.readValueIdx == CONSTANT_1);
+	TEST_VERIFY(m_context.readValue16 == CONSTANT_3);
+	TEST_VERIFY(m_context.readValue16Idx == CONSTANT_3);
+	TEST_VERIFY(m_context.readValue64 == CONSTANT_64);
+	TEST_VERIFY(m_context.readValue64Idx == CONSTANT_64);
+}
+
+void CMemAccessBSwapTest::Compile(Jitter::CJitter& jitter)
+{
+#define PUSH_IDX(field, offset)                     \
+	if(m_useVariableIndices)                        \
+	{                                               \
+		jitter.PushRel(offsetof(CONTEXT, field));   \
+	}                                               \
+	else                                            \
+	{                                               \
+		jitter.PushCst(offset);                     \
+	}
+
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		//Store tests
+		{
+			jitter.PushRelRef(offsetof(CONTEXT, memory));
+			jitter.PushCst(STORE_OFFSET);
+			jitter.AddRef();
+			jitter.PushRel(offsetof(CONTEXT, writeValue));
+			jitter.StoreAtRefBSwap();
+		}
+
+		{
+			jitter.PushRelRef(offsetof(CONTEXT, memory));
+			jitter.PushCst(STORE_CST_OFFSET);
+			jitter.AddRef();
+			jitter.PushCst(CONSTANT_2);
+			jitter.StoreAtRefBSwap();
+		}
+
+		{
+			jitter.PushRelRef(offsetof(CONTEXT, memory));
+			PUSH_IDX(storeIdx, STORE_IDX_OFFSET);
+			jitter.PushRel(offsetof(CONTEXT, writeValue));
+			jitter.StoreAtRefIdxBSwap(1);
+		}
+
+		{
+			jitter.PushRelRef(offsetof(CONTEXT, memory));
+			jitter.PushCst(STORE16_OFFSET);
+			jitter.AddRef();
+			jitter.PushRel(offsetof(CONTEXT, writeValue));
+			jitter.Store16AtRefBSwap();
+		}
+
+		{
+			jitter.PushRelRef(offsetof(CONTEXT, memory));
+			PUSH_IDX(storeIdx16, STORE16_IDX_OFFSET);
+			jitter.PushRel(offsetof(CONTEXT, writeValue));
+			jitter.Store16AtRefIdxBSwap(1);
+		}
+
+		{
+			jitter.PushRelRef(offsetof(CONTEXT, memory));
+			jitter.PushCst(STORE16_CST_OFFSET);
+			jitter.AddRef();
+			jitter.PushCst(CONSTANT_3);
+			jitter.Store16AtRefBSwap();
+		}
+
+		{
+			jitter.PushRelRef(offsetof(CONTEXT, memory));
+			jitter.PushCst(STORE64_OFFSET);
+			jitter.AddRef();
+			jitter.PushRel64(offsetof(CONTEXT, writeValue64));
+			jitter.Store64AtRefBSwap();
+		}
+
+		{
+			jitter.PushRelRef(offsetof(CONTEXT, memory));
+			PUSH_IDX(storeIdx64, STORE64_IDX_OFFSET);
+			jitter.PushRel64(offsetof(CONTEXT, writeValue64));
+			jitter.Store64AtRefIdxBSwap(1);
+		}
+
+		//Load tests
+		{
+			jitter.PushRelRef(offsetof(CONTEXT, memory));
+			jitter.PushCst(LOAD_OFFSET);
+			jitter.AddRef();
+			jitter.LoadFromRefBSwap();
+			jitter.PullRel(offsetof(CONTEXT, readValue));
+		}
+
+		{
+			jitter.PushRelRef(offsetof(CONTEXT, memory));
+			PUSH_IDX(loadIdx, LOAD_OFFSET);
+			jitter.LoadFromRefIdxBSwap(1);
+			jitter.PullRel(offsetof(CONTEXT, readValueIdx));
+		}
+
+		{
+			jitter.PushRelRef(offsetof(CONTEXT, memory));
+			jitter.PushCst(LOAD16_OFFSET);
+			jitter.AddRef();
+			jitter.Load16FromRefBSwap();
+			jitter.PullRel(offsetof(CONTEXT, readValue16));
+		}
+
+		{
+			jitter.PushRelRef(offsetof(CONTEXT, memory));
+			PUSH_IDX(loadIdx16, LOAD16_OFFSET);
+			jitter.Load16FromRefIdxBSwap(1);
+			jitter.PullRel(offsetof(CONTEXT, readValue16Idx));
+		}
+
+		{
+			jitter.PushRelRef(offsetof(CONTEXT, memory));
+			jitter.PushCst(LOAD64_OFFSET);
+			jitter.AddRef();
+			jitter.Load64FromRefBSwap();
+			jitter.PullRel64(offsetof(CONTEXT, readValue64));
+		}
+
+		{
+			jitter.PushRelRef(offsetof(CONTEXT, memory));
+			PUSH_IDX(loadIdx64, LOAD64_OFFSET);
+			jitter.Load64FromRefIdxBSwap(1);
+			jitter.PullRel64(offsetof(CONTEXT, readValue64Idx));
+		}
+	}
+	jitter.End();
+
+#undef PUSH_IDX
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Test.h"
+
+class CMemAccessBSwapTest : public CTest
+{
+public:
+	CMemAccessBSwapTest(bool);
+
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	enum
+	{
+		MEMORY_SIZE = 0x40,
+	};
+
+	struct CONTEXT
+	{
+		void* memory;
+		uint64 writeValue64;
+		uint64 readValue64;
+		uint64 readValue64Idx;
+		uint32 writeValue;
+		uint32 readValue;
+		uint32 readValueIdx;
+		uint32 readValue16;
+		uint32 readValue16Idx;
+
+		uint32 storeIdx;
+		uint32 storeIdx16;
+		uint32 storeIdx64;
+		uint32 loadIdx;
+		uint32 loadIdx16;
+		uint32 loadIdx64;
+	};
+
+	CONTEXT m_context;
+	uint8 m_memory[MEMORY_SIZE];
+	FunctionType m_function;
+	bool m_useVariableIndices;
+};
@@ -0,0 +1,107 @@
+#include "MemAccessLargeOffsetTest.h"
+#include "MemStream.h"
+
+//Offsets are chosen to need more than one byte when encoded as LEB128 (used by Wasm memargs)
+#define CST_INDEX (0x30)
+#define FAR_INDEX (0x1300)
+#define NEG_INDEX_BASE (0x1000)
+#define NEG_INDEX (-4)
+#define STORE_FAR_INDEX (0x1380)
+
+#define VALUE_0 (0x01234567)
+#define VALUE_1 (0x89ABCDEF)
+#define VALUE_2 (0xFEDCBA98)
+#define VALUE_3 (0x76543210)
+#define VALUE_64 (0x0011223344556677ULL)
+
+void CMemAccessLargeOffsetTest::Run()
+{
+	memset(&m_context, 0, sizeof(m_context));
+	memset(&m_memory, 0xFF, sizeof(m_memory));
+
+	m_memory[CST_INDEX] = VALUE_0;
+	m_memory[FAR_INDEX] = VALUE_1;
+	m_memory[NEG_INDEX_BASE + NEG_INDEX] = VALUE_2;
+
+	m_context.memory = m_memory;
+	m_context.value = VALUE_3;
+	m_context.value64 = VALUE_64;
+	m_context.fpValue = 2.5f;
+	m_context.farValue = VALUE_0;
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		m_context.mdValue.nV[i] = 0x10000 * i;
+	}
+
+	m_function(&m_context);
+
+	TEST_VERIFY(m_context.result == VALUE_3);
+	TEST_VERIFY(m_context.result64 == VALUE_64);
+	TEST_VERIFY(m_context.fpResult == 3.5f);
+	TEST_VERIFY(m_context.farResult == (VALUE_0 + VALUE_3));
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		TEST_VERIFY(m_context.mdResult.nV[i] == 0x10000 * i);
+	}
+
+	TEST_VERIFY(m_context.cstIndexValue == VALUE_0);
+	TEST_VERIFY(m_context.farIndexValue == VALUE_1);
+	TEST_VERIFY(m_context.negIndexValue == VALUE_2);
+	TEST_VERIFY(m_memory[STORE_FAR_INDEX] == VALUE_3);
+}
+
+void CMemAccessLargeOffsetTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		//Relatives
+		jitter.PushRel(offsetof(CONTEXT, value));
+		jitter.PullRel(offsetof(CONTEXT, result));
+
+		jitter.PushRel64(offsetof(CONTEXT, value64));
+		jitter.PullRel64(offsetof(CONTEXT, result64));
+
+		jitter.FP_PushRel32(offsetof(CONTEXT, fpValue));
+		jitter.FP_PushCst32(1.0f);
+		jitter.FP_AddS();
+		jitter.FP_PullRel32(offsetof(CONTEXT, fpResult));
+
+		jitter.MD_PushRel(offsetof(CONTEXT, mdValue));
+		jitter.MD_PullRel(offsetof(CONTEXT, mdResult));
+
+		jitter.PushRel(offsetof(CONTEXT, farValue));
+		jitter.PushRel(offsetof(CONTEXT, value));
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, farResult));
+
+		//Constant indices
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushCst(CST_INDEX);
+		jitter.LoadFromRefIdx(sizeof(uint32));
+		jitter.PullRel(offsetof(CONTEXT, cstIndexValue));
+
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushCst(FAR_INDEX);
+		jitter.LoadFromRefIdx(sizeof(uint32));
+		jitter.PullRel(offsetof(CONTEXT, farIndexValue));
+
+		//Negative displacements can't be folded in an unsigned offset
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushCst(NEG_INDEX_BASE * sizeof(uint32));
+		jitter.AddRef();
+		jitter.PushCst(NEG_INDEX);
+		jitter.LoadFromRefIdx(sizeof(uint32));
+		jitter.PullRel(offsetof(CONTEXT, negIndexValue));
+
+		jitter.PushRelRef(offsetof(CONTEXT, memory));
+		jitter.PushCst(STORE_FAR_INDEX);
+		jitter.PushRel(offsetof(CONTEXT, value));
+		jitter.StoreAtRefIdx(sizeof(uint32));
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
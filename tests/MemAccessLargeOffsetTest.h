@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Test.h"
+#include "Align16.h"
+#include "uint128.h"
+
+class CMemAccessLargeOffsetTest : public CTest
+{
+public:
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	static constexpr size_t MEMORY_SIZE = 0x1400;
+
+	struct CONTEXT
+	{
+		ALIGN16
+
+		uint128 padding0[0x10];
+
+		uint128 mdValue;
+		uint128 mdResult;
+		void* memory;
+		uint64 value64;
+		uint64 result64;
+		float fpValue;
+		float fpResult;
+		uint32 value;
+		uint32 result;
+
+		uint32 cstIndexValue;
+		uint32 farIndexValue;
+		uint32 negIndexValue;
+
+		uint32 padding1[0x300];
+
+		uint32 farValue;
+		uint32 farResult;
+	};
+
+	CONTEXT m_context;
+	uint32 m_memory[MEMORY_SIZE];
+	FunctionType m_function;
+};
@@ -0,0 +1,174 @@
+#include "MemAccessMemBaseTest.h"
+#include "MemStream.h"
+#include "Jitter_CodeGenFactory.h"
+#include <stdexcept>
+
+#define CONSTANT_1 (0x01234567)
+#define CONSTANT_2 (0x89ABCDEF)
+
+//Indices are relative to BASE_OFFSET, displacements are added on top of them
+#define BASE_OFFSET (0x08)
+#define STORE_DISP (0x00)
+#define STORE8_DISP (0x04)
+#define STORE16_DISP (0x06)
+#define STORE_CST_DISP (0x0C)
+#define LOAD_DISP (0x10)
+#define LOAD8_DISP (0x14)
+#define LOAD16_DISP (0x16)
+#define OVERWRITE_DISP (0x18)
+
+CMemAccessMemBaseTest::CMemAccessMemBaseTest(bool useVariableIndices)
+    : m_useVariableIndices(useVariableIndices)
+{
+}
+
+void CMemAccessMemBaseTest::Run()
+{
+	m_context = {};
+	m_context.storeIdx = BASE_OFFSET;
+	m_context.loadIdx = BASE_OFFSET;
+	m_context.writeValue = CONSTANT_1;
+	m_context.memory = m_memory;
+	m_context.farMemory = m_memory;
+
+	memset(&m_memory, 0x80, sizeof(m_memory));
+	uint32 loadValue = CONSTANT_2;
+	memcpy(m_memory + BASE_OFFSET + LOAD_DISP, &loadValue, sizeof(uint32));
+	m_memory[BASE_OFFSET + LOAD8_DISP] = 0xA5;
+	m_memory[BASE_OFFSET + LOAD16_DISP + 0] = 0x34;
+	m_memory[BASE_OFFSET + LOAD16_DISP + 1] = 0xB2;
+	memcpy(m_memory + BASE_OFFSET + OVERWRITE_DISP, &loadValue, sizeof(uint32));
+
+	m_function(&m_context);
+	if(!m_farFunction.IsEmpty())
+	{
+		m_farFunction(&m_context);
+		TEST_VERIFY(m_context.readValueFar == CONSTANT_1);
+	}
+
+	uint32 storeValue = 0, storeCstValue = 0, overwriteValue = 0;
+	memcpy(&storeValue, m_memory + BASE_OFFSET + STORE_DISP, sizeof(uint32));
+	memcpy(&storeCstValue, m_memory + BASE_OFFSET + STORE_CST_DISP, sizeof(uint32));
+	memcpy(&overwriteValue, m_memory + BASE_OFFSET + OVERWRITE_DISP, sizeof(uint32));
+
+	TEST_VERIFY(storeValue == CONSTANT_1);
+	TEST_VERIFY(storeCstValue == CONSTANT_2);
+	TEST_VERIFY(m_memory[BASE_OFFSET + STORE8_DISP] == 0x67);
+	TEST_VERIFY(m_memory[BASE_OFFSET + STORE8_DISP + 1] == 0x80);
+	TEST_VERIFY(m_memory[BASE_OFFSET + STORE16_DISP + 0] == 0x67);
+	TEST_VERIFY(m_memory[BASE_OFFSET + STORE16_DISP + 1] == 0x45);
+	TEST_VERIFY(m_memory[BASE_OFFSET + STORE16_DISP + 2] == 0x80);
+	TEST_VERIFY(overwriteValue == CONSTANT_1);
+
+	TEST_VERIFY(m_context.readValue == CONSTANT_2);
+	TEST_VERIFY(m_context.readValue8 == 0xA5);
+	TEST_VERIFY(m_context.readValue16 == 0xB234);
+	TEST_VERIFY(m_context.readValueBefore == CONSTANT_2);
+	TEST_VERIFY(m_context.readValueAfter == CONSTANT_1);
+}
+
+void CMemAccessMemBaseTest::Compile(Jitter::CJitter& jitter)
+{
+#define PUSH_IDX(field)                             \
+	if(m_useVariableIndices)                        \
+	{                                               \
+		jitter.PushRel(offsetof(CONTEXT, field));   \
+	}                                               \
+	else                                            \
+	{                                               \
+		jitter.PushCst(BASE_OFFSET);                \
+	}
+
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+	jitter.SetMemoryBase(offsetof(CONTEXT, memory));
+
+	jitter.Begin();
+	{
+		//Store tests
+		PUSH_IDX(storeIdx);
+		jitter.PushRel(offsetof(CONTEXT, writeValue));
+		jitter.StoreAtMemBase(STORE_DISP);
+
+		PUSH_IDX(storeIdx);
+		jitter.PushRel(offsetof(CONTEXT, writeValue));
+		jitter.Store8AtMemBase(STORE8_DISP);
+
+		PUSH_IDX(storeIdx);
+		jitter.PushRel(offsetof(CONTEXT, writeValue));
+		jitter.Store16AtMemBase(STORE16_DISP);
+
+		PUSH_IDX(storeIdx);
+		jitter.PushCst(CONSTANT_2);
+		jitter.StoreAtMemBase(STORE_CST_DISP);
+
+		//Load tests
+		PUSH_IDX(loadIdx);
+		jitter.LoadFromMemBase(LOAD_DISP);
+		jitter.PullRel(offsetof(CONTEXT, readValue));
+
+		PUSH_IDX(loadIdx);
+		jitter.Load8FromMemBase(LOAD8_DISP);
+		jitter.PullRel(offsetof(CONTEXT, readValue8));
+
+		PUSH_IDX(loadIdx);
+		jitter.Load16FromMemBase(LOAD16_DISP);
+		jitter.PullRel(offsetof(CONTEXT, readValue16));
+
+		//Load, overwrite and load again, second load must not reuse the first one
+		PUSH_IDX(loadIdx);
+		jitter.LoadFromMemBase(OVERWRITE_DISP);
+		jitter.PullRel(offsetof(CONTEXT, readValueBefore));
+
+		PUSH_IDX(storeIdx);
+		jitter.PushRel(offsetof(CONTEXT, writeValue));
+		jitter.StoreAtMemBase(OVERWRITE_DISP);
+
+		PUSH_IDX(loadIdx);
+		jitter.LoadFromMemBase(OVERWRITE_DISP);
+		jitter.PullRel(offsetof(CONTEXT, readValueAfter));
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+
+	//Code generators without a memory base register access the pointer as a regular relative,
+	//which can't be that far on every platform
+	if(jitter.GetCodeGen()->SupportsMemoryBase())
+	{
+		Framework::CMemStream farCodeStream;
+		jitter.SetStream(&farCodeStream);
+		jitter.SetMemoryBase(offsetof(CONTEXT, farMemory));
+
+		jitter.Begin();
+		{
+			PUSH_IDX(loadIdx);
+			jitter.LoadFromMemBase(OVERWRITE_DISP);
+			jitter.PullRel(offsetof(CONTEXT, readValueFar));
+		}
+		jitter.End();
+
+		m_farFunction = FunctionType(farCodeStream.GetBuffer(), farCodeStream.GetSize());
+	}
+
+#undef PUSH_IDX
+
+	//Memory base accesses are refused when no memory base was set
+	{
+		Framework::CMemStream unsetCodeStream;
+		Jitter::CJitter unsetJitter(Jitter::CreateCodeGen());
+		unsetJitter.SetStream(&unsetCodeStream);
+		bool failed = false;
+		unsetJitter.Begin();
+		try
+		{
+			unsetJitter.PushCst(BASE_OFFSET);
+			unsetJitter.LoadFromMemBase(LOAD_DISP);
+		}
+		catch(const std::runtime_error&)
+		{
+			failed = true;
+		}
+		TEST_VERIFY(failed);
+	}
+}
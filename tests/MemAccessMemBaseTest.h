@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Test.h"
+
+class CMemAccessMemBaseTest : public CTest
+{
+public:
+	CMemAccessMemBaseTest(bool);
+
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	enum
+	{
+		MEMORY_SIZE = 0x40,
+		FAR_PADDING_SIZE = 0x8000,
+	};
+
+	struct CONTEXT
+	{
+		void* memory;
+		uint32 writeValue;
+		uint32 readValue;
+		uint32 readValue8;
+		uint32 readValue16;
+		uint32 readValueBefore;
+		uint32 readValueAfter;
+
+		uint32 storeIdx;
+		uint32 loadIdx;
+
+		//Memory pointer too far to be loaded with an immediate offset on some platforms
+		uint32 readValueFar;
+		uint8 padding[FAR_PADDING_SIZE];
+		void* farMemory;
+	};
+
+	CONTEXT m_context;
+	uint8 m_memory[MEMORY_SIZE];
+	FunctionType m_function;
+	FunctionType m_farFunction;
+	bool m_useVariableIndices;
+};
@@ -0,0 +1,117 @@
+#include "MemoryFunctionRegionTest.h"
+#include "MemStream.h"
+#ifndef __EMSCRIPTEN__
+#include <stdexcept>
+#include "MemoryFunctionStream.h"
+#endif
+
+#define VALUE (0x1234)
+#define CONSTANT0 (0x55AA)
+#define CONSTANT1 (0x0F0F)
+#define REGION_SIZE (0x1000)
+#define CODE_CAPACITY (0x400)
+
+void CMemoryFunctionRegionTest::EmitFunction(Jitter::CJitter& jitter, size_t resultOffset, uint32 constant)
+{
+	jitter.Begin();
+	{
+		jitter.PushRel(offsetof(CONTEXT, value));
+		jitter.PushCst(constant);
+		jitter.Xor();
+		jitter.PullRel(resultOffset);
+	}
+	jitter.End();
+}
+
+void CMemoryFunctionRegionTest::Compile(Jitter::CJitter& jitter)
+{
+#ifdef __EMSCRIPTEN__
+	{
+		Framework::CMemStream codeStream;
+		jitter.SetStream(&codeStream);
+		EmitFunction(jitter, offsetof(CONTEXT, result0), CONSTANT0);
+		m_function0 = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+	}
+	{
+		Framework::CMemStream codeStream;
+		jitter.SetStream(&codeStream);
+		EmitFunction(jitter, offsetof(CONTEXT, result1), CONSTANT1);
+		m_function1 = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+	}
+#else
+	m_region = std::make_unique<CMemoryFunctionRegion>(REGION_SIZE);
+
+	auto stats = m_region->GetStats();
+	TEST_VERIFY(stats.capacity >= REGION_SIZE);
+	TEST_VERIFY(stats.usedSize == 0);
+	TEST_VERIFY(stats.functionCount == 0);
+	TEST_VERIFY(stats.largestFreeBlockSize == stats.capacity);
+	size_t capacity = stats.capacity;
+
+	//Copied from a temporary buffer
+	{
+		Framework::CMemStream codeStream;
+		jitter.SetStream(&codeStream);
+		EmitFunction(jitter, offsetof(CONTEXT, result0), CONSTANT0);
+		m_function0 = FunctionType(*m_region, codeStream.GetBuffer(), codeStream.GetSize());
+	}
+
+	//Generated in place
+	m_function1 = FunctionType::Reserve(*m_region, CODE_CAPACITY);
+	m_function1.BeginModify();
+	{
+		CMemoryFunctionStream codeStream(m_function1);
+		jitter.SetStream(&codeStream);
+		EmitFunction(jitter, offsetof(CONTEXT, result1), CONSTANT1);
+	}
+	m_function1.EndModify();
+
+	stats = m_region->GetStats();
+	TEST_VERIFY(stats.functionCount == 2);
+	TEST_VERIFY(stats.usedSize >= (m_function0.GetSize() + CODE_CAPACITY));
+	TEST_VERIFY(stats.largestFreeBlockSize == (capacity - stats.usedSize));
+	TEST_VERIFY((stats.hugePageMode == CMemoryFunctionRegion::HUGE_PAGE_MODE_NONE) == (stats.hugePageBackedSize == 0));
+	TEST_VERIFY((stats.mappingMode == CMemoryFunctionRegion::MAPPING_MODE_DUAL) == (m_function1.GetWritableCode() != m_function1.GetCode()));
+	size_t usedSize = stats.usedSize;
+
+	//Freed space is given back to the region and can be reused
+	{
+		auto function = FunctionType::Reserve(*m_region, CODE_CAPACITY);
+		TEST_VERIFY(m_region->GetStats().functionCount == 3);
+		auto code = function.GetCode();
+		function = FunctionType();
+		stats = m_region->GetStats();
+		TEST_VERIFY(stats.functionCount == 2);
+		TEST_VERIFY(stats.usedSize == usedSize);
+		TEST_VERIFY(stats.largestFreeBlockSize == (capacity - usedSize));
+		function = FunctionType::Reserve(*m_region, CODE_CAPACITY);
+		TEST_VERIFY(function.GetCode() == code);
+	}
+
+	//Running out of space is reported as an error
+	{
+		bool failed = false;
+		try
+		{
+			auto function = FunctionType::Reserve(*m_region, capacity);
+		}
+		catch(const std::runtime_error&)
+		{
+			failed = true;
+		}
+		TEST_VERIFY(failed);
+	}
+#endif
+}
+
+void CMemoryFunctionRegionTest::Run()
+{
+	memset(&m_context, 0, sizeof(CONTEXT));
+	m_context.value = VALUE;
+
+	m_function0(&m_context);
+	m_function1(&m_context);
+
+	TEST_VERIFY(m_context.result0 == (VALUE ^ CONSTANT0));
+	TEST_VERIFY(m_context.result1 == (VALUE ^ CONSTANT1));
+}
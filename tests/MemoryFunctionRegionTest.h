@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Test.h"
+#include <memory>
+
+class CMemoryFunctionRegionTest : public CTest
+{
+public:
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	struct CONTEXT
+	{
+		uint32 value;
+		uint32 result0;
+		uint32 result1;
+	};
+
+	void EmitFunction(Jitter::CJitter&, size_t, uint32);
+
+	CONTEXT m_context;
+#ifndef __EMSCRIPTEN__
+	//Needs to be destroyed after the functions allocated from it
+	std::unique_ptr<CMemoryFunctionRegion> m_region;
+#endif
+	FunctionType m_function0;
+	FunctionType m_function1;
+};
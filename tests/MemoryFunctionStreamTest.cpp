@@ -0,0 +1,116 @@
+#include "MemoryFunctionStreamTest.h"
+#include "MemStream.h"
+#include "Jitter_CodeGenFactory.h"
+#ifndef __EMSCRIPTEN__
+#include <stdexcept>
+#include "MemoryFunctionStream.h"
+#endif
+
+#define VALUE0 (0x1234)
+#define VALUE1 (0x10)
+#define LOOP_COUNT (8)
+#define CODE_CAPACITY (0x1000)
+#define LARGE_CODE_CAPACITY (0x400000)
+
+void CMemoryFunctionStreamTest::EmitFunction(Jitter::CJitter& jitter)
+{
+	jitter.Begin();
+	{
+		jitter.PushCst(0);
+		jitter.PullRel(offsetof(CONTEXT, counter));
+
+		auto loopLabel = jitter.CreateLabel();
+		jitter.MarkLabel(loopLabel);
+		{
+			jitter.PushRel(offsetof(CONTEXT, result));
+			jitter.PushRel(offsetof(CONTEXT, value0));
+			jitter.Add();
+			jitter.PushRel(offsetof(CONTEXT, value1));
+			jitter.Xor();
+			jitter.PullRel(offsetof(CONTEXT, result));
+
+			jitter.PushRel(offsetof(CONTEXT, counter));
+			jitter.PushCst(1);
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, counter));
+
+			jitter.PushRel(offsetof(CONTEXT, counter));
+			jitter.PushCst(LOOP_COUNT);
+			jitter.BeginIf(Jitter::CONDITION_BL);
+			{
+				jitter.Goto(loopLabel);
+			}
+			jitter.EndIf();
+		}
+	}
+	jitter.End();
+}
+
+void CMemoryFunctionStreamTest::Compile(Jitter::CJitter& jitter)
+{
+#ifdef __EMSCRIPTEN__
+	//Code needs to be compiled into a module, can't be generated in place
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+	EmitFunction(jitter);
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+#else
+	m_function = FunctionType::Reserve(CODE_CAPACITY);
+	m_function.BeginModify();
+	{
+		CMemoryFunctionStream codeStream(m_function);
+		jitter.SetStream(&codeStream);
+		EmitFunction(jitter);
+		TEST_VERIFY(codeStream.GetSize() != 0);
+		TEST_VERIFY(codeStream.GetSize() <= m_function.GetSize());
+	}
+	m_function.EndModify();
+
+	//Code that doesn't fit in the reserved memory is reported as an error
+	{
+		auto smallFunction = FunctionType::Reserve(0x10);
+		smallFunction.BeginModify();
+		CMemoryFunctionStream codeStream(smallFunction);
+		Jitter::CJitter overflowJitter(Jitter::CreateCodeGen());
+		overflowJitter.SetStream(&codeStream);
+		bool failed = false;
+		try
+		{
+			EmitFunction(overflowJitter);
+		}
+		catch(const std::runtime_error&)
+		{
+			failed = true;
+		}
+		smallFunction.EndModify();
+		TEST_VERIFY(failed);
+	}
+
+	//Code written through the writable view is seen through the executable one
+	{
+		auto largeFunction = FunctionType::Reserve(LARGE_CODE_CAPACITY);
+		largeFunction.BeginModify();
+		reinterpret_cast<uint8*>(largeFunction.GetWritableCode())[LARGE_CODE_CAPACITY - 1] = 0xCC;
+		largeFunction.EndModify();
+		TEST_VERIFY(reinterpret_cast<const uint8*>(largeFunction.GetCode())[LARGE_CODE_CAPACITY - 1] == 0xCC);
+	}
+#endif
+}
+
+void CMemoryFunctionStreamTest::Run()
+{
+	memset(&m_context, 0, sizeof(CONTEXT));
+	m_context.value0 = VALUE0;
+	m_context.value1 = VALUE1;
+
+	m_function(&m_context);
+
+	uint32 result = 0;
+	for(uint32 i = 0; i < LOOP_COUNT; i++)
+	{
+		result = (result + VALUE0) ^ VALUE1;
+	}
+
+	TEST_VERIFY(m_context.result == result);
+	TEST_VERIFY(m_context.counter == LOOP_COUNT);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Test.h"
+
+class CMemoryFunctionStreamTest : public CTest
+{
+public:
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	struct CONTEXT
+	{
+		uint32 value0;
+		uint32 value1;
+		uint32 result;
+		uint32 counter;
+	};
+
+	void EmitFunction(Jitter::CJitter&);
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
@@ -0,0 +1,92 @@
+#include "PinnedRelativeTest.h"
+#include "MemStream.h"
+#include "Jitter_CodeGen_Wasm.h"
+
+#define START_PC (0x1000)
+#define START_CYCLES (100)
+#define CALL_CYCLES (10)
+
+extern "C" void PinnedRelativeTest_Observe(void* context)
+{
+	//Callee must see the latest values and can modify them
+	auto pinnedContext = reinterpret_cast<CPinnedRelativeTest::CONTEXT*>(context);
+	pinnedContext->observedPc = pinnedContext->pc;
+	pinnedContext->cycles -= CALL_CYCLES;
+}
+
+void CPinnedRelativeTest::PrepareExternalFunctions()
+{
+	Jitter::CWasmFunctionRegistry::RegisterFunction(reinterpret_cast<uintptr_t>(&PinnedRelativeTest_Observe), "_PinnedRelativeTest_Observe", "vi");
+}
+
+void CPinnedRelativeTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.PinRelative(offsetof(CONTEXT, pc));
+	jitter.PinRelative(offsetof(CONTEXT, cycles));
+
+	jitter.Begin();
+	{
+		jitter.PushRel(offsetof(CONTEXT, pc));
+		jitter.PushCst(4);
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, pc));
+
+		jitter.PushRel(offsetof(CONTEXT, cycles));
+		jitter.PushCst(1);
+		jitter.Sub();
+		jitter.PullRel(offsetof(CONTEXT, cycles));
+
+		jitter.PushRel(offsetof(CONTEXT, condition));
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_NE);
+		{
+			jitter.PushRel(offsetof(CONTEXT, pc));
+			jitter.PushCst(8);
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, pc));
+		}
+		jitter.EndIf();
+
+		jitter.PushCtx();
+		jitter.Call(reinterpret_cast<void*>(&PinnedRelativeTest_Observe), 1, Jitter::CJitter::RETURN_VALUE_NONE);
+
+		jitter.PushRel(offsetof(CONTEXT, cycles));
+		jitter.PushCst(1);
+		jitter.Sub();
+		jitter.PullRel(offsetof(CONTEXT, cycles));
+
+		jitter.PushRel(offsetof(CONTEXT, pc));
+		jitter.PushCst(4);
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, pc));
+
+		//Aliased access, needs to see the values held in registers
+		jitter.PushRel64(offsetof(CONTEXT, pc));
+		jitter.PullRel64(offsetof(CONTEXT, pcCycles));
+	}
+	jitter.End();
+
+	jitter.ClearPinnedRelatives();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CPinnedRelativeTest::Run()
+{
+	memset(&m_context, 0, sizeof(m_context));
+	m_context.pc = START_PC;
+	m_context.cycles = START_CYCLES;
+	m_context.condition = 1;
+
+	m_function(&m_context);
+
+	uint32 expectedPc = START_PC + 4 + 8 + 4;
+	uint32 expectedCycles = START_CYCLES - 1 - CALL_CYCLES - 1;
+	TEST_VERIFY(m_context.observedPc == (START_PC + 4 + 8));
+	TEST_VERIFY(m_context.pc == expectedPc);
+	TEST_VERIFY(m_context.cycles == expectedCycles);
+	TEST_VERIFY(m_context.pcCycles == ((static_cast<uint64>(expectedCycles) << 32) | expectedPc));
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Test.h"
+
+extern "C" void PinnedRelativeTest_Observe(void*);
+
+class CPinnedRelativeTest : public CTest
+{
+public:
+	static void PrepareExternalFunctions();
+
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	friend void ::PinnedRelativeTest_Observe(void*);
+
+	struct CONTEXT
+	{
+		uint32 pc;
+		uint32 cycles;
+		uint64 pcCycles;
+		uint32 observedPc;
+		uint32 condition;
+	};
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
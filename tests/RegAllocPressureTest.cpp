@@ -0,0 +1,100 @@
+#include "RegAllocPressureTest.h"
+#include "MemStream.h"
+#include "offsetof_def.h"
+
+#define ROUND_COUNT (3)
+#define VAR_STRIDE (5)
+
+void CRegAllocPressureTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		for(unsigned int round = 0; round < ROUND_COUNT; round++)
+		{
+			for(unsigned int i = 0; i < MAX_VARS; i++)
+			{
+				jitter.PushRel(offsetof(CONTEXT, number[i]));
+				jitter.PushRel(offsetof(CONTEXT, number[(i + VAR_STRIDE) % MAX_VARS]));
+				jitter.Add();
+				jitter.PullRel(offsetof(CONTEXT, number[i]));
+
+				if((i % MAX_WIDE_VARS) != 0) continue;
+
+				unsigned int wideIndex = (i / MAX_WIDE_VARS) % MAX_WIDE_VARS;
+
+				//64-bit temporaries end up between the integer and float locals on Wasm
+				jitter.PushRel(offsetof(CONTEXT, number[i]));
+				jitter.PushRel(offsetof(CONTEXT, number[(i + 1) % MAX_VARS]));
+				jitter.MergeTo64();
+				jitter.PushRel64(offsetof(CONTEXT, wide[wideIndex]));
+				jitter.Add64();
+				jitter.PullRel64(offsetof(CONTEXT, wide[wideIndex]));
+
+				jitter.FP_PushRel32(offsetof(CONTEXT, single[wideIndex]));
+				jitter.FP_PushRel32(offsetof(CONTEXT, single[(wideIndex + 1) % MAX_WIDE_VARS]));
+				jitter.FP_AddS();
+				jitter.FP_PullRel32(offsetof(CONTEXT, single[wideIndex]));
+			}
+		}
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CRegAllocPressureTest::Run()
+{
+	CONTEXT expected;
+	InitContext(expected);
+	ComputeExpected(expected);
+
+	InitContext(m_context);
+	m_function(&m_context);
+
+	for(unsigned int i = 0; i < MAX_VARS; i++)
+	{
+		TEST_VERIFY(m_context.number[i] == expected.number[i]);
+	}
+	for(unsigned int i = 0; i < MAX_WIDE_VARS; i++)
+	{
+		TEST_VERIFY(m_context.wide[i] == expected.wide[i]);
+		TEST_VERIFY(m_context.single[i] == expected.single[i]);
+	}
+}
+
+void CRegAllocPressureTest::InitContext(CONTEXT& context)
+{
+	memset(&context, 0, sizeof(CONTEXT));
+	for(unsigned int i = 0; i < MAX_VARS; i++)
+	{
+		context.number[i] = 0x01010101 * (i + 1);
+	}
+	for(unsigned int i = 0; i < MAX_WIDE_VARS; i++)
+	{
+		context.wide[i] = 0x0123456789ABCDEFULL * (i + 1);
+		context.single[i] = static_cast<float>(i) + 0.5f;
+	}
+}
+
+void CRegAllocPressureTest::ComputeExpected(CONTEXT& context)
+{
+	for(unsigned int round = 0; round < ROUND_COUNT; round++)
+	{
+		for(unsigned int i = 0; i < MAX_VARS; i++)
+		{
+			context.number[i] += context.number[(i + VAR_STRIDE) % MAX_VARS];
+
+			if((i % MAX_WIDE_VARS) != 0) continue;
+
+			unsigned int wideIndex = (i / MAX_WIDE_VARS) % MAX_WIDE_VARS;
+
+			uint64 merged = static_cast<uint64>(context.number[i]) | (static_cast<uint64>(context.number[(i + 1) % MAX_VARS]) << 32);
+			context.wide[wideIndex] = merged + context.wide[wideIndex];
+
+			context.single[wideIndex] = context.single[wideIndex] + context.single[(wideIndex + 1) % MAX_WIDE_VARS];
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Test.h"
+
+//Keeps more values live than there are registers, mixing 32-bit relatives
+//with 64-bit and single precision values. On Wasm, registers and 64-bit
+//temporaries are locals, this makes sure their indices don't overlap.
+class CRegAllocPressureTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	enum MAX_VARS
+	{
+		MAX_VARS = 24,
+	};
+
+	enum MAX_WIDE_VARS
+	{
+		MAX_WIDE_VARS = 4,
+	};
+
+	struct CONTEXT
+	{
+		uint32 number[MAX_VARS];
+		uint64 wide[MAX_WIDE_VARS];
+		float single[MAX_WIDE_VARS];
+	};
+
+	static void InitContext(CONTEXT&);
+	static void ComputeExpected(CONTEXT&);
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
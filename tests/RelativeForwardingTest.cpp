@@ -0,0 +1,128 @@
+#include "RelativeForwardingTest.h"
+#include "MemStream.h"
+#include "Jitter_CodeGen_Wasm.h"
+
+#define FLAGS_INITIAL (0xFF)
+#define FLAGS_LESS (0x01)
+#define FLAGS_GREATER (0x02)
+#define CONSTANT_VALUE (7)
+#define OBSERVED_FIRST (0x55)
+#define OBSERVED_SECOND (0x66)
+#define LOOP_START (3)
+#define LOOP_COUNT (4)
+
+extern "C" void RelativeForwardingTest_Observe(void* context)
+{
+	auto forwardingContext = reinterpret_cast<CRelativeForwardingTest::CONTEXT*>(context);
+	forwardingContext->observedByCall = forwardingContext->observed;
+}
+
+void CRelativeForwardingTest::PrepareExternalFunctions()
+{
+	Jitter::CWasmFunctionRegistry::RegisterFunction(reinterpret_cast<uintptr_t>(&RelativeForwardingTest_Observe), "_RelativeForwardingTest_Observe", "vi");
+}
+
+void CRelativeForwardingTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		//Overwritten on both paths, first store is dead
+		jitter.PushCst(FLAGS_INITIAL);
+		jitter.PullRel(offsetof(CONTEXT, flags));
+
+		jitter.PushCst(CONSTANT_VALUE);
+		jitter.PullRel(offsetof(CONTEXT, constant));
+
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(5);
+		jitter.BeginIf(Jitter::CONDITION_BL);
+		{
+			jitter.PushCst(FLAGS_LESS);
+			jitter.PullRel(offsetof(CONTEXT, flags));
+		}
+		jitter.Else();
+		{
+			jitter.PushCst(FLAGS_GREATER);
+			jitter.PullRel(offsetof(CONTEXT, flags));
+		}
+		jitter.EndIf();
+
+		//Constant is known on all paths
+		jitter.PushRel(offsetof(CONTEXT, constant));
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, result));
+
+		//Overwritten on all paths, but observed by the call on one of them
+		jitter.PushCst(OBSERVED_FIRST);
+		jitter.PullRel(offsetof(CONTEXT, observed));
+
+		jitter.PushRel(offsetof(CONTEXT, input));
+		jitter.PushCst(0);
+		jitter.BeginIf(Jitter::CONDITION_NE);
+		{
+			jitter.PushCtx();
+			jitter.Call(reinterpret_cast<void*>(&RelativeForwardingTest_Observe), 1, Jitter::CJitter::RETURN_VALUE_NONE);
+		}
+		jitter.EndIf();
+
+		jitter.PushCst(OBSERVED_SECOND);
+		jitter.PullRel(offsetof(CONTEXT, observed));
+
+		//Value is only known before entering the loop
+		jitter.PushCst(LOOP_START);
+		jitter.PullRel(offsetof(CONTEXT, loopValue));
+
+		jitter.PushCst(0);
+		jitter.PullRel(offsetof(CONTEXT, counter));
+
+		auto loopLabel = jitter.CreateLabel();
+		jitter.MarkLabel(loopLabel);
+		{
+			jitter.PushRel(offsetof(CONTEXT, loopValue));
+			jitter.PushCst(1);
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, loopValue));
+
+			jitter.PushRel(offsetof(CONTEXT, counter));
+			jitter.PushCst(1);
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, counter));
+
+			jitter.PushRel(offsetof(CONTEXT, counter));
+			jitter.PushCst(LOOP_COUNT);
+			jitter.BeginIf(Jitter::CONDITION_BL);
+			{
+				jitter.Goto(loopLabel);
+			}
+			jitter.EndIf();
+		}
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CRelativeForwardingTest::RunWithInput(uint32 input)
+{
+	memset(&m_context, 0, sizeof(CONTEXT));
+	m_context.input = input;
+	m_function(&m_context);
+	TEST_VERIFY(m_context.flags == ((input < 5) ? FLAGS_LESS : FLAGS_GREATER));
+	TEST_VERIFY(m_context.constant == CONSTANT_VALUE);
+	TEST_VERIFY(m_context.result == (CONSTANT_VALUE + input));
+	TEST_VERIFY(m_context.observed == OBSERVED_SECOND);
+	TEST_VERIFY(m_context.observedByCall == ((input != 0) ? OBSERVED_FIRST : 0));
+	TEST_VERIFY(m_context.counter == LOOP_COUNT);
+	TEST_VERIFY(m_context.loopValue == (LOOP_START + LOOP_COUNT));
+}
+
+void CRelativeForwardingTest::Run()
+{
+	RunWithInput(0);
+	RunWithInput(2);
+	RunWithInput(9);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Test.h"
+
+extern "C" void RelativeForwardingTest_Observe(void*);
+
+class CRelativeForwardingTest : public CTest
+{
+public:
+	static void PrepareExternalFunctions();
+
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	friend void ::RelativeForwardingTest_Observe(void*);
+
+	struct CONTEXT
+	{
+		uint32 input;
+		uint32 flags;
+		uint32 constant;
+		uint32 result;
+		uint32 observed;
+		uint32 observedByCall;
+		uint32 counter;
+		uint32 loopValue;
+	};
+
+	void RunWithInput(uint32);
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
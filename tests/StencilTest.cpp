@@ -0,0 +1,197 @@
+#include "StencilTest.h"
+#include "MemStream.h"
+#include "Jitter_CodeGenFactory.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include "Jitter_CodeGen_x86_64_Stencil.h"
+#define HAS_STENCIL_CODEGEN
+#endif
+
+#define VALUE0 (0x80004321)
+#define VALUE1 (0x00001234)
+#define SHIFT_AMOUNT (7)
+#define LOOP_COUNT (5)
+
+void CStencilTest::Compile(Jitter::CJitter&)
+{
+	//Platforms without a baseline code generator get the optimized one, results must be the same
+	auto codeGen = Jitter::CreateCodeGen(Jitter::CODEGEN_TIER::BASELINE);
+#ifdef HAS_STENCIL_CODEGEN
+	TEST_VERIFY(dynamic_cast<Jitter::CCodeGen_x86_64_Stencil*>(codeGen) != nullptr);
+#endif
+	Jitter::CJitter stencilJitter(codeGen);
+	CompileFunction(stencilJitter);
+	CompileFallbackFunction(stencilJitter);
+}
+
+void CStencilTest::CompileFunction(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, resultAdd));
+
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Sub();
+		jitter.PullRel(offsetof(CONTEXT, resultSub));
+
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushCst(0xFFFF00FF);
+		jitter.And();
+		jitter.PullRel(offsetof(CONTEXT, resultAnd));
+
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Or();
+		jitter.PullRel(offsetof(CONTEXT, resultOr));
+
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushCst(0x55555555);
+		jitter.Xor();
+		jitter.PullRel(offsetof(CONTEXT, resultXor));
+
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Not();
+		jitter.PullRel(offsetof(CONTEXT, resultNot));
+
+		//Intermediate results end up in temporaries
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Add();
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Sub();
+		jitter.Xor();
+		jitter.PullRel(offsetof(CONTEXT, resultMixed));
+
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, shiftAmount));
+		jitter.Shl();
+		jitter.PullRel(offsetof(CONTEXT, resultShl));
+
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, shiftAmount));
+		jitter.Srl();
+		jitter.PullRel(offsetof(CONTEXT, resultSrl));
+
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, shiftAmount));
+		jitter.Sra();
+		jitter.PullRel(offsetof(CONTEXT, resultSra));
+
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Shl(SHIFT_AMOUNT + 3);
+		jitter.PullRel(offsetof(CONTEXT, resultShlCst));
+
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Cmp(Jitter::CONDITION_LT);
+		jitter.PullRel(offsetof(CONTEXT, resultCmpLt));
+
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Cmp(Jitter::CONDITION_BL);
+		jitter.PullRel(offsetof(CONTEXT, resultCmpBl));
+
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.PushCst(VALUE1);
+		jitter.Cmp(Jitter::CONDITION_EQ);
+		jitter.PullRel(offsetof(CONTEXT, resultCmpEq));
+
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.Cmp(Jitter::CONDITION_GE);
+		jitter.PullRel(offsetof(CONTEXT, resultCmpGe));
+
+		//Constant operand gets moved last, condition is swapped
+		jitter.PushCst(VALUE0);
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Cmp(Jitter::CONDITION_GE);
+		jitter.PullRel(offsetof(CONTEXT, resultCmpGeCst));
+
+		jitter.PushCst(0);
+		jitter.PullRel(offsetof(CONTEXT, counter));
+
+		auto loopLabel = jitter.CreateLabel();
+		jitter.MarkLabel(loopLabel);
+		{
+			jitter.PushRel(offsetof(CONTEXT, resultSum));
+			jitter.PushRel(offsetof(CONTEXT, value1));
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, resultSum));
+
+			jitter.PushRel(offsetof(CONTEXT, counter));
+			jitter.PushCst(1);
+			jitter.Add();
+			jitter.PullRel(offsetof(CONTEXT, counter));
+
+			jitter.PushRel(offsetof(CONTEXT, counter));
+			jitter.PushRel(offsetof(CONTEXT, loopCount));
+			jitter.BeginIf(Jitter::CONDITION_BL);
+			{
+				jitter.Goto(loopLabel);
+			}
+			jitter.EndIf();
+		}
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CStencilTest::CompileFallbackFunction(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	//No stencil for LZC, the whole function goes through the regular code generator
+	jitter.Begin();
+	{
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Lzc();
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, resultLzcAdd));
+	}
+	jitter.End();
+
+	m_fallbackFunction = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CStencilTest::Run()
+{
+	memset(&m_context, 0, sizeof(CONTEXT));
+	m_context.value0 = VALUE0;
+	m_context.value1 = VALUE1;
+	m_context.shiftAmount = SHIFT_AMOUNT;
+	m_context.loopCount = LOOP_COUNT;
+
+	m_function(&m_context);
+	m_fallbackFunction(&m_context);
+
+	TEST_VERIFY(m_context.resultAdd == (VALUE0 + VALUE1));
+	TEST_VERIFY(m_context.resultSub == (VALUE0 - VALUE1));
+	TEST_VERIFY(m_context.resultAnd == (VALUE0 & 0xFFFF00FF));
+	TEST_VERIFY(m_context.resultOr == (VALUE0 | VALUE1));
+	TEST_VERIFY(m_context.resultXor == (VALUE0 ^ 0x55555555));
+	TEST_VERIFY(m_context.resultNot == static_cast<uint32>(~VALUE1));
+	TEST_VERIFY(m_context.resultMixed == ((VALUE0 + VALUE1) ^ (VALUE0 - VALUE1)));
+	TEST_VERIFY(m_context.resultShl == (VALUE0 << SHIFT_AMOUNT));
+	TEST_VERIFY(m_context.resultSrl == (VALUE0 >> SHIFT_AMOUNT));
+	TEST_VERIFY(m_context.resultSra == static_cast<uint32>(static_cast<int32>(VALUE0) >> SHIFT_AMOUNT));
+	TEST_VERIFY(m_context.resultShlCst == (VALUE1 << (SHIFT_AMOUNT + 3)));
+	TEST_VERIFY(m_context.resultCmpLt == 1);
+	TEST_VERIFY(m_context.resultCmpBl == 0);
+	TEST_VERIFY(m_context.resultCmpEq == 1);
+	TEST_VERIFY(m_context.resultCmpGe == 1);
+	TEST_VERIFY(m_context.resultCmpGeCst == 0);
+	TEST_VERIFY(m_context.resultLzcAdd == (VALUE0 + 18));
+	TEST_VERIFY(m_context.counter == LOOP_COUNT);
+	TEST_VERIFY(m_context.resultSum == (VALUE1 * LOOP_COUNT));
+}
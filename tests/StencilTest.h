@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Test.h"
+
+class CStencilTest : public CTest
+{
+public:
+	void Run() override;
+	void Compile(Jitter::CJitter&) override;
+
+private:
+	struct CONTEXT
+	{
+		uint32 value0;
+		uint32 value1;
+		uint32 shiftAmount;
+		uint32 loopCount;
+
+		uint32 resultAdd;
+		uint32 resultSub;
+		uint32 resultAnd;
+		uint32 resultOr;
+		uint32 resultXor;
+		uint32 resultNot;
+		uint32 resultMixed;
+
+		uint32 resultShl;
+		uint32 resultSrl;
+		uint32 resultSra;
+		uint32 resultShlCst;
+
+		uint32 resultCmpLt;
+		uint32 resultCmpBl;
+		uint32 resultCmpEq;
+		uint32 resultCmpGe;
+		uint32 resultCmpGeCst;
+
+		uint32 counter;
+		uint32 resultSum;
+
+		uint32 resultLzcAdd;
+	};
+
+	void CompileFunction(Jitter::CJitter&);
+	void CompileFallbackFunction(Jitter::CJitter&);
+
+	CONTEXT m_context;
+	FunctionType m_function;
+	FunctionType m_fallbackFunction;
+};
@@ -0,0 +1,83 @@
+#include "UnreachableBlockTest.h"
+#include "MemStream.h"
+
+static constexpr uint32 LOOP_COUNT = 10;
+
+void CUnreachableBlockTest::Compile(Jitter::CJitter& jitter)
+{
+	auto compileFunction =
+	    [&](Framework::CMemStream& codeStream, bool withDeadBlocks) {
+		    jitter.SetStream(&codeStream);
+
+		    jitter.Begin();
+		    {
+			    auto loopLabel = jitter.CreateLabel();
+			    auto endLabel = jitter.CreateLabel();
+			    auto deadLabel1 = jitter.CreateLabel();
+			    auto deadLabel2 = jitter.CreateLabel();
+
+			    //Reachable loop
+			    jitter.MarkLabel(loopLabel);
+			    {
+				    jitter.PushRel(offsetof(CONTEXT, counter));
+				    jitter.PushCst(1);
+				    jitter.Add();
+				    jitter.PullRel(offsetof(CONTEXT, counter));
+
+				    jitter.PushRel(offsetof(CONTEXT, counter));
+				    jitter.PushCst(LOOP_COUNT);
+				    jitter.BeginIf(Jitter::CONDITION_BL);
+				    {
+					    jitter.Goto(loopLabel);
+				    }
+				    jitter.EndIf();
+			    }
+
+			    jitter.Goto(endLabel);
+
+			    //Unreachable blocks referencing each other
+			    if(withDeadBlocks)
+			    {
+				    jitter.MarkLabel(deadLabel1);
+				    {
+					    jitter.PushCst(RESULT_BAD);
+					    jitter.PullRel(offsetof(CONTEXT, result));
+					    jitter.Goto(deadLabel2);
+				    }
+
+				    jitter.MarkLabel(deadLabel2);
+				    {
+					    jitter.PushCst(RESULT_BAD);
+					    jitter.PullRel(offsetof(CONTEXT, counter));
+					    jitter.Goto(deadLabel1);
+				    }
+			    }
+
+			    jitter.MarkLabel(endLabel);
+			    {
+				    jitter.PushCst(RESULT_GOOD);
+				    jitter.PullRel(offsetof(CONTEXT, result));
+			    }
+		    }
+		    jitter.End();
+	    };
+
+	Framework::CMemStream codeStream;
+	compileFunction(codeStream, true);
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+
+	//Unreachable blocks must be removed entirely, leaving the same code as without them
+	Framework::CMemStream referenceCodeStream;
+	compileFunction(referenceCodeStream, false);
+	m_codeSize = codeStream.GetSize();
+	m_referenceCodeSize = referenceCodeStream.GetSize();
+}
+
+void CUnreachableBlockTest::Run()
+{
+	memset(&m_context, 0, sizeof(CONTEXT));
+	m_function(&m_context);
+	TEST_VERIFY(m_context.counter == LOOP_COUNT);
+	TEST_VERIFY(m_context.result == RESULT_GOOD);
+	TEST_VERIFY(m_codeSize == m_referenceCodeSize);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Test.h"
+
+class CUnreachableBlockTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	enum RESULT
+	{
+		RESULT_NONE = 0,
+		RESULT_GOOD = 1,
+		RESULT_BAD = 2,
+	};
+
+	struct CONTEXT
+	{
+		uint32 counter;
+		uint32 result;
+	};
+
+	CONTEXT m_context;
+	FunctionType m_function;
+	uint64 m_codeSize = 0;
+	uint64 m_referenceCodeSize = 0;
+};
@@ -0,0 +1,104 @@
+#include "ValueNumberingTest.h"
+#include "MemStream.h"
+
+static constexpr uint32 VALUE_0 = 0x12345678;
+static constexpr uint32 VALUE_1 = 0x0F0F0F0F;
+static constexpr uint32 VALUE_2 = 0xCAFEBABE;
+static constexpr uint32 OVERWRITE_VALUE = 0x55AA55AA;
+
+void CValueNumberingTest::Compile(Jitter::CJitter& jitter)
+{
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+
+	jitter.Begin();
+	{
+		//sum = value0 + value1
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, sum));
+
+		//diff = value0 - value1
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Sub();
+		jitter.PullRel(offsetof(CONTEXT, diff));
+
+		//commutedSumXor = (value1 + value0) ^ value2 (same value as sum)
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.Add();
+		jitter.PushRel(offsetof(CONTEXT, value2));
+		jitter.Xor();
+		jitter.PullRel(offsetof(CONTEXT, commutedSumXor));
+
+		jitter.PushRel(offsetof(CONTEXT, diff));
+		jitter.PullRel(offsetof(CONTEXT, diffCopy));
+
+		//Overwrite diff, the expression needs to be computed again
+		jitter.PushCst(OVERWRITE_VALUE);
+		jitter.PullRel(offsetof(CONTEXT, diff));
+
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.Sub();
+		jitter.PullRel(offsetof(CONTEXT, diffRecomputed));
+
+		//Update value0, sum needs to be computed again
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PushCst(1);
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, value0));
+
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, sumAfterUpdate));
+
+		//total = value1 + value2
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.PushRel(offsetof(CONTEXT, value2));
+		jitter.Add();
+		jitter.PullRel(offsetof(CONTEXT, total));
+
+		jitter.PushRel(offsetof(CONTEXT, total));
+		jitter.PullRel(offsetof(CONTEXT, totalCopy));
+
+		//Same value as total, but used after total is overwritten
+		jitter.PushRel(offsetof(CONTEXT, value1));
+		jitter.PushRel(offsetof(CONTEXT, value2));
+		jitter.Add();
+
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.PullRel(offsetof(CONTEXT, total));
+
+		jitter.PushRel(offsetof(CONTEXT, value0));
+		jitter.Xor();
+		jitter.PullRel(offsetof(CONTEXT, deferredSumXor));
+	}
+	jitter.End();
+
+	m_function = FunctionType(codeStream.GetBuffer(), codeStream.GetSize());
+}
+
+void CValueNumberingTest::Run()
+{
+	m_context = {};
+	m_context.value0 = VALUE_0;
+	m_context.value1 = VALUE_1;
+	m_context.value2 = VALUE_2;
+
+	m_function(&m_context);
+
+	TEST_VERIFY(m_context.value0 == VALUE_0 + 1);
+	TEST_VERIFY(m_context.sum == VALUE_0 + VALUE_1);
+	TEST_VERIFY(m_context.diff == OVERWRITE_VALUE);
+	TEST_VERIFY(m_context.commutedSumXor == ((VALUE_0 + VALUE_1) ^ VALUE_2));
+	TEST_VERIFY(m_context.diffCopy == VALUE_0 - VALUE_1);
+	TEST_VERIFY(m_context.diffRecomputed == VALUE_0 - VALUE_1);
+	TEST_VERIFY(m_context.sumAfterUpdate == VALUE_0 + 1 + VALUE_1);
+	TEST_VERIFY(m_context.total == VALUE_0 + 1);
+	TEST_VERIFY(m_context.totalCopy == VALUE_1 + VALUE_2);
+	TEST_VERIFY(m_context.deferredSumXor == ((VALUE_1 + VALUE_2) ^ (VALUE_0 + 1)));
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Test.h"
+
+class CValueNumberingTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	struct CONTEXT
+	{
+		uint32 value0;
+		uint32 value1;
+		uint32 value2;
+
+		uint32 sum;
+		uint32 diff;
+		uint32 commutedSumXor;
+		uint32 sumAfterUpdate;
+		uint32 diffCopy;
+		uint32 diffRecomputed;
+		uint32 total;
+		uint32 totalCopy;
+		uint32 deferredSumXor;
+	};
+
+	CONTEXT m_context;
+	FunctionType m_function;
+};
@@ -0,0 +1,61 @@
+#include "WasmBatchTest.h"
+
+#ifdef __EMSCRIPTEN__
+
+#include "MemStream.h"
+#include "Jitter_CodeGen_Wasm.h"
+
+#define VALUE (0x1234)
+#define CONSTANT (0x55AA)
+
+void CWasmBatchTest::EmitFunction(Jitter::CJitter& jitter, uint32 index)
+{
+	jitter.Begin();
+	{
+		jitter.PushRel(offsetof(CONTEXT, value));
+		jitter.Shl(index + 1);
+		jitter.PushCst(CONSTANT + index);
+		jitter.Xor();
+		jitter.PullRel(offsetof(CONTEXT, results) + (index * sizeof(uint32)));
+	}
+	jitter.End();
+}
+
+void CWasmBatchTest::Compile(Jitter::CJitter& jitter)
+{
+	auto codeGen = dynamic_cast<Jitter::CCodeGen_Wasm*>(jitter.GetCodeGen());
+	TEST_VERIFY(codeGen != nullptr);
+
+	//All functions end up in a single module that is instantiated once
+	Framework::CMemStream codeStream;
+	jitter.SetStream(&codeStream);
+	codeGen->BeginBatch();
+	for(uint32 i = 0; i < FUNCTION_COUNT; i++)
+	{
+		EmitFunction(jitter, i);
+	}
+	codeGen->EndBatch(codeStream);
+	TEST_VERIFY(codeStream.GetSize() != 0);
+
+	m_functions = FunctionType::CreateBatch(codeStream.GetBuffer(), codeStream.GetSize(), FUNCTION_COUNT);
+}
+
+void CWasmBatchTest::Run()
+{
+	memset(&m_context, 0, sizeof(CONTEXT));
+	m_context.value = VALUE;
+
+	TEST_VERIFY(m_functions.size() == FUNCTION_COUNT);
+	for(uint32 i = 0; i < FUNCTION_COUNT; i++)
+	{
+		TEST_VERIFY(!m_functions[i].IsEmpty());
+		m_functions[i](&m_context);
+	}
+
+	for(uint32 i = 0; i < FUNCTION_COUNT; i++)
+	{
+		TEST_VERIFY(m_context.results[i] == ((VALUE << (i + 1)) ^ (CONSTANT + i)));
+	}
+}
+
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Test.h"
+
+#ifdef __EMSCRIPTEN__
+
+#include <vector>
+
+class CWasmBatchTest : public CTest
+{
+public:
+	void Compile(Jitter::CJitter&) override;
+	void Run() override;
+
+private:
+	enum
+	{
+		FUNCTION_COUNT = 4,
+	};
+
+	struct CONTEXT
+	{
+		uint32 value;
+		uint32 results[FUNCTION_COUNT];
+	};
+
+	void EmitFunction(Jitter::CJitter&, uint32);
+
+	CONTEXT m_context;
+	std::vector<FunctionType> m_functions;
+};
+
+#endif